@@ -0,0 +1,484 @@
+// File: bin_proto.c
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 17 Oct 2026
+// Rev.: 17 Oct 2026
+//
+// Binary framed command protocol of the hardware demo for the TI Tiva TM4C1294
+// Connected LaunchPad Evaluation Kit. It runs on the UART user interface next
+// to the text shell. A frame is detected by its sync byte at the beginning of
+// a line. See bin_proto.h for the frame format.
+//
+
+
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "driverlib/i2c.h"
+#include "driverlib/rom.h"
+#include "driverlib/rom_map.h"
+#include "driverlib/uart.h"
+#include "grlib/grlib.h"
+#include "utils/uartstdio.h"
+#include "hw/adc/adc.h"
+#include "hw/gpio/gpio_led.h"
+#include "hw/i2c/i2c.h"
+#include "hw/lcd/lcd.h"
+#include "hw/pwm/pwm_rgb_led.h"
+#include "hw/ssi/ssi.h"
+#include "hw/system/timebase.h"
+#include "hw/uart/uart.h"
+#include "uart_ui.h"
+#include "bin_proto.h"
+#include "sensor.h"
+#include "task.h"
+#include "hw_demo.h"
+#include "hw_demo_io.h"
+
+
+
+// Global variables.
+static tUartUi *g_psBinProtoUartUi;
+static tContext *g_psBinProtoContext;
+static uint8_t g_pui8BinProtoRx[BIN_PROTO_HEADER_LEN + BIN_PROTO_PAYLOAD_MAX + BIN_PROTO_CRC_LEN];
+static uint8_t g_pui8BinProtoTx[BIN_PROTO_HEADER_LEN + BIN_PROTO_PAYLOAD_MAX + BIN_PROTO_CRC_LEN];
+static uint32_t g_pui32BinProtoSsiData[BIN_PROTO_PAYLOAD_MAX / 2];
+
+
+
+// Function prototypes of local functions.
+static uint16_t BinProtoCrc16(uint16_t ui16Crc, const uint8_t *pui8Data, uint32_t ui32Length);
+static uint16_t BinProtoGet16(const uint8_t *pui8Data);
+static uint32_t BinProtoGet32(const uint8_t *pui8Data);
+static void BinProtoPut16(uint8_t *pui8Data, uint16_t ui16Value);
+static void BinProtoPut32(uint8_t *pui8Data, uint32_t ui32Value);
+static int BinProtoGetByte(uint8_t *pui8Byte);
+static void BinProtoSend(uint8_t ui8Seq, uint8_t ui8Opcode, uint8_t ui8Status, uint8_t ui8Length);
+static uint8_t BinProtoExec(uint8_t ui8Opcode, uint8_t *pui8Req, uint8_t ui8ReqLength, uint8_t *pui8Resp, uint8_t *pui8RespLength);
+static uint8_t BinProtoI2C(uint8_t *pui8Req, uint8_t ui8ReqLength, uint8_t *pui8Resp, uint8_t *pui8RespLength);
+static uint8_t BinProtoSsi(uint8_t *pui8Req, uint8_t ui8ReqLength, uint8_t *pui8Resp, uint8_t *pui8RespLength);
+static uint8_t BinProtoUart(uint8_t *pui8Req, uint8_t ui8ReqLength, uint8_t *pui8Resp, uint8_t *pui8RespLength);
+static uint8_t BinProtoLcd(uint8_t ui8Opcode, uint8_t *pui8Req, uint8_t ui8ReqLength);
+
+
+
+// Initialize the binary protocol.
+void BinProtoInit(tUartUi *psUartUi, tContext *psContext)
+{
+    g_psBinProtoUartUi = psUartUi;
+    g_psBinProtoContext = psContext;
+}
+
+
+
+// Receive and execute one binary frame and send the response. The sync byte
+// must already have been consumed, e.g. by UartUiGets. Returns 0 if the
+// command was executed successfully, -1 otherwise.
+int BinProtoProcess(void)
+{
+    uint8_t *pui8Rx = g_pui8BinProtoRx;
+    uint8_t ui8Length, ui8RespLength = 0, ui8Status;
+    uint16_t ui16Crc;
+    int i;
+
+    // Header: sequence number, opcode and payload length.
+    for (i = 1; i < BIN_PROTO_HEADER_LEN; i++) {
+        if (BinProtoGetByte(&pui8Rx[i])) {
+            BinProtoSend(pui8Rx[1], pui8Rx[2], BIN_PROTO_STATUS_ERR_TIMEOUT, 0);
+            return -1;
+        }
+    }
+    ui8Length = pui8Rx[3];
+    if (ui8Length > BIN_PROTO_PAYLOAD_MAX) {
+        BinProtoSend(pui8Rx[1], pui8Rx[2], BIN_PROTO_STATUS_ERR_LENGTH, 0);
+        return -1;
+    }
+    // Payload and CRC.
+    for (i = 0; i < ui8Length + BIN_PROTO_CRC_LEN; i++) {
+        if (BinProtoGetByte(&pui8Rx[BIN_PROTO_HEADER_LEN + i])) {
+            BinProtoSend(pui8Rx[1], pui8Rx[2], BIN_PROTO_STATUS_ERR_TIMEOUT, 0);
+            return -1;
+        }
+    }
+    ui16Crc = BinProtoCrc16(0xffff, &pui8Rx[1], BIN_PROTO_HEADER_LEN - 1 + ui8Length);
+    if (ui16Crc != BinProtoGet16(&pui8Rx[BIN_PROTO_HEADER_LEN + ui8Length])) {
+        BinProtoSend(pui8Rx[1], pui8Rx[2], BIN_PROTO_STATUS_ERR_CRC, 0);
+        return -1;
+    }
+
+    // Execute the command. The first byte of the response payload is the status.
+    ui8Status = BinProtoExec(pui8Rx[2], &pui8Rx[BIN_PROTO_HEADER_LEN], ui8Length,
+                             &g_pui8BinProtoTx[BIN_PROTO_HEADER_LEN + 1], &ui8RespLength);
+    BinProtoSend(pui8Rx[1], pui8Rx[2], ui8Status, ui8RespLength);
+
+    return (ui8Status == BIN_PROTO_STATUS_OK) ? 0 : -1;
+}
+
+
+
+// Send a frame that is not a response to a command, e.g. a block of the ADC
+// stream. The data are sent after the status byte. They are truncated to the
+// maximum payload length.
+void BinProtoSendData(uint8_t ui8Seq, uint8_t ui8Opcode, uint8_t ui8Status, const void *pvData, uint8_t ui8Length)
+{
+    if (ui8Length > BIN_PROTO_PAYLOAD_MAX - 1) ui8Length = BIN_PROTO_PAYLOAD_MAX - 1;
+    memcpy(&g_pui8BinProtoTx[BIN_PROTO_HEADER_LEN + 1], pvData, ui8Length);
+    BinProtoSend(ui8Seq, ui8Opcode, ui8Status, ui8Length);
+}
+
+
+
+// Calculate the CRC-16/CCITT.
+static uint16_t BinProtoCrc16(uint16_t ui16Crc, const uint8_t *pui8Data, uint32_t ui32Length)
+{
+    while (ui32Length--) {
+        ui16Crc ^= (uint16_t) *pui8Data++ << 8;
+        for (int i = 0; i < 8; i++) {
+            if (ui16Crc & 0x8000) ui16Crc = (ui16Crc << 1) ^ 0x1021;
+            else ui16Crc <<= 1;
+        }
+    }
+    return ui16Crc;
+}
+
+
+
+// Get little endian values from a byte stream.
+static uint16_t BinProtoGet16(const uint8_t *pui8Data)
+{
+    return (uint16_t) pui8Data[0] | ((uint16_t) pui8Data[1] << 8);
+}
+
+static uint32_t BinProtoGet32(const uint8_t *pui8Data)
+{
+    return (uint32_t) BinProtoGet16(pui8Data) | ((uint32_t) BinProtoGet16(pui8Data + 2) << 16);
+}
+
+
+
+// Put little endian values into a byte stream.
+static void BinProtoPut16(uint8_t *pui8Data, uint16_t ui16Value)
+{
+    pui8Data[0] = ui16Value & 0xff;
+    pui8Data[1] = (ui16Value >> 8) & 0xff;
+}
+
+static void BinProtoPut32(uint8_t *pui8Data, uint32_t ui32Value)
+{
+    BinProtoPut16(pui8Data, ui32Value & 0xffff);
+    BinProtoPut16(pui8Data + 2, (ui32Value >> 16) & 0xffff);
+}
+
+
+
+// Receive a byte from the UART. Returns -1 on timeout.
+static int BinProtoGetByte(uint8_t *pui8Byte)
+{
+    tTimeout sTimeout;
+    int32_t i32Char;
+
+    TimeoutStart(&sTimeout, BIN_PROTO_BYTE_TIMEOUT_US);
+    while ((i32Char = UartUiCharGetNonBlocking(g_psBinProtoUartUi)) < 0) {
+        if (TimeoutExpired(&sTimeout)) return -1;
+    }
+    *pui8Byte = i32Char & 0xff;
+
+    return 0;
+}
+
+
+
+// Send a response frame. The response data (without the status byte) must
+// already be stored in the payload area of the transmit buffer.
+static void BinProtoSend(uint8_t ui8Seq, uint8_t ui8Opcode, uint8_t ui8Status, uint8_t ui8Length)
+{
+    uint8_t *pui8Tx = g_pui8BinProtoTx;
+    uint32_t ui32FrameLength;
+
+    ui8Length++;    // Status byte.
+    pui8Tx[0] = BIN_PROTO_SYNC;
+    pui8Tx[1] = ui8Seq;
+    pui8Tx[2] = ui8Opcode | BIN_PROTO_OPCODE_RESPONSE;
+    pui8Tx[3] = ui8Length;
+    pui8Tx[BIN_PROTO_HEADER_LEN] = ui8Status;
+    BinProtoPut16(&pui8Tx[BIN_PROTO_HEADER_LEN + ui8Length],
+                  BinProtoCrc16(0xffff, &pui8Tx[1], BIN_PROTO_HEADER_LEN - 1 + ui8Length));
+    // Write the raw bytes. UARTwrite cannot be used, as it expands newlines.
+    ui32FrameLength = BIN_PROTO_HEADER_LEN + ui8Length + BIN_PROTO_CRC_LEN;
+#ifdef UART_BUFFERED
+    // The frame must not overtake buffered console output.
+    UARTFlushTx(false);
+#endif
+    for (uint32_t i = 0; i < ui32FrameLength; i++) {
+        MAP_UARTCharPut(g_psBinProtoUartUi->ui32Base, pui8Tx[i]);
+    }
+}
+
+
+
+// Execute a command. Returns a BIN_PROTO_STATUS_* code.
+static uint8_t BinProtoExec(uint8_t ui8Opcode, uint8_t *pui8Req, uint8_t ui8ReqLength, uint8_t *pui8Resp, uint8_t *pui8RespLength)
+{
+    uint32_t ui32Led;
+    uint32_t pui32Adc[5];       // Joystick X/Y, accelerometer X/Y/Z.
+    uint8_t ui8Length;
+    int i;
+
+    *pui8RespLength = 0;
+    switch (ui8Opcode) {
+        // Echo the payload.
+        case BIN_PROTO_OPCODE_PING:
+            if (ui8ReqLength > BIN_PROTO_PAYLOAD_MAX - 1) return BIN_PROTO_STATUS_ERR_LENGTH;
+            memcpy(pui8Resp, pui8Req, ui8ReqLength);
+            *pui8RespLength = ui8ReqLength;
+            break;
+        // Firmware name, version and release date, separated by spaces.
+        case BIN_PROTO_OPCODE_INFO:
+            ui8Length = sizeof(FW_NAME " " FW_VERSION " " FW_RELEASEDATE) - 1;
+            memcpy(pui8Resp, FW_NAME " " FW_VERSION " " FW_RELEASEDATE, ui8Length);
+            *pui8RespLength = ui8Length;
+            break;
+        // Joystick X/Y and accelerometer X/Y/Z.
+        case BIN_PROTO_OPCODE_ADC:
+            if (ui8ReqLength != 0) return BIN_PROTO_STATUS_ERR_LENGTH;
+            AdcConvert(&g_sAdcJoystick, &pui32Adc[0]);
+            AdcConvert(&g_sAdcAccel, &pui32Adc[2]);
+            for (i = 0; i < 5; i++) BinProtoPut16(&pui8Resp[2 * i], pui32Adc[i]);
+            *pui8RespLength = 10;
+            break;
+        // Optionally set the LEDs. Returns the current LED value.
+        case BIN_PROTO_OPCODE_LED:
+            if (ui8ReqLength > 1) return BIN_PROTO_STATUS_ERR_LENGTH;
+            if (ui8ReqLength == 1) GpioLedSet(pui8Req[0]);
+            ui32Led = GpioLedGet();
+            pui8Resp[0] = ui32Led & 0xff;
+            *pui8RespLength = 1;
+            if ((ui8ReqLength == 1) && (ui32Led != pui8Req[0])) return BIN_PROTO_STATUS_ERR_HW;
+            break;
+        // Set the RGB LED. Payload: R, G, B.
+        case BIN_PROTO_OPCODE_RGB:
+            if (ui8ReqLength != 3) return BIN_PROTO_STATUS_ERR_LENGTH;
+            PwmRgbLedSet(pui8Req[0], pui8Req[1], pui8Req[2]);
+            break;
+        case BIN_PROTO_OPCODE_I2C:
+            return BinProtoI2C(pui8Req, ui8ReqLength, pui8Resp, pui8RespLength);
+        case BIN_PROTO_OPCODE_SSI:
+            return BinProtoSsi(pui8Req, ui8ReqLength, pui8Resp, pui8RespLength);
+        case BIN_PROTO_OPCODE_UART:
+            return BinProtoUart(pui8Req, ui8ReqLength, pui8Resp, pui8RespLength);
+        case BIN_PROTO_OPCODE_LCD_CLEAR:
+        case BIN_PROTO_OPCODE_LCD_PIXEL:
+        case BIN_PROTO_OPCODE_LCD_LINE:
+        case BIN_PROTO_OPCODE_LCD_RECT:
+        case BIN_PROTO_OPCODE_LCD_CIRCLE:
+        case BIN_PROTO_OPCODE_LCD_TEXT:
+        case BIN_PROTO_OPCODE_LCD_ORIENT:
+        case BIN_PROTO_OPCODE_LCD_BEGIN:
+        case BIN_PROTO_OPCODE_LCD_COMMIT:
+            // The host draws on the LCD, so stop showing the sensor values.
+            TaskEnable(TASK_LCD, false);
+            return BinProtoLcd(ui8Opcode, pui8Req, ui8ReqLength);
+        default:
+            return BIN_PROTO_STATUS_ERR_OPCODE;
+    }
+
+    return BIN_PROTO_STATUS_OK;
+}
+
+
+
+// I2C access.
+// Request: PORT SLV-ADR ACC DATA[] (write) or PORT SLV-ADR ACC [NUM] (read).
+// The access mode bits ACC are the same as for the `i2c' shell command.
+// Response: I2C master status (32 bit), read data.
+static uint8_t BinProtoI2C(uint8_t *pui8Req, uint8_t ui8ReqLength, uint8_t *pui8Resp, uint8_t *pui8RespLength)
+{
+    tI2C *psI2C;
+    uint8_t ui8SlaveAddr, ui8Rw, ui8Num = 0;
+    bool bRepeatedStart, bStop, bQuickCmd;
+    uint32_t ui32Status;
+
+    if (ui8ReqLength < 3) return BIN_PROTO_STATUS_ERR_LENGTH;
+    switch (pui8Req[0]) {
+        case 0: psI2C = &g_sI2C0; break;
+        case 2: psI2C = &g_sI2C2; break;
+        default: return BIN_PROTO_STATUS_ERR_PARAM;
+    }
+    // The host uses the I2C port 2 of the sensors, so stop reading them.
+    if (psI2C == &g_sI2C2) {
+        TaskEnable(TASK_SENSOR, false);
+        SensorLogPause(true);
+    }
+    ui8SlaveAddr = pui8Req[1];
+    ui8Rw = pui8Req[2] & 0x1;
+    bRepeatedStart = (pui8Req[2] & 0x2) ? true : false;
+    bStop = (pui8Req[2] & 0x4) ? false : true;
+    bQuickCmd = (pui8Req[2] & 0x8) ? true : false;
+    // I2C quick command.
+    if (bQuickCmd) {
+        ui32Status = I2CMasterQuickCmdAdv(psI2C, ui8SlaveAddr, ui8Rw, bRepeatedStart);
+    // I2C write.
+    } else if (ui8Rw == 0) {
+        if (ui8ReqLength < 4) return BIN_PROTO_STATUS_ERR_LENGTH;
+        ui32Status = I2CMasterWriteAdv(psI2C, ui8SlaveAddr, &pui8Req[3], ui8ReqLength - 3, bRepeatedStart, bStop);
+    // I2C read.
+    } else {
+        ui8Num = (ui8ReqLength > 3) ? pui8Req[3] : 1;
+        if (ui8Num == 0 || ui8Num > BIN_PROTO_PAYLOAD_MAX - 1 - 4) return BIN_PROTO_STATUS_ERR_PARAM;
+        ui32Status = I2CMasterReadAdv(psI2C, ui8SlaveAddr, &pui8Resp[4], ui8Num, bRepeatedStart, bStop);
+    }
+    // Resume the sensor log once the bus is released.
+    if ((psI2C == &g_sI2C2) && (ui32Status || !I2CMasterXferBusHeld(psI2C))) SensorLogPause(false);
+    BinProtoPut32(pui8Resp, ui32Status);
+    if (ui32Status) {
+        *pui8RespLength = 4;
+        return BIN_PROTO_STATUS_ERR_HW;
+    }
+    *pui8RespLength = 4 + ui8Num;
+
+    return BIN_PROTO_STATUS_OK;
+}
+
+
+
+// SSI access.
+// Request: PORT 0 DATA[] (write, 16 bit each) or PORT 1 NUM (read).
+// Response: read data (16 bit each).
+static uint8_t BinProtoSsi(uint8_t *pui8Req, uint8_t ui8ReqLength, uint8_t *pui8Resp, uint8_t *pui8RespLength)
+{
+    tSSI *psSsi;
+    uint32_t *pui32Data = g_pui32BinProtoSsiData;
+    uint32_t ui32Num;
+    int32_t i32Read;
+    int i;
+
+    if (ui8ReqLength < 3) return BIN_PROTO_STATUS_ERR_LENGTH;
+    switch (pui8Req[0]) {
+        case 2: psSsi = &g_sSsi2; break;
+        case 3: psSsi = &g_sSsi3; break;
+        default: return BIN_PROTO_STATUS_ERR_PARAM;
+    }
+    // SSI write.
+    if (pui8Req[1] == 0) {
+        if ((ui8ReqLength - 2) & 0x1) return BIN_PROTO_STATUS_ERR_LENGTH;
+        ui32Num = (ui8ReqLength - 2) / 2;
+        for (i = 0; i < ui32Num; i++) pui32Data[i] = BinProtoGet16(&pui8Req[2 + 2 * i]);
+        if (SsiMasterWrite(psSsi, pui32Data, ui32Num)) return BIN_PROTO_STATUS_ERR_HW;
+    // SSI read.
+    } else {
+        ui32Num = pui8Req[2];
+        if (ui32Num == 0 || ui32Num > (BIN_PROTO_PAYLOAD_MAX - 1) / 2) return BIN_PROTO_STATUS_ERR_PARAM;
+        i32Read = SsiMasterRead(psSsi, pui32Data, ui32Num);
+        if (i32Read < 0) return BIN_PROTO_STATUS_ERR_HW;
+        for (i = 0; i < i32Read; i++) BinProtoPut16(&pui8Resp[2 * i], pui32Data[i]);
+        *pui8RespLength = 2 * i32Read;
+        if (i32Read != ui32Num) return BIN_PROTO_STATUS_WARNING;
+    }
+
+    return BIN_PROTO_STATUS_OK;
+}
+
+
+
+// UART access.
+// Request: PORT 0 DATA[] (write) or PORT 1 NUM (read).
+// Response: read data.
+static uint8_t BinProtoUart(uint8_t *pui8Req, uint8_t ui8ReqLength, uint8_t *pui8Resp, uint8_t *pui8RespLength)
+{
+    tUART *psUart;
+    uint8_t ui8Num;
+    uint32_t ui32Read;
+
+    if (ui8ReqLength < 3) return BIN_PROTO_STATUS_ERR_LENGTH;
+    switch (pui8Req[0]) {
+        case 6: psUart = &g_sUart6; break;
+        default: return BIN_PROTO_STATUS_ERR_PARAM;
+    }
+    // UART write.
+    if (pui8Req[1] == 0) {
+        if (UartWrite(psUart, &pui8Req[2], ui8ReqLength - 2)) return BIN_PROTO_STATUS_ERR_HW;
+    // UART read.
+    } else {
+        ui8Num = pui8Req[2];
+        if (ui8Num == 0 || ui8Num > BIN_PROTO_PAYLOAD_MAX - 1) return BIN_PROTO_STATUS_ERR_PARAM;
+        ui32Read = UartRead(psUart, pui8Resp, ui8Num);
+        *pui8RespLength = ui32Read;
+        if (ui32Read != ui8Num) return BIN_PROTO_STATUS_WARNING;
+    }
+
+    return BIN_PROTO_STATUS_OK;
+}
+
+
+
+// LCD commands. Coordinates are signed 16 bit, colors 32 bit values.
+static uint8_t BinProtoLcd(uint8_t ui8Opcode, uint8_t *pui8Req, uint8_t ui8ReqLength)
+{
+    tContext *psContext = g_psBinProtoContext;
+
+    if (psContext == NULL) return BIN_PROTO_STATUS_ERR_HW;
+    switch (ui8Opcode) {
+        // COLOR
+        case BIN_PROTO_OPCODE_LCD_CLEAR:
+            if (ui8ReqLength != 4) return BIN_PROTO_STATUS_ERR_LENGTH;
+            LcdClear(psContext, BinProtoGet32(&pui8Req[0]));
+            break;
+        // X Y COLOR
+        case BIN_PROTO_OPCODE_LCD_PIXEL:
+            if (ui8ReqLength != 8) return BIN_PROTO_STATUS_ERR_LENGTH;
+            LcdDrawPixel(psContext, (int16_t) BinProtoGet16(&pui8Req[0]),
+                         (int16_t) BinProtoGet16(&pui8Req[2]), BinProtoGet32(&pui8Req[4]));
+            break;
+        // X1 Y1 X2 Y2 COLOR
+        case BIN_PROTO_OPCODE_LCD_LINE:
+            if (ui8ReqLength != 12) return BIN_PROTO_STATUS_ERR_LENGTH;
+            LcdDrawLine(psContext, (int16_t) BinProtoGet16(&pui8Req[0]),
+                        (int16_t) BinProtoGet16(&pui8Req[2]), (int16_t) BinProtoGet16(&pui8Req[4]),
+                        (int16_t) BinProtoGet16(&pui8Req[6]), BinProtoGet32(&pui8Req[8]));
+            break;
+        // X1 Y1 X2 Y2 COLOR FILL
+        case BIN_PROTO_OPCODE_LCD_RECT:
+            if (ui8ReqLength != 13) return BIN_PROTO_STATUS_ERR_LENGTH;
+            LcdDrawRect(psContext, (int16_t) BinProtoGet16(&pui8Req[0]),
+                        (int16_t) BinProtoGet16(&pui8Req[2]), (int16_t) BinProtoGet16(&pui8Req[4]),
+                        (int16_t) BinProtoGet16(&pui8Req[6]), BinProtoGet32(&pui8Req[8]), pui8Req[12]);
+            break;
+        // X Y RADIUS COLOR FILL
+        case BIN_PROTO_OPCODE_LCD_CIRCLE:
+            if (ui8ReqLength != 11) return BIN_PROTO_STATUS_ERR_LENGTH;
+            LcdDrawCircle(psContext, (int16_t) BinProtoGet16(&pui8Req[0]),
+                          (int16_t) BinProtoGet16(&pui8Req[2]), (int16_t) BinProtoGet16(&pui8Req[4]),
+                          BinProtoGet32(&pui8Req[6]), pui8Req[10]);
+            break;
+        // X Y COLOR CENTER TEXT[]
+        case BIN_PROTO_OPCODE_LCD_TEXT:
+            if (ui8ReqLength < 9) return BIN_PROTO_STATUS_ERR_LENGTH;
+            // Terminate the text in place. This overwrites the already
+            // checked CRC behind the payload.
+            pui8Req[ui8ReqLength] = 0;
+            LcdDrawText(psContext, (char *) &pui8Req[9], (int16_t) BinProtoGet16(&pui8Req[0]),
+                        (int16_t) BinProtoGet16(&pui8Req[2]), BinProtoGet32(&pui8Req[4]), pui8Req[8]);
+            break;
+        // ORIENTATION
+        case BIN_PROTO_OPCODE_LCD_ORIENT:
+            if (ui8ReqLength != 1) return BIN_PROTO_STATUS_ERR_LENGTH;
+            LcdSetOrientation(psContext, pui8Req[0]);
+            break;
+        // [TIMEOUT-MS]
+        case BIN_PROTO_OPCODE_LCD_BEGIN:
+            if (ui8ReqLength == 0) LcdBatchBegin(psContext, LCD_BATCH_TIMEOUT_DEFAULT);
+            else if (ui8ReqLength == 4) LcdBatchBegin(psContext, BinProtoGet32(&pui8Req[0]));
+            else return BIN_PROTO_STATUS_ERR_LENGTH;
+            break;
+        case BIN_PROTO_OPCODE_LCD_COMMIT:
+            if (ui8ReqLength != 0) return BIN_PROTO_STATUS_ERR_LENGTH;
+            LcdBatchCommit(psContext);
+            break;
+        default:
+            return BIN_PROTO_STATUS_ERR_OPCODE;
+    }
+
+    return BIN_PROTO_STATUS_OK;
+}
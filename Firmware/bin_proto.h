@@ -0,0 +1,71 @@
+// File: bin_proto.h
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 17 Oct 2026
+// Rev.: 17 Oct 2026
+//
+// Header file for the binary framed command protocol of the hardware demo for
+// the TI Tiva TM4C1294 Connected LaunchPad Evaluation Kit.
+//
+
+
+
+#ifndef __BIN_PROTO_H__
+#define __BIN_PROTO_H__
+
+
+
+// Frame format (all multi-byte values are little endian):
+//   SYNC SEQ OPCODE LEN PAYLOAD[LEN] CRC16[2]
+// The CRC-16/CCITT (polynomial 0x1021, initial value 0xffff) is calculated
+// over SEQ, OPCODE, LEN and PAYLOAD. A response echoes the sequence number,
+// sets the BIN_PROTO_OPCODE_RESPONSE bit of the opcode and starts its payload
+// with a BIN_PROTO_STATUS_* byte.
+#define BIN_PROTO_SYNC                  0xa5
+#define BIN_PROTO_HEADER_LEN            4
+#define BIN_PROTO_CRC_LEN               2
+#define BIN_PROTO_PAYLOAD_MAX           250
+#define BIN_PROTO_BYTE_TIMEOUT_US       100000  // Timeout between two bytes of a frame.
+
+// Opcodes.
+#define BIN_PROTO_OPCODE_PING           0x00    // Echo the payload.
+#define BIN_PROTO_OPCODE_INFO           0x01    // Firmware name, version and release date.
+#define BIN_PROTO_OPCODE_ADC            0x10    // Read all ADC values.
+#define BIN_PROTO_OPCODE_ADC_STREAM     0x11    // ADC stream block (sent by the MCU only).
+#define BIN_PROTO_OPCODE_LED            0x20    // Get/set the user LEDs.
+#define BIN_PROTO_OPCODE_RGB            0x21    // Set the RGB LED.
+#define BIN_PROTO_OPCODE_I2C            0x30    // I2C access.
+#define BIN_PROTO_OPCODE_SENSOR_LOG     0x31    // Sensor log block (sent by the MCU only).
+#define BIN_PROTO_OPCODE_SSI            0x40    // SSI access.
+#define BIN_PROTO_OPCODE_UART           0x50    // UART access.
+#define BIN_PROTO_OPCODE_LCD_CLEAR      0x60
+#define BIN_PROTO_OPCODE_LCD_PIXEL      0x61
+#define BIN_PROTO_OPCODE_LCD_LINE       0x62
+#define BIN_PROTO_OPCODE_LCD_RECT       0x63
+#define BIN_PROTO_OPCODE_LCD_CIRCLE     0x64
+#define BIN_PROTO_OPCODE_LCD_TEXT       0x65
+#define BIN_PROTO_OPCODE_LCD_ORIENT     0x66
+#define BIN_PROTO_OPCODE_LCD_BEGIN      0x67
+#define BIN_PROTO_OPCODE_LCD_COMMIT     0x68
+#define BIN_PROTO_OPCODE_RESPONSE       0x80
+
+// Response status codes.
+#define BIN_PROTO_STATUS_OK             0x00
+#define BIN_PROTO_STATUS_WARNING        0x01    // E.g. less data read than requested.
+#define BIN_PROTO_STATUS_ERR_CRC        0x02
+#define BIN_PROTO_STATUS_ERR_TIMEOUT    0x03    // Incomplete frame.
+#define BIN_PROTO_STATUS_ERR_LENGTH     0x04
+#define BIN_PROTO_STATUS_ERR_OPCODE     0x05
+#define BIN_PROTO_STATUS_ERR_PARAM      0x06
+#define BIN_PROTO_STATUS_ERR_HW         0x07
+
+
+
+// Function prototypes.
+void BinProtoInit(tUartUi *psUartUi, tContext *psContext);
+int BinProtoProcess(void);
+void BinProtoSendData(uint8_t ui8Seq, uint8_t ui8Opcode, uint8_t ui8Status, const void *pvData, uint8_t ui8Length);
+
+
+
+#endif  // __BIN_PROTO_H__
@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 26 Aug 2020
-// Rev.: 27 Aug 2020
+// Rev.: 17 Oct 2026
 //
 // User functions of the boot loader running on the TI Tiva TM4C1294 Connected
 // LaunchPad Evaluation Kit.
@@ -20,6 +20,7 @@
 #include "utils/ustdlib.h"
 #include "hw/gpio/gpio.h"
 #include "hw/gpio/gpio_led.h"
+#include "hw/system/timebase.h"
 #include "bl_config.h"
 #include "bl_user.h"
 #include "bl_user_io.h"
@@ -38,13 +39,11 @@ extern void Delay(uint32_t ui32Count);
 
 
 
-// Delay in microseconds.
+// Delay in microseconds. The boot loader does not use interrupts, so the
+// timebase is polled.
 void DelayUs(uint32_t ui32DelayUs)
 {
-    // CAUTION: Calling SysCtlDelay(0) will hang the system.
-    if (ui32DelayUs > 0)
-        // Note: The SysCtlDelay executes a simple 3 instruction cycle loop.
-        ROM_SysCtlDelay((g_ui32SysClock / 3e6) * ui32DelayUs);
+    TimebaseDelayUs(ui32DelayUs);
 }
 
 
@@ -78,6 +77,9 @@ int UserHwInit(void)
     // Set up the system clock.
     g_ui32SysClock = MAP_SysCtlClockFreqSet(SYSTEM_CLOCK_SETTINGS, SYSTEM_CLOCK_FREQ);
 
+    // Start the timebase for delays without interrupts.
+    TimebaseInit(g_ui32SysClock, false);
+
     // Initialize the LEDs.
     GpioLedInit();
     // Switch on LED 0 to indicate activity.
@@ -2,22 +2,39 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 13 Feb 2020
-// Rev.: 11 Apr 2020
+// Rev.: 17 Oct 2026
 //
 // ADC functions on the TI Tiva TM4C1294 Connected LaunchPad Evaluation Kit.
 //
+// A tADC describes a sample sequence with one step per channel. One trigger
+// samples all channels back-to-back into the FIFO of the sequence.
+//
+// An ADC stream samples several channels with one sample sequence triggered by
+// a timer. The samples are stored by the uDMA in ping-pong mode, so one buffer
+// can be read while the other one is filled.
+//
 
 
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
+#include "inc/hw_adc.h"
 #include "driverlib/adc.h"
 #include "driverlib/gpio.h"
 #include "driverlib/sysctl.h"
+#include "driverlib/timer.h"
+#include "driverlib/udma.h"
+#include "udma.h"
 #include "adc.h"
 
 
 
+// Function prototypes of local functions.
+static void *AdcStreamFifo(tADCStream *psAdcStream);
+
+
+
 // Reset an ADC.
 void AdcReset(tADC *psAdc)
 {
@@ -28,12 +45,16 @@ void AdcReset(tADC *psAdc)
 
 
 
-// Initialize an ADC.
+// Initialize an ADC sample sequence.
 void AdcInit(tADC *psAdc)
 {
-    // Set up the IO pins for the I2C master.
-    SysCtlPeripheralEnable(psAdc->ui32PeripheralGpio);
-    GPIOPinTypeADC(psAdc->ui32PortGpioBase, psAdc->ui8PinGpio);
+    uint32_t ui32Config;
+
+    // Set up the IO pins of the channels.
+    for (uint32_t i = 0; i < psAdc->ui32ChannelNum; i++) {
+        SysCtlPeripheralEnable(psAdc->psChannel[i].ui32PeripheralGpio);
+        GPIOPinTypeADC(psAdc->psChannel[i].ui32PortGpioBase, psAdc->psChannel[i].ui8PinGpio);
+    }
 
     // Set up the ADC.
     SysCtlPeripheralEnable(psAdc->ui32PeripheralAdc);
@@ -48,19 +69,25 @@ void AdcInit(tADC *psAdc)
     ADCClockConfigSet(psAdc->ui32BaseAdc, ADC_CLOCK_SRC_PLL | ADC_CLOCK_RATE_FULL, 30);
 //    ADCClockConfigSet(psAdc->ui32BaseAdc, ADC_CLOCK_SRC_PIOSC | ADC_CLOCK_RATE_FULL, 1);
     ADCReferenceSet(psAdc->ui32BaseAdc, ADC_REF_INT);
+    ADCSequenceDisable(psAdc->ui32BaseAdc, psAdc->ui32SequenceNum);
     ADCSequenceConfigure(psAdc->ui32BaseAdc, psAdc->ui32SequenceNum, ADC_TRIGGER_PROCESSOR, 0);
-    ADCSequenceStepConfigure(psAdc->ui32BaseAdc, psAdc->ui32SequenceNum, psAdc->ui32Step, psAdc->ui32Config);
+    // The last step ends the sequence and sets the interrupt flag.
+    for (uint32_t i = 0; i < psAdc->ui32ChannelNum; i++) {
+        ui32Config = psAdc->psChannel[i].ui32Config & ~(ADC_CTL_IE | ADC_CTL_END);
+        if (i == psAdc->ui32ChannelNum - 1) ui32Config |= ADC_CTL_IE | ADC_CTL_END;
+        ADCSequenceStepConfigure(psAdc->ui32BaseAdc, psAdc->ui32SequenceNum, i, ui32Config);
+    }
     ADCSequenceEnable(psAdc->ui32BaseAdc, psAdc->ui32SequenceNum);
     ADCIntClear(psAdc->ui32BaseAdc, psAdc->ui32SequenceNum);
 }
 
 
 
-// Trigger an ADC conversion and return the result.
-uint32_t AdcConvert(tADC *psAdc)
+// Trigger the conversion of all channels of an ADC sample sequence. The
+// results are stored in pui32Values in the order of the channels. Returns the
+// number of values.
+uint32_t AdcConvert(tADC *psAdc, uint32_t *pui32Values)
 {
-    uint32_t ui32ADCValue;
-
     // Trigger the ADC conversion.
     ADCProcessorTrigger(psAdc->ui32BaseAdc, psAdc->ui32SequenceNum);
 
@@ -70,9 +97,170 @@ uint32_t AdcConvert(tADC *psAdc)
     // Clear the ADC interrupt flag.
     ADCIntClear(psAdc->ui32BaseAdc, psAdc->ui32SequenceNum);
 
-    // Read the ADC value.
-    ADCSequenceDataGet(psAdc->ui32BaseAdc, psAdc->ui32SequenceNum, &ui32ADCValue);
+    // Read the ADC values.
+    return ADCSequenceDataGet(psAdc->ui32BaseAdc, psAdc->ui32SequenceNum, pui32Values);
+}
+
+
+
+// Set up an ADC stream. The channels must be initialized with AdcInit before.
+// The interrupt handler must call AdcStreamIntHandler for this stream. Returns
+// 0 on success, -1 on error.
+int AdcStreamInit(tADCStream *psAdcStream, void (*pfnIntHandler)(void))
+{
+    uint32_t ui32Channel = UDMA_CHANNEL_NUM(psAdcStream->ui32UdmaChannel);
+
+    if (!psAdcStream->ui32UdmaChannel) return -1;
+    psAdcStream->ui32ChannelNum = 0;
+    for (uint32_t i = 0; i < psAdcStream->ui32AdcNum; i++) {
+        psAdcStream->ui32ChannelNum += psAdcStream->ppsAdc[i]->ui32ChannelNum;
+    }
+    if (psAdcStream->ui32ChannelNum < 1 || psAdcStream->ui32ChannelNum > ADC_SEQ_STEPS_MAX) return -1;
+    if (psAdcStream->ui32BufLength % psAdcStream->ui32ChannelNum) return -1;
+    if (psAdcStream->ui32BufLength > UDMA_XFER_SIZE_MAX) return -1;
 
-    return ui32ADCValue;
+    // Set up the trigger timer.
+    SysCtlPeripheralEnable(psAdcStream->ui32PeripheralTimer);
+    while(!SysCtlPeripheralReady(psAdcStream->ui32PeripheralTimer));
+    TimerDisable(psAdcStream->ui32BaseTimer, TIMER_A);
+
+    // Set up the uDMA channel.
+    UdmaInit();
+    uDMAChannelAssign(psAdcStream->ui32UdmaChannel);
+    uDMAChannelAttributeDisable(ui32Channel, UDMA_ATTR_ALL);
+    uDMAChannelAttributeEnable(ui32Channel, UDMA_ATTR_HIGH_PRIORITY);
+
+    psAdcStream->bRunning = false;
+    psAdcStream->ui32BlockCnt = 0;
+    psAdcStream->ui32OverrunCnt = 0;
+
+    // Register the interrupt function. Only the uDMA completion interrupt of
+    // the sequence is enabled when the stream is started.
+    ADCIntDisableEx(psAdcStream->ui32BaseAdc, ADC_INT_DMA_SS0 << psAdcStream->ui32SequenceNum);
+    ADCIntRegister(psAdcStream->ui32BaseAdc, psAdcStream->ui32SequenceNum, pfnIntHandler);
+
+    return 0;
 }
 
+
+
+// Start an ADC stream. The rate is the number of samples per second and
+// channel. Returns 0 on success, -1 if the rate is out of range.
+int AdcStreamStart(tADCStream *psAdcStream, uint32_t ui32SysClock, uint32_t ui32Rate)
+{
+    uint32_t ui32Base = psAdcStream->ui32BaseAdc;
+    uint32_t ui32Seq = psAdcStream->ui32SequenceNum;
+    uint32_t ui32Channel = UDMA_CHANNEL_NUM(psAdcStream->ui32UdmaChannel);
+    uint32_t ui32Config, ui32Step = 0;
+    tADC *psAdc;
+
+    if (ui32Rate < 1 || ui32Rate > ADC_STREAM_SAMPLE_RATE_MAX / psAdcStream->ui32ChannelNum) return -1;
+    if (psAdcStream->bRunning) AdcStreamStop(psAdcStream);
+
+    // Sample all channels with one sequence. As the uDMA arbitration size is
+    // one, each step must request a transfer.
+    ADCSequenceDisable(ui32Base, ui32Seq);
+    ADCSequenceConfigure(ui32Base, ui32Seq, ADC_TRIGGER_TIMER, 0);
+    for (uint32_t i = 0; i < psAdcStream->ui32AdcNum; i++) {
+        psAdc = psAdcStream->ppsAdc[i];
+        for (uint32_t j = 0; j < psAdc->ui32ChannelNum; j++, ui32Step++) {
+            ui32Config = psAdc->psChannel[j].ui32Config & ~(ADC_CTL_IE | ADC_CTL_END);
+            if (ui32Step == psAdcStream->ui32ChannelNum - 1) ui32Config |= ADC_CTL_END;
+            ADCSequenceStepConfigure(ui32Base, ui32Seq, ui32Step, ui32Config | ADC_CTL_IE);
+        }
+    }
+    ADCSequenceOverflowClear(ui32Base, ui32Seq);
+    ADCSequenceUnderflowClear(ui32Base, ui32Seq);
+    ADCSequenceDMAEnable(ui32Base, ui32Seq);
+    ADCSequenceEnable(ui32Base, ui32Seq);
+
+    // Fill the primary buffer first, then the alternate buffer.
+    psAdcStream->ui32BlockCnt = 0;
+    psAdcStream->ui32OverrunCnt = 0;
+    for (int i = 0; i < 2; i++) {
+        ui32Config = i ? UDMA_ALT_SELECT : UDMA_PRI_SELECT;
+        uDMAChannelControlSet(ui32Channel | ui32Config, UDMA_SIZE_16 | UDMA_SRC_INC_NONE | UDMA_DST_INC_16 | UDMA_ARB_1);
+        uDMAChannelTransferSet(ui32Channel | ui32Config, UDMA_MODE_PINGPONG, AdcStreamFifo(psAdcStream),
+                               psAdcStream->pui16Buf[i], psAdcStream->ui32BufLength);
+    }
+    uDMAChannelEnable(ui32Channel);
+    ADCIntClearEx(ui32Base, ADC_INT_DMA_SS0 << ui32Seq);
+    ADCIntEnableEx(ui32Base, ADC_INT_DMA_SS0 << ui32Seq);
+
+    // Start the trigger timer.
+    TimerConfigure(psAdcStream->ui32BaseTimer, TIMER_CFG_PERIODIC);
+    TimerLoadSet(psAdcStream->ui32BaseTimer, TIMER_A, ui32SysClock / ui32Rate - 1);
+    TimerControlTrigger(psAdcStream->ui32BaseTimer, TIMER_A, true);
+    psAdcStream->bRunning = true;
+    TimerEnable(psAdcStream->ui32BaseTimer, TIMER_A);
+
+    return 0;
+}
+
+
+
+// Stop an ADC stream.
+void AdcStreamStop(tADCStream *psAdcStream)
+{
+    TimerDisable(psAdcStream->ui32BaseTimer, TIMER_A);
+    TimerControlTrigger(psAdcStream->ui32BaseTimer, TIMER_A, false);
+    uDMAChannelDisable(UDMA_CHANNEL_NUM(psAdcStream->ui32UdmaChannel));
+    ADCIntDisableEx(psAdcStream->ui32BaseAdc, ADC_INT_DMA_SS0 << psAdcStream->ui32SequenceNum);
+    ADCSequenceDisable(psAdcStream->ui32BaseAdc, psAdcStream->ui32SequenceNum);
+    ADCSequenceDMADisable(psAdcStream->ui32BaseAdc, psAdcStream->ui32SequenceNum);
+    psAdcStream->bRunning = false;
+}
+
+
+
+// Interrupt handler of an ADC stream. It is called when the uDMA has filled a
+// buffer, which is then set up to be filled again after the other one.
+void AdcStreamIntHandler(tADCStream *psAdcStream)
+{
+    uint32_t ui32Channel = UDMA_CHANNEL_NUM(psAdcStream->ui32UdmaChannel);
+    uint32_t ui32Select;
+
+    ADCIntClearEx(psAdcStream->ui32BaseAdc, ADC_INT_DMA_SS0 << psAdcStream->ui32SequenceNum);
+
+    if (!psAdcStream->bRunning) return;
+
+    // The buffers are filled alternately, starting with the primary one.
+    for (int i = 0; i < 2; i++) {
+        ui32Select = (psAdcStream->ui32BlockCnt & 1) ? UDMA_ALT_SELECT : UDMA_PRI_SELECT;
+        if (uDMAChannelModeGet(ui32Channel | ui32Select) != UDMA_MODE_STOP) break;
+        uDMAChannelTransferSet(ui32Channel | ui32Select, UDMA_MODE_PINGPONG, AdcStreamFifo(psAdcStream),
+                               psAdcStream->pui16Buf[psAdcStream->ui32BlockCnt & 1], psAdcStream->ui32BufLength);
+        psAdcStream->ui32BlockCnt++;
+    }
+
+    // Both buffers were full, so samples were lost and the channel order in the
+    // FIFO is no longer known. Stop the stream.
+    if (!uDMAChannelIsEnabled(ui32Channel) || ADCSequenceOverflow(psAdcStream->ui32BaseAdc, psAdcStream->ui32SequenceNum)) {
+        psAdcStream->ui32OverrunCnt++;
+        AdcStreamStop(psAdcStream);
+    }
+}
+
+
+
+// Copy a filled buffer of an ADC stream. The block number counts the filled
+// buffers starting from 0. As the buffer of a block is filled again after the
+// next block, the copy is only valid if no further block was completed
+// meanwhile. Returns 0 on success, -1 if the block is not available.
+int AdcStreamBlockCopy(tADCStream *psAdcStream, uint32_t ui32Block, uint16_t *pui16Data)
+{
+    if (psAdcStream->ui32BlockCnt - ui32Block != 1) return -1;
+    memcpy(pui16Data, psAdcStream->pui16Buf[ui32Block & 1], psAdcStream->ui32BufLength * sizeof(uint16_t));
+    if (psAdcStream->ui32BlockCnt - ui32Block != 1) return -1;
+
+    return 0;
+}
+
+
+
+// Get the address of the FIFO of the sample sequence used by an ADC stream.
+static void *AdcStreamFifo(tADCStream *psAdcStream)
+{
+    return (void *) (psAdcStream->ui32BaseAdc + ADC_O_SSFIFO0 +
+                     (ADC_O_SSFIFO1 - ADC_O_SSFIFO0) * psAdcStream->ui32SequenceNum);
+}
@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 13 Feb 2020
-// Rev.: 06 Apr 2020
+// Rev.: 17 Oct 2026
 //
 // Header file for the ADC functions on the TI Tiva TM4C1294 Connected
 // LaunchPad Evaluation Kit.
@@ -15,23 +15,57 @@
 
 
 
+// Maximum number of steps of a sample sequence (sample sequencer 0).
+#define ADC_SEQ_STEPS_MAX           8
+// Maximum aggregate sample rate of an ADC stream in samples per second.
+#define ADC_STREAM_SAMPLE_RATE_MAX  1000000
+
+
+
 // Types.
 typedef struct {
-    uint32_t ui32PeripheralAdc;
     uint32_t ui32PeripheralGpio;
     uint32_t ui32PortGpioBase;
     uint8_t  ui8PinGpio;
+    uint32_t ui32Config;            // ADC_CTL_CHn, IE and END are set by the driver.
+} tADCChannel;
+
+// Sample sequence. Each channel is sampled by one step of the sequence.
+typedef struct {
+    uint32_t ui32PeripheralAdc;
     uint32_t ui32BaseAdc;
-    uint32_t ui32SequenceNum;
-    uint32_t ui32Step;
-    uint32_t ui32Config;
+    uint32_t ui32SequenceNum;       // Must have a step for each channel.
+    const tADCChannel *psChannel;
+    uint32_t ui32ChannelNum;
 } tADC;
 
+typedef struct {
+    uint32_t ui32BaseAdc;
+    uint32_t ui32SequenceNum;       // Must have a step for each channel.
+    uint32_t ui32UdmaChannel;       // uDMA channel assignment (UDMA_CHn_ADCx_y)
+    uint32_t ui32PeripheralTimer;
+    uint32_t ui32BaseTimer;         // Timer A triggers the sample sequence.
+    tADC     **ppsAdc;              // Sequences, initialized with AdcInit.
+    uint32_t ui32AdcNum;
+    uint16_t *pui16Buf[2];          // Ping-pong buffers.
+    uint32_t ui32BufLength;         // Multiple of the channel number, max. UDMA_XFER_SIZE_MAX.
+    // State of the stream. Managed by the driver.
+    uint32_t ui32ChannelNum;        // Channels of all sequences.
+    volatile bool bRunning;
+    volatile uint32_t ui32BlockCnt; // Number of filled buffers.
+    volatile uint32_t ui32OverrunCnt;
+} tADCStream;
+
 
 // Function prototypes.
 void AdcReset(tADC *psAdc);
 void AdcInit(tADC *psAdc);
-uint32_t AdcConvert(tADC *psAdc);
+uint32_t AdcConvert(tADC *psAdc, uint32_t *pui32Values);
+int AdcStreamInit(tADCStream *psAdcStream, void (*pfnIntHandler)(void));
+int AdcStreamStart(tADCStream *psAdcStream, uint32_t ui32SysClock, uint32_t ui32Rate);
+void AdcStreamStop(tADCStream *psAdcStream);
+void AdcStreamIntHandler(tADCStream *psAdcStream);
+int AdcStreamBlockCopy(tADCStream *psAdcStream, uint32_t ui32Block, uint16_t *pui16Data);
 
 
 
@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 10 Feb 2020
-// Rev.: 29 May 2020
+// Rev.: 17 Oct 2026
 //
 // GPIO functions for the TI Tiva TM4C1294 Connected LaunchPad Evaluation Kit.
 //
@@ -10,7 +10,9 @@
 
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
+#include "inc/hw_memmap.h"
 #include "driverlib/gpio.h"
 #include "driverlib/sysctl.h"
 #include "gpio.h"
@@ -48,9 +50,17 @@ void GpioInitIntr(tGPIO *psGpio, void (*pfnIntHandler)(void))
     // Initialize the GPIO input.
     GpioInit(psGpio);
 
-    // Register and enable interrupt function.
+    // Register and enable interrupt function. The pins 1..7 of the ports P
+    // and Q have their own interrupts.
     GPIOIntTypeSet(psGpio->ui32Port, psGpio->ui8Pins, psGpio->ui32IntType);
-    GPIOIntRegister(psGpio->ui32Port, pfnIntHandler);
+    if ((psGpio->ui32Port == GPIO_PORTP_BASE) || (psGpio->ui32Port == GPIO_PORTQ_BASE)) {
+        if (psGpio->ui8Pins & 0x01) GPIOIntRegister(psGpio->ui32Port, pfnIntHandler);
+        for (uint32_t i = 1; i < 8; i++) {
+            if (psGpio->ui8Pins & (1 << i)) GPIOIntRegisterPin(psGpio->ui32Port, i, pfnIntHandler);
+        }
+    } else {
+        GPIOIntRegister(psGpio->ui32Port, pfnIntHandler);
+    }
     GPIOIntEnable(psGpio->ui32Port, psGpio->ui8Pins);
 }
 
@@ -118,3 +128,73 @@ bool GpioOutputGetBool(tGPIO *psGpio)
     }
 }
 
+
+
+// Initialize a table of GPIO ports. The interrupt handler of a port is
+// registered and enabled, if given.
+void GpioPortInit(tGpioPort *psGpioPort, uint32_t ui32PortNum)
+{
+    for (uint32_t i = 0; i < ui32PortNum; i++) {
+        if (psGpioPort[i].pfnIntHandler) GpioInitIntr(&psGpioPort[i].sGpio, psGpioPort[i].pfnIntHandler);
+        else GpioInit(&psGpioPort[i].sGpio);
+    }
+}
+
+
+
+// Find the entry of a GPIO port in a table of GPIO ports by its base address.
+// Returns NULL if the port is not in the table.
+tGpioPort *GpioPortFind(tGpioPort *psGpioPort, uint32_t ui32PortNum, uint32_t ui32Port)
+{
+    for (uint32_t i = 0; i < ui32PortNum; i++) {
+        if (psGpioPort[i].sGpio.ui32Port == ui32Port) return &psGpioPort[i];
+    }
+
+    return NULL;
+}
+
+
+
+// Read the logical value of a table of GPIO ports. Each port is read once.
+uint32_t GpioPortRead(tGpioPort *psGpioPort, uint32_t ui32PortNum)
+{
+    uint32_t ui32Val = 0;
+    uint32_t ui32Pins;
+    uint32_t ui32Pin;
+
+    for (uint32_t i = 0; i < ui32PortNum; i++) {
+        ui32Pins = (GPIOPinRead(psGpioPort[i].sGpio.ui32Port, psGpioPort[i].sGpio.ui8Pins) ^ psGpioPort[i].ui8ActiveLow) &
+                   psGpioPort[i].sGpio.ui8Pins;
+        // Map the active pins to their logical bits.
+        while (ui32Pins) {
+            ui32Pin = __builtin_ctz(ui32Pins);
+            ui32Pins &= ui32Pins - 1;
+            ui32Val |= 1 << psGpioPort[i].pui8Index[ui32Pin];
+        }
+    }
+
+    return ui32Val;
+}
+
+
+
+// Write a logical value to the outputs of a table of GPIO ports. Each port is
+// written once.
+void GpioPortWrite(tGpioPort *psGpioPort, uint32_t ui32PortNum, uint32_t ui32Val)
+{
+    uint32_t ui32Pins;
+    uint32_t ui32Pin;
+    uint8_t ui8PortVal;
+
+    for (uint32_t i = 0; i < ui32PortNum; i++) {
+        if (psGpioPort[i].sGpio.bInput) continue;
+        ui32Pins = psGpioPort[i].sGpio.ui8Pins;
+        ui8PortVal = 0;
+        while (ui32Pins) {
+            ui32Pin = __builtin_ctz(ui32Pins);
+            ui32Pins &= ui32Pins - 1;
+            if (ui32Val & (1 << psGpioPort[i].pui8Index[ui32Pin])) ui8PortVal |= 1 << ui32Pin;
+        }
+        GPIOPinWrite(psGpioPort[i].sGpio.ui32Port, psGpioPort[i].sGpio.ui8Pins, ui8PortVal ^ psGpioPort[i].ui8ActiveLow);
+    }
+}
@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 10 Feb 2020
-// Rev.: 24 Apr 2020
+// Rev.: 17 Oct 2026
 //
 // Header file for the GPIO functions for the TI Tiva TM4C1294 Connected
 // LaunchPad Evaluation Kit.
@@ -26,6 +26,16 @@ typedef struct {
     uint32_t ui32IntType;
 } tGPIO;
 
+// Pins of one GPIO port in a table of GPIO ports. The pins are mapped to bits
+// of a logical value, which may span several ports. A logical bit is 1 if the
+// pin is active.
+typedef struct {
+    tGPIO    sGpio;                 // Port, pins and their configuration.
+    uint8_t  ui8ActiveLow;          // Pins which are active low.
+    uint8_t  pui8Index[8];          // Logical bit of each pin.
+    void     (*pfnIntHandler)(void);    // Interrupt handler of the port or NULL.
+} tGpioPort;
+
 
 
 // Function prototypes.
@@ -37,6 +47,10 @@ void GpioOutputSet(tGPIO *psGpio, uint8_t ui8Val);
 void GpioOutputSetBool(tGPIO *psGpio, bool bVal);
 int32_t GpioOutputGet(tGPIO *psGpio);
 bool GpioOutputGetBool(tGPIO *psGpio);
+void GpioPortInit(tGpioPort *psGpioPort, uint32_t ui32PortNum);
+tGpioPort *GpioPortFind(tGpioPort *psGpioPort, uint32_t ui32PortNum, uint32_t ui32Port);
+uint32_t GpioPortRead(tGpioPort *psGpioPort, uint32_t ui32PortNum);
+void GpioPortWrite(tGpioPort *psGpioPort, uint32_t ui32PortNum, uint32_t ui32Val);
 
 
 
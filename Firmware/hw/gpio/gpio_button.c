@@ -2,11 +2,20 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 10 Feb 2020
-// Rev.: 24 Apr 2020
+// Rev.: 17 Oct 2026
 //
 // GPIO button functions for the TI Tiva TM4C1294 Connected LaunchPad
 // Evaluation Kit.
 //
+// The buttons are described by a table of GPIO ports. Each port has its own
+// interrupt handler, which processes all pins of the port with an edge at
+// once. It only restarts the debounce time of these buttons. The button
+// status is sampled by GpioButtonTick, which is called from a periodic
+// interrupt, once the input has been stable for the debounce time. Each
+// change of the button status is put as a timestamped event into a ring
+// buffer, which is read by the main loop. The GPIO and the tick interrupts
+// must have the same priority, so they do not preempt each other.
+//
 
 
 
@@ -15,189 +24,247 @@
 #include "inc/hw_memmap.h"
 #include "driverlib/gpio.h"
 #include "driverlib/sysctl.h"
-#include "utils/uartstdio.h"
 #include "gpio.h"
+#include "timebase.h"
 #include "gpio_button.h"
 
 
 
-// Global variables holding the button status.
-uint8_t g_ui8GpioButtonStatus[GPIO_BUTTON_NUM];
-uint32_t g_ui32GpioButtonPressedCnt[GPIO_BUTTON_NUM];
-uint32_t g_ui32GpioButtonReleasedCnt[GPIO_BUTTON_NUM];
+// Function prototypes of local functions.
+static void GpioButtonPortIntHandler(const tGpioPort *psGpioPort);
+static void GpioButtonPortJIntHandler(void);
+static void GpioButtonPortHIntHandler(void);
+static void GpioButtonPortKIntHandler(void);
+static void GpioButtonEventPut(uint8_t ui8Button, uint8_t ui8Status, uint64_t ui64Ticks);
 
 
 
-// GPIO definitions.
-// USR_SW1: PJ0
-tGPIO g_sGpioUsrSw1 = {
-    SYSCTL_PERIPH_GPIOJ,
-    GPIO_PORTJ_BASE,
-    GPIO_PIN_0,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD_WPU,  // ui32PinType
-    true,                   // bInput: false = output, true = input
-    GPIO_BOTH_EDGES         // ui32IntType
-};
-// USR_SW2: PJ1
-tGPIO g_sGpioUsrSw2 = {
-    SYSCTL_PERIPH_GPIOJ,
-    GPIO_PORTJ_BASE,
-    GPIO_PIN_1,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD_WPU,  // ui32PinType
-    true,                   // bInput: false = output, true = input
-    GPIO_BOTH_EDGES         // ui32IntType
-};
-// Educational BoosterPack MK II S1: PH1
-tGPIO g_sGpioEduBoosterS1 = {
-    SYSCTL_PERIPH_GPIOH,
-    GPIO_PORTH_BASE,
-    GPIO_PIN_1,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD_WPU,  // ui32PinType
-    true,                   // bInput: false = output, true = input
-    GPIO_BOTH_EDGES         // ui32IntType
+// GPIO definitions. All buttons are active low.
+static tGpioPort g_psGpioButtonPort[] = {
+    // USR_SW1: PJ0, USR_SW2: PJ1
+    {
+        {
+            SYSCTL_PERIPH_GPIOJ,
+            GPIO_PORTJ_BASE,
+            GPIO_PIN_0 | GPIO_PIN_1,    // ui8Pins
+            GPIO_STRENGTH_2MA,          // ui32Strength
+            GPIO_PIN_TYPE_STD_WPU,      // ui32PinType
+            true,                       // bInput: false = output, true = input
+            GPIO_BOTH_EDGES             // ui32IntType
+        },
+        GPIO_PIN_0 | GPIO_PIN_1,        // ui8ActiveLow
+        {[0] = GPIO_BUTTON_USR_SW1, [1] = GPIO_BUTTON_USR_SW2},     // pui8Index
+        GpioButtonPortJIntHandler       // pfnIntHandler
+    },
+    // Educational BoosterPack MK II S1: PH1
+    {
+        {
+            SYSCTL_PERIPH_GPIOH,
+            GPIO_PORTH_BASE,
+            GPIO_PIN_1,                 // ui8Pins
+            GPIO_STRENGTH_2MA,          // ui32Strength
+            GPIO_PIN_TYPE_STD_WPU,      // ui32PinType
+            true,                       // bInput: false = output, true = input
+            GPIO_BOTH_EDGES             // ui32IntType
+        },
+        GPIO_PIN_1,                     // ui8ActiveLow
+        {[1] = GPIO_BUTTON_EDU_S1},     // pui8Index
+        GpioButtonPortHIntHandler       // pfnIntHandler
+    },
+    // Educational BoosterPack MK II S2: PK6
+    {
+        {
+            SYSCTL_PERIPH_GPIOK,
+            GPIO_PORTK_BASE,
+            GPIO_PIN_6,                 // ui8Pins
+            GPIO_STRENGTH_2MA,          // ui32Strength
+            GPIO_PIN_TYPE_STD_WPU,      // ui32PinType
+            true,                       // bInput: false = output, true = input
+            GPIO_BOTH_EDGES             // ui32IntType
+        },
+        GPIO_PIN_6,                     // ui8ActiveLow
+        {[6] = GPIO_BUTTON_EDU_S2},     // pui8Index
+        GpioButtonPortKIntHandler       // pfnIntHandler
+    },
 };
-// Educational BoosterPack MK II S2: PK6
-tGPIO g_sGpioEduBoosterS2 = {
-    SYSCTL_PERIPH_GPIOK,
-    GPIO_PORTK_BASE,
-    GPIO_PIN_6,             // ui8Pins
-    GPIO_STRENGTH_2MA,      // ui32Strength
-    GPIO_PIN_TYPE_STD_WPU,  // ui32PinType
-    true,                   // bInput: false = output, true = input
-    GPIO_BOTH_EDGES         // ui32IntType
+#define GPIO_BUTTON_PORT_NUM    (sizeof(g_psGpioButtonPort) / sizeof(g_psGpioButtonPort[0]))
+
+
+
+// Global variables.
+tGpioButton g_psGpioButton[GPIO_BUTTON_NUM];
+uint32_t g_ui32GpioButtonEventDropCnt;
+const char *g_ppcGpioButtonName[GPIO_BUTTON_NUM] = {
+    "USR_SW1",
+    "USR_SW2",
+    "Educational BoosterPack MK II S1",
+    "Educational BoosterPack MK II S2",
 };
 
+// Debounce state. Managed by the interrupt handlers.
+static uint16_t g_ui16GpioButtonDebounceTicks;
+static uint32_t g_ui32GpioButtonDebounce;   // Buttons in the debounce time.
+
+// Event ring buffer with a single producer (tick interrupt) and a single
+// consumer (main loop). The indices run freely and are masked on access.
+static tGpioButtonEvent g_psGpioButtonEventBuf[GPIO_BUTTON_EVENT_BUF_SIZE];
+static volatile uint32_t g_ui32GpioButtonEventHead;     // Written by the producer.
+static volatile uint32_t g_ui32GpioButtonEventTail;     // Written by the consumer.
+
 
 
-// Initialize the GPIO buttons.
-void GpioButtonInit(void)
+// Initialize the GPIO buttons. GpioButtonTick must be called at ui32TickRate
+// for debouncing the buttons.
+void GpioButtonInit(uint32_t ui32TickRate)
 {
-    // USR_SW1: PJ0
-    GpioInitIntr(&g_sGpioUsrSw1, GpioButtonIntHandler);
-    g_ui8GpioButtonStatus[GPIO_BUTTON_USR_SW1] = GPIO_BUTTON_RELEASED;
-    g_ui32GpioButtonPressedCnt[GPIO_BUTTON_USR_SW1] = 0;
-    g_ui32GpioButtonReleasedCnt[GPIO_BUTTON_USR_SW1] = 0;
-    // USR_SW2: PJ1
-    GpioInitIntr(&g_sGpioUsrSw2, GpioButtonIntHandler);
-    g_ui8GpioButtonStatus[GPIO_BUTTON_USR_SW2] = GPIO_BUTTON_RELEASED;
-    g_ui32GpioButtonPressedCnt[GPIO_BUTTON_USR_SW2] = 0;
-    g_ui32GpioButtonReleasedCnt[GPIO_BUTTON_USR_SW2] = 0;
-    // Educational BoosterPack MK II S1: PH1
-    GpioInitIntr(&g_sGpioEduBoosterS1, GpioButtonIntHandler);
-    g_ui8GpioButtonStatus[GPIO_BUTTON_EDU_S1] = GPIO_BUTTON_RELEASED;
-    g_ui32GpioButtonPressedCnt[GPIO_BUTTON_EDU_S1] = 0;
-    g_ui32GpioButtonReleasedCnt[GPIO_BUTTON_EDU_S1] = 0;
-    // Educational BoosterPack MK II S2: PK6
-    GpioInitIntr(&g_sGpioEduBoosterS2, GpioButtonIntHandler);
-    g_ui8GpioButtonStatus[GPIO_BUTTON_EDU_S2] = GPIO_BUTTON_RELEASED;
-    g_ui32GpioButtonPressedCnt[GPIO_BUTTON_EDU_S2] = 0;
-    g_ui32GpioButtonReleasedCnt[GPIO_BUTTON_EDU_S2] = 0;
+    uint32_t ui32Pins;
+    uint32_t ui32Pin;
+    uint32_t ui32Pressed;
+    tGpioButton *psButton;
+
+    g_ui16GpioButtonDebounceTicks = (GPIO_BUTTON_DEBOUNCE_MS * ui32TickRate + 999) / 1000;
+    g_ui32GpioButtonDebounce = 0;
+    g_ui32GpioButtonEventHead = 0;
+    g_ui32GpioButtonEventTail = 0;
+    g_ui32GpioButtonEventDropCnt = 0;
+    // Link the buttons to their port and pin.
+    for (uint32_t i = 0; i < GPIO_BUTTON_PORT_NUM; i++) {
+        ui32Pins = g_psGpioButtonPort[i].sGpio.ui8Pins;
+        while (ui32Pins) {
+            ui32Pin = __builtin_ctz(ui32Pins);
+            ui32Pins &= ui32Pins - 1;
+            psButton = &g_psGpioButton[g_psGpioButtonPort[i].pui8Index[ui32Pin]];
+            psButton->psGpioPort = &g_psGpioButtonPort[i];
+            psButton->ui8Pin = 1 << ui32Pin;
+        }
+    }
+    GpioPortInit(g_psGpioButtonPort, GPIO_BUTTON_PORT_NUM);
+    ui32Pressed = GpioButtonGet();
+    for (uint32_t i = 0; i < GPIO_BUTTON_NUM; i++) {
+        g_psGpioButton[i].ui32PressedCnt = 0;
+        g_psGpioButton[i].ui32ReleasedCnt = 0;
+        g_psGpioButton[i].ui16Debounce = 0;
+        g_psGpioButton[i].ui8Status = (ui32Pressed >> i) & 0x1 ? GPIO_BUTTON_PRESSED : GPIO_BUTTON_RELEASED;
+    }
 }
 
 
 
-// Get the GPIO button status.
+// Get the GPIO button status. Bit i is set if button i is pressed.
 uint32_t GpioButtonGet(void)
 {
-    uint32_t ui32Val = 0;
+    return GpioPortRead(g_psGpioButtonPort, GPIO_BUTTON_PORT_NUM);
+}
 
-    ui32Val |= (GpioInputGetBool(&g_sGpioUsrSw1) & 0x1) << 0;
-    ui32Val |= (GpioInputGetBool(&g_sGpioUsrSw2) & 0x1) << 1;
-    ui32Val |= (GpioInputGetBool(&g_sGpioEduBoosterS1) & 0x1) << 2;
-    ui32Val |= (GpioInputGetBool(&g_sGpioEduBoosterS2) & 0x1) << 3;
 
-    // Invert the value, as it is active low.
-    ui32Val = ~ui32Val & 0x0f;
 
-    return ui32Val;
+// Get the next button event from the ring buffer. Returns false if there is
+// no event. Must only be called from the main loop.
+bool GpioButtonEventGet(tGpioButtonEvent *psEvent)
+{
+    uint32_t ui32Tail = g_ui32GpioButtonEventTail;
+
+    if (ui32Tail == g_ui32GpioButtonEventHead) return false;
+    *psEvent = g_psGpioButtonEventBuf[ui32Tail & (GPIO_BUTTON_EVENT_BUF_SIZE - 1)];
+    // Release the slot only after it has been read.
+    __sync_synchronize();
+    g_ui32GpioButtonEventTail = ui32Tail + 1;
+
+    return true;
 }
 
 
 
-// Interrupt handler for buttons.
-void GpioButtonIntHandler(void)
+// Sample the buttons whose input has been stable for the debounce time and
+// create an event if their status has changed. Only the buttons in their
+// debounce time are visited. Must be called periodically from an interrupt
+// handler at the tick rate given to GpioButtonInit.
+void GpioButtonTick(void)
 {
-    uint32_t intStatusPortUsrSw1 = 0;
-    uint32_t intStatusPortUsrSw2 = 0;
-    uint32_t intStatusPortEduBoosterS1 = 0;
-    uint32_t intStatusPortEduBoosterS2 = 0;
-
-    intStatusPortUsrSw1 = GPIOIntStatus(g_sGpioUsrSw1.ui32Port, true);
-    GPIOIntClear(g_sGpioUsrSw1.ui32Port, intStatusPortUsrSw1);
-//    intStatusPortUsrSw2 = GPIOIntStatus(g_sGpioUsrSw2.ui32Port, true);
-//    GPIOIntClear(g_sGpioUsrSw2.ui32Port, intStatusPortUsrSw2);
-    intStatusPortUsrSw2 = intStatusPortUsrSw1;  // Both buttons are on port J.
-    intStatusPortEduBoosterS1 = GPIOIntStatus(g_sGpioEduBoosterS1.ui32Port, true);
-    GPIOIntClear(g_sGpioEduBoosterS1.ui32Port, intStatusPortEduBoosterS1);
-    intStatusPortEduBoosterS2 = GPIOIntStatus(g_sGpioEduBoosterS2.ui32Port, true);
-    GPIOIntClear(g_sGpioEduBoosterS2.ui32Port, intStatusPortEduBoosterS2);
-
-    // USR_SW1: PJ0
-    if ((intStatusPortUsrSw1 & g_sGpioUsrSw1.ui8Pins) == g_sGpioUsrSw1.ui8Pins) {
-        if (GpioInputGetBool(&g_sGpioUsrSw1)) {
-            g_ui8GpioButtonStatus[GPIO_BUTTON_USR_SW1] = GPIO_BUTTON_RELEASED;
-            g_ui32GpioButtonReleasedCnt[GPIO_BUTTON_USR_SW1]++;
-            #ifdef GPIO_BUTTON_MESSAGE_USR_SW1
-            UARTprintf("USR_SW1 released.\n");
-            #endif
-        } else {
-            g_ui8GpioButtonStatus[GPIO_BUTTON_USR_SW1] = GPIO_BUTTON_PRESSED;
-            g_ui32GpioButtonPressedCnt[GPIO_BUTTON_USR_SW1]++;
-            #ifdef GPIO_BUTTON_MESSAGE_USR_SW1
-            UARTprintf("USR_SW1 pressed.\n");
-            #endif
-        }
-    }
-    // USR_SW2: PJ1
-    if ((intStatusPortUsrSw2 & g_sGpioUsrSw2.ui8Pins) == g_sGpioUsrSw2.ui8Pins) {
-        if (GpioInputGetBool(&g_sGpioUsrSw2)) {
-            g_ui8GpioButtonStatus[GPIO_BUTTON_USR_SW2] = GPIO_BUTTON_RELEASED;
-            g_ui32GpioButtonReleasedCnt[GPIO_BUTTON_USR_SW2]++;
-            #ifdef GPIO_BUTTON_MESSAGE_USR_SW2
-            UARTprintf("USR_SW2 released.\n");
-            #endif
-        } else {
-            g_ui8GpioButtonStatus[GPIO_BUTTON_USR_SW2] = GPIO_BUTTON_PRESSED;
-            g_ui32GpioButtonPressedCnt[GPIO_BUTTON_USR_SW2]++;
-            #ifdef GPIO_BUTTON_MESSAGE_USR_SW2
-            UARTprintf("USR_SW2 pressed.\n");
-            #endif
-        }
-    }
-    // Educational BoosterPack MK II S1: PH1
-    if ((intStatusPortEduBoosterS1 & g_sGpioEduBoosterS1.ui8Pins) == g_sGpioEduBoosterS1.ui8Pins) {
-        if (GpioInputGetBool(&g_sGpioEduBoosterS1)) {
-            g_ui8GpioButtonStatus[GPIO_BUTTON_EDU_S1] = GPIO_BUTTON_RELEASED;
-            g_ui32GpioButtonReleasedCnt[GPIO_BUTTON_EDU_S1]++;
-            #ifdef GPIO_BUTTON_MESSAGE_EDU_S1
-            UARTprintf("Educational BoosterPack MK II S1 released.\n");
-            #endif
-        } else {
-            g_ui8GpioButtonStatus[GPIO_BUTTON_EDU_S1] = GPIO_BUTTON_PRESSED;
-            g_ui32GpioButtonPressedCnt[GPIO_BUTTON_EDU_S1]++;
-            #ifdef GPIO_BUTTON_MESSAGE_EDU_S1
-            UARTprintf("Educational BoosterPack MK II S1 pressed.\n");
-            #endif
-        }
+    uint32_t ui32Buttons = g_ui32GpioButtonDebounce;
+    uint32_t ui32Index;
+    uint8_t ui8Status;
+    tGpioButton *psButton;
+
+    while (ui32Buttons) {
+        ui32Index = __builtin_ctz(ui32Buttons);
+        ui32Buttons &= ui32Buttons - 1;
+        psButton = &g_psGpioButton[ui32Index];
+        if (--psButton->ui16Debounce) continue;
+        g_ui32GpioButtonDebounce &= ~(1 << ui32Index);
+        ui8Status = (GPIOPinRead(psButton->psGpioPort->sGpio.ui32Port, psButton->ui8Pin) ^ psButton->psGpioPort->ui8ActiveLow) &
+                    psButton->ui8Pin ? GPIO_BUTTON_PRESSED : GPIO_BUTTON_RELEASED;
+        // Bounces only.
+        if (ui8Status == psButton->ui8Status) continue;
+        psButton->ui8Status = ui8Status;
+        if (ui8Status == GPIO_BUTTON_PRESSED) psButton->ui32PressedCnt++;
+        else psButton->ui32ReleasedCnt++;
+        GpioButtonEventPut(ui32Index, ui8Status, psButton->ui64Edge);
     }
-    // Educational BoosterPack MK II S2: PK6
-    if ((intStatusPortEduBoosterS2 & g_sGpioEduBoosterS2.ui8Pins) == g_sGpioEduBoosterS2.ui8Pins) {
-        if (GpioInputGetBool(&g_sGpioEduBoosterS2)) {
-            g_ui8GpioButtonStatus[GPIO_BUTTON_EDU_S2] = GPIO_BUTTON_RELEASED;
-            g_ui32GpioButtonReleasedCnt[GPIO_BUTTON_EDU_S2]++;
-            #ifdef GPIO_BUTTON_MESSAGE_EDU_S2
-            UARTprintf("Educational BoosterPack MK II S2 released.\n");
-            #endif
-        } else {
-            g_ui8GpioButtonStatus[GPIO_BUTTON_EDU_S2] = GPIO_BUTTON_PRESSED;
-            g_ui32GpioButtonPressedCnt[GPIO_BUTTON_EDU_S2]++;
-            #ifdef GPIO_BUTTON_MESSAGE_EDU_S2
-            UARTprintf("Educational BoosterPack MK II S2 pressed.\n");
-            #endif
-        }
+}
+
+
+
+// Interrupt handler of a GPIO port with buttons. An edge (re)starts the
+// debounce time of the button. The time of the first edge is kept as time of
+// the event.
+static void GpioButtonPortIntHandler(const tGpioPort *psGpioPort)
+{
+    uint32_t ui32Pins = GPIOIntStatus(psGpioPort->sGpio.ui32Port, true) & psGpioPort->sGpio.ui8Pins;
+    uint32_t ui32Pin;
+    uint32_t ui32Index;
+    uint64_t ui64Ticks;
+
+    GPIOIntClear(psGpioPort->sGpio.ui32Port, ui32Pins);
+    if (!ui32Pins) return;
+    ui64Ticks = TimebaseTicksGet();
+    while (ui32Pins) {
+        ui32Pin = __builtin_ctz(ui32Pins);
+        ui32Pins &= ui32Pins - 1;
+        ui32Index = psGpioPort->pui8Index[ui32Pin];
+        if (!(g_ui32GpioButtonDebounce & (1 << ui32Index))) g_psGpioButton[ui32Index].ui64Edge = ui64Ticks;
+        g_psGpioButton[ui32Index].ui16Debounce = g_ui16GpioButtonDebounceTicks;
+        g_ui32GpioButtonDebounce |= 1 << ui32Index;
     }
 }
 
+
+
+// Interrupt handlers of the GPIO ports with buttons. The port is looked up by
+// its base address, so the order of the port table does not matter.
+static void GpioButtonPortJIntHandler(void)
+{
+    GpioButtonPortIntHandler(GpioPortFind(g_psGpioButtonPort, GPIO_BUTTON_PORT_NUM, GPIO_PORTJ_BASE));
+}
+
+static void GpioButtonPortHIntHandler(void)
+{
+    GpioButtonPortIntHandler(GpioPortFind(g_psGpioButtonPort, GPIO_BUTTON_PORT_NUM, GPIO_PORTH_BASE));
+}
+
+static void GpioButtonPortKIntHandler(void)
+{
+    GpioButtonPortIntHandler(GpioPortFind(g_psGpioButtonPort, GPIO_BUTTON_PORT_NUM, GPIO_PORTK_BASE));
+}
+
+
+
+// Put a button event into the ring buffer. The event is dropped if the ring
+// buffer is full.
+static void GpioButtonEventPut(uint8_t ui8Button, uint8_t ui8Status, uint64_t ui64Ticks)
+{
+    uint32_t ui32Head = g_ui32GpioButtonEventHead;
+    tGpioButtonEvent *psEvent;
+
+    if (ui32Head - g_ui32GpioButtonEventTail >= GPIO_BUTTON_EVENT_BUF_SIZE) {
+        g_ui32GpioButtonEventDropCnt++;
+        return;
+    }
+    psEvent = &g_psGpioButtonEventBuf[ui32Head & (GPIO_BUTTON_EVENT_BUF_SIZE - 1)];
+    psEvent->ui64Ticks = ui64Ticks;
+    psEvent->ui8Button = ui8Button;
+    psEvent->ui8Status = ui8Status;
+    // Publish the event only after it has been written.
+    __sync_synchronize();
+    g_ui32GpioButtonEventHead = ui32Head + 1;
+}
@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 10 Feb 2020
-// Rev.: 24 Apr 2020
+// Rev.: 17 Oct 2026
 //
 // Header file for the GPIO button functions for the TI Tiva TM4C1294 Connected
 // LaunchPad Evaluation Kit.
@@ -15,33 +15,56 @@
 
 
 
+#include "gpio.h"
+
+
+
 // Button parameters.
 #define GPIO_BUTTON_USR_SW1     0
 #define GPIO_BUTTON_USR_SW2     1
 #define GPIO_BUTTON_EDU_S1      2
 #define GPIO_BUTTON_EDU_S2      3
-#define GPIO_BUTTON_NUM         4
+#define GPIO_BUTTON_NUM         4       // Max. 32.
 #define GPIO_BUTTON_RELEASED    0
 #define GPIO_BUTTON_PRESSED     1
-// Print message, when a button is pressed or released.
-//#define GPIO_BUTTON_MESSAGE_USR_SW1
-//#define GPIO_BUTTON_MESSAGE_USR_SW2
-//#define GPIO_BUTTON_MESSAGE_EDU_S1
-//#define GPIO_BUTTON_MESSAGE_EDU_S2
+#define GPIO_BUTTON_DEBOUNCE_MS 20
+#define GPIO_BUTTON_EVENT_BUF_SIZE  16      // Must be a power of 2.
+
+
+
+// Types.
+typedef struct {
+    uint64_t ui64Ticks;         // Timebase ticks of the first edge.
+    uint8_t  ui8Button;         // GPIO_BUTTON_*
+    uint8_t  ui8Status;         // GPIO_BUTTON_RELEASED or GPIO_BUTTON_PRESSED
+} tGpioButtonEvent;
+
+// Status and counters of a button. The members are ordered by size to avoid
+// padding.
+typedef struct {
+    uint64_t ui64Edge;          // Timebase ticks of the first edge of a bounce burst.
+    const tGpioPort *psGpioPort;
+    uint32_t ui32PressedCnt;
+    uint32_t ui32ReleasedCnt;
+    uint16_t ui16Debounce;      // Remaining debounce ticks.
+    uint8_t  ui8Pin;
+    uint8_t  ui8Status;         // GPIO_BUTTON_RELEASED or GPIO_BUTTON_PRESSED
+} tGpioButton;
 
 
 
 // Global variables holding the button status.
-extern uint8_t g_ui8GpioButtonStatus[GPIO_BUTTON_NUM];
-extern uint32_t g_ui32GpioButtonPressedCnt[GPIO_BUTTON_NUM];
-extern uint32_t g_ui32GpioButtonReleasedCnt[GPIO_BUTTON_NUM];
+extern tGpioButton g_psGpioButton[GPIO_BUTTON_NUM];
+extern uint32_t g_ui32GpioButtonEventDropCnt;
+extern const char *g_ppcGpioButtonName[GPIO_BUTTON_NUM];
 
 
 
 // Function prototypes.
-void GpioButtonInit(void);
+void GpioButtonInit(uint32_t ui32TickRate);
 uint32_t GpioButtonGet(void);
-void GpioButtonIntHandler(void);
+bool GpioButtonEventGet(tGpioButtonEvent *psEvent);
+void GpioButtonTick(void);
 
 
 
@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 11 Feb 2020
-// Rev.: 17 Apr 2020
+// Rev.: 17 Oct 2026
 //
 // I2C functions on the TI Tiva TM4C1294 Connected LaunchPad Evaluation Kit.
 //
@@ -10,14 +10,39 @@
 
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include "driverlib/gpio.h"
 #include "driverlib/i2c.h"
+#include "driverlib/interrupt.h"
 #include "driverlib/sysctl.h"
+#include "timebase.h"
 #include "i2c.h"
 
 
 
+// I2C master interrupt flags that indicate a failed transfer.
+#define I2C_XFER_ERR_FLAGS  (I2C_MASTER_INT_ARB_LOST | I2C_MASTER_INT_NACK | I2C_MASTER_INT_TIMEOUT)
+
+// The busy flag of the I2C master is only set some time after starting a
+// transfer. A byte takes at least 20 us at 400 kHz.
+#define I2C_BUSY_SETTLE_US  10
+
+
+
+// Function prototypes of local functions.
+static void I2CMasterXferStart(tI2C *psI2C);
+static void I2CMasterXferStartRead(tI2C *psI2C, tI2CXfer *psXfer);
+static void I2CMasterXferComplete(tI2C *psI2C, uint32_t ui32Status);
+static void I2CScanProbe(tI2CScan *psScan);
+static void I2CScanProbeDone(tI2CXfer *psXfer);
+static uint32_t I2CMasterXferBlocking(tI2C *psI2C, tI2CXfer *psXfer);
+static uint32_t I2CMasterTimeoutUs(tI2C *psI2C);
+static bool I2CMasterBusWait(tI2C *psI2C);
+static bool I2CMasterWait(tI2C *psI2C);
+
+
+
 // Initialize an I2C master.
 void I2CMasterInit(tI2C *psI2C)
 {
@@ -44,6 +69,439 @@ void I2CMasterInit(tI2C *psI2C)
 
 
 
+// Enable the interrupt-driven transfer engine of an I2C master. The I2C
+// master must be initialized with I2CMasterInit before. The interrupt
+// handler must call I2CMasterIntHandler for this I2C master.
+void I2CMasterIntInit(tI2C *psI2C, void (*pfnIntHandler)(void))
+{
+    // Reset the transfer engine.
+    psI2C->psXferHead = NULL;
+    psI2C->psXferTail = NULL;
+    psI2C->ui32XferState = I2C_XFER_STATE_IDLE;
+    psI2C->ui32XferIndex = 0;
+    psI2C->ui32XferErr = 0;
+    psI2C->bXferCmdStop = true;
+    psI2C->bXferAborted = false;
+    psI2C->ui32XferCnt = 0;
+    psI2C->ui32XferErrCnt = 0;
+
+    // Register and enable interrupt function.
+    I2CMasterIntClearEx(psI2C->ui32BaseI2C, 0xffffffffU);
+    I2CMasterIntEnableEx(psI2C->ui32BaseI2C, psI2C->ui32IntFlags | I2C_MASTER_INT_DATA);
+    I2CIntRegister(psI2C->ui32BaseI2C, pfnIntHandler);
+    psI2C->bIntEnabled = true;
+}
+
+
+
+// Interrupt handler of the I2C master transfer engine.
+void I2CMasterIntHandler(tI2C *psI2C)
+{
+    uint32_t ui32I2CMasterInt;
+    tI2CXfer *psXfer = psI2C->psXferHead;
+    bool bStop;
+
+    // Read and clear the I2C master interrupts.
+    ui32I2CMasterInt = I2CMasterIntStatusEx(psI2C->ui32BaseI2C, true);
+    I2CMasterIntClearEx(psI2C->ui32BaseI2C, ui32I2CMasterInt);
+
+    // Waiting for the stop condition after an error or an abort. The next
+    // transfer is only started when the master is done with the stop
+    // condition. An aborted transfer was already removed from the queue.
+    if (psI2C->ui32XferState == I2C_XFER_STATE_STOP) {
+        if ((ui32I2CMasterInt & (I2C_MASTER_INT_STOP | I2C_MASTER_INT_DATA)) && !I2CMasterBusy(psI2C->ui32BaseI2C)) {
+            if (psI2C->bXferAborted) {
+                psI2C->bXferAborted = false;
+                I2CMasterXferStart(psI2C);
+            } else if (psXfer) {
+                I2CMasterXferComplete(psI2C, psI2C->ui32XferErr);
+            }
+        }
+        return;
+    }
+
+    if ((psI2C->ui32XferState == I2C_XFER_STATE_IDLE) || !psXfer) return;
+
+    // Collect error flags. The transfer only advances when the master
+    // operation is finished (data interrupt) or arbitration was lost.
+    psI2C->ui32XferErr |= ui32I2CMasterInt & I2C_XFER_ERR_FLAGS;
+    if (!(ui32I2CMasterInt & I2C_MASTER_INT_DATA) && !(psI2C->ui32XferErr & I2C_MASTER_INT_ARB_LOST)) return;
+    if (!psI2C->ui32XferErr && (I2CMasterErr(psI2C->ui32BaseI2C) != I2C_MASTER_ERR_NONE)) {
+        psI2C->ui32XferErr = 1;
+    }
+
+    // Error: Release the bus, unless arbitration was lost or the master
+    // already issued a stop condition.
+    if (psI2C->ui32XferErr) {
+        if (!(psI2C->ui32XferErr & I2C_MASTER_INT_ARB_LOST) && !psI2C->bXferCmdStop) {
+            psI2C->ui32XferState = I2C_XFER_STATE_STOP;
+            psI2C->bXferCmdStop = true;
+            I2CMasterControl(psI2C->ui32BaseI2C, I2C_MASTER_CMD_BURST_SEND_ERROR_STOP);
+        } else {
+            I2CMasterXferComplete(psI2C, psI2C->ui32XferErr);
+        }
+        return;
+    }
+
+    switch (psI2C->ui32XferState) {
+        case I2C_XFER_STATE_WRITE:
+            psI2C->ui32XferIndex++;
+            if (psI2C->ui32XferIndex < psXfer->ui8WriteLength) {
+                bStop = (psI2C->ui32XferIndex == psXfer->ui8WriteLength - 1) && !psXfer->ui8ReadLength &&
+                        !(psXfer->ui8Flags & I2C_XFER_FLAG_NO_STOP);
+                psI2C->bXferCmdStop = bStop;
+                I2CMasterDataPut(psI2C->ui32BaseI2C, psXfer->pui8WriteData[psI2C->ui32XferIndex]);
+                I2CMasterControl(psI2C->ui32BaseI2C, bStop ? I2C_MASTER_CMD_BURST_SEND_FINISH : I2C_MASTER_CMD_BURST_SEND_CONT);
+            } else if (psXfer->ui8ReadLength) {
+                // Continue with the read phase using a repeated start.
+                I2CMasterXferStartRead(psI2C, psXfer);
+            } else {
+                I2CMasterXferComplete(psI2C, 0);
+            }
+            break;
+        case I2C_XFER_STATE_READ:
+            psXfer->pui8ReadData[psI2C->ui32XferIndex++] = I2CMasterDataGet(psI2C->ui32BaseI2C);
+            if (psI2C->ui32XferIndex < psXfer->ui8ReadLength) {
+                bStop = (psI2C->ui32XferIndex == psXfer->ui8ReadLength - 1) && !(psXfer->ui8Flags & I2C_XFER_FLAG_NO_STOP);
+                psI2C->bXferCmdStop = bStop;
+                I2CMasterControl(psI2C->ui32BaseI2C, bStop ? I2C_MASTER_CMD_BURST_RECEIVE_FINISH : I2C_MASTER_CMD_BURST_RECEIVE_CONT);
+            } else {
+                I2CMasterXferComplete(psI2C, 0);
+            }
+            break;
+        case I2C_XFER_STATE_QUICK:
+            I2CMasterXferComplete(psI2C, 0);
+            break;
+        default:
+            I2CMasterXferComplete(psI2C, 1);
+            break;
+    }
+}
+
+
+
+// Queue a transfer on an I2C master. The transfer is started immediately if
+// the I2C master is idle. Returns 0 on success, -1 on invalid parameters.
+int I2CMasterXferSubmit(tI2C *psI2C, tI2CXfer *psXfer)
+{
+    bool bIntDisabled;
+
+    if (!psI2C->bIntEnabled || !psXfer) return -1;
+    if (!(psXfer->ui8Flags & I2C_XFER_FLAG_QUICK_CMD) && !psXfer->ui8WriteLength && !psXfer->ui8ReadLength) return -1;
+
+    psXfer->ui32Status = I2C_XFER_STATUS_PENDING;
+    psXfer->bDone = false;
+    psXfer->psNext = NULL;
+
+    bIntDisabled = IntMasterDisable();
+    if (psI2C->psXferTail) psI2C->psXferTail->psNext = psXfer;
+    else psI2C->psXferHead = psXfer;
+    psI2C->psXferTail = psXfer;
+    if (psI2C->ui32XferState == I2C_XFER_STATE_IDLE) I2CMasterXferStart(psI2C);
+    if (!bIntDisabled) IntMasterEnable();
+
+    return 0;
+}
+
+
+
+// Wait until a queued transfer is done. The transfer is aborted on timeout.
+// Must not be called from an interrupt handler with the same or a higher
+// priority than the I2C master interrupt.
+uint32_t I2CMasterXferWait(tI2C *psI2C, tI2CXfer *psXfer)
+{
+    tTimeout sTimeout;
+
+    // Allow the same time per byte as the polling functions. The processor
+    // sleeps until the transfer is done.
+    TimeoutStart(&sTimeout, I2CMasterTimeoutUs(psI2C) * (psXfer->ui8WriteLength + psXfer->ui8ReadLength + 1));
+    while (!psXfer->bDone) {
+        if (TimeoutExpired(&sTimeout)) {
+            I2CMasterXferAbort(psI2C, psXfer);
+            break;
+        }
+        TimeoutSleep(&sTimeout, &psXfer->bDone);
+    }
+
+    return psXfer->ui32Status;
+}
+
+
+
+// Abort a transfer of an I2C master. If the transfer is in progress, the bus
+// is released and the next queued transfer is started by the interrupt
+// handler once the stop condition is done. Other queued transfers are not
+// affected. Nothing is done if the transfer is not queued (anymore). The
+// aborted transfer is done with the status I2C_MASTER_INT_TIMEOUT.
+void I2CMasterXferAbort(tI2C *psI2C, tI2CXfer *psXfer)
+{
+    tI2CXfer *psXferPrev;
+    bool bIntDisabled;
+
+    if (!psXfer) return;
+    bIntDisabled = IntMasterDisable();
+    if (psI2C->psXferHead == psXfer && psI2C->ui32XferState == I2C_XFER_STATE_IDLE) {
+        I2CMasterXferComplete(psI2C, I2C_MASTER_INT_TIMEOUT);
+    } else if (psI2C->psXferHead == psXfer) {
+        // The stop condition is already requested after an error.
+        if (psI2C->ui32XferState != I2C_XFER_STATE_STOP) {
+            psI2C->ui32XferState = I2C_XFER_STATE_STOP;
+            I2CMasterControl(psI2C->ui32BaseI2C, I2C_MASTER_CMD_BURST_SEND_ERROR_STOP);
+        }
+        psI2C->bXferCmdStop = true;
+        psI2C->bXferAborted = true;
+        psI2C->psXferHead = psXfer->psNext;
+        if (!psI2C->psXferHead) psI2C->psXferTail = NULL;
+        psI2C->ui32XferCnt++;
+        psI2C->ui32XferErrCnt++;
+        psXfer->ui32Status = I2C_MASTER_INT_TIMEOUT;
+        psXfer->bDone = true;
+        if (psXfer->pfnCallback) psXfer->pfnCallback(psXfer);
+    } else {
+        for (psXferPrev = psI2C->psXferHead; psXferPrev && psXferPrev->psNext != psXfer; psXferPrev = psXferPrev->psNext);
+        if (psXferPrev) {
+            psXferPrev->psNext = psXfer->psNext;
+            if (psI2C->psXferTail == psXfer) psI2C->psXferTail = psXferPrev;
+            psI2C->ui32XferCnt++;
+            psI2C->ui32XferErrCnt++;
+            psXfer->ui32Status = I2C_MASTER_INT_TIMEOUT;
+            psXfer->bDone = true;
+            if (psXfer->pfnCallback) psXfer->pfnCallback(psXfer);
+        }
+    }
+    if (!bIntDisabled) IntMasterEnable();
+}
+
+
+
+// Check if the transfer engine of an I2C master is idle.
+bool I2CMasterXferIdle(tI2C *psI2C)
+{
+    return (psI2C->ui32XferState == I2C_XFER_STATE_IDLE) && !psI2C->psXferHead;
+}
+
+
+
+// Check if the last transfer of an I2C master ended without a stop condition,
+// so the master still holds the bus for a repeated start.
+bool I2CMasterXferBusHeld(tI2C *psI2C)
+{
+    return !psI2C->bXferCmdStop;
+}
+
+
+
+// Set the speed of an I2C master. The speed is changed between two transfers
+// of the transfer engine.
+void I2CMasterSpeedSet(tI2C *psI2C, bool bFast)
+{
+    tTimeout sTimeout;
+    bool bIntDisabled;
+
+    TimeoutStart(&sTimeout, I2CMasterTimeoutUs(psI2C) * 16);
+    while (true) {
+        bIntDisabled = IntMasterDisable();
+        // Change the speed anyway if the transfer engine does not get idle.
+        if (!psI2C->bIntEnabled || I2CMasterXferIdle(psI2C) || TimeoutExpired(&sTimeout)) {
+            psI2C->bFast = bFast;
+            I2CMasterInitExpClk(psI2C->ui32BaseI2C, psI2C->ui32I2CClk, bFast);
+            if (!bIntDisabled) IntMasterEnable();
+            return;
+        }
+        if (!bIntDisabled) IntMasterEnable();
+        TimeoutSleep(&sTimeout, NULL);
+    }
+}
+
+
+
+// Start scanning the slave addresses ui8AddrFirst to ui8AddrLast of an I2C
+// master for devices. The transfer engine must be enabled. The scan runs in
+// the background. Returns 0 on success, -1 on invalid parameters.
+int I2CScanStart(tI2CScan *psScan, tI2C *psI2C, uint8_t ui8AddrFirst, uint8_t ui8AddrLast, uint8_t ui8Mode)
+{
+    if (!psI2C->bIntEnabled || ui8AddrFirst > ui8AddrLast || ui8AddrLast > 0x7f) return -1;
+
+    psScan->psI2C = psI2C;
+    psScan->ui8Mode = ui8Mode;
+    psScan->ui8AddrFirst = ui8AddrFirst;
+    psScan->ui8AddrLast = ui8AddrLast;
+    psScan->ui8Addr = ui8AddrFirst;
+    for (int i = 0; i < I2C_SCAN_MAP_WORDS; i++) psScan->pui32Map[i] = 0;
+    psScan->sXfer.pfnCallback = I2CScanProbeDone;
+    psScan->sXfer.pvCallbackData = psScan;
+    psScan->bAbort = false;
+    psScan->bDone = false;
+    I2CScanProbe(psScan);
+
+    return 0;
+}
+
+
+
+// Wait until a scan is done. The scan is aborted on timeout. Returns 0 on
+// success or I2C_MASTER_INT_TIMEOUT.
+uint32_t I2CScanWait(tI2CScan *psScan)
+{
+    tI2C *psI2C = psScan->psI2C;
+    tTimeout sTimeout;
+
+    // Allow the time of a transfer of two bytes per slave address. The
+    // processor sleeps until the scan is done.
+    TimeoutStart(&sTimeout, I2CMasterTimeoutUs(psI2C) * 3 * (psScan->ui8AddrLast - psScan->ui8AddrFirst + 1));
+    while (!psScan->bDone) {
+        if (TimeoutExpired(&sTimeout)) {
+            psScan->bAbort = true;
+            I2CMasterXferAbort(psI2C, &psScan->sXfer);
+            return I2C_MASTER_INT_TIMEOUT;
+        }
+        TimeoutSleep(&sTimeout, &psScan->bDone);
+    }
+
+    return 0;
+}
+
+
+
+// Check if a device was found at a slave address by a scan.
+bool I2CScanFound(const tI2CScan *psScan, uint8_t ui8SlaveAddr)
+{
+    return (psScan->pui32Map[(ui8SlaveAddr >> 5) & (I2C_SCAN_MAP_WORDS - 1)] >> (ui8SlaveAddr & 0x1f)) & 1;
+}
+
+
+
+// Queue the probe of the current slave address of a scan.
+static void I2CScanProbe(tI2CScan *psScan)
+{
+    tI2CXfer *psXfer = &psScan->sXfer;
+    uint8_t ui8SlaveAddr = psScan->ui8Addr;
+    bool bRead;
+
+    // Detect I2C devices based on the i2cdetect program of the i2c-tools.
+    // Please see: https://github.com/mozilla-b2g/i2c-tools/blob/master/tools/i2cdetect.c
+    // A write quick command can corrupt EEPROMs and a read quick command can
+    // lock the bus on some write-only devices.
+    switch (psScan->ui8Mode) {
+        case I2C_SCAN_MODE_QUICK:
+            bRead = false;
+            break;
+        case I2C_SCAN_MODE_READ:
+            bRead = true;
+            break;
+        default:
+            bRead = (ui8SlaveAddr >= 0x30 && ui8SlaveAddr <= 0x37) || (ui8SlaveAddr >= 0x50 && ui8SlaveAddr <= 0x5f);
+            break;
+    }
+    psXfer->ui8SlaveAddr = ui8SlaveAddr;
+    psXfer->ui8Flags = bRead ? 0 : I2C_XFER_FLAG_QUICK_CMD;     // Quick command: R/W bit = write
+    psXfer->pui8WriteData = NULL;
+    psXfer->ui8WriteLength = 0;
+    psXfer->pui8ReadData = &psScan->ui8Data;
+    psXfer->ui8ReadLength = bRead ? 1 : 0;
+    if (I2CMasterXferSubmit(psScan->psI2C, psXfer)) psScan->bDone = true;
+}
+
+
+
+// Called by the I2C interrupt handler when the probe of a slave address is
+// done. Records the result and queues the probe of the next slave address.
+static void I2CScanProbeDone(tI2CXfer *psXfer)
+{
+    tI2CScan *psScan = (tI2CScan *) psXfer->pvCallbackData;
+    uint8_t ui8SlaveAddr = psScan->ui8Addr;
+
+    if (!psXfer->ui32Status) psScan->pui32Map[ui8SlaveAddr >> 5] |= 1u << (ui8SlaveAddr & 0x1f);
+    if (psScan->bAbort || ui8SlaveAddr >= psScan->ui8AddrLast) {
+        psScan->bDone = true;
+        return;
+    }
+    psScan->ui8Addr = ui8SlaveAddr + 1;
+    I2CScanProbe(psScan);
+}
+
+
+
+// Start the transfer at the head of the queue.
+static void I2CMasterXferStart(tI2C *psI2C)
+{
+    tI2CXfer *psXfer = psI2C->psXferHead;
+    bool bStop;
+
+    if (!psXfer) {
+        psI2C->ui32XferState = I2C_XFER_STATE_IDLE;
+        return;
+    }
+
+    psI2C->ui32XferIndex = 0;
+    psI2C->ui32XferErr = 0;
+    I2CMasterIntClearEx(psI2C->ui32BaseI2C, 0xffffffffU);
+
+    if (psXfer->ui8Flags & I2C_XFER_FLAG_QUICK_CMD) {
+        // The quick command includes the stop condition.
+        psI2C->ui32XferState = I2C_XFER_STATE_QUICK;
+        psI2C->bXferCmdStop = true;
+        I2CMasterSlaveAddrSet(psI2C->ui32BaseI2C, psXfer->ui8SlaveAddr, psXfer->ui8Flags & I2C_XFER_FLAG_QUICK_READ);
+        I2CMasterControl(psI2C->ui32BaseI2C, I2C_MASTER_CMD_QUICK_COMMAND);
+    } else if (psXfer->ui8WriteLength) {
+        bStop = (psXfer->ui8WriteLength == 1) && !psXfer->ui8ReadLength && !(psXfer->ui8Flags & I2C_XFER_FLAG_NO_STOP);
+        psI2C->ui32XferState = I2C_XFER_STATE_WRITE;
+        psI2C->bXferCmdStop = bStop;
+        I2CMasterSlaveAddrSet(psI2C->ui32BaseI2C, psXfer->ui8SlaveAddr, false);     // false = write; true = read
+        I2CMasterDataPut(psI2C->ui32BaseI2C, psXfer->pui8WriteData[0]);
+        I2CMasterControl(psI2C->ui32BaseI2C, bStop ? I2C_MASTER_CMD_SINGLE_SEND : I2C_MASTER_CMD_BURST_SEND_START);
+    } else {
+        I2CMasterXferStartRead(psI2C, psXfer);
+    }
+}
+
+
+
+// Start the read phase of a transfer.
+static void I2CMasterXferStartRead(tI2C *psI2C, tI2CXfer *psXfer)
+{
+    bool bStop = (psXfer->ui8ReadLength == 1) && !(psXfer->ui8Flags & I2C_XFER_FLAG_NO_STOP);
+
+    psI2C->ui32XferIndex = 0;
+    psI2C->ui32XferState = I2C_XFER_STATE_READ;
+    psI2C->bXferCmdStop = bStop;
+    I2CMasterSlaveAddrSet(psI2C->ui32BaseI2C, psXfer->ui8SlaveAddr, true);          // false = write; true = read
+    I2CMasterControl(psI2C->ui32BaseI2C, bStop ? I2C_MASTER_CMD_SINGLE_RECEIVE : I2C_MASTER_CMD_BURST_RECEIVE_START);
+}
+
+
+
+// Finish the transfer at the head of the queue and start the next one.
+static void I2CMasterXferComplete(tI2C *psI2C, uint32_t ui32Status)
+{
+    tI2CXfer *psXfer = psI2C->psXferHead;
+
+    psI2C->psXferHead = psXfer->psNext;
+    if (!psI2C->psXferHead) psI2C->psXferTail = NULL;
+    psI2C->ui32XferState = I2C_XFER_STATE_IDLE;
+    psI2C->ui32XferCnt++;
+    if (ui32Status) psI2C->ui32XferErrCnt++;
+
+    // Issue the next transfer right away before running the callback.
+    I2CMasterXferStart(psI2C);
+
+    psXfer->ui32Status = ui32Status;
+    psXfer->bDone = true;
+    if (psXfer->pfnCallback) psXfer->pfnCallback(psXfer);
+}
+
+
+
+// Run a single transfer on the transfer engine and wait until it is done.
+static uint32_t I2CMasterXferBlocking(tI2C *psI2C, tI2CXfer *psXfer)
+{
+    if (I2CMasterXferSubmit(psI2C, psXfer)) return 1;
+
+    return I2CMasterXferWait(psI2C, psXfer);
+}
+
+
+
 // Write data to an I2C master.
 uint32_t I2CMasterWrite(tI2C *psI2C, uint8_t ui8SlaveAddr, uint8_t *pui8Data, uint8_t ui8Length)
 {
@@ -56,10 +514,20 @@ uint32_t I2CMasterWrite(tI2C *psI2C, uint8_t ui8SlaveAddr, uint8_t *pui8Data, ui
 uint32_t I2CMasterWriteAdv(tI2C *psI2C, uint8_t ui8SlaveAddr, uint8_t *pui8Data, uint8_t ui8Length, bool bRepeatedStart, bool bStop)
 {
     uint32_t ui32I2CMasterInt, ui32I2CMasterErr;
-    uint32_t ui32Timeout = psI2C->ui32Timeout + 10;     // Guarantee some minimum timeout value.
 
     if (ui8Length < 1) return 1;
 
+    // Use the interrupt-driven transfer engine, if enabled. A repeated start
+    // is generated by the I2C master if the bus was not released before.
+    if (psI2C->bIntEnabled) {
+        tI2CXfer sXfer = {0};
+        sXfer.ui8SlaveAddr = ui8SlaveAddr;
+        sXfer.ui8Flags = bStop ? 0 : I2C_XFER_FLAG_NO_STOP;
+        sXfer.pui8WriteData = pui8Data;
+        sXfer.ui8WriteLength = ui8Length;
+        return I2CMasterXferBlocking(psI2C, &sXfer);
+    }
+
     // Clear all I2C master interrupts.
     I2CMasterIntClearEx(psI2C->ui32BaseI2C, 0xffffffffU);
 
@@ -67,15 +535,7 @@ uint32_t I2CMasterWriteAdv(tI2C *psI2C, uint8_t ui8SlaveAddr, uint8_t *pui8Data,
     I2CMasterSlaveAddrSet(psI2C->ui32BaseI2C, ui8SlaveAddr, false);   // false = write; true = read
 
     // Wait until the I2C bus is free, if no repeated start.
-    if (!bRepeatedStart) {
-        for (int i = 0; i <= ui32Timeout; i++) {
-            if (!I2CMasterBusBusy(psI2C->ui32BaseI2C)) break;
-            SysCtlDelay(psI2C->ui32I2CClk / 3e5);   // 10 us delay.
-                                                    // Note: The SysCtlDelay executes a simple 3 instruction cycle loop.
-            // Timeout while waiting for the I2C bus to be free.
-            if (i == ui32Timeout) return I2C_MASTER_INT_ARB_LOST;
-        }
-    }
+    if (!bRepeatedStart && !I2CMasterBusWait(psI2C)) return I2C_MASTER_INT_ARB_LOST;
 
     // Send data.
     for (int i = 0; i < ui8Length; i++) {
@@ -88,15 +548,9 @@ uint32_t I2CMasterWriteAdv(tI2C *psI2C, uint8_t ui8SlaveAddr, uint8_t *pui8Data,
             else I2CMasterControl(psI2C->ui32BaseI2C, I2C_MASTER_CMD_BURST_SEND_CONT);
         }
         // Wait until the transfer is finished.
-        SysCtlDelay(psI2C->ui32I2CClk / 3e5);   // 10 us delay.
-        for (int i = 0; i <= ui32Timeout; i++) {
-            if (!I2CMasterBusy(psI2C->ui32BaseI2C)) break;
-            SysCtlDelay(psI2C->ui32I2CClk / 3e5);   // 10 us delay.
-            // Timeout while waiting for the I2C master to be ready.
-            if (i == ui32Timeout) {
-                I2CMasterControl(psI2C->ui32BaseI2C, I2C_MASTER_CMD_BURST_SEND_ERROR_STOP);
-                return I2C_MASTER_INT_TIMEOUT;
-            }
+        if (!I2CMasterWait(psI2C)) {
+            I2CMasterControl(psI2C->ui32BaseI2C, I2C_MASTER_CMD_BURST_SEND_ERROR_STOP);
+            return I2C_MASTER_INT_TIMEOUT;
         }
         // Read I2C master interrupts.
         ui32I2CMasterInt = I2CMasterIntStatusEx(psI2C->ui32BaseI2C, false);
@@ -130,10 +584,20 @@ uint32_t I2CMasterRead(tI2C *psI2C, uint8_t ui8SlaveAddr, uint8_t *pui8Data, uin
 uint32_t I2CMasterReadAdv(tI2C *psI2C, uint8_t ui8SlaveAddr, uint8_t *pui8Data, uint8_t ui8Length, bool bRepeatedStart, bool bStop)
 {
     uint32_t ui32I2CMasterInt, ui32I2CMasterErr;
-    uint32_t ui32Timeout = psI2C->ui32Timeout + 10;     // Guarantee some minimum timeout value.
 
     if (ui8Length < 1) return 1;
 
+    // Use the interrupt-driven transfer engine, if enabled. A repeated start
+    // is generated by the I2C master if the bus was not released before.
+    if (psI2C->bIntEnabled) {
+        tI2CXfer sXfer = {0};
+        sXfer.ui8SlaveAddr = ui8SlaveAddr;
+        sXfer.ui8Flags = bStop ? 0 : I2C_XFER_FLAG_NO_STOP;
+        sXfer.pui8ReadData = pui8Data;
+        sXfer.ui8ReadLength = ui8Length;
+        return I2CMasterXferBlocking(psI2C, &sXfer);
+    }
+
     // Clear all I2C master interrupts.
     I2CMasterIntClearEx(psI2C->ui32BaseI2C, 0xffffffffU);
 
@@ -141,15 +605,7 @@ uint32_t I2CMasterReadAdv(tI2C *psI2C, uint8_t ui8SlaveAddr, uint8_t *pui8Data,
     I2CMasterSlaveAddrSet(psI2C->ui32BaseI2C, ui8SlaveAddr, true);    // false = write; true = read
 
     // Wait until the I2C bus is free, if no repeated start.
-    if (!bRepeatedStart) {
-        for (int i = 0; i <= ui32Timeout; i++) {
-            if (!I2CMasterBusBusy(psI2C->ui32BaseI2C)) break;
-            SysCtlDelay(psI2C->ui32I2CClk / 3e5);   // 10 us delay.
-                                                    // Note: The SysCtlDelay executes a simple 3 instruction cycle loop.
-            // Timeout while waiting for the I2C bus to be free.
-            if (i == ui32Timeout) return I2C_MASTER_INT_ARB_LOST;
-        }
-    }
+    if (!bRepeatedStart && !I2CMasterBusWait(psI2C)) return I2C_MASTER_INT_ARB_LOST;
 
     // Receive data.
     for (int i = 0; i < ui8Length; i++) {
@@ -161,15 +617,9 @@ uint32_t I2CMasterReadAdv(tI2C *psI2C, uint8_t ui8SlaveAddr, uint8_t *pui8Data,
             else I2CMasterControl(psI2C->ui32BaseI2C, I2C_MASTER_CMD_BURST_RECEIVE_CONT);
         }
         // Wait until the transfer is finished.
-        SysCtlDelay(psI2C->ui32I2CClk / 3e5);   // 10 us delay.
-        for (int i = 0; i <= ui32Timeout; i++) {
-            if (!I2CMasterBusy(psI2C->ui32BaseI2C)) break;
-            SysCtlDelay(psI2C->ui32I2CClk / 3e5);   // 10 us delay.
-            // Timeout while waiting for the I2C master to be ready.
-            if (i == ui32Timeout) {
-                I2CMasterControl(psI2C->ui32BaseI2C, I2C_MASTER_CMD_BURST_SEND_ERROR_STOP);
-                return I2C_MASTER_INT_TIMEOUT;
-            }
+        if (!I2CMasterWait(psI2C)) {
+            I2CMasterControl(psI2C->ui32BaseI2C, I2C_MASTER_CMD_BURST_SEND_ERROR_STOP);
+            return I2C_MASTER_INT_TIMEOUT;
         }
         // Read I2C master interrupts.
         ui32I2CMasterInt = I2CMasterIntStatusEx(psI2C->ui32BaseI2C, false);
@@ -205,7 +655,15 @@ uint32_t I2CMasterQuickCmd(tI2C *psI2C, uint8_t ui8SlaveAddr, bool bReceive)
 uint32_t I2CMasterQuickCmdAdv(tI2C *psI2C, uint8_t ui8SlaveAddr, bool bReceive, bool bRepeatedStart)
 {
     uint32_t ui32I2CMasterInt, ui32I2CMasterErr;
-    uint32_t ui32Timeout = psI2C->ui32Timeout + 10;     // Guarantee some minimum timeout value.
+
+    // Use the interrupt-driven transfer engine, if enabled. A repeated start
+    // is generated by the I2C master if the bus was not released before.
+    if (psI2C->bIntEnabled) {
+        tI2CXfer sXfer = {0};
+        sXfer.ui8SlaveAddr = ui8SlaveAddr;
+        sXfer.ui8Flags = I2C_XFER_FLAG_QUICK_CMD | (bReceive ? I2C_XFER_FLAG_QUICK_READ : 0);
+        return I2CMasterXferBlocking(psI2C, &sXfer);
+    }
 
     // Clear all I2C Master interrupts.
     I2CMasterIntClearEx(psI2C->ui32BaseI2C, 0xffffffffU);
@@ -214,28 +672,14 @@ uint32_t I2CMasterQuickCmdAdv(tI2C *psI2C, uint8_t ui8SlaveAddr, bool bReceive,
     I2CMasterSlaveAddrSet(psI2C->ui32BaseI2C, ui8SlaveAddr, bReceive);  // false = write; true = read
 
     // Wait until the I2C bus is free, if no repeated start.
-    if (!bRepeatedStart) {
-        for (int i = 0; i <= ui32Timeout; i++) {
-            if (!I2CMasterBusBusy(psI2C->ui32BaseI2C)) break;
-            SysCtlDelay(psI2C->ui32I2CClk / 3e5);   // 10 us delay.
-                                                    // Note: The SysCtlDelay executes a simple 3 instruction cycle loop.
-            // Timeout while waiting for the I2C bus to be free.
-            if (i == ui32Timeout) return I2C_MASTER_INT_ARB_LOST;
-        }
-    }
+    if (!bRepeatedStart && !I2CMasterBusWait(psI2C)) return I2C_MASTER_INT_ARB_LOST;
 
     // Send the quick command.
     I2CMasterControl(psI2C->ui32BaseI2C, I2C_MASTER_CMD_QUICK_COMMAND);
     // Wait until the transfer is finished.
-    SysCtlDelay(psI2C->ui32I2CClk / 3e5);   // 10 us delay.
-    for (int i = 0; i <= ui32Timeout; i++) {
-        if (!I2CMasterBusy(psI2C->ui32BaseI2C)) break;
-        SysCtlDelay(psI2C->ui32I2CClk / 3e5);   // 10 us delay.
-        // Timeout while waiting for the I2C master to be ready.
-        if (i == ui32Timeout) {
-            I2CMasterControl(psI2C->ui32BaseI2C, I2C_MASTER_CMD_BURST_SEND_ERROR_STOP);
-            return I2C_MASTER_INT_TIMEOUT;
-        }
+    if (!I2CMasterWait(psI2C)) {
+        I2CMasterControl(psI2C->ui32BaseI2C, I2C_MASTER_CMD_BURST_SEND_ERROR_STOP);
+        return I2C_MASTER_INT_TIMEOUT;
     }
     // Read I2C master interrupts.
     ui32I2CMasterInt = I2CMasterIntStatusEx(psI2C->ui32BaseI2C, false);
@@ -252,3 +696,43 @@ uint32_t I2CMasterQuickCmdAdv(tI2C *psI2C, uint8_t ui8SlaveAddr, bool bReceive,
     return ui32I2CMasterInt;
 }
 
+
+
+// Get the timeout for waiting on the I2C bus or master in microseconds.
+static uint32_t I2CMasterTimeoutUs(tI2C *psI2C)
+{
+    return (psI2C->ui32Timeout + 10) * 10;  // Guarantee some minimum timeout value.
+}
+
+
+
+// Wait until the I2C bus is free. Returns false on timeout.
+static bool I2CMasterBusWait(tI2C *psI2C)
+{
+    tTimeout sTimeout;
+
+    TimeoutStart(&sTimeout, I2CMasterTimeoutUs(psI2C));
+    while (I2CMasterBusBusy(psI2C->ui32BaseI2C)) {
+        if (TimeoutExpired(&sTimeout)) return false;
+    }
+
+    return true;
+}
+
+
+
+// Wait until the I2C master has finished the current transfer. Returns false
+// on timeout.
+static bool I2CMasterWait(tI2C *psI2C)
+{
+    tTimeout sTimeout;
+
+    TimeoutStart(&sTimeout, I2C_BUSY_SETTLE_US);
+    while (!TimeoutExpired(&sTimeout));
+    TimeoutStart(&sTimeout, I2CMasterTimeoutUs(psI2C));
+    while (I2CMasterBusy(psI2C->ui32BaseI2C)) {
+        if (TimeoutExpired(&sTimeout)) return false;
+    }
+
+    return true;
+}
@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 11 Feb 2020
-// Rev.: 14 Apr 2020
+// Rev.: 17 Oct 2026
 //
 // Header file for the I2C functions on the TI Tiva TM4C1294 Connected
 // LaunchPad Evaluation Kit.
@@ -15,7 +15,53 @@
 
 
 
+// I2C transfer flags.
+#define I2C_XFER_FLAG_NO_STOP           0x02    // Do not generate a stop condition at the end.
+#define I2C_XFER_FLAG_QUICK_CMD         0x04    // Send a quick command.
+#define I2C_XFER_FLAG_QUICK_READ        0x08    // Quick command with the R/W bit set to read.
+
+// I2C transfer engine states.
+#define I2C_XFER_STATE_IDLE             0
+#define I2C_XFER_STATE_WRITE            1
+#define I2C_XFER_STATE_READ             2
+#define I2C_XFER_STATE_QUICK            3
+#define I2C_XFER_STATE_STOP             4
+
+// Pseudo status of an I2C transfer that is still queued or in progress.
+#define I2C_XFER_STATUS_PENDING         0x80000000
+
+// I2C bus scan modes.
+#define I2C_SCAN_MODE_AUTO              0       // Quick command or read based on the slave address.
+#define I2C_SCAN_MODE_QUICK             1       // Quick command.
+#define I2C_SCAN_MODE_READ              2       // Read one byte.
+
+// Number of 32 bit words of the bitmap of a bus scan.
+#define I2C_SCAN_MAP_WORDS              4
+
+
+
 // Types.
+
+// I2C transfer descriptor for the interrupt-driven transfer engine. A write
+// phase is followed by a read phase using a repeated start, if both lengths
+// are non-zero. The descriptor and the data buffers are owned by the caller
+// and must stay valid until the transfer is done.
+typedef struct sI2CXfer {
+    uint8_t  ui8SlaveAddr;
+    uint8_t  ui8Flags;              // I2C_XFER_FLAG_*
+    uint8_t  *pui8WriteData;
+    uint8_t  ui8WriteLength;
+    uint8_t  *pui8ReadData;
+    uint8_t  ui8ReadLength;
+    // Called from interrupt context when the transfer is done.
+    void     (*pfnCallback)(struct sI2CXfer *psXfer);
+    void     *pvCallbackData;
+    // Set by the transfer engine.
+    volatile uint32_t ui32Status;   // 0 = OK; I2C_MASTER_INT_* error flags or 1 = other error
+    volatile bool     bDone;
+    struct sI2CXfer *psNext;
+} tI2CXfer;
+
 typedef struct {
     uint32_t ui32PeripheralI2C;
     uint32_t ui32PeripheralGpio;
@@ -29,11 +75,49 @@ typedef struct {
     bool     bFast;                 // false = 100 kbps; true = 400 kbps
     uint32_t ui32IntFlags;
     uint32_t ui32Timeout;
+    // State of the interrupt-driven transfer engine. Managed by the driver.
+    bool     bIntEnabled;
+    tI2CXfer * volatile psXferHead;
+    tI2CXfer * volatile psXferTail;
+    volatile uint32_t ui32XferState;
+    volatile uint32_t ui32XferIndex;
+    volatile uint32_t ui32XferErr;
+    volatile bool     bXferCmdStop; // Last command included a stop condition.
+    volatile bool     bXferAborted; // Head transfer was aborted while waiting for the stop condition.
+    volatile uint32_t ui32XferCnt;
+    volatile uint32_t ui32XferErrCnt;
 } tI2C;
 
+// I2C bus scan. The slave addresses are probed one after another by the
+// transfer engine. Each finished probe queues the next one from the
+// interrupt handler, so several I2C masters can be scanned concurrently.
+typedef struct {
+    tI2C     *psI2C;
+    uint8_t  ui8Mode;               // I2C_SCAN_MODE_*
+    uint8_t  ui8AddrFirst;
+    uint8_t  ui8AddrLast;
+    volatile uint8_t ui8Addr;       // Slave address being probed.
+    uint8_t  ui8Data;
+    tI2CXfer sXfer;
+    uint32_t pui32Map[I2C_SCAN_MAP_WORDS];  // Bit n set = device found at slave address n.
+    volatile bool bAbort;
+    volatile bool bDone;
+} tI2CScan;
+
 
 // Function prototypes.
 void I2CMasterInit(tI2C *psI2C);
+void I2CMasterIntInit(tI2C *psI2C, void (*pfnIntHandler)(void));
+void I2CMasterIntHandler(tI2C *psI2C);
+int I2CMasterXferSubmit(tI2C *psI2C, tI2CXfer *psXfer);
+uint32_t I2CMasterXferWait(tI2C *psI2C, tI2CXfer *psXfer);
+void I2CMasterXferAbort(tI2C *psI2C, tI2CXfer *psXfer);
+bool I2CMasterXferIdle(tI2C *psI2C);
+bool I2CMasterXferBusHeld(tI2C *psI2C);
+void I2CMasterSpeedSet(tI2C *psI2C, bool bFast);
+int I2CScanStart(tI2CScan *psScan, tI2C *psI2C, uint8_t ui8AddrFirst, uint8_t ui8AddrLast, uint8_t ui8Mode);
+uint32_t I2CScanWait(tI2CScan *psScan);
+bool I2CScanFound(const tI2CScan *psScan, uint8_t ui8SlaveAddr);
 uint32_t I2CMasterWrite(tI2C *pcI2C, uint8_t ui8SlaveAddr, uint8_t *ui8Data, uint8_t ui8Length);
 uint32_t I2CMasterWriteAdv(tI2C *psI2C, uint8_t ui8SlaveAddr, uint8_t *pui8Data, uint8_t ui8Length, bool bRepeatedStart, bool bStop);
 uint32_t I2CMasterRead(tI2C *psI2C, uint8_t ui8SlaveAddr, uint8_t *ui8Data, uint8_t ui8Length);
@@ -44,4 +128,3 @@ uint32_t I2CMasterQuickCmdAdv(tI2C *psI2C, uint8_t ui8SlaveAddr, bool bReceive,
 
 
 #endif  // __I2C_H__
-
@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 13 Feb 2020
-// Rev.: 11 Apr 2020
+// Rev.: 17 Oct 2026
 //
 // I2C functions for the OPT3001 ambient light sensor on the Educational
 // BoosterPack MK II connected to the TI Tiva TM4C1294 Connected LaunchPad
@@ -17,6 +17,7 @@
 #include "driverlib/i2c.h"
 #include "driverlib/sysctl.h"
 #include "i2c.h"
+#include "i2c_opt3001.h"
 
 
 
@@ -37,85 +38,121 @@ uint32_t I2COpt3001Reset(tI2C *psI2C, uint8_t ui8SlaveAddr)
 uint32_t I2COpt3001Init(tI2C *psI2C, uint8_t ui8SlaveAddr)
 {
     uint8_t ui8Data[3] = {0x01, 0xce, 0x10};
+    uint8_t ui8DataLowLimit[3] = {0x02, 0x00, 0x00};
+    uint32_t ui32I2CMasterStatus;
+
+    // Restore the default low limit, in case the end-of-conversion mode was
+    // set up by I2COpt3001InitStream.
+    ui32I2CMasterStatus = I2CMasterWrite(psI2C, ui8SlaveAddr, ui8DataLowLimit, 3);
+    if (ui32I2CMasterStatus) return ui32I2CMasterStatus;
 
     return I2CMasterWrite(psI2C, ui8SlaveAddr, ui8Data, 3);
 }
 
 
 
-// Read the light illuminance from the OPT3001 sensor IC.
-// Returns the light illuminance in lux.
-float I2COpt3001ReadIlluminance(tI2C *psI2C, uint8_t ui8SlaveAddr)
+// Initialize the OPT3001 sensor IC for the maximum conversion rate (100 ms
+// conversion time). The INT pin is set to the end-of-conversion mode by
+// writing 0xc000 to the low limit register. It is asserted when a conversion
+// is done and released by reading the configuration register.
+uint32_t I2COpt3001InitStream(tI2C *psI2C, uint8_t ui8SlaveAddr)
 {
-    uint8_t ui8Data[2];
+    uint8_t ui8Data[3] = {0x01, 0xc6, 0x10};
+    uint8_t ui8DataLowLimit[3] = {0x02, 0xc0, 0x00};
     uint32_t ui32I2CMasterStatus;
-    uint32_t ui32IlluminanceRaw;
-    uint32_t ui32IlluminanceMantissa, ui32IlluminanceExponent;
-    float fIlluminance;
 
-    // Set the pointer register of the OPT3001 IC to the result register (0x00).
-    ui8Data[0] = 0x00;
-    ui32I2CMasterStatus = I2CMasterWrite(psI2C, ui8SlaveAddr, ui8Data, 1);
-    if (ui32I2CMasterStatus) return -255;
+    ui32I2CMasterStatus = I2CMasterWrite(psI2C, ui8SlaveAddr, ui8DataLowLimit, 3);
+    if (ui32I2CMasterStatus) return ui32I2CMasterStatus;
 
-    // Read the result register.
-    ui32I2CMasterStatus = I2CMasterRead(psI2C, ui8SlaveAddr, ui8Data, 2);
-    if (ui32I2CMasterStatus) return -255;
-
-    // Calculate the light illuminance in lux.
-    ui32IlluminanceRaw = (uint32_t) (ui8Data[0] << 8) | ui8Data[1];
-    ui32IlluminanceMantissa = ui32IlluminanceRaw & 0x0fff;
-    ui32IlluminanceExponent = (ui32IlluminanceRaw & 0xf000) >> 12;
-    fIlluminance = (float) ui32IlluminanceMantissa * 0.01 * (1 << ui32IlluminanceExponent);
-
-    return fIlluminance;
+    return I2CMasterWrite(psI2C, ui8SlaveAddr, ui8Data, 3);
 }
 
 
 
-// Read the manufacturer ID from the OPT3001 sensor IC.
-uint32_t I2COpt3001ReadManufacturerId(tI2C *psI2C, uint8_t ui8SlaveAddr)
+// Read a 16 bit register of the OPT3001 sensor IC. Returns the I2C master
+// status.
+uint32_t I2COpt3001ReadReg(tI2C *psI2C, uint8_t ui8SlaveAddr, uint8_t ui8Reg, uint16_t *pui16Value)
 {
     uint8_t ui8Data[2];
     uint32_t ui32I2CMasterStatus;
-    uint32_t ui32ManufacturerId;
 
-    // Set the pointer register of the OPT3001 IC to the manufacturer ID register (0x7e).
-    ui8Data[0] = 0x7e;
+    // Set the pointer register of the OPT3001 IC to the register.
+    ui8Data[0] = ui8Reg;
     ui32I2CMasterStatus = I2CMasterWrite(psI2C, ui8SlaveAddr, ui8Data, 1);
-    if (ui32I2CMasterStatus) return ~0;
+    if (ui32I2CMasterStatus) return ui32I2CMasterStatus;
 
-    // Read the manufacturer ID register.
+    // Read the register.
     ui32I2CMasterStatus = I2CMasterRead(psI2C, ui8SlaveAddr, ui8Data, 2);
-    if (ui32I2CMasterStatus) return ~0;
+    if (ui32I2CMasterStatus) return ui32I2CMasterStatus;
 
-    // Calculate the manufacturer ID.
-    ui32ManufacturerId = (uint32_t) (ui8Data[0] << 8) | (ui8Data[1]);
+    *pui16Value = (uint16_t) (ui8Data[0] << 8) | ui8Data[1];
 
-    return ui32ManufacturerId;
+    return 0;
 }
 
 
 
-// Read the device ID from the OPT3001 sensor IC.
-uint32_t I2COpt3001ReadDeviceId(tI2C *psI2C, uint8_t ui8SlaveAddr)
+// Convert the raw value of the result register.
+// Returns the light illuminance in 1/100 lux.
+uint32_t I2COpt3001IlluminanceConv(uint16_t ui16Raw)
 {
-    uint8_t ui8Data[2];
+    // The register holds a 12 bit mantissa with 0.01 lux per LSB and a 4 bit
+    // exponent. So the result is exact in units of 0.01 lux.
+    return (uint32_t) (ui16Raw & 0x0fff) << (ui16Raw >> 12);
+}
+
+
+
+// Read the light illuminance from the OPT3001 sensor IC.
+// The light illuminance is returned in 1/100 lux. Returns the I2C master
+// status.
+uint32_t I2COpt3001ReadIlluminanceFixed(tI2C *psI2C, uint8_t ui8SlaveAddr, uint32_t *pui32Illuminance)
+{
+    uint16_t ui16Raw;
     uint32_t ui32I2CMasterStatus;
-    uint32_t ui32DeviceID;
 
-    // Set the pointer register of the OPT3001 IC to the device ID register (0x7f).
-    ui8Data[0] = 0x7f;
-    ui32I2CMasterStatus = I2CMasterWrite(psI2C, ui8SlaveAddr, ui8Data, 1);
-    if (ui32I2CMasterStatus) return ~0;
+    ui32I2CMasterStatus = I2COpt3001ReadReg(psI2C, ui8SlaveAddr, I2C_OPT3001_REG_RESULT, &ui16Raw);
+    if (ui32I2CMasterStatus) return ui32I2CMasterStatus;
+    *pui32Illuminance = I2COpt3001IlluminanceConv(ui16Raw);
 
-    // Read the device ID register.
-    ui32I2CMasterStatus = I2CMasterRead(psI2C, ui8SlaveAddr, ui8Data, 2);
-    if (ui32I2CMasterStatus) return ~0;
+    return 0;
+}
 
-    // Calculate the device ID.
-    ui32DeviceID = (uint32_t) (ui8Data[0] << 8) | (ui8Data[1]);
 
-    return ui32DeviceID;
+
+// Read the light illuminance from the OPT3001 sensor IC.
+// Returns the light illuminance in lux.
+float I2COpt3001ReadIlluminance(tI2C *psI2C, uint8_t ui8SlaveAddr)
+{
+    uint32_t ui32Illuminance;
+
+    if (I2COpt3001ReadIlluminanceFixed(psI2C, ui8SlaveAddr, &ui32Illuminance)) return -255;
+
+    return (float) ui32Illuminance / 100;
+}
+
+
+
+// Read the manufacturer ID from the OPT3001 sensor IC.
+uint32_t I2COpt3001ReadManufacturerId(tI2C *psI2C, uint8_t ui8SlaveAddr)
+{
+    uint16_t ui16ManufacturerId;
+
+    // Manufacturer ID register (0x7e).
+    if (I2COpt3001ReadReg(psI2C, ui8SlaveAddr, 0x7e, &ui16ManufacturerId)) return ~0;
+
+    return ui16ManufacturerId;
 }
 
+
+
+// Read the device ID from the OPT3001 sensor IC.
+uint32_t I2COpt3001ReadDeviceId(tI2C *psI2C, uint8_t ui8SlaveAddr)
+{
+    uint16_t ui16DeviceId;
+
+    // Device ID register (0x7f).
+    if (I2COpt3001ReadReg(psI2C, ui8SlaveAddr, 0x7f, &ui16DeviceId)) return ~0;
+
+    return ui16DeviceId;
+}
@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 13 Feb 2020
-// Rev.: 04 Apr 2020
+// Rev.: 17 Oct 2026
 //
 // Header file for the I2C functions for the OPT3001 ambient light sensor on
 // the Educational BoosterPack MK II connected to the TI Tiva TM4C1294
@@ -16,9 +16,19 @@
 
 
 
+// OPT3001 registers.
+#define I2C_OPT3001_REG_RESULT  0x00
+#define I2C_OPT3001_REG_CONFIG  0x01
+
+
+
 // Function prototypes.
 uint32_t I2COpt3001Reset(tI2C *psI2C, uint8_t ui8SlaveAddr);
 uint32_t I2COpt3001Init(tI2C *psI2C, uint8_t ui8SlaveAddr);
+uint32_t I2COpt3001InitStream(tI2C *psI2C, uint8_t ui8SlaveAddr);
+uint32_t I2COpt3001ReadReg(tI2C *psI2C, uint8_t ui8SlaveAddr, uint8_t ui8Reg, uint16_t *pui16Value);
+uint32_t I2COpt3001IlluminanceConv(uint16_t ui16Raw);
+uint32_t I2COpt3001ReadIlluminanceFixed(tI2C *psI2C, uint8_t ui8SlaveAddr, uint32_t *pui32Illuminance);
 float I2COpt3001ReadIlluminance(tI2C *psI2C, uint8_t ui8SlaveAddr);
 uint32_t I2COpt3001ReadManufacturerId(tI2C *psI2C, uint8_t ui8SlaveAddr);
 uint32_t I2COpt3001ReadDeviceId(tI2C *psI2C, uint8_t ui8SlaveAddr);
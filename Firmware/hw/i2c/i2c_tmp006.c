@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 12 Feb 2020
-// Rev.: 11 Apr 2020
+// Rev.: 17 Oct 2026
 //
 // I2C functions for the TMP006 temperature sensor on the Educational
 // BoosterPack MK II connected to the TI Tiva TM4C1294 Connected LaunchPad
@@ -17,6 +17,27 @@
 #include "driverlib/i2c.h"
 #include "driverlib/sysctl.h"
 #include "i2c.h"
+#include "i2c_tmp006.h"
+
+
+
+// Coefficients of the object temperature calculation from the TMP006 user's
+// guide (SBOU107) in fixed point. The temperature difference to the reference
+// temperature of 25 *C has I2C_TMP006_TEMP_FRAC_BITS fractional bits.
+#define I2C_TMP006_TREF             (25 << I2C_TMP006_TEMP_FRAC_BITS)
+#define I2C_TMP006_TKELVIN          8741        // 273.15 K with 5 fractional bits.
+#define I2C_TMP006_A1               1879048     // 1.75e-3 with 30 fractional bits.
+#define I2C_TMP006_A2               -18017      // -1.678e-5 with 30 fractional bits.
+#define I2C_TMP006_B0               -29400000   // -2.94e-5 V in pV.
+#define I2C_TMP006_B1               -570000     // -5.7e-7 V in pV.
+#define I2C_TMP006_B2               4630        // 4.63e-9 V in pV.
+#define I2C_TMP006_C2               134         // 13.4 in 1/10.
+#define I2C_TMP006_VOLT_LSB         156250      // 156.25 nV in pV.
+
+
+
+// Function prototypes of local functions.
+static uint32_t I2CTmp006Isqrt(uint64_t ui64Value);
 
 
 
@@ -40,96 +61,192 @@ uint32_t I2CTmp006Init(tI2C *psI2C, uint8_t ui8SlaveAddr)
 
 
 
-// Read the sensor voltage from the TMP006 sensor IC.
-// Returns the sensor voltage in nano Volts (nV).
-float I2CTmp006ReadVolt(tI2C *psI2C, uint8_t ui8SlaveAddr)
+// Initialize the TMP006 sensor IC for the maximum conversion rate (4
+// conversions per second). The DRDY pin is asserted when a conversion is done
+// and released by reading the sensor voltage or the temperature register.
+uint32_t I2CTmp006InitStream(tI2C *psI2C, uint8_t ui8SlaveAddr)
+{
+    uint8_t ui8Data[3] = {0x02, 0x71, 0x00};
+
+    return I2CMasterWrite(psI2C, ui8SlaveAddr, ui8Data, 3);
+}
+
+
+
+// Read a 16 bit register of the TMP006 sensor IC. Returns the I2C master
+// status.
+uint32_t I2CTmp006ReadReg(tI2C *psI2C, uint8_t ui8SlaveAddr, uint8_t ui8Reg, uint16_t *pui16Value)
 {
     uint8_t ui8Data[2];
     uint32_t ui32I2CMasterStatus;
-    uint32_t ui32VoltageRaw;
-    int iVoltageSign;
-    float fVoltage;
 
-    // Set the pointer register of the TMP006 IC to the sensor voltage register (0x00).
-    ui8Data[0] = 0x00;
+    // Set the pointer register of the TMP006 IC to the register.
+    ui8Data[0] = ui8Reg;
     ui32I2CMasterStatus = I2CMasterWrite(psI2C, ui8SlaveAddr, ui8Data, 1);
-    if (ui32I2CMasterStatus) return -255;
+    if (ui32I2CMasterStatus) return ui32I2CMasterStatus;
 
-    // Read the sensor voltage register.
+    // Read the register.
     ui32I2CMasterStatus = I2CMasterRead(psI2C, ui8SlaveAddr, ui8Data, 2);
-    if (ui32I2CMasterStatus) return -255;
-
-    // Calculate the sensor voltage in nano Volts (nV).
-    ui32VoltageRaw = (uint32_t) (ui8Data[0] << 8) | ui8Data[1];
-    // Negative sensor voltage.
-    if (ui32VoltageRaw & 0x8000) {
-        ui32VoltageRaw = (~ui32VoltageRaw + 1) & 0x7fff;
-        iVoltageSign = -1;
-    } else {
-        iVoltageSign = 1;
-    }
-    fVoltage = (float) ui32VoltageRaw * 156.25 * iVoltageSign;
+    if (ui32I2CMasterStatus) return ui32I2CMasterStatus;
+
+    *pui16Value = (uint16_t) (ui8Data[0] << 8) | ui8Data[1];
 
-    return fVoltage;
+    return 0;
 }
 
 
 
-// Read the temperature from the TMP006 sensor IC.
-// Returns the temperature in degree Celcius.
-float I2CTmp006ReadTemp(tI2C *psI2C, uint8_t ui8SlaveAddr)
+// Convert the raw value of the sensor voltage register.
+// Returns the sensor voltage in nano Volts (nV), rounded toward zero.
+int32_t I2CTmp006VoltConv(uint16_t ui16Raw)
 {
-    uint8_t ui8Data[2];
+    // The register holds a two's complement value with 156.25 nV per LSB.
+    return (int32_t) (int16_t) ui16Raw * 625 / 4;
+}
+
+
+
+// Convert the raw value of the temperature register.
+// Returns the temperature in degree Celcius as fixed-point value with
+// I2C_TMP006_TEMP_FRAC_BITS fractional bits (1/32 degree Celcius per LSB).
+int32_t I2CTmp006TempConv(uint16_t ui16Raw)
+{
+    // The upper 14 bits of the register hold a two's complement value with
+    // 1/32 degree Celcius per LSB.
+    return (int32_t) (int16_t) ui16Raw >> 2;
+}
+
+
+
+// Calculate the object temperature from the raw values of the sensor voltage
+// and the temperature register. The calibration factor ui32S0 is given in
+// units of 1e-17. The calculation follows the TMP006 user's guide:
+//   S = S0 * (1 + a1 * (Tdie - Tref) + a2 * (Tdie - Tref)^2)
+//   Vos = b0 + b1 * (Tdie - Tref) + b2 * (Tdie - Tref)^2
+//   f(Vobj) = (Vobj - Vos) + c2 * (Vobj - Vos)^2
+//   Tobj = (Tdie^4 + f(Vobj) / S)^(1/4)
+// It is done in 64 bit integer arithmetic. The fourth root is taken with two
+// integer square roots of Tobj^4 with 4 * I2C_TMP006_TEMP_FRAC_BITS fractional
+// bits.
+// Returns the object temperature in degree Celcius with
+// I2C_TMP006_TEMP_FRAC_BITS fractional bits or I2C_TMP006_OBJ_TEMP_INVALID.
+int32_t I2CTmp006ObjTempConv(uint16_t ui16RawVolt, uint16_t ui16RawTemp, uint32_t ui32S0)
+{
+    int64_t i64Tdie = I2CTmp006TempConv(ui16RawTemp) + I2C_TMP006_TKELVIN;
+    int64_t i64Tdiff = I2CTmp006TempConv(ui16RawTemp) - I2C_TMP006_TREF;
+    int64_t i64S, i64Vos, i64V, i64VnV, i64F, i64Tobj4;
+
+    if (!ui32S0) return I2C_TMP006_OBJ_TEMP_INVALID;
+    // S / S0 with 30 fractional bits.
+    i64S = ((int64_t) 1 << 30) + I2C_TMP006_A1 * i64Tdiff / 32 + I2C_TMP006_A2 * i64Tdiff * i64Tdiff / 1024;
+    // Vos and Vobj - Vos in pV.
+    i64Vos = I2C_TMP006_B0 + I2C_TMP006_B1 * i64Tdiff / 32 + I2C_TMP006_B2 * i64Tdiff * i64Tdiff / 1024;
+    i64V = (int64_t) (int16_t) ui16RawVolt * I2C_TMP006_VOLT_LSB - i64Vos;
+    // f(Vobj) in pV. The square is calculated in nV to avoid an overflow.
+    i64VnV = i64V / 1000;
+    i64F = i64V + i64VnV * i64VnV * I2C_TMP006_C2 / 10000000;
+    // f(Vobj) / S in K^4. S0 is in units of 1e-17, f(Vobj) in units of 1e-12.
+    i64F = i64F * 100000 / ui32S0;
+    i64F = (i64F << 16) / (i64S >> 14);
+    // Tobj^4 with 20 fractional bits.
+    i64Tobj4 = i64Tdie * i64Tdie * i64Tdie * i64Tdie + (i64F << (4 * I2C_TMP006_TEMP_FRAC_BITS));
+    if (i64Tobj4 <= 0) return I2C_TMP006_OBJ_TEMP_INVALID;
+
+    return (int32_t) I2CTmp006Isqrt(I2CTmp006Isqrt(i64Tobj4)) - I2C_TMP006_TKELVIN;
+}
+
+
+
+// Read the sensor voltage from the TMP006 sensor IC.
+// The sensor voltage is returned in nano Volts (nV). Returns the I2C master
+// status.
+uint32_t I2CTmp006ReadVoltFixed(tI2C *psI2C, uint8_t ui8SlaveAddr, int32_t *pi32Voltage)
+{
+    uint16_t ui16Raw;
     uint32_t ui32I2CMasterStatus;
-    uint32_t ui32TemperatureRaw;
-    int iTemperatureSign;
-    float fTemperature;
 
-    // Set the pointer register of the TMP006 IC to the ambient temperature register (0x01).
-    ui8Data[0] = 0x01;
-    ui32I2CMasterStatus = I2CMasterWrite(psI2C, ui8SlaveAddr, ui8Data, 1);
-    if (ui32I2CMasterStatus) return -255;
+    ui32I2CMasterStatus = I2CTmp006ReadReg(psI2C, ui8SlaveAddr, I2C_TMP006_REG_VOLT, &ui16Raw);
+    if (ui32I2CMasterStatus) return ui32I2CMasterStatus;
+    *pi32Voltage = I2CTmp006VoltConv(ui16Raw);
+
+    return 0;
+}
+
 
-    // Read the ambient temperature register.
-    ui32I2CMasterStatus = I2CMasterRead(psI2C, ui8SlaveAddr, ui8Data, 2);
-    if (ui32I2CMasterStatus) return -255;
-
-    // Calculate the temperature in degree Celcius.
-    ui32TemperatureRaw = (uint32_t) (ui8Data[0] << 6) | (ui8Data[1] >> 2);
-    // Negative temperature.
-    if (ui32TemperatureRaw & 0x2000) {
-        ui32TemperatureRaw = (~ui32TemperatureRaw + 1) & 0x1fff;
-        iTemperatureSign = -1;
-    } else {
-        iTemperatureSign = 1;
-    }
-    fTemperature = (float) ui32TemperatureRaw / 32 * iTemperatureSign;
 
-    return fTemperature;
+// Read the temperature from the TMP006 sensor IC.
+// The temperature is returned in degree Celcius with I2C_TMP006_TEMP_FRAC_BITS
+// fractional bits. Returns the I2C master status.
+uint32_t I2CTmp006ReadTempFixed(tI2C *psI2C, uint8_t ui8SlaveAddr, int32_t *pi32Temperature)
+{
+    uint16_t ui16Raw;
+    uint32_t ui32I2CMasterStatus;
+
+    ui32I2CMasterStatus = I2CTmp006ReadReg(psI2C, ui8SlaveAddr, I2C_TMP006_REG_TEMP, &ui16Raw);
+    if (ui32I2CMasterStatus) return ui32I2CMasterStatus;
+    *pi32Temperature = I2CTmp006TempConv(ui16Raw);
+
+    return 0;
 }
 
 
 
-// Read the manufacturer ID from the TMP006 sensor IC.
-uint32_t I2CTmp006ReadManufacturerId(tI2C *psI2C, uint8_t ui8SlaveAddr)
+// Read the object temperature from the TMP006 sensor IC. The calibration
+// factor ui32S0 is given in units of 1e-17.
+// The object temperature is returned in degree Celcius with
+// I2C_TMP006_TEMP_FRAC_BITS fractional bits or I2C_TMP006_OBJ_TEMP_INVALID.
+// Returns the I2C master status.
+uint32_t I2CTmp006ReadObjTempFixed(tI2C *psI2C, uint8_t ui8SlaveAddr, uint32_t ui32S0, int32_t *pi32Temperature)
 {
-    uint8_t ui8Data[2];
+    uint16_t ui16RawVolt, ui16RawTemp;
     uint32_t ui32I2CMasterStatus;
-    uint32_t manufacturerId;
 
-    // Set the pointer register of the TMP006 IC to the manufacturer ID register (0xfe).
-    ui8Data[0] = 0xfe;
-    ui32I2CMasterStatus = I2CMasterWrite(psI2C, ui8SlaveAddr, ui8Data, 1);
-    if (ui32I2CMasterStatus) return ~0;
+    ui32I2CMasterStatus = I2CTmp006ReadReg(psI2C, ui8SlaveAddr, I2C_TMP006_REG_VOLT, &ui16RawVolt);
+    if (ui32I2CMasterStatus) return ui32I2CMasterStatus;
+    ui32I2CMasterStatus = I2CTmp006ReadReg(psI2C, ui8SlaveAddr, I2C_TMP006_REG_TEMP, &ui16RawTemp);
+    if (ui32I2CMasterStatus) return ui32I2CMasterStatus;
+    *pi32Temperature = I2CTmp006ObjTempConv(ui16RawVolt, ui16RawTemp, ui32S0);
 
-    // Read the manufacturer ID register.
-    ui32I2CMasterStatus = I2CMasterRead(psI2C, ui8SlaveAddr, ui8Data, 2);
-    if (ui32I2CMasterStatus) return ~0;
+    return 0;
+}
 
-    // Calculate the manufacturer ID.
-    manufacturerId = (uint32_t) (ui8Data[0] << 8) | (ui8Data[1]);
 
-    return manufacturerId;
+
+// Read the sensor voltage from the TMP006 sensor IC.
+// Returns the sensor voltage in nano Volts (nV).
+float I2CTmp006ReadVolt(tI2C *psI2C, uint8_t ui8SlaveAddr)
+{
+    int32_t i32Voltage;
+
+    if (I2CTmp006ReadVoltFixed(psI2C, ui8SlaveAddr, &i32Voltage)) return -255;
+
+    return (float) i32Voltage;
+}
+
+
+
+// Read the temperature from the TMP006 sensor IC.
+// Returns the temperature in degree Celcius.
+float I2CTmp006ReadTemp(tI2C *psI2C, uint8_t ui8SlaveAddr)
+{
+    int32_t i32Temperature;
+
+    if (I2CTmp006ReadTempFixed(psI2C, ui8SlaveAddr, &i32Temperature)) return -255;
+
+    return (float) i32Temperature / (1 << I2C_TMP006_TEMP_FRAC_BITS);
+}
+
+
+
+// Read the manufacturer ID from the TMP006 sensor IC.
+uint32_t I2CTmp006ReadManufacturerId(tI2C *psI2C, uint8_t ui8SlaveAddr)
+{
+    uint16_t ui16ManufacturerId;
+
+    // Manufacturer ID register (0xfe).
+    if (I2CTmp006ReadReg(psI2C, ui8SlaveAddr, 0xfe, &ui16ManufacturerId)) return ~0;
+
+    return ui16ManufacturerId;
 }
 
 
@@ -137,22 +254,32 @@ uint32_t I2CTmp006ReadManufacturerId(tI2C *psI2C, uint8_t ui8SlaveAddr)
 // Read the device ID from the TMP006 sensor IC.
 uint32_t I2CTmp006ReadDeviceId(tI2C *psI2C, uint8_t ui8SlaveAddr)
 {
-    uint8_t ui8Data[2];
-    uint32_t ui32I2CMasterStatus;
-    uint32_t deviceId;
+    uint16_t ui16DeviceId;
 
-    // Set the pointer register of the TMP006 IC to the device ID register (0xff).
-    ui8Data[0] = 0xff;
-    ui32I2CMasterStatus = I2CMasterWrite(psI2C, ui8SlaveAddr, ui8Data, 1);
-    if (ui32I2CMasterStatus) return ~0;
+    // Device ID register (0xff).
+    if (I2CTmp006ReadReg(psI2C, ui8SlaveAddr, 0xff, &ui16DeviceId)) return ~0;
 
-    // Read the device ID register.
-    ui32I2CMasterStatus = I2CMasterRead(psI2C, ui8SlaveAddr, ui8Data, 2);
-    if (ui32I2CMasterStatus) return ~0;
+    return ui16DeviceId;
+}
 
-    // Calculate the device ID.
-    deviceId = (uint32_t) (ui8Data[0] << 8) | (ui8Data[1]);
 
-    return deviceId;
-}
 
+// Integer square root, rounded down.
+static uint32_t I2CTmp006Isqrt(uint64_t ui64Value)
+{
+    uint64_t ui64Root = 0;
+    uint64_t ui64Bit = (uint64_t) 1 << 62;
+
+    while (ui64Bit > ui64Value) ui64Bit >>= 2;
+    while (ui64Bit) {
+        if (ui64Value >= ui64Root + ui64Bit) {
+            ui64Value -= ui64Root + ui64Bit;
+            ui64Root = (ui64Root >> 1) + ui64Bit;
+        } else {
+            ui64Root >>= 1;
+        }
+        ui64Bit >>= 2;
+    }
+
+    return (uint32_t) ui64Root;
+}
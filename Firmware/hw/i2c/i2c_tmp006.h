@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 12 Feb 2020
-// Rev.: 04 Apr 2020
+// Rev.: 17 Oct 2026
 //
 // Header file for the I2C functions for the TMP006 temperature sensor on the
 // Educational BoosterPack MK II connected to the TI Tiva TM4C1294 Connected
@@ -20,9 +20,36 @@
 
 
 
+// TMP006 registers.
+#define I2C_TMP006_REG_VOLT     0x00    // Sensor voltage.
+#define I2C_TMP006_REG_TEMP     0x01    // Ambient temperature.
+#define I2C_TMP006_REG_CONFIG   0x02
+
+// Fractional bits of the fixed-point temperature.
+#define I2C_TMP006_TEMP_FRAC_BITS   5
+
+// Default calibration factor S0 of the object temperature in units of 1e-17
+// (6.4e-14). The TMP006 user's guide gives a range of 5e-14 to 7e-14.
+#define I2C_TMP006_S0_DEFAULT       6400
+#define I2C_TMP006_S0_MIN           1000
+#define I2C_TMP006_S0_MAX           20000
+
+// Object temperature if the sensor values are out of range.
+#define I2C_TMP006_OBJ_TEMP_INVALID INT32_MIN
+
+
+
 // Function prototypes.
 uint32_t I2CTmp006Reset(tI2C *I2C, uint8_t ui8SlaveAddr);
 uint32_t I2CTmp006Init(tI2C *psI2C, uint8_t ui8SlaveAddr);
+uint32_t I2CTmp006InitStream(tI2C *psI2C, uint8_t ui8SlaveAddr);
+uint32_t I2CTmp006ReadReg(tI2C *psI2C, uint8_t ui8SlaveAddr, uint8_t ui8Reg, uint16_t *pui16Value);
+int32_t I2CTmp006VoltConv(uint16_t ui16Raw);
+int32_t I2CTmp006TempConv(uint16_t ui16Raw);
+int32_t I2CTmp006ObjTempConv(uint16_t ui16RawVolt, uint16_t ui16RawTemp, uint32_t ui32S0);
+uint32_t I2CTmp006ReadVoltFixed(tI2C *psI2C, uint8_t ui8SlaveAddr, int32_t *pi32Voltage);
+uint32_t I2CTmp006ReadTempFixed(tI2C *psI2C, uint8_t ui8SlaveAddr, int32_t *pi32Temperature);
+uint32_t I2CTmp006ReadObjTempFixed(tI2C *psI2C, uint8_t ui8SlaveAddr, uint32_t ui32S0, int32_t *pi32Temperature);
 float I2CTmp006ReadVolt(tI2C *psI2C, uint8_t ui8SlaveAddr);
 float I2CTmp006ReadTemp(tI2C *psI2C, uint8_t ui8SlaveAddr);
 uint32_t I2CTmp006ReadManufacturerId(tI2C *psI2C, uint8_t ui8SlaveAddr);
@@ -36,24 +36,86 @@
 //
 // Modified by Gene Bogdanov 8/30/2017
 //
+// Modified by M. Fras 10/17/2026: Only flush the dirty region of the frame
+// buffer using the uDMA controller.
+//
+// Modified by M. Fras 10/17/2026: Optional double buffering. The front buffer
+// is sent to the display in the background while the back buffer is drawn.
+//
+// Modified by M. Fras 10/17/2026: Optional indexed color frame buffer with 8 or
+// 4 bits per pixel, which is expanded to RGB565 by the flush.
+//
+// Modified by M. Fras 10/17/2026: Word-wide fills and image expansion with a
+// palette translated once per call.
+//
 //*****************************************************************************
 
 #include "Crystalfontz128x128_ST7735.h"
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
 #include "grlib/grlib.h"
 #include "HAL_EK_TM4C1294XL_Crystalfontz128x128_ST7735.h"
+#include "system.h"
 
 uint8_t Lcd_Orientation;
 uint16_t Lcd_ScreenWidth, Lcd_ScreenHeigth;
 uint8_t Lcd_PenSolid, Lcd_FontSolid, Lcd_FlagRead;
 uint16_t Lcd_TouchTrim;
 
-uint16_t Lcd_buffer[LCD_VERTICAL_MAX][LCD_HORIZONTAL_MAX] = {0}; // Gene Bogdanov: LCD frame buffer in RAM
+tLcdPixel Lcd_buffer[LCD_VERTICAL_MAX][LCD_BUFFER_WIDTH] = {0}; // Gene Bogdanov: LCD frame buffer in RAM
+#ifdef LCD_DOUBLE_BUFFER
+static tLcdPixel Lcd_buffer2[LCD_VERTICAL_MAX][LCD_BUFFER_WIDTH] = {0}; // second frame buffer
+#endif
+
+// A dirty region narrower than the display is queued as one uDMA task per row
+#if HAL_LCD_TASK_MAX < LCD_VERTICAL_MAX
+#error "HAL_LCD_TASK_MAX must be at least LCD_VERTICAL_MAX."
+#endif
+
+// Frame buffer used for drawing (the back buffer with double buffering)
+tLcdPixel (*Lcd_DrawBuffer)[LCD_BUFFER_WIDTH] = Lcd_buffer;
 
+#if LCD_BUFFER_BPP != 16
+// Palette of the indexed color frame buffer (byte swapped RGB565)
+static uint16_t Lcd_Palette[LCD_PALETTE_SIZE];
+static bool Lcd_PaletteDirect = false;          // default 8 bpp palette: RGB 3-3-2
+static uint32_t Lcd_TranslateValue = 0xffffffff, Lcd_TranslateIndex = 0;
+// Image palette entries translated by PixelDrawMultiple
+static uint8_t Lcd_IndexCache[LCD_PALETTE_SIZE];
+static uint32_t Lcd_IndexValid[(LCD_PALETTE_SIZE + 31) / 32];
+// Rows expanded to RGB565 by the flush
+static uint16_t Lcd_RowBuffer[2][LCD_HORIZONTAL_MAX];
+#endif
+
+// Bounding box of the modified region of the frame buffer (empty if x0 > x1)
+static int32_t Lcd_DirtyX0 = 0, Lcd_DirtyY0 = 0;
+static int32_t Lcd_DirtyX1 = LCD_HORIZONTAL_MAX - 1, Lcd_DirtyY1 = LCD_VERTICAL_MAX - 1;
+
+// Flush statistics
+uint32_t Lcd_FlushCount = 0;
+uint32_t Lcd_FlushBytes = 0;
+uint64_t Lcd_FlushCycles = 0;
+uint32_t Lcd_FlushCyclesLast = 0;
+tPerfProbe Lcd_FlushProbe = {"lcd-flush"};
+
+// Frame statistics (time from the start of a flush until the frame is sent)
+volatile uint32_t Lcd_FrameCount = 0;
+volatile uint64_t Lcd_FrameCycles = 0;
+volatile uint32_t Lcd_FrameCyclesLast = 0;
+static uint32_t Lcd_FrameStart = 0;
+
+static inline void Crystalfontz128x128_Dirty(int32_t x0, int32_t y0, int32_t x1, int32_t y1);
 static void Crystalfontz128x128_Flush(void *pvDisplayData);
+static void Crystalfontz128x128_FrameDone(void);
 static uint32_t Crystalfontz128x128_ColorTranslate(void *pvDisplayData, uint32_t ulValue);
+#if LCD_BUFFER_BPP != 16
+static void Crystalfontz128x128_SetDefaultPalette(void);
+static void Crystalfontz128x128_FlushIndexed(tLcdPixel (*frame)[LCD_BUFFER_WIDTH],
+                                             int32_t x0, int32_t y0, int32_t x1, int32_t y1);
+#endif
 
 //*****************************************************************************
 //
@@ -100,6 +162,10 @@ void Crystalfontz128x128_Init(void)
     Lcd_FlagRead  = 0;
     Lcd_TouchTrim = 0;
 
+#if LCD_BUFFER_BPP != 16
+    Crystalfontz128x128_SetDefaultPalette();
+#endif
+    Crystalfontz128x128_Dirty(0, 0, LCD_HORIZONTAL_MAX - 1, LCD_VERTICAL_MAX - 1);
     Crystalfontz128x128_Flush(0); // Gene Bogdanov: flush the RAM buffer instead of filling LCD memory with fixed values
 
     HAL_LCD_delay(10);
@@ -185,6 +251,130 @@ void Crystalfontz128x128_SetOrientation(uint8_t orientation)
             HAL_LCD_writeData(CM_MADCTL_MX | CM_MADCTL_MV | CM_MADCTL_BGR);
             break;
     }
+    // the whole screen must be redrawn with the new orientation
+    Crystalfontz128x128_Dirty(0, 0, LCD_HORIZONTAL_MAX - 1, LCD_VERTICAL_MAX - 1);
+}
+
+
+//*****************************************************************************
+//
+//! Marks a region of the frame buffer as modified.
+//!
+//! \param x0 is the X coordinate of the upper left corner of the region.
+//! \param y0 is the Y coordinate of the upper left corner of the region.
+//! \param x1 is the X coordinate of the lower right corner of the region.
+//! \param y1 is the Y coordinate of the lower right corner of the region.
+//!
+//! This function extends the bounding box of the region which is sent to the
+//! display on the next flush. It must be called when the frame buffer is
+//! modified directly instead of using the display driver functions.  The
+//! region is clipped to the screen.  An empty or inverted region is ignored.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void Crystalfontz128x128_SetDirty(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
+{
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 > LCD_HORIZONTAL_MAX - 1) x1 = LCD_HORIZONTAL_MAX - 1;
+    if (y1 > LCD_VERTICAL_MAX - 1) y1 = LCD_VERTICAL_MAX - 1;
+    if ((x0 > x1) || (y0 > y1)) return;
+    Crystalfontz128x128_Dirty(x0, y0, x1, y1);
+}
+
+
+//*****************************************************************************
+//
+//! Extends the bounding box of the dirty region.  The empty region has its
+//! minimum coordinates beyond the screen and its maximum coordinates before
+//! the screen, so no special case is needed.  Inlined by the draw functions.
+//
+//*****************************************************************************
+static inline void Crystalfontz128x128_Dirty(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
+{
+    if (x0 < Lcd_DirtyX0) Lcd_DirtyX0 = x0;
+    if (y0 < Lcd_DirtyY0) Lcd_DirtyY0 = y0;
+    if (x1 > Lcd_DirtyX1) Lcd_DirtyX1 = x1;
+    if (y1 > Lcd_DirtyY1) Lcd_DirtyY1 = y1;
+}
+
+
+//*****************************************************************************
+//
+//! Resets the flush statistics.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void Crystalfontz128x128_ResetFlushStats(void)
+{
+    Lcd_FlushCount = 0;
+    Lcd_FlushBytes = 0;
+    Lcd_FlushCycles = 0;
+    Lcd_FlushCyclesLast = 0;
+    Lcd_FrameCount = 0;
+    Lcd_FrameCycles = 0;
+    Lcd_FrameCyclesLast = 0;
+}
+
+
+#if LCD_BUFFER_BPP == 16
+
+//*****************************************************************************
+//
+//! Translates a 24-bit RGB color to the byte swapped 5-6-5 RGB color of the
+//! frame buffer.
+//!
+//! \param rgb is the 24-bit RGB color.
+//!
+//! \return Returns the byte swapped 5-6-5 RGB color.
+//
+//*****************************************************************************
+static inline uint32_t Crystalfontz128x128_Rgb565(uint32_t rgb)
+{
+    uint32_t rgb565 = ((rgb & 0x00f80000) >> 8) | ((rgb & 0x0000fc00) >> 5) | ((rgb & 0x000000f8) >> 3);
+    return (rgb565 >> 8) | ((rgb565 << 8) & 0xff00);  // swap bytes
+}
+
+
+//*****************************************************************************
+//
+//! Fills a horizontal sequence of pixels of the frame buffer with a color.
+//!
+//! \param p is a pointer to the first pixel.
+//! \param count is the number of pixels to fill.
+//! \param value is the color of the pixels.
+//!
+//! After a single pixel to reach a word aligned address, the pixels are
+//! filled with word writes, 8 pixels per loop iteration.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static inline void Crystalfontz128x128_Fill(uint16_t *p, int32_t count, uint32_t value)
+{
+    uint32_t *pWrite;
+    uint32_t fill = value | (value << 16);
+
+    if (((uintptr_t)p & 2) && count > 0) { // starts at an odd address: fill in first pixel
+        *p++ = value;
+        count--;
+    }
+    pWrite = (uint32_t *)p;
+    for (; count >= 8; count -= 8) {
+        pWrite[0] = fill;
+        pWrite[1] = fill;
+        pWrite[2] = fill;
+        pWrite[3] = fill;
+        pWrite += 4;
+    }
+    for (; count >= 2; count -= 2) {
+        *pWrite++ = fill;
+    }
+    if (count > 0) { // fill in last pixel
+        *(uint16_t *)pWrite = value;
+    }
 }
 
 
@@ -209,7 +399,8 @@ void Crystalfontz128x128_SetOrientation(uint8_t orientation)
 static void Crystalfontz128x128_PixelDraw(void *pvDisplayData, int32_t lX, int32_t lY,
                                    uint32_t ulValue)
 {
-    Lcd_buffer[lY][lX] = ulValue;
+    Lcd_DrawBuffer[lY][lX] = ulValue;
+    Crystalfontz128x128_Dirty(lX, lY, lX, lY);
 }
 
 
@@ -244,33 +435,72 @@ static void Crystalfontz128x128_PixelDrawMultiple(void *pvDisplayData, int32_t l
                                            const uint8_t *pucData,
                                            const uint8_t *pucPalette)
 {
-    uint32_t Data, rgb, native;
-    uint16_t *pWrite = &Lcd_buffer[lY][lX]; // pointer to the write location in Lcd_buffer[]
+    uint32_t Data, Bits, i;
+    uint32_t Color[16];                         // palette translated once per call
+    uint16_t *pWrite = &Lcd_DrawBuffer[lY][lX]; // pointer to the write location in Lcd_DrawBuffer[]
+    uint32_t *pWrite32;
+
+    if (lCount <= 0) {
+        return;
+    }
+    Crystalfontz128x128_Dirty(lX, lY, lX + lCount - 1, lY);
 
     //
     // Determine how to interpret the pixel data based on the number of bits
-    // per pixel.
+    // per pixel.  Whole words of the frame buffer are written where the write
+    // location is word aligned.  The first row of an image is flagged with
+    // GRLIB_DRIVER_FLAG_NEW_IMAGE.
     //
-    switch(lBPP)
+    switch(lBPP & ~GRLIB_DRIVER_FLAG_NEW_IMAGE)
     {
         // The pixel data is in 1 bit per pixel format
         case 1:
         {
-            // Loop while there are more pixels to draw
-            while(lCount > 0)
-            {
-                // Get the next byte of image data
-                Data = *pucData++;
+            // The palette holds the 2 pre-translated colors.  Build the pixel
+            // pairs for all combinations of 2 bits; the left pixel is in the
+            // lower half word.
+            for (i = 0; i < 4; i++) {
+                Color[i] = ((uint32_t *)pucPalette)[i >> 1] | (((uint32_t *)pucPalette)[i & 1] << 16);
+            }
 
-                // Loop through the pixels in this byte of image data
-                for(; (lX0 < 8) && lCount; lX0++, lCount--)
-                {
-                    // Draw this pixel in the appropriate color
-                    *pWrite++ = ((uint32_t *)pucPalette)[(Data >> (7 - lX0)) & 1];
+            // The pixel bits are left aligned in Data, Bits is their number
+            Data = (uint32_t)*pucData++ << (24 + lX0);
+            Bits = 8 - lX0;
+
+            // Draw a single pixel to reach a word aligned write location
+            if ((uintptr_t)pWrite & 2) {
+                *pWrite++ = ((uint32_t *)pucPalette)[Data >> 31];
+                Data <<= 1;
+                Bits--;
+                lCount--;
+            }
+
+            // Draw 8 pixels with 4 word writes per byte of image data
+            pWrite32 = (uint32_t *)pWrite;
+            for (; lCount >= 8; lCount -= 8) {
+                if (Bits < 8) {
+                    Data |= (uint32_t)*pucData++ << (24 - Bits);
+                    Bits += 8;
                 }
+                pWrite32[0] = Color[Data >> 30];
+                pWrite32[1] = Color[(Data >> 28) & 3];
+                pWrite32[2] = Color[(Data >> 26) & 3];
+                pWrite32[3] = Color[(Data >> 24) & 3];
+                pWrite32 += 4;
+                Data <<= 8;
+                Bits -= 8;
+            }
 
-                // Start at the beginning of the next byte of image data
-                lX0 = 0;
+            // Draw the remaining pixels one at a time
+            pWrite = (uint16_t *)pWrite32;
+            for (; lCount; lCount--) {
+                if (!Bits) {
+                    Data = (uint32_t)*pucData++ << 24;
+                    Bits = 8;
+                }
+                *pWrite++ = ((uint32_t *)pucPalette)[Data >> 31];
+                Data <<= 1;
+                Bits--;
             }
             // The image data has been drawn
 
@@ -280,47 +510,37 @@ static void Crystalfontz128x128_PixelDrawMultiple(void *pvDisplayData, int32_t l
         // The pixel data is in 4 bit per pixel format
         case 4:
         {
-            // Loop while there are more pixels to draw.  "Duff's device" is
-            // used to jump into the middle of the loop if the first nibble of
-            // the pixel data should not be used.  Duff's device makes use of
-            // the fact that a case statement is legal anywhere within a
-            // sub-block of a switch statement.  See
-            // http://en.wikipedia.org/wiki/Duff's_device for detailed
-            // information about Duff's device.
-            switch(lX0 & 1)
-            {
-                case 0:
-
-                    while(lCount)
-                    {
-                        // Get the upper nibble of the next byte of pixel data
-                        // and extract the corresponding entry from the palette
-                        Data = (*pucData >> 4);
-                        rgb = *(uint32_t *)(pucPalette + 3*Data);
-                        native = Crystalfontz128x128_ColorTranslate(pvDisplayData, rgb);
-                        // Write to LCD screen
-                        *pWrite++ = native;
-
-                        // Decrement the count of pixels to draw
-                        lCount--;
-
-                        // See if there is another pixel to draw
-                        if(lCount)
-                        {
-                case 1:
-                            // Get the lower nibble of the next byte of pixel
-                            // data and extract the corresponding entry from
-                            // the palette
-                            Data = (*pucData++ & 15);
-                            rgb = *(uint32_t *)(pucPalette + 3*Data);
-                            native = Crystalfontz128x128_ColorTranslate(pvDisplayData, rgb);
-                            // Write to LCD screen
-                            *pWrite++ = native;
-
-                            // Decrement the count of pixels to draw
-                            lCount--;
-                        }
-                    }
+            // Translate the 16 palette entries
+            for (i = 0; i < 16; i++) {
+                Color[i] = Crystalfontz128x128_Rgb565(*(uint32_t *)(pucPalette + 3*i));
+            }
+
+            // Draw the lower nibble first if the first pixel is odd
+            if (lX0 & 1) {
+                *pWrite++ = Color[*pucData++ & 15];
+                lCount--;
+            }
+
+            // Draw 2 pixels per byte of image data
+            if (!((uintptr_t)pWrite & 2)) {
+                pWrite32 = (uint32_t *)pWrite;
+                for (; lCount >= 2; lCount -= 2) {
+                    Data = *pucData++;
+                    *pWrite32++ = Color[Data >> 4] | (Color[Data & 15] << 16);
+                }
+                pWrite = (uint16_t *)pWrite32;
+            } else {
+                for (; lCount >= 2; lCount -= 2) {
+                    Data = *pucData++;
+                    pWrite[0] = Color[Data >> 4];
+                    pWrite[1] = Color[Data & 15];
+                    pWrite += 2;
+                }
+            }
+
+            // Draw the upper nibble of the last byte
+            if (lCount) {
+                *pWrite = Color[*pucData >> 4];
             }
             // The image data has been drawn.
 
@@ -330,16 +550,20 @@ static void Crystalfontz128x128_PixelDrawMultiple(void *pvDisplayData, int32_t l
         // The pixel data is in 8 bit per pixel format
         case 8:
         {
-            // Loop while there are more pixels to draw
+            // Translate the palette entries on first use
+            uint16_t Translated[256];
+            uint32_t Valid[256 / 32] = {0};
+
             while(lCount--)
             {
-                // Get the next byte of pixel data and extract the
-                // corresponding entry from the palette
+                // Get the next byte of pixel data and translate the
+                // corresponding entry from the palette if not done yet
                 Data = *pucData++;
-                rgb = *(uint32_t *)(pucPalette + 3*Data);
-                native = Crystalfontz128x128_ColorTranslate(pvDisplayData, rgb);
-                // Write to LCD screen
-                *pWrite++ = native;
+                if (!(Valid[Data >> 5] & (1 << (Data & 31)))) {
+                    Translated[Data] = Crystalfontz128x128_Rgb565(*(uint32_t *)(pucPalette + 3*Data));
+                    Valid[Data >> 5] |= 1 << (Data & 31);
+                }
+                *pWrite++ = Translated[Data];
             }
             // The image data has been drawn
             break;
@@ -353,20 +577,7 @@ static void Crystalfontz128x128_PixelDrawMultiple(void *pvDisplayData, int32_t l
         //
         case 16:
         {
-            uint16_t usData;
-
-            // Loop while there are more pixels to draw.
-
-            while(lCount--)
-            {
-                // Get the next byte of pixel data and extract the
-                // corresponding entry from the palette
-                usData = *((uint16_t *)pucData);
-                pucData += 2;
-
-                // Translate this palette entry and write it to the screen
-                *pWrite++ = usData;
-            }
+            memcpy(pWrite, pucData, lCount * sizeof(uint16_t));
         }
     }
 }
@@ -392,22 +603,8 @@ static void Crystalfontz128x128_PixelDrawMultiple(void *pvDisplayData, int32_t l
 static void Crystalfontz128x128_LineDrawH(void *pvDisplayData, int32_t lX1, int32_t lX2,
                                    int32_t lY, uint32_t ulValue)
 {
-    if (lX1 & 1) { // starts at an odd coordinate: fill in first pixel
-        Lcd_buffer[lY][lX1] = ulValue;
-        lX1++;
-    }
-
-    if (!(lX2 & 1)) { // ends at an even coordinate: fill in last pixel
-        Lcd_buffer[lY][lX2] = ulValue;
-        lX2--;
-    }
-
-    // fill in the bulk of the line 2 pixels at a time
-    uint32_t *pWrite = (uint32_t*)&Lcd_buffer[lY][lX1]; // pointer to the start of the line
-    uint32_t fill = ulValue | (ulValue << 16);
-    for (; lX1 < lX2; lX1 += 2) {
-        *pWrite++ = fill;
-    }
+    Crystalfontz128x128_Dirty(lX1, lY, lX2, lY);
+    Crystalfontz128x128_Fill(&Lcd_DrawBuffer[lY][lX1], lX2 - lX1 + 1, ulValue);
 }
 
 
@@ -431,9 +628,11 @@ static void Crystalfontz128x128_LineDrawH(void *pvDisplayData, int32_t lX1, int3
 static void Crystalfontz128x128_LineDrawV(void *pvDisplayData, int32_t lX, int32_t lY1,
                                    int32_t lY2, uint32_t ulValue)
 {
+    Crystalfontz128x128_Dirty(lX, lY1, lX, lY2);
+
     // fill the line
     for (; lY1 <= lY2; lY1++) {
-        Lcd_buffer[lY1][lX] = ulValue;
+        Lcd_DrawBuffer[lY1][lX] = ulValue;
     }
 }
 
@@ -462,29 +661,12 @@ static void Crystalfontz128x128_RectFill(void *pvDisplayData, const tRectangle *
     int32_t lX2 = pRect->i16XMax;
     int32_t lY1 = pRect->i16YMin;
     int32_t lY2 = pRect->i16YMax;
-    uint32_t i;
-    if (lX1 & 1) { // starts at an odd coordinate: fill in first column
-        for (i = lY1; i <= lY2; i++) {
-            Lcd_buffer[i][lX1] = ulValue;
-        }
-        lX1++;
-    }
 
-    if (!(lX2 & 1)) { // ends at an even coordinate: fill in last column
-        for (i = lY1; i <= lY2; i++) {
-            Lcd_buffer[i][lX2] = ulValue;
-        }
-        lX2--;
-    }
+    Crystalfontz128x128_Dirty(lX1, lY1, lX2, lY2);
 
-    // fill the bulk of the rectangle
-    uint32_t fill = ulValue | (ulValue << 16);
+    // fill the rectangle line by line
     for (; lY1 <= lY2; lY1++) {
-        // fill 2 pixels at a time
-        uint32_t *pWrite = (uint32_t*)&Lcd_buffer[lY1][lX1]; // pointer to the start of the line
-        for (i = lX1; i < lX2; i += 2) {
-            *pWrite++ = fill;
-        }
+        Crystalfontz128x128_Fill(&Lcd_DrawBuffer[lY1][lX1], lX2 - lX1 + 1, ulValue);
     }
 }
 
@@ -508,17 +690,367 @@ static void Crystalfontz128x128_RectFill(void *pvDisplayData, const tRectangle *
 static uint32_t Crystalfontz128x128_ColorTranslate(void *pvDisplayData,
                                     uint32_t ulValue)
 {
-    //
-    // Translate from a 24-bit RGB color to a 5-6-5 RGB color.
-    //
-    uint32_t rgb565 =
-           ((((ulValue) & 0x00f80000) >> 8) |
-            (((ulValue) & 0x0000fc00) >> 5) |
-            (((ulValue) & 0x000000f8) >> 3));
-    return (rgb565 >> 8) | ((rgb565 << 8) & 0xff00);  // swap bytes
+    return Crystalfontz128x128_Rgb565(ulValue);
 }
 
 
+#else // LCD_BUFFER_BPP != 16
+
+//*****************************************************************************
+//
+// M. Fras: Indexed color frame buffer. Each pixel is an index into a palette
+// of 256 (8 bpp) or 16 (4 bpp) colors. For 4 bpp, the upper nibble of a byte
+// holds the left pixel. The palette is kept pre-translated to the byte
+// swapped RGB565 format of the display, so the flush expands the indices with
+// a table lookup per pixel.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+//! Sets colors of the palette of the indexed color frame buffer.
+//!
+//! \param palette is a pointer to the 24-bit RGB colors.
+//! \param offset is the first palette entry to set.
+//! \param count is the number of palette entries to set.
+//!
+//! The colors of all pixels with these indices change, so the whole screen is
+//! redrawn on the next flush.  Colors are mapped to the closest palette entry
+//! after a palette has been set.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void Crystalfontz128x128_SetPalette(const uint32_t *palette, uint32_t offset, uint32_t count)
+{
+    uint32_t rgb565;
+
+    for (; count && offset < LCD_PALETTE_SIZE; count--, offset++) {
+        rgb565 = ((*palette & 0x00f80000) >> 8) | ((*palette & 0x0000fc00) >> 5) | ((*palette & 0x000000f8) >> 3);
+        Lcd_Palette[offset] = (rgb565 >> 8) | ((rgb565 << 8) & 0xff00); // swap bytes
+        palette++;
+    }
+    Lcd_PaletteDirect = false;
+    Lcd_TranslateValue = 0xffffffff; // invalidate the last translated color
+    Crystalfontz128x128_Dirty(0, 0, LCD_HORIZONTAL_MAX - 1, LCD_VERTICAL_MAX - 1);
+}
+
+
+//*****************************************************************************
+//
+//! Sets the default palette of the indexed color frame buffer.
+//!
+//! For 8 bpp, the palette holds 3 bits of red, 3 bits of green and 2 bits of
+//! blue, so colors are translated to indices without a search.  For 4 bpp,
+//! the palette holds the 16 standard VGA colors.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void Crystalfontz128x128_SetDefaultPalette(void)
+{
+#if LCD_BUFFER_BPP == 8
+    uint32_t i, rgb;
+
+    for (i = 0; i < LCD_PALETTE_SIZE; i++) {
+        rgb = (((i >> 5) * 255 / 7) << 16) | ((((i >> 2) & 7) * 255 / 7) << 8) | ((i & 3) * 255 / 3);
+        Crystalfontz128x128_SetPalette(&rgb, i, 1);
+    }
+    Lcd_PaletteDirect = true;
+#else
+    static const uint32_t vga[16] = {
+        0x000000, 0x000080, 0x008000, 0x008080, 0x800000, 0x800080, 0x808000, 0xc0c0c0,
+        0x808080, 0x0000ff, 0x00ff00, 0x00ffff, 0xff0000, 0xff00ff, 0xffff00, 0xffffff
+    };
+
+    Crystalfontz128x128_SetPalette(vga, 0, 16);
+#endif
+}
+
+
+//*****************************************************************************
+//
+//! Writes a palette index into the frame buffer.
+//
+//*****************************************************************************
+static inline void Crystalfontz128x128_IndexPut(int32_t lX, int32_t lY, uint32_t index)
+{
+#if LCD_BUFFER_BPP == 8
+    Lcd_DrawBuffer[lY][lX] = index;
+#else
+    uint8_t *pWrite = &Lcd_DrawBuffer[lY][lX >> 1];
+
+    *pWrite = (lX & 1) ? (*pWrite & 0xf0) | index : (*pWrite & 0x0f) | (index << 4);
+#endif
+}
+
+
+//*****************************************************************************
+//
+//! Fills a horizontal sequence of pixels of the frame buffer with an index.
+//
+//*****************************************************************************
+static void Crystalfontz128x128_IndexFill(int32_t lX1, int32_t lX2, int32_t lY, uint32_t index)
+{
+#if LCD_BUFFER_BPP == 8
+    memset(&Lcd_DrawBuffer[lY][lX1], index, lX2 - lX1 + 1);
+#else
+    if (lX1 & 1) { // starts at an odd coordinate: fill in first pixel
+        Crystalfontz128x128_IndexPut(lX1++, lY, index);
+    }
+    if (!(lX2 & 1) && lX2 >= lX1) { // ends at an even coordinate: fill in last pixel
+        Crystalfontz128x128_IndexPut(lX2--, lY, index);
+    }
+    // fill in the bulk of the line 2 pixels at a time
+    if (lX1 < lX2) {
+        memset(&Lcd_DrawBuffer[lY][lX1 >> 1], index * 0x11, (lX2 - lX1 + 1) >> 1);
+    }
+#endif
+}
+
+
+//*****************************************************************************
+//
+//! Translates an entry of an image palette to an index of the frame buffer
+//! palette.  Each entry is only translated once per call of PixelDrawMultiple.
+//
+//*****************************************************************************
+static inline uint32_t Crystalfontz128x128_PaletteIndex(const uint8_t *pucPalette, uint32_t entry)
+{
+    if (!(Lcd_IndexValid[entry >> 5] & (1u << (entry & 31)))) {
+        Lcd_IndexCache[entry] = Crystalfontz128x128_ColorTranslate(0, *(uint32_t *)(pucPalette + 3 * entry));
+        Lcd_IndexValid[entry >> 5] |= 1u << (entry & 31);
+    }
+    return Lcd_IndexCache[entry];
+}
+
+
+//*****************************************************************************
+//
+//! Draws a pixel on the screen (indexed color frame buffer).
+//
+//*****************************************************************************
+static void Crystalfontz128x128_PixelDraw(void *pvDisplayData, int32_t lX, int32_t lY,
+                                   uint32_t ulValue)
+{
+    Crystalfontz128x128_IndexPut(lX, lY, ulValue);
+    Crystalfontz128x128_Dirty(lX, lY, lX, lY);
+}
+
+
+//*****************************************************************************
+//
+//! Draws a horizontal sequence of pixels on the screen (indexed color frame
+//! buffer).  The colors of an image palette are translated once per call.
+//
+//*****************************************************************************
+static void Crystalfontz128x128_PixelDrawMultiple(void *pvDisplayData, int32_t lX,
+                                           int32_t lY, int32_t lX0, int32_t lCount,
+                                           int32_t lBPP,
+                                           const uint8_t *pucData,
+                                           const uint8_t *pucPalette)
+{
+    uint32_t Data, rgb565;
+
+    if (lCount <= 0) return;
+    Crystalfontz128x128_Dirty(lX, lY, lX + lCount - 1, lY);
+    memset(Lcd_IndexValid, 0, sizeof(Lcd_IndexValid));
+
+    // the first row of an image is flagged with GRLIB_DRIVER_FLAG_NEW_IMAGE
+    switch(lBPP & ~GRLIB_DRIVER_FLAG_NEW_IMAGE)
+    {
+        // 1 bpp: the palette contains pre-translated colors
+        case 1:
+            while(lCount > 0)
+            {
+                Data = *pucData++;
+                for(; (lX0 < 8) && lCount; lX0++, lCount--)
+                {
+                    Crystalfontz128x128_IndexPut(lX++, lY, ((uint32_t *)pucPalette)[(Data >> (7 - lX0)) & 1]);
+                }
+                lX0 = 0;
+            }
+            break;
+
+        // 4 bpp: the upper nibble is the left pixel
+        case 4:
+            for(lX0 &= 1; lCount; lCount--, lX0 ^= 1)
+            {
+                Data = lX0 ? (*pucData++ & 15) : (*pucData >> 4);
+                Crystalfontz128x128_IndexPut(lX++, lY, Crystalfontz128x128_PaletteIndex(pucPalette, Data));
+            }
+            break;
+
+        case 8:
+            while(lCount--)
+            {
+                Crystalfontz128x128_IndexPut(lX++, lY, Crystalfontz128x128_PaletteIndex(pucPalette, *pucData++));
+            }
+            break;
+
+        // native (byte swapped RGB565) data
+        case 16:
+            while(lCount--)
+            {
+                rgb565 = (pucData[0] << 8) | pucData[1];
+                pucData += 2;
+                Crystalfontz128x128_IndexPut(lX++, lY, Crystalfontz128x128_ColorTranslate(pvDisplayData,
+                    ((rgb565 & 0xf800) << 8) | ((rgb565 & 0x07e0) << 5) | ((rgb565 & 0x001f) << 3)));
+            }
+            break;
+    }
+}
+
+
+//*****************************************************************************
+//
+//! Draws a horizontal line (indexed color frame buffer).
+//
+//*****************************************************************************
+static void Crystalfontz128x128_LineDrawH(void *pvDisplayData, int32_t lX1, int32_t lX2,
+                                   int32_t lY, uint32_t ulValue)
+{
+    Crystalfontz128x128_Dirty(lX1, lY, lX2, lY);
+    Crystalfontz128x128_IndexFill(lX1, lX2, lY, ulValue);
+}
+
+
+//*****************************************************************************
+//
+//! Draws a vertical line (indexed color frame buffer).
+//
+//*****************************************************************************
+static void Crystalfontz128x128_LineDrawV(void *pvDisplayData, int32_t lX, int32_t lY1,
+                                   int32_t lY2, uint32_t ulValue)
+{
+    Crystalfontz128x128_Dirty(lX, lY1, lX, lY2);
+    for (; lY1 <= lY2; lY1++) {
+        Crystalfontz128x128_IndexPut(lX, lY1, ulValue);
+    }
+}
+
+
+//*****************************************************************************
+//
+//! Fills a rectangle (indexed color frame buffer).
+//
+//*****************************************************************************
+static void Crystalfontz128x128_RectFill(void *pvDisplayData, const tRectangle *pRect,
+                                  uint32_t ulValue)
+{
+    int32_t lY;
+
+    Crystalfontz128x128_Dirty(pRect->i16XMin, pRect->i16YMin, pRect->i16XMax, pRect->i16YMax);
+    for (lY = pRect->i16YMin; lY <= pRect->i16YMax; lY++) {
+        Crystalfontz128x128_IndexFill(pRect->i16XMin, pRect->i16XMax, lY, ulValue);
+    }
+}
+
+
+//*****************************************************************************
+//
+//! Translates a 24-bit RGB color to an index of the frame buffer palette.
+//!
+//! With the default 8 bpp palette, the index is calculated directly.
+//! Otherwise, the closest palette entry is searched.  The result of the last
+//! search is remembered, as the same color is often translated repeatedly.
+//!
+//! \return Returns the palette index.
+//
+//*****************************************************************************
+static uint32_t Crystalfontz128x128_ColorTranslate(void *pvDisplayData,
+                                    uint32_t ulValue)
+{
+    uint32_t i, c, diff, best = 0, bestDiff = 0xffffffff;
+    int32_t dR, dG, dB;
+
+    ulValue &= 0x00ffffff;
+    if (Lcd_PaletteDirect) {
+        return ((ulValue >> 16) & 0xe0) | ((ulValue >> 11) & 0x1c) | ((ulValue >> 6) & 0x03);
+    }
+    if (ulValue == Lcd_TranslateValue) return Lcd_TranslateIndex;
+
+    for (i = 0; i < LCD_PALETTE_SIZE && bestDiff; i++) {
+        c = (Lcd_Palette[i] >> 8) | ((Lcd_Palette[i] << 8) & 0xff00); // undo the byte swap
+        dR = ((c >> 8) & 0xf8) - ((ulValue >> 16) & 0xf8);
+        dG = ((c >> 3) & 0xfc) - ((ulValue >> 8) & 0xfc);
+        dB = ((c << 3) & 0xf8) - (ulValue & 0xf8);
+        diff = dR * dR + dG * dG + dB * dB;
+        if (diff < bestDiff) {
+            bestDiff = diff;
+            best = i;
+        }
+    }
+    Lcd_TranslateValue = ulValue;
+    Lcd_TranslateIndex = best;
+
+    return best;
+}
+
+
+//*****************************************************************************
+//
+//! Sends the dirty region of the indexed color frame buffer to the display.
+//!
+//! Each row is expanded to RGB565 into one of two row buffers, while the
+//! previous row is sent from the other one by the uDMA controller.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void Crystalfontz128x128_FlushIndexed(tLcdPixel (*frame)[LCD_BUFFER_WIDTH],
+                                             int32_t x0, int32_t y0, int32_t x1, int32_t y1)
+{
+    uint32_t width = x1 - x0 + 1;
+    uint32_t half = 0;
+    uint32_t n;
+    const uint8_t *pRead;
+    uint16_t *pWrite;
+    int32_t y;
+
+    for (y = y0; y <= y1; y++, half ^= 1) {
+        pWrite = Lcd_RowBuffer[half];
+        n = width;
+#if LCD_BUFFER_BPP == 8
+        pRead = &frame[y][x0];
+        for (; n >= 4; n -= 4) {
+            pWrite[0] = Lcd_Palette[pRead[0]];
+            pWrite[1] = Lcd_Palette[pRead[1]];
+            pWrite[2] = Lcd_Palette[pRead[2]];
+            pWrite[3] = Lcd_Palette[pRead[3]];
+            pWrite += 4;
+            pRead += 4;
+        }
+        while (n--) {
+            *pWrite++ = Lcd_Palette[*pRead++];
+        }
+#else
+        pRead = &frame[y][x0 >> 1];
+        if (x0 & 1) {
+            *pWrite++ = Lcd_Palette[*pRead++ & 15];
+            n--;
+        }
+        for (; n >= 2; n -= 2) {
+            uint32_t Data = *pRead++;
+            pWrite[0] = Lcd_Palette[Data >> 4];
+            pWrite[1] = Lcd_Palette[Data & 15];
+            pWrite += 2;
+        }
+        if (n) {
+            *pWrite = Lcd_Palette[*pRead >> 4];
+        }
+#endif
+        // send the row when the previous one has left the other row buffer
+        while (HAL_LCD_busy());
+        HAL_LCD_queueData((const uint8_t *)Lcd_RowBuffer[half], width * sizeof(uint16_t));
+        HAL_LCD_startQueue(y == y1 ? Crystalfontz128x128_FrameDone : 0);
+    }
+    HAL_LCD_waitIdle();
+}
+
+#endif // LCD_BUFFER_BPP
+
+
 //*****************************************************************************
 //
 //! Flushes any cached drawing operations.
@@ -532,23 +1064,138 @@ static uint32_t Crystalfontz128x128_ColorTranslate(void *pvDisplayData,
 //!
 //! Gene Bogdanov: Added local frame buffer.
 //!
+//! M. Fras: Only the dirty region of the frame buffer is sent to the display.
+//! With double buffering, the flush swaps the buffers and returns while the
+//! frame is being sent.
+//!
 //! \return None.
 //
 //*****************************************************************************
 static void
 Crystalfontz128x128_Flush(void *pvDisplayData)
 {
-    Crystalfontz128x128_SetDrawFrame(0, 0, LCD_HORIZONTAL_MAX-1, LCD_VERTICAL_MAX-1);
+    Crystalfontz128x128_Swap(false);
+}
+
+
+#if LCD_BUFFER_BPP == 16
+//*****************************************************************************
+//
+// Queues a block of the frame buffer for the asynchronous transfer.  If the
+// task list is full, the queued data and the block are sent blocking instead.
+//
+//*****************************************************************************
+static void
+Crystalfontz128x128_QueueData(const uint8_t *data, uint32_t length)
+{
+    if (!HAL_LCD_queueData(data, length)) {
+        HAL_LCD_startQueue(0);
+        HAL_LCD_waitIdle();
+        HAL_LCD_writeDataBulk(data, length);
+    }
+}
+#endif // LCD_BUFFER_BPP
+
+
+//*****************************************************************************
+//
+//! Sends the dirty region of the frame buffer to the display.
+//!
+//! \param sync selects whether the function waits until the frame has been
+//! sent completely.
+//!
+//! Without double buffering, the frame buffer must not be modified while it is
+//! sent, so the function always waits.  With double buffering, the back buffer
+//! becomes the front buffer, which is sent by the uDMA controller in the
+//! background, and drawing continues in the other buffer.  A frame is only
+//! started after the previous one has been sent completely, so the display
+//! never shows a mix of two frames.  The sync option additionally waits until
+//! the new frame is on the display.
+//!
+//! \return None.
+//
+//*****************************************************************************
+void Crystalfontz128x128_Swap(bool sync)
+{
+    int32_t x0 = Lcd_DirtyX0, y0 = Lcd_DirtyY0;
+    int32_t x1 = Lcd_DirtyX1, y1 = Lcd_DirtyY1;
+    uint32_t rowBytes = (x1 - x0 + 1) * sizeof(uint16_t); // RGB565 pixels sent
+    tLcdPixel (*frame)[LCD_BUFFER_WIDTH] = Lcd_DrawBuffer;
+    uint32_t cycles = CycleCounterGet();
+
+    if (x0 > x1) { // nothing to do
+        if (sync) HAL_LCD_waitIdle();
+        return;
+    }
+
+    // M. Fras: Only send the dirty region using the uDMA controller. Setting
+    // the draw frame waits until the previous frame has been sent.
+    Crystalfontz128x128_SetDrawFrame(x0, y0, x1, y1);
     HAL_LCD_writeCommand(CM_RAMWR);
-    int i;
-    uint16_t *pRead = &Lcd_buffer[0][0];
-    uint32_t data;
-    for (i = 0; i < LCD_HORIZONTAL_MAX * LCD_VERTICAL_MAX; i++)
-    {
-        data = *pRead++;
-        HAL_LCD_writeData((uint8_t)data);
-        HAL_LCD_writeData((uint8_t)(data >> 8));
+#if LCD_BUFFER_BPP != 16
+    Lcd_FrameStart = CycleCounterGet();
+    Crystalfontz128x128_FlushIndexed(frame, x0, y0, x1, y1);
+#else
+    if (rowBytes == sizeof(Lcd_buffer[0])) { // full rows are contiguous in memory
+        Crystalfontz128x128_QueueData((const uint8_t *)&frame[y0][0], rowBytes * (y1 - y0 + 1));
+    } else {
+        for (int32_t y = y0; y <= y1; y++) {
+            Crystalfontz128x128_QueueData((const uint8_t *)&frame[y][x0], rowBytes);
+        }
     }
+    Lcd_FrameStart = CycleCounterGet();
+    HAL_LCD_startQueue(Crystalfontz128x128_FrameDone);
+
+#ifdef LCD_DOUBLE_BUFFER
+    // Continue drawing in the other buffer. It lacks the dirty region of the
+    // frame being sent, so copy it.
+    Lcd_DrawBuffer = (frame == Lcd_buffer) ? Lcd_buffer2 : Lcd_buffer;
+    if (rowBytes == sizeof(Lcd_buffer[0])) {
+        memcpy(&Lcd_DrawBuffer[y0][0], &frame[y0][0], rowBytes * (y1 - y0 + 1));
+    } else {
+        for (int32_t y = y0; y <= y1; y++) {
+            memcpy(&Lcd_DrawBuffer[y][x0], &frame[y][x0], rowBytes);
+        }
+    }
+    if (sync) HAL_LCD_waitIdle();
+#else
+    HAL_LCD_waitIdle();
+#endif
+#endif // LCD_BUFFER_BPP
+
+    // mark the frame buffer as clean
+    Lcd_DirtyX0 = LCD_HORIZONTAL_MAX;
+    Lcd_DirtyY0 = LCD_VERTICAL_MAX;
+    Lcd_DirtyX1 = -1;
+    Lcd_DirtyY1 = -1;
+
+    // update the statistics
+    cycles = CycleCounterGet() - cycles;
+    Lcd_FlushCount++;
+    Lcd_FlushBytes += rowBytes * (y1 - y0 + 1);
+    Lcd_FlushCycles += cycles;
+    Lcd_FlushCyclesLast = cycles;
+    PerfProbeUpdate(&Lcd_FlushProbe, cycles);
+}
+
+
+//*****************************************************************************
+//
+//! Updates the frame statistics when a frame has been sent.
+//!
+//! This function is called by the hardware abstraction layer, possibly from
+//! the SSI interrupt handler.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void Crystalfontz128x128_FrameDone(void)
+{
+    uint32_t cycles = CycleCounterGet() - Lcd_FrameStart;
+
+    Lcd_FrameCount++;
+    Lcd_FrameCycles += cycles;
+    Lcd_FrameCyclesLast = cycles;
 }
 
 
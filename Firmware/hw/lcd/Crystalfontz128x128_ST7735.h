@@ -45,11 +45,31 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "grlib/grlib.h"
+#include "perf.h"
 
 // LCD Screen Dimensions
 #define LCD_VERTICAL_MAX                   128
 #define LCD_HORIZONTAL_MAX                 128
 
+// Frame buffer format: 16 bits per pixel (RGB565) or 8 or 4 bits per pixel
+// (indices into a palette)
+#ifndef LCD_BUFFER_BPP
+#define LCD_BUFFER_BPP                     16
+#endif
+#if LCD_BUFFER_BPP == 16
+typedef uint16_t tLcdPixel;
+#elif (LCD_BUFFER_BPP == 8) || (LCD_BUFFER_BPP == 4)
+typedef uint8_t tLcdPixel;
+#define LCD_PALETTE_SIZE                   (1 << LCD_BUFFER_BPP)
+#else
+#error "LCD_BUFFER_BPP must be 16, 8 or 4."
+#endif
+#if defined(LCD_DOUBLE_BUFFER) && (LCD_BUFFER_BPP != 16)
+#error "Double buffering requires LCD_BUFFER_BPP = 16."
+#endif
+// Number of tLcdPixel elements per row of the frame buffer
+#define LCD_BUFFER_WIDTH                   (LCD_HORIZONTAL_MAX * LCD_BUFFER_BPP / (8 * sizeof(tLcdPixel)))
+
 #define LCD_ORIENTATION_UP    0
 #define LCD_ORIENTATION_LEFT  1
 #define LCD_ORIENTATION_DOWN  2
@@ -99,7 +119,20 @@ extern uint16_t Lcd_ScreenWidth, Lcd_ScreenHeigth;
 extern uint8_t Lcd_PenSolid, Lcd_FontSolid, Lcd_FlagRead;
 extern uint16_t Lcd_TouchTrim;
 
-extern uint16_t Lcd_buffer[LCD_VERTICAL_MAX][LCD_HORIZONTAL_MAX];
+extern tLcdPixel Lcd_buffer[LCD_VERTICAL_MAX][LCD_BUFFER_WIDTH];
+extern tLcdPixel (*Lcd_DrawBuffer)[LCD_BUFFER_WIDTH];
+
+// Flush statistics
+extern uint32_t Lcd_FlushCount;
+extern uint32_t Lcd_FlushBytes;
+extern uint64_t Lcd_FlushCycles;
+extern uint32_t Lcd_FlushCyclesLast;
+extern tPerfProbe Lcd_FlushProbe;
+
+// Frame statistics
+extern volatile uint32_t Lcd_FrameCount;
+extern volatile uint64_t Lcd_FrameCycles;
+extern volatile uint32_t Lcd_FrameCyclesLast;
 
 extern const tDisplay g_sCrystalfontz128x128;
 
@@ -109,6 +142,16 @@ extern void Crystalfontz128x128_SetDrawFrame(uint32_t x0, uint32_t y0, uint32_t
 
 extern void Crystalfontz128x128_SetOrientation(uint8_t orientation);
 
+extern void Crystalfontz128x128_SetDirty(int32_t x0, int32_t y0, int32_t x1, int32_t y1);
+
+extern void Crystalfontz128x128_ResetFlushStats(void);
+
+extern void Crystalfontz128x128_Swap(bool sync);
+
+#if LCD_BUFFER_BPP != 16
+extern void Crystalfontz128x128_SetPalette(const uint32_t *palette, uint32_t offset, uint32_t count);
+#endif
+
 
 
 #endif /* __CRYSTALFONTZLCD_H__ */
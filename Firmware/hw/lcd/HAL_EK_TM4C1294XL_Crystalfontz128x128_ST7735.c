@@ -37,6 +37,9 @@
 //
 // Ported by Gene Bogdanov 8/30/2017
 //
+// Modified by M. Fras 10/17/2026: Send bulk data asynchronously with a uDMA
+// peripheral scatter-gather task list.
+//
 //*****************************************************************************
 
 
@@ -45,10 +48,23 @@
 #include "HAL_EK_TM4C1294XL_Crystalfontz128x128_ST7735.h"
 #include "grlib/grlib.h"
 #include "inc/hw_memmap.h"
+#include "inc/hw_ssi.h"
+#include "inc/hw_udma.h"
 #include "driverlib/gpio.h"
+#include "driverlib/interrupt.h"
 #include "driverlib/ssi.h"
 #include "driverlib/sysctl.h"
 #include "driverlib/pin_map.h"
+#include "driverlib/udma.h"
+#include "udma.h"
+
+// task list of the asynchronous bulk data transfer
+static tDMAControlTable HAL_LCD_taskList[HAL_LCD_TASK_MAX];
+static uint32_t HAL_LCD_taskCount = 0;
+static volatile bool HAL_LCD_asyncBusy = false;
+static void (*HAL_LCD_asyncDone)(void) = 0;
+
+static void HAL_LCD_asyncCheck(void);
 
 void HAL_LCD_PortInit(void)
 {
@@ -82,6 +98,11 @@ void HAL_LCD_SpiInit(void)
     SSIConfigSetExpClk(LCD_SSI_BASE, LCD_SYSTEM_CLOCK, LCD_SSI_PROTOCOL, SSI_MODE_MASTER, LCD_SSI_CLOCK, LCD_SSI_DATA_WIDTH);
     SSIEnable(LCD_SSI_BASE);
 
+    // set up the uDMA channel for bulk data transfers
+    UdmaInit();
+    uDMAChannelAssign(LCD_SSI_UDMA_CHANNEL);
+    uDMAChannelAttributeDisable(UDMA_CHANNEL_NUM(LCD_SSI_UDMA_CHANNEL), UDMA_ATTR_ALL);
+
     // set outputs to default state
     GPIOPinWrite(LCD_CS_BASE, LCD_CS_PIN, 0);
     GPIOPinWrite(LCD_DC_BASE, LCD_DC_PIN, LCD_DC_PIN);
@@ -102,13 +123,14 @@ void HAL_LCD_SpiInit(void)
 //*****************************************************************************
 //
 // Writes a command to the CFAF128128B-0145T.  This function implements the basic SPI
-// interface to the LCD display.
+// interface to the LCD display.  An asynchronous bulk data transfer is finished
+// before.
 //
 //*****************************************************************************
 void HAL_LCD_writeCommand(uint8_t command)
 {
     // Set to command mode
-    while (SSIBusy(LCD_SSI_BASE)); // finish any transmission
+    HAL_LCD_waitIdle(); // finish any transmission
     GPIOPinWrite(LCD_DC_BASE, LCD_DC_PIN, 0);
 
     // Transmit data
@@ -131,3 +153,151 @@ void HAL_LCD_writeData(uint8_t data)
     // Transmit data
     SSIDataPut(LCD_SSI_BASE, data); // returns before data finishes transmitting
 }
+
+
+//*****************************************************************************
+//
+// Writes a block of data to the CFAF128128B-0145T using the uDMA controller.
+// This function returns after the data finished transmitting.
+//
+//*****************************************************************************
+void HAL_LCD_writeDataBulk(const uint8_t *data, uint32_t length)
+{
+    uint32_t count;
+
+    while (length) {
+        count = (length > UDMA_XFER_SIZE_MAX) ? UDMA_XFER_SIZE_MAX : length;
+        if (!HAL_LCD_queueData(data, count)) { // task list full: send it first
+            HAL_LCD_startQueue(0);
+            HAL_LCD_waitIdle();
+            continue;
+        }
+        data += count;
+        length -= count;
+    }
+    HAL_LCD_startQueue(0);
+    HAL_LCD_waitIdle();
+}
+
+
+//*****************************************************************************
+//
+// Appends a block of data to the task list of the next asynchronous transfer.
+// The block is split into parts of at most UDMA_XFER_SIZE_MAX bytes.  Returns
+// false if the task list is full.  Must not be called while an asynchronous
+// transfer is in progress.
+//
+//*****************************************************************************
+bool HAL_LCD_queueData(const uint8_t *data, uint32_t length)
+{
+    uint32_t count;
+
+    if (HAL_LCD_taskCount + (length + UDMA_XFER_SIZE_MAX - 1) / UDMA_XFER_SIZE_MAX > HAL_LCD_TASK_MAX) {
+        return false;
+    }
+    while (length) {
+        count = (length > UDMA_XFER_SIZE_MAX) ? UDMA_XFER_SIZE_MAX : length;
+        HAL_LCD_taskList[HAL_LCD_taskCount++] = (tDMAControlTable)
+            uDMATaskStructEntry(count, UDMA_SIZE_8,
+                                UDMA_SRC_INC_8, (void *)data,
+                                UDMA_DST_INC_NONE, (void *)(LCD_SSI_BASE + SSI_O_DR),
+                                UDMA_ARB_4, UDMA_MODE_PER_SCATTER_GATHER);
+        data += count;
+        length -= count;
+    }
+    return true;
+}
+
+
+//*****************************************************************************
+//
+// Starts the asynchronous transfer of the queued data.  The function returns
+// immediately.  The optional callback is called when the uDMA controller has
+// finished, either from HAL_LCD_dmaIntHandler or from polling the state.
+//
+//*****************************************************************************
+void HAL_LCD_startQueue(void (*callback)(void))
+{
+    uint32_t channel = UDMA_CHANNEL_NUM(LCD_SSI_UDMA_CHANNEL);
+    tDMAControlTable *last;
+
+    while (HAL_LCD_busy()); // the previous transfer may still fill the FIFO
+    if (!HAL_LCD_taskCount) {
+        if (callback) callback();
+        return;
+    }
+
+    // the last task switches the channel back to basic mode, which stops it
+    last = &HAL_LCD_taskList[HAL_LCD_taskCount - 1];
+    last->ui32Control = (last->ui32Control & ~UDMA_CHCTL_XFERMODE_M) | UDMA_MODE_BASIC;
+
+    HAL_LCD_asyncDone = callback;
+    HAL_LCD_asyncBusy = true;
+    SSIDMAEnable(LCD_SSI_BASE, SSI_DMA_TX);
+    uDMAChannelScatterGatherSet(channel, HAL_LCD_taskCount, HAL_LCD_taskList, 1);
+    uDMAChannelEnable(channel);
+    HAL_LCD_taskCount = 0;
+}
+
+
+//*****************************************************************************
+//
+// Returns true while an asynchronous transfer is in progress.
+//
+//*****************************************************************************
+bool HAL_LCD_busy(void)
+{
+    HAL_LCD_asyncCheck();
+    return HAL_LCD_asyncBusy;
+}
+
+
+//*****************************************************************************
+//
+// Waits until an asynchronous transfer has finished transmitting.
+//
+//*****************************************************************************
+void HAL_LCD_waitIdle(void)
+{
+    while (HAL_LCD_busy());
+    while (SSIBusy(LCD_SSI_BASE)); // finish transmission
+}
+
+
+//*****************************************************************************
+//
+// Must be called by the interrupt handler of the SSI, so the end of an
+// asynchronous transfer is detected without polling.  The SSI interrupt is
+// shared with the SSI master driver, which clears the interrupt status.
+//
+//*****************************************************************************
+void HAL_LCD_dmaIntHandler(void)
+{
+    HAL_LCD_asyncCheck();
+}
+
+
+//*****************************************************************************
+//
+// Finishes an asynchronous transfer once the uDMA channel has stopped.  The
+// last bytes may still be in the transmit FIFO.
+//
+//*****************************************************************************
+static void HAL_LCD_asyncCheck(void)
+{
+    uint32_t channel = UDMA_CHANNEL_NUM(LCD_SSI_UDMA_CHANNEL);
+    void (*callback)(void) = 0;
+    bool intDisabled;
+
+    if (!HAL_LCD_asyncBusy) return;
+    intDisabled = IntMasterDisable();
+    if (HAL_LCD_asyncBusy && !uDMAChannelIsEnabled(channel)) {
+        SSIDMADisable(LCD_SSI_BASE, SSI_DMA_TX);
+        // the scatter-gather transfer ends on the alternate control structure
+        uDMAChannelAttributeDisable(channel, UDMA_ATTR_ALTSELECT);
+        HAL_LCD_asyncBusy = false;
+        callback = HAL_LCD_asyncDone;
+    }
+    if (!intDisabled) IntMasterEnable();
+    if (callback) callback();
+}
@@ -42,8 +42,10 @@
 #ifndef __HAL_EK_TM4C1294XL_CRYSTALFONTZLCD_H_
 #define __HAL_EK_TM4C1294XL_CRYSTALFONTZLCD_H_
 
+#include <stdbool.h>
 #include <stdint.h>
 #include "driverlib/sysctl.h"
+#include "timebase.h"
 
 //*****************************************************************************
 //
@@ -85,6 +87,10 @@
 #define LCD_SSI_BASE        SSI3_BASE
 #define LCD_SSI_PROTOCOL    SSI_FRF_MOTO_MODE_0
 #define LCD_SSI_DATA_WIDTH  8 // bits
+#define LCD_SSI_UDMA_CHANNEL UDMA_CH15_SSI3TX // uDMA channel for bulk data transfers
+
+// Maximum number of uDMA tasks of an asynchronous transfer (one per row of the display)
+#define HAL_LCD_TASK_MAX    128
 
 //*****************************************************************************
 //
@@ -93,9 +99,15 @@
 //*****************************************************************************
 extern void HAL_LCD_writeCommand(uint8_t command);
 extern void HAL_LCD_writeData(uint8_t data);
+extern void HAL_LCD_writeDataBulk(const uint8_t *data, uint32_t length);
+extern bool HAL_LCD_queueData(const uint8_t *data, uint32_t length);
+extern void HAL_LCD_startQueue(void (*callback)(void));
+extern bool HAL_LCD_busy(void);
+extern void HAL_LCD_waitIdle(void);
+extern void HAL_LCD_dmaIntHandler(void);
 extern void HAL_LCD_PortInit(void);
 extern void HAL_LCD_SpiInit(void);
 
-#define HAL_LCD_delay(x)    SysCtlDelay((x) * 40) // delay in us
+#define HAL_LCD_delay(x)    TimebaseDelayUs(x) // delay in us
 
 #endif /* __HAL_EK_TM4C1294XL_CRYSTALFONTZLCD_H_ */
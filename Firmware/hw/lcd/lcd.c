@@ -2,17 +2,30 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 03 Apr 2020
-// Rev.: 18 Apr 2020
+// Rev.: 17 Oct 2026
 //
 // Functions for the LCD on the Educational BoosterPack MKII connected to the
 // BoosterPack 2 socket of the TI Tiva TM4C1294 Connected LaunchPad Evaluation
 // Kit.
 //
+// In batch mode, the drawing functions only update the frame buffer. It is
+// sent to the display on commit or automatically after a timeout without
+// further drawing operations. The timer interrupt only requests the
+// auto-commit, which is done by LcdBatchProcess from the main loop, so it never
+// interrupts another access to the LCD.
+//
+// Widgets may be drawn on off-screen canvases with 4 or 8 bits per pixel, which
+// need less RAM than the 16 bit frame buffer, and then copied onto the LCD.
+//
 
 
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <stddef.h>
+#include "inc/hw_memmap.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/timer.h"
 #include "utils/ustdlib.h"
 #include "Crystalfontz128x128_ST7735.h"
 #include "images.h"
@@ -20,6 +33,28 @@
 
 
 
+// Timer for the auto-commit of the batch mode.
+#define LCD_BATCH_TIMER_PERIPH      SYSCTL_PERIPH_TIMER5
+#define LCD_BATCH_TIMER_BASE        TIMER5_BASE
+
+
+
+// Global variables for the batch mode.
+static volatile bool g_bLcdBatch = false;
+static volatile bool g_bLcdBatchDue = false;
+static tContext *g_psLcdBatchContext = NULL;
+static uint32_t g_ui32LcdBatchTimeout = 0;
+static uint32_t g_ui32LcdSysClock = 0;
+
+
+
+// Function prototypes of local functions.
+static void LcdFlush(tContext *psContext);
+static void LcdBatchTimerStart(uint32_t ui32TimeoutMs);
+static void LcdBatchTimerIntHandler(void);
+
+
+
 // Initialize the LCD on the Educational BoosterPack MKII.
 void LcdInit(tContext *psContext)
 {
@@ -51,7 +86,7 @@ void LcdSetOrientation(tContext *psContext, uint8_t ui8Orientation)
     Crystalfontz128x128_SetOrientation(ui8Orientation & 0x3);
 
     // Flush any cached drawing operations.
-    GrFlush(psContext);
+    LcdFlush(psContext);
 }
 
 
@@ -70,7 +105,7 @@ void LcdClear(tContext *psContext, uint32_t ui32Color)
     GrRectFill(psContext, &sRect);
 
     // Flush any cached drawing operations.
-    GrFlush(psContext);
+    LcdFlush(psContext);
 }
 
 
@@ -86,7 +121,7 @@ void LcdDrawPixel(tContext *psContext, int32_t i32X, int32_t i32Y,
     GrLineDraw(psContext, i32X, i32Y, i32X, i32Y);
 
     // Flush any cached drawing operations.
-    GrFlush(psContext);
+    LcdFlush(psContext);
 }
 
 
@@ -102,7 +137,7 @@ void LcdDrawLine(tContext *psContext, int32_t i32X1, int32_t i32Y1,
     GrLineDraw(psContext, i32X1, i32Y1, i32X2, i32Y2);
 
     // Flush any cached drawing operations.
-    GrFlush(psContext);
+    LcdFlush(psContext);
 }
 
 
@@ -128,7 +163,7 @@ void LcdDrawRect(tContext *psContext, int16_t i16X1, int16_t i16Y1,
     }
 
     // Flush any cached drawing operations.
-    GrFlush(psContext);
+    LcdFlush(psContext);
 }
 
 
@@ -153,7 +188,7 @@ void LcdDrawCircle(tContext *psContext, int32_t i32X, int32_t i32Y,
     }
 
     // Flush any cached drawing operations.
-    GrFlush(psContext);
+    LcdFlush(psContext);
 }
 
 
@@ -173,7 +208,7 @@ void LcdDrawText(tContext *psContext, const char *pcText, int32_t i32X,
     }
 
     // Flush any cached drawing operations.
-    GrFlush(psContext);
+    LcdFlush(psContext);
 }
 
 
@@ -253,6 +288,192 @@ void LcdFwInfo(tLcdFwInfo *psLcdFwInfo)
     GrImageDraw(psContext, psLcdFwInfo->pu8ImageData, i32ImageX, psLcdFwInfo->i32ImageY);
 
     // Flush any cached drawing operations.
+    LcdFlush(psContext);
+}
+
+
+
+// Show status lines below the firmware info instead of the logo. Each line
+// should fit into the frame (17 characters).
+void LcdFwInfoStatus(tLcdFwInfo *psLcdFwInfo, const char * const *ppcLine, uint32_t ui32LineNum)
+{
+    tContext *psContext = psLcdFwInfo->psContext;
+    tRectangle sRect;
+
+    // Compose the status lines on the canvas if available.
+    if (psLcdFwInfo->psStatusCanvas) {
+        psContext = &psLcdFwInfo->psStatusCanvas->sContext;
+    }
+
+    // Clear the area of the logo.
+    GrContextForegroundSet(psContext, psLcdFwInfo->ui32ColorBackground);
+    if (psLcdFwInfo->psStatusCanvas) {
+        sRect.i16XMin = 0;
+        sRect.i16YMin = 0;
+        sRect.i16XMax = GrContextDpyWidthGet(psContext) - 1;
+        sRect.i16YMax = GrContextDpyHeightGet(psContext) - 1;
+    } else {
+        sRect.i16XMin = LCD_FRAME_PADDING + LCD_FRAME_WIDTH;
+        sRect.i16YMin = LCD_STATUS_Y;
+        sRect.i16XMax = GrContextDpyWidthGet(psContext) - 1 - (LCD_FRAME_PADDING + LCD_FRAME_WIDTH);
+        sRect.i16YMax = GrContextDpyHeightGet(psContext) - 1 - (LCD_FRAME_PADDING + LCD_FRAME_WIDTH);
+    }
+    GrRectFill(psContext, &sRect);
+
+    // Draw the status lines.
+    GrContextForegroundSet(psContext, psLcdFwInfo->ui32ColorText);
+    GrContextFontSet(psContext, &g_sFontFixed6x8);
+    for (uint32_t i = 0; i < ui32LineNum; i++) {
+        GrStringDraw(psContext, ppcLine[i], -1, sRect.i16XMin + LCD_CONTENT_PADDING,
+                     sRect.i16YMin + 4 + i * 10, false);
+    }
+
+    // Copy the canvas onto the LCD.
+    if (psLcdFwInfo->psStatusCanvas) {
+        GrImageDraw(psLcdFwInfo->psContext, psLcdFwInfo->psStatusCanvas->pui8Image,
+                    LCD_FRAME_PADDING + LCD_FRAME_WIDTH, LCD_STATUS_Y);
+    }
+
+    // Flush any cached drawing operations.
+    LcdFlush(psLcdFwInfo->psContext);
+}
+
+
+
+// Start batch mode. Drawing operations are only sent to the LCD on commit or
+// after a timeout without further drawing operations. A timeout of 0 disables
+// the auto-commit.
+void LcdBatchBegin(tContext *psContext, uint32_t ui32TimeoutMs)
+{
+    if (ui32TimeoutMs > LCD_BATCH_TIMEOUT_MAX) ui32TimeoutMs = LCD_BATCH_TIMEOUT_MAX;
+    g_psLcdBatchContext = psContext;
+    g_ui32LcdBatchTimeout = ui32TimeoutMs;
+    g_bLcdBatch = true;
+    LcdBatchTimerStart(g_ui32LcdBatchTimeout);
+}
+
+
+
+// End batch mode and send all drawing operations to the LCD.
+void LcdBatchCommit(tContext *psContext)
+{
+    g_bLcdBatch = false;
+    g_bLcdBatchDue = false;
+    TimerDisable(LCD_BATCH_TIMER_BASE, TIMER_A);
     GrFlush(psContext);
 }
 
+
+
+// Do the auto-commit of the batch mode after the timeout. Must be called from
+// the main loop.
+void LcdBatchProcess(void)
+{
+    if (!g_bLcdBatchDue) return;
+    g_bLcdBatchDue = false;
+    if (g_bLcdBatch) LcdBatchCommit(g_psLcdBatchContext);
+}
+
+
+
+// Check if batch mode is active.
+bool LcdBatchActive(void)
+{
+    return g_bLcdBatch;
+}
+
+
+
+// Send the drawing operations since the last swap to the LCD. With double
+// buffering, the frame is sent in the background and drawing continues in the
+// other frame buffer. With bSync, wait until the frame is on the display.
+void LcdSwap(tContext *psContext, bool bSync)
+{
+    Crystalfontz128x128_Swap(bSync);
+}
+
+
+
+// Initialize an off-screen canvas with 4 or 8 bits per pixel in the image
+// buffer pui8Image of ui32Size bytes. The canvas uses the first ui32PaletteNum
+// colors of the palette pui32Palette. Returns -1 if the parameters are invalid
+// or the image buffer is too small.
+int LcdCanvasInit(tLcdCanvas *psCanvas, uint8_t *pui8Image, uint32_t ui32Size,
+                  uint32_t ui32Bpp, int32_t i32Width, int32_t i32Height,
+                  uint32_t *pui32Palette, uint32_t ui32PaletteNum)
+{
+    if (ui32Bpp != 4 && ui32Bpp != 8) return -1;
+    if (i32Width <= 0 || i32Height <= 0) return -1;
+    if (ui32Size < LCD_CANVAS_SIZE(ui32Bpp, i32Width, i32Height)) return -1;
+    if (ui32PaletteNum == 0 || ui32PaletteNum > (1 << ui32Bpp)) return -1;
+
+    psCanvas->pui8Image = pui8Image;
+    if (ui32Bpp == 4) {
+        GrOffScreen4BPPInit(&psCanvas->sDisplay, pui8Image, i32Width, i32Height);
+        GrOffScreen4BPPPaletteSet(&psCanvas->sDisplay, pui32Palette, 0, ui32PaletteNum);
+    } else {
+        GrOffScreen8BPPInit(&psCanvas->sDisplay, pui8Image, i32Width, i32Height);
+        GrOffScreen8BPPPaletteSet(&psCanvas->sDisplay, pui32Palette, 0, ui32PaletteNum);
+    }
+    GrContextInit(&psCanvas->sContext, &psCanvas->sDisplay);
+    GrContextFontSet(&psCanvas->sContext, &g_sFontFixed6x8);
+
+    return 0;
+}
+
+
+
+// Copy an off-screen canvas onto the LCD.
+void LcdCanvasDraw(tContext *psContext, tLcdCanvas *psCanvas, int32_t i32X, int32_t i32Y)
+{
+    GrImageDraw(psContext, psCanvas->pui8Image, i32X, i32Y);
+    LcdFlush(psContext);
+}
+
+
+
+// Initialize the timer for the auto-commit of the batch mode.
+void LcdBatchInit(uint32_t ui32SysClock)
+{
+    g_ui32LcdSysClock = ui32SysClock;
+    SysCtlPeripheralEnable(LCD_BATCH_TIMER_PERIPH);
+    while(!SysCtlPeripheralReady(LCD_BATCH_TIMER_PERIPH));
+    TimerConfigure(LCD_BATCH_TIMER_BASE, TIMER_CFG_ONE_SHOT);
+    TimerIntRegister(LCD_BATCH_TIMER_BASE, TIMER_A, LcdBatchTimerIntHandler);
+    TimerIntEnable(LCD_BATCH_TIMER_BASE, TIMER_TIMA_TIMEOUT);
+}
+
+
+
+// Flush any cached drawing operations, unless batch mode is active.
+static void LcdFlush(tContext *psContext)
+{
+    if (g_bLcdBatch) {
+        // Restart the auto-commit timeout.
+        LcdBatchTimerStart(g_ui32LcdBatchTimeout);
+        return;
+    }
+    GrFlush(psContext);
+}
+
+
+
+// Start the auto-commit timer.
+static void LcdBatchTimerStart(uint32_t ui32TimeoutMs)
+{
+    TimerDisable(LCD_BATCH_TIMER_BASE, TIMER_A);
+    g_bLcdBatchDue = false;
+    if (!ui32TimeoutMs || !g_ui32LcdSysClock) return;
+    TimerLoadSet(LCD_BATCH_TIMER_BASE, TIMER_A, g_ui32LcdSysClock / 1000 * ui32TimeoutMs);
+    TimerEnable(LCD_BATCH_TIMER_BASE, TIMER_A);
+}
+
+
+
+// Interrupt handler of the auto-commit timer. The commit is left to
+// LcdBatchProcess.
+static void LcdBatchTimerIntHandler(void)
+{
+    TimerIntClear(LCD_BATCH_TIMER_BASE, TIMER_TIMA_TIMEOUT);
+    if (g_bLcdBatch) g_bLcdBatchDue = true;
+}
@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 03 Apr 2020
-// Rev.: 11 Apr 2020
+// Rev.: 17 Oct 2026
 //
 // Header file for the LCD on the Educational BoosterPack MKII connected to the
 // BoosterPack 2 socket of the TI Tiva TM4C1294 Connected LaunchPad Evaluation
@@ -16,6 +16,7 @@
 
 
 
+#include <stdbool.h>
 #include <stdint.h>
 #include "grlib/grlib.h"
 
@@ -25,10 +26,27 @@
 #define LCD_FRAME_PADDING           3
 #define LCD_FRAME_WIDTH             3
 #define LCD_CONTENT_PADDING         5
+#define LCD_BATCH_TIMEOUT_DEFAULT   1000        // ms
+#define LCD_BATCH_TIMEOUT_MAX       30000       // ms
+// Status area below the firmware info.
+#define LCD_STATUS_Y                70
+#define LCD_STATUS_WIDTH            116
+#define LCD_STATUS_HEIGHT           52
+
+// Size of the image buffer of an off-screen canvas with 4 or 8 bits per pixel.
+#define LCD_CANVAS_SIZE(bpp, w, h)  ((bpp) == 4 ? GrOffScreen4BPPSize(w, h) : GrOffScreen8BPPSize(w, h))
 
 
 
 // Types.
+// Off-screen canvas with a palette of 16 (4 bpp) or 256 (8 bpp) colors. Its
+// image buffer is a grlib image, which is drawn onto the LCD.
+typedef struct {
+    tDisplay        sDisplay;
+    tContext        sContext;
+    uint8_t         *pui8Image;
+} tLcdCanvas;
+
 typedef struct {
     tContext        *psContext;
     uint32_t        ui32ColorBackground;
@@ -43,6 +61,7 @@ typedef struct {
     const uint8_t   *pu8ImageData;
     int32_t         i32ImageX;
     int32_t         i32ImageY;
+    tLcdCanvas      *psStatusCanvas;    // Optional canvas for the status lines.
 } tLcdFwInfo;
 
 
@@ -63,6 +82,17 @@ void LcdDrawText(tContext *psContext, const char *pcText, int32_t i32X,
                  int32_t i32Y, uint32_t ui32Color, bool bCenter);
 void LcdFontSet(tContext *psContext, const tFont *pFnt);
 void LcdFwInfo(tLcdFwInfo *psLcdFwInfo);
+void LcdFwInfoStatus(tLcdFwInfo *psLcdFwInfo, const char * const *ppcLine, uint32_t ui32LineNum);
+void LcdBatchInit(uint32_t ui32SysClock);
+void LcdBatchBegin(tContext *psContext, uint32_t ui32TimeoutMs);
+void LcdBatchCommit(tContext *psContext);
+void LcdBatchProcess(void);
+bool LcdBatchActive(void);
+void LcdSwap(tContext *psContext, bool bSync);
+int LcdCanvasInit(tLcdCanvas *psCanvas, uint8_t *pui8Image, uint32_t ui32Size,
+                  uint32_t ui32Bpp, int32_t i32Width, int32_t i32Height,
+                  uint32_t *pui32Palette, uint32_t ui32PaletteNum);
+void LcdCanvasDraw(tContext *psContext, tLcdCanvas *psCanvas, int32_t i32X, int32_t i32Y);
 
 
 
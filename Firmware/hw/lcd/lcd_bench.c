@@ -0,0 +1,514 @@
+// File: lcd_bench.c
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 17 Oct 2026
+// Rev.: 17 Oct 2026
+//
+// Benchmark of the drawing functions of the LCD driver on the TI Tiva TM4C1294
+// Connected LaunchPad Evaluation Kit. The former drawing functions of the
+// driver, which write the images pixel by pixel and translate their palette
+// for every pixel, are kept here as reference. Both the former and the current
+// drawing functions draw fonts and images into the frame buffer. Their run
+// time is measured with the cycle counter and the frames are compared by a
+// checksum. Only the 16 bpp frame buffer is supported.
+//
+
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "grlib/grlib.h"
+#include "Crystalfontz128x128_ST7735.h"
+#include "system.h"
+#include "images.h"
+#include "lcd_bench.h"
+
+
+
+#if LCD_BUFFER_BPP == 16
+
+// Names of the benchmark cases.
+static const char * const g_ppcLcdBenchName[LCD_BENCH_NUM] = {
+    "Rectangle fill",
+    "Text fixed6x8",
+    "Text cmss14b",
+    "Image 4 bpp",
+    "Image 1 bpp",
+};
+
+// 1 bpp image of 64 x 32 pixels.
+#define LCD_BENCH_IMAGE_WIDTH       64
+#define LCD_BENCH_IMAGE_HEIGHT      32
+static uint8_t g_pui8LcdBenchImage[5 + LCD_BENCH_IMAGE_WIDTH / 8 * LCD_BENCH_IMAGE_HEIGHT];
+
+
+
+// Function prototypes of local functions.
+static uint32_t LcdBenchRun(tContext *psContext, uint32_t ui32Bench, uint32_t ui32Loops, uint32_t *pui32Cycles);
+static void LcdBenchDraw(tContext *psContext, uint32_t ui32Bench);
+static void LcdBenchRefPixelDraw(void *pvDisplayData, int32_t lX, int32_t lY,
+                                 uint32_t ulValue);
+static void LcdBenchRefPixelDrawMultiple(void *pvDisplayData, int32_t lX,
+                                         int32_t lY, int32_t lX0, int32_t lCount,
+                                         int32_t lBPP,
+                                         const uint8_t *pucData,
+                                         const uint8_t *pucPalette);
+static void LcdBenchRefLineDrawH(void *pvDisplayData, int32_t lX1, int32_t lX2,
+                                 int32_t lY, uint32_t ulValue);
+static void LcdBenchRefRectFill(void *pvDisplayData, const tRectangle *pRect,
+                                uint32_t ulValue);
+static uint32_t LcdBenchRefColorTranslate(void *pvDisplayData,
+                                          uint32_t ulValue);
+
+#endif  // LCD_BUFFER_BPP == 16
+
+
+
+// Run the benchmark cases ui32Loops times with the former and the current
+// drawing functions of the LCD driver. The results are stored in the array
+// psLcdBench of LCD_BENCH_NUM entries. The frame buffer is overwritten and
+// the last frame is shown on the LCD. Returns -1 if the frame buffer does not
+// have 16 bpp or the number of loops is invalid.
+int LcdBench(tContext *psContext, uint32_t ui32Loops, tLcdBench *psLcdBench)
+{
+#if LCD_BUFFER_BPP == 16
+    tDisplay sDisplayRef;
+    tContext sContextRef, sContextNew;
+    uint32_t ui32ChecksumRef, ui32ChecksumNew;
+
+    if (ui32Loops == 0 || ui32Loops > LCD_BENCH_LOOPS_MAX) return -1;
+
+    // Display with the former drawing functions. Drawing vertical lines has
+    // not changed.
+    sDisplayRef = g_sCrystalfontz128x128;
+    sDisplayRef.pfnPixelDraw = LcdBenchRefPixelDraw;
+    sDisplayRef.pfnPixelDrawMultiple = LcdBenchRefPixelDrawMultiple;
+    sDisplayRef.pfnLineDrawH = LcdBenchRefLineDrawH;
+    sDisplayRef.pfnRectFill = LcdBenchRefRectFill;
+    sDisplayRef.pfnColorTranslate = LcdBenchRefColorTranslate;
+    GrContextInit(&sContextRef, &sDisplayRef);
+    GrContextInit(&sContextNew, &g_sCrystalfontz128x128);
+
+    // Image with a pattern of lines and dots.
+    g_pui8LcdBenchImage[0] = IMAGE_FMT_1BPP_UNCOMP;
+    g_pui8LcdBenchImage[1] = LCD_BENCH_IMAGE_WIDTH;
+    g_pui8LcdBenchImage[2] = 0;
+    g_pui8LcdBenchImage[3] = LCD_BENCH_IMAGE_HEIGHT;
+    g_pui8LcdBenchImage[4] = 0;
+    for (uint32_t i = 5; i < sizeof(g_pui8LcdBenchImage); i++) {
+        g_pui8LcdBenchImage[i] = (i & 8) ? 0x55 << (i & 1) : i * 37;
+    }
+
+    for (uint32_t i = 0; i < LCD_BENCH_NUM; i++) {
+        psLcdBench[i].pcName = g_ppcLcdBenchName[i];
+        ui32ChecksumRef = LcdBenchRun(&sContextRef, i, ui32Loops, &psLcdBench[i].ui32CyclesOld);
+        ui32ChecksumNew = LcdBenchRun(&sContextNew, i, ui32Loops, &psLcdBench[i].ui32CyclesNew);
+        psLcdBench[i].bMatch = ui32ChecksumRef == ui32ChecksumNew;
+    }
+
+    // Show the last frame.
+    Crystalfontz128x128_SetDirty(0, 0, LCD_HORIZONTAL_MAX - 1, LCD_VERTICAL_MAX - 1);
+    GrFlush(psContext);
+
+    return 0;
+#else
+    return -1;
+#endif
+}
+
+
+
+#if LCD_BUFFER_BPP == 16
+
+// Run a benchmark case ui32Loops times on a cleared frame buffer. The cycles
+// per loop are stored in pui32Cycles. Returns the checksum of the frame buffer
+// (FNV-1a of its words).
+static uint32_t LcdBenchRun(tContext *psContext, uint32_t ui32Bench, uint32_t ui32Loops, uint32_t *pui32Cycles)
+{
+    const uint32_t *pui32Data = (const uint32_t *) Lcd_DrawBuffer;
+    uint32_t ui32Cycles;
+    uint32_t ui32Checksum = 2166136261u;
+
+    memset(Lcd_DrawBuffer, 0, LCD_VERTICAL_MAX * sizeof(*Lcd_DrawBuffer));
+    ui32Cycles = CycleCounterGet();
+    for (uint32_t i = 0; i < ui32Loops; i++) {
+        LcdBenchDraw(psContext, ui32Bench);
+    }
+    *pui32Cycles = (CycleCounterGet() - ui32Cycles) / ui32Loops;
+
+    for (uint32_t i = 0; i < LCD_VERTICAL_MAX * sizeof(*Lcd_DrawBuffer) / sizeof(uint32_t); i++) {
+        ui32Checksum = (ui32Checksum ^ pui32Data[i]) * 16777619u;
+    }
+
+    return ui32Checksum;
+}
+
+
+
+// Draw a benchmark case. Odd and even start coordinates are used, as the
+// drawing functions write whole words of the frame buffer where possible.
+static void LcdBenchDraw(tContext *psContext, uint32_t ui32Bench)
+{
+    tRectangle sRect = {1, 1, LCD_HORIZONTAL_MAX - 2, LCD_VERTICAL_MAX - 2};
+
+    switch (ui32Bench) {
+        case 0:
+            GrContextForegroundSet(psContext, ClrNavy);
+            GrRectFill(psContext, &sRect);
+            break;
+        case 1:
+            GrContextFontSet(psContext, &g_sFontFixed6x8);
+            GrContextForegroundSet(psContext, ClrWhite);
+            GrContextBackgroundSet(psContext, ClrDarkGreen);
+            for (int32_t i = 0; i < LCD_VERTICAL_MAX / 8; i++) {
+                GrStringDraw(psContext, "Quick brown fox 01234", -1, i & 1, i * 8, true);
+            }
+            break;
+        case 2:
+            GrContextFontSet(psContext, &g_sFontCmss14b);
+            GrContextForegroundSet(psContext, ClrYellow);
+            for (int32_t i = 0; i < LCD_VERTICAL_MAX / 16; i++) {
+                GrStringDraw(psContext, "Hello World 123", -1, i, i * 16, false);
+            }
+            break;
+        case 3:
+            GrImageDraw(psContext, g_pui8LogoMpp, 11, 10);
+            GrImageDraw(psContext, g_pui8LogoMpp, 10, 70);
+            break;
+        case 4:
+            GrContextForegroundSet(psContext, ClrOrange);
+            GrContextBackgroundSet(psContext, ClrBlack);
+            for (int32_t i = 0; i < 4; i++) {
+                GrImageDraw(psContext, g_pui8LcdBenchImage, (i & 1) * 61 + (i >> 1), i * LCD_BENCH_IMAGE_HEIGHT);
+            }
+            break;
+    }
+}
+
+
+
+//*****************************************************************************
+//
+// Reference: the former drawing functions of the LCD driver.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+//! Draws a pixel on the screen.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param lX is the X coordinate of the pixel.
+//! \param lY is the Y coordinate of the pixel.
+//! \param ulValue is the color of the pixel.
+//!
+//! This function sets the given pixel to a particular color. The coordinates of
+//! the pixel are assumed to be within the extents of the display.
+//!
+//! Gene Bogdanov: Added local frame buffer.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void LcdBenchRefPixelDraw(void *pvDisplayData, int32_t lX, int32_t lY,
+                                 uint32_t ulValue)
+{
+    Lcd_DrawBuffer[lY][lX] = ulValue;
+    Crystalfontz128x128_SetDirty(lX, lY, lX, lY);
+}
+
+
+//*****************************************************************************
+//
+//! Draws a horizontal sequence of pixels on the screen.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param lX is the X coordinate of the first pixel.
+//! \param lY is the Y coordinate of the first pixel.
+//! \param lX0 is sub-pixel offset within the pixel data, which is valid for 1
+//! or 4 bit per pixel formats.
+//! \param lCount is the number of pixels to draw.
+//! \param lBPP is the number of bits per pixel; must be 1, 4, or 8.
+//! \param pucData is a pointer to the pixel data.  For 1 and 4 bit per pixel
+//! formats, the most significant bit(s) represent the left-most pixel.
+//! \param pucPalette is a pointer to the palette used to draw the pixels.
+//!
+//! This function draws a horizontal sequence of pixels on the screen, using
+//! the supplied palette.  For 1 bit per pixel format, the palette contains
+//! pre-translated colors; for 4 and 8 bit per pixel formats, the palette
+//! contains 24-bit RGB values that must be translated before being written to
+//! the display.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void LcdBenchRefPixelDrawMultiple(void *pvDisplayData, int32_t lX,
+                                         int32_t lY, int32_t lX0, int32_t lCount,
+                                         int32_t lBPP,
+                                         const uint8_t *pucData,
+                                         const uint8_t *pucPalette)
+{
+    uint32_t Data, rgb, native;
+    uint16_t *pWrite = &Lcd_DrawBuffer[lY][lX]; // pointer to the write location in Lcd_DrawBuffer[]
+
+    if (lCount > 0) {
+        Crystalfontz128x128_SetDirty(lX, lY, lX + lCount - 1, lY);
+    }
+
+    //
+    // Determine how to interpret the pixel data based on the number of bits
+    // per pixel.
+    //
+    switch(lBPP)
+    {
+        // The pixel data is in 1 bit per pixel format
+        case 1:
+        {
+            // Loop while there are more pixels to draw
+            while(lCount > 0)
+            {
+                // Get the next byte of image data
+                Data = *pucData++;
+
+                // Loop through the pixels in this byte of image data
+                for(; (lX0 < 8) && lCount; lX0++, lCount--)
+                {
+                    // Draw this pixel in the appropriate color
+                    *pWrite++ = ((uint32_t *)pucPalette)[(Data >> (7 - lX0)) & 1];
+                }
+
+                // Start at the beginning of the next byte of image data
+                lX0 = 0;
+            }
+            // The image data has been drawn
+
+            break;
+        }
+
+        // The pixel data is in 4 bit per pixel format
+        case 4:
+        {
+            // Loop while there are more pixels to draw.  "Duff's device" is
+            // used to jump into the middle of the loop if the first nibble of
+            // the pixel data should not be used.  Duff's device makes use of
+            // the fact that a case statement is legal anywhere within a
+            // sub-block of a switch statement.  See
+            // http://en.wikipedia.org/wiki/Duff's_device for detailed
+            // information about Duff's device.
+            switch(lX0 & 1)
+            {
+                case 0:
+
+                    while(lCount)
+                    {
+                        // Get the upper nibble of the next byte of pixel data
+                        // and extract the corresponding entry from the palette
+                        Data = (*pucData >> 4);
+                        rgb = *(uint32_t *)(pucPalette + 3*Data);
+                        native = LcdBenchRefColorTranslate(pvDisplayData, rgb);
+                        // Write to LCD screen
+                        *pWrite++ = native;
+
+                        // Decrement the count of pixels to draw
+                        lCount--;
+
+                        // See if there is another pixel to draw
+                        if(lCount)
+                        {
+                case 1:
+                            // Get the lower nibble of the next byte of pixel
+                            // data and extract the corresponding entry from
+                            // the palette
+                            Data = (*pucData++ & 15);
+                            rgb = *(uint32_t *)(pucPalette + 3*Data);
+                            native = LcdBenchRefColorTranslate(pvDisplayData, rgb);
+                            // Write to LCD screen
+                            *pWrite++ = native;
+
+                            // Decrement the count of pixels to draw
+                            lCount--;
+                        }
+                    }
+            }
+            // The image data has been drawn.
+
+            break;
+        }
+
+        // The pixel data is in 8 bit per pixel format
+        case 8:
+        {
+            // Loop while there are more pixels to draw
+            while(lCount--)
+            {
+                // Get the next byte of pixel data and extract the
+                // corresponding entry from the palette
+                Data = *pucData++;
+                rgb = *(uint32_t *)(pucPalette + 3*Data);
+                native = LcdBenchRefColorTranslate(pvDisplayData, rgb);
+                // Write to LCD screen
+                *pWrite++ = native;
+            }
+            // The image data has been drawn
+            break;
+        }
+
+        //
+        // We are being passed data in the display's native format.  Merely
+        // write it directly to the display.  This is a special case which is
+        // not used by the graphics library but which is helpful to
+        // applications which may want to handle, for example, JPEG images.
+        //
+        case 16:
+        {
+            uint16_t usData;
+
+            // Loop while there are more pixels to draw.
+
+            while(lCount--)
+            {
+                // Get the next byte of pixel data and extract the
+                // corresponding entry from the palette
+                usData = *((uint16_t *)pucData);
+                pucData += 2;
+
+                // Translate this palette entry and write it to the screen
+                *pWrite++ = usData;
+            }
+        }
+    }
+}
+
+
+//*****************************************************************************
+//
+//! Draws a horizontal line.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param lX1 is the X coordinate of the start of the line.
+//! \param lX2 is the X coordinate of the end of the line.
+//! \param lY is the Y coordinate of the line.
+//! \param ulValue is the color of the line.
+//!
+//! This function draws a horizontal line on the display.  The coordinates of
+//! the line are assumed to be within the extents of the display.
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void LcdBenchRefLineDrawH(void *pvDisplayData, int32_t lX1, int32_t lX2,
+                                 int32_t lY, uint32_t ulValue)
+{
+    Crystalfontz128x128_SetDirty(lX1, lY, lX2, lY);
+
+    if (lX1 & 1) { // starts at an odd coordinate: fill in first pixel
+        Lcd_DrawBuffer[lY][lX1] = ulValue;
+        lX1++;
+    }
+
+    if (!(lX2 & 1)) { // ends at an even coordinate: fill in last pixel
+        Lcd_DrawBuffer[lY][lX2] = ulValue;
+        lX2--;
+    }
+
+    // fill in the bulk of the line 2 pixels at a time
+    uint32_t *pWrite = (uint32_t*)&Lcd_DrawBuffer[lY][lX1]; // pointer to the start of the line
+    uint32_t fill = ulValue | (ulValue << 16);
+    for (; lX1 < lX2; lX1 += 2) {
+        *pWrite++ = fill;
+    }
+}
+
+
+//*****************************************************************************
+//
+//! Fills a rectangle.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param pRect is a pointer to the structure describing the rectangle.
+//! \param ulValue is the color of the rectangle.
+//!
+//! This function fills a rectangle on the display.  The coordinates of the
+//! rectangle are assumed to be within the extents of the display, and the
+//! rectangle specification is fully inclusive (in other words, both sXMin and
+//! sXMax are drawn, along with sYMin and sYMax).
+//!
+//! \return None.
+//
+//*****************************************************************************
+static void LcdBenchRefRectFill(void *pvDisplayData, const tRectangle *pRect,
+                                uint32_t ulValue)
+{
+    int32_t lX1 = pRect->i16XMin;
+    int32_t lX2 = pRect->i16XMax;
+    int32_t lY1 = pRect->i16YMin;
+    int32_t lY2 = pRect->i16YMax;
+    uint32_t i;
+
+    Crystalfontz128x128_SetDirty(lX1, lY1, lX2, lY2);
+
+    if (lX1 & 1) { // starts at an odd coordinate: fill in first column
+        for (i = lY1; i <= lY2; i++) {
+            Lcd_DrawBuffer[i][lX1] = ulValue;
+        }
+        lX1++;
+    }
+
+    if (!(lX2 & 1)) { // ends at an even coordinate: fill in last column
+        for (i = lY1; i <= lY2; i++) {
+            Lcd_DrawBuffer[i][lX2] = ulValue;
+        }
+        lX2--;
+    }
+
+    // fill the bulk of the rectangle
+    uint32_t fill = ulValue | (ulValue << 16);
+    for (; lY1 <= lY2; lY1++) {
+        // fill 2 pixels at a time
+        uint32_t *pWrite = (uint32_t*)&Lcd_DrawBuffer[lY1][lX1]; // pointer to the start of the line
+        for (i = lX1; i < lX2; i += 2) {
+            *pWrite++ = fill;
+        }
+    }
+}
+
+
+//*****************************************************************************
+//
+//! Translates a 24-bit RGB color to a display driver-specific color.
+//!
+//! \param pvDisplayData is a pointer to the driver-specific data for this
+//! display driver.
+//! \param ulValue is the 24-bit RGB color.  The least-significant byte is the
+//! blue channel, the next byte is the green channel, and the third byte is the
+//! red channel.
+//!
+//! This function translates a 24-bit RGB color into a value that can be
+//! written into the display's frame buffer in order to reproduce that color,
+//! or the closest possible approximation of that color.
+//!
+//! \return Returns the display-driver specific color.
+//
+//*****************************************************************************
+static uint32_t LcdBenchRefColorTranslate(void *pvDisplayData,
+                                          uint32_t ulValue)
+{
+    //
+    // Translate from a 24-bit RGB color to a 5-6-5 RGB color.
+    //
+    uint32_t rgb565 =
+           ((((ulValue) & 0x00f80000) >> 8) |
+            (((ulValue) & 0x0000fc00) >> 5) |
+            (((ulValue) & 0x000000f8) >> 3));
+    return (rgb565 >> 8) | ((rgb565 << 8) & 0xff00);  // swap bytes
+}
+
+
+
+#endif  // LCD_BUFFER_BPP == 16
+
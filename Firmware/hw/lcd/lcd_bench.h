@@ -0,0 +1,48 @@
+// File: lcd_bench.h
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 17 Oct 2026
+// Rev.: 17 Oct 2026
+//
+// Header file for the benchmark of the drawing functions of the LCD driver on
+// the TI Tiva TM4C1294 Connected LaunchPad Evaluation Kit.
+//
+
+
+
+#ifndef __LCD_BENCH_H__
+#define __LCD_BENCH_H__
+
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "grlib/grlib.h"
+
+
+
+// Constants.
+#define LCD_BENCH_NUM               5           // Number of benchmark cases.
+#define LCD_BENCH_LOOPS_DEFAULT     100
+#define LCD_BENCH_LOOPS_MAX         1000
+
+
+
+// Types.
+// Result of a benchmark case.
+typedef struct {
+    const char      *pcName;
+    uint32_t        ui32CyclesOld;      // Cycles per loop of the former drawing functions.
+    uint32_t        ui32CyclesNew;      // Cycles per loop of the current drawing functions.
+    bool            bMatch;             // Both draw the same frame.
+} tLcdBench;
+
+
+
+// Function prototypes.
+int LcdBench(tContext *psContext, uint32_t ui32Loops, tLcdBench *psLcdBench);
+
+
+
+#endif  // __LCD_BENCH_H__
+
@@ -2,11 +2,21 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 10 Feb 2020
-// Rev.: 11 Apr 2020
+// Rev.: 17 Oct 2026
 //
 // RGB LED control using PWM functions on the TI Tiva TM4C1294 Connected
 // LaunchPad Evaluation Kit.
 //
+// The 8 bit values of the colors are converted into pulse widths by a lookup
+// table per channel, which is generated at compile time. It contains the
+// gamma correction, so the brightness changes evenly for the eye, and the
+// white balance. So a color update takes three table loads.
+//
+// Effects (fade, breathe and color ramp) run on chip. A timer interrupt
+// updates the colors at a fixed rate from precomputed tables. The PWM
+// generator (locally synchronized) and the timer take over new duty cycles
+// only at the end of a PWM period, so the output does not glitch.
+//
 
 
 
@@ -14,6 +24,7 @@
 #include <stdint.h>
 #include "inc/hw_memmap.h"
 #include "driverlib/gpio.h"
+#include "driverlib/interrupt.h"
 #include "driverlib/pin_map.h"
 #include "driverlib/pwm.h"
 #include "driverlib/sysctl.h"
@@ -22,6 +33,82 @@
 
 
 
+// Length of the breathing table. Must be a power of 2.
+#define PWM_RGB_LED_BREATHE_LEN     64
+
+// Gamma correction of a color value i (0..255). The gamma curve x^2.2 is
+// approximated by 0.8 * x^2 + 0.2 * x^3 (max. error 0.01). The result is
+// scaled to 5 * 255^3.
+#define PWM_RGB_LED_GAMMA(i)        (4 * 255 * (i) * (i) + (i) * (i) * (i))
+#define PWM_RGB_LED_GAMMA_MAX       (5 * 255 * 255 * 255)
+
+// Pulse width of a color value i with the white balance gain wb. At least 1
+// clock cycle, as the outputs do not work with a pulse width of 0.
+#define PWM_RGB_LED_PULSE(i, wb)    (((uint64_t) PWM_RGB_LED_PULSE_MAX * (wb) * PWM_RGB_LED_GAMMA(i) / \
+                                      (256ull * PWM_RGB_LED_GAMMA_MAX)) > 1 ? \
+                                     ((uint64_t) PWM_RGB_LED_PULSE_MAX * (wb) * PWM_RGB_LED_GAMMA(i) / \
+                                      (256ull * PWM_RGB_LED_GAMMA_MAX)) : 1)
+
+// Table entries of the red and green PWM outputs and the blue timer output.
+// The timer output is high from the match value to the end of the period.
+#define PWM_RGB_LED_LUT_R(i)        PWM_RGB_LED_PULSE(i, PWM_RGB_LED_WB_R)
+#define PWM_RGB_LED_LUT_G(i)        PWM_RGB_LED_PULSE(i, PWM_RGB_LED_WB_G)
+#define PWM_RGB_LED_LUT_B(i)        (PWM_RGB_LED_PERIOD - PWM_RGB_LED_PULSE(i, PWM_RGB_LED_WB_B))
+
+// Generate the 256 entries of a lookup table with the entry macro f.
+#define PWM_RGB_LED_LUT_4(f, i)     f(i), f((i) + 1), f((i) + 2), f((i) + 3)
+#define PWM_RGB_LED_LUT_16(f, i)    PWM_RGB_LED_LUT_4(f, i), PWM_RGB_LED_LUT_4(f, (i) + 4), \
+                                    PWM_RGB_LED_LUT_4(f, (i) + 8), PWM_RGB_LED_LUT_4(f, (i) + 12)
+#define PWM_RGB_LED_LUT_64(f, i)    PWM_RGB_LED_LUT_16(f, i), PWM_RGB_LED_LUT_16(f, (i) + 16), \
+                                    PWM_RGB_LED_LUT_16(f, (i) + 32), PWM_RGB_LED_LUT_16(f, (i) + 48)
+#define PWM_RGB_LED_LUT_256(f)      PWM_RGB_LED_LUT_64(f, 0), PWM_RGB_LED_LUT_64(f, 64), \
+                                    PWM_RGB_LED_LUT_64(f, 128), PWM_RGB_LED_LUT_64(f, 192)
+
+
+
+// Types.
+typedef struct {
+    volatile uint8_t ui8Effect;     // PWM_RGB_LED_FX_*
+    uint8_t  pui8Color[3];          // Current color (R, G, B).
+    uint8_t  pui8Start[3];          // Start color of a fade.
+    uint8_t  pui8Target[3];         // Target color of a fade or color of the breathing.
+    uint32_t ui32Steps;             // Updates per effect period.
+    uint32_t ui32Step;
+} tPwmRgbLedFx;
+
+
+
+// Function prototypes of local functions.
+static uint8_t PwmRgbLedCoerce(int iRgb);
+static void PwmRgbLedOutput(const uint8_t *pui8Color);
+static void PwmRgbLedFxIntHandler(void);
+
+
+
+// Pulse widths of the red and green channel and match values of the blue
+// channel for the color values 0..255.
+static const uint16_t g_ppui16PwmRgbLedLut[3][256] = {
+    {PWM_RGB_LED_LUT_256(PWM_RGB_LED_LUT_R)},
+    {PWM_RGB_LED_LUT_256(PWM_RGB_LED_LUT_G)},
+    {PWM_RGB_LED_LUT_256(PWM_RGB_LED_LUT_B)},
+};
+
+// Brightness during a breathing period: (1 - cos(x)) / 2.
+static const uint8_t g_pui8PwmRgbLedBreathe[PWM_RGB_LED_BREATHE_LEN] = {
+      0,   1,   2,   5,  10,  15,  21,  29,  37,  47,  57,  67,  79,  90, 103, 115,
+    127, 140, 152, 165, 176, 188, 198, 208, 218, 226, 234, 240, 245, 250, 253, 254,
+    255, 254, 253, 250, 245, 240, 234, 226, 218, 208, 198, 188, 176, 165, 152, 140,
+    128, 115, 103,  90,  79,  67,  57,  47,  37,  29,  21,  15,  10,   5,   2,   1,
+};
+
+
+
+// Global variables.
+static tPwmRgbLedFx g_sPwmRgbLedFx;
+static uint32_t g_ui32PwmRgbLedFxSysClock;
+
+
+
 // Initialize the PWM pins for the RGB LED on the Educational BoosterPack MK II.
 void PwmRgbLedInit(void)
 {
@@ -34,7 +121,7 @@ void PwmRgbLedInit(void)
     PWMClockSet(PWM0_BASE, PWM_SYSCLK_DIV_1);
     PWMGenConfigure(PWM0_BASE, PWM_GEN_3, PWM_GEN_MODE_DOWN | PWM_GEN_MODE_NO_SYNC);
     PWMGenPeriodSet(PWM0_BASE, PWM_GEN_3, PWM_RGB_LED_PERIOD);
-    PWMPulseWidthSet(PWM0_BASE, PWM_OUT_6, 1);
+    PWMPulseWidthSet(PWM0_BASE, PWM_OUT_6, g_ppui16PwmRgbLedLut[0][0]);
     PWMGenEnable(PWM0_BASE, PWM_GEN_3);
     PWMOutputState(PWM0_BASE, PWM_OUT_6_BIT, true);
 
@@ -46,7 +133,7 @@ void PwmRgbLedInit(void)
     PWMClockSet(PWM0_BASE, PWM_SYSCLK_DIV_1);
     PWMGenConfigure(PWM0_BASE, PWM_GEN_3, PWM_GEN_MODE_DOWN | PWM_GEN_MODE_NO_SYNC);
     PWMGenPeriodSet(PWM0_BASE, PWM_GEN_3, PWM_RGB_LED_PERIOD);
-    PWMPulseWidthSet(PWM0_BASE, PWM_OUT_7, 1);
+    PWMPulseWidthSet(PWM0_BASE, PWM_OUT_7, g_ppui16PwmRgbLedLut[1][0]);
     PWMGenEnable(PWM0_BASE, PWM_GEN_3);
     PWMOutputState(PWM0_BASE, PWM_OUT_7_BIT, true);
 
@@ -56,11 +143,13 @@ void PwmRgbLedInit(void)
     GPIOPinConfigure(GPIO_PM0_T2CCP0);
     GPIOPinTypeTimer(GPIO_PORTM_BASE, GPIO_PIN_0);
     TimerClockSourceSet(GPIO_PORTM_BASE, TIMER_CLOCK_SYSTEM);
-    TimerConfigure(TIMER2_BASE, TIMER_CFG_SPLIT_PAIR | TIMER_CFG_A_PWM);
+    // Timer B of this timer updates the effects.
+    TimerConfigure(TIMER2_BASE, TIMER_CFG_SPLIT_PAIR | TIMER_CFG_A_PWM | TIMER_CFG_B_PERIODIC);
     TimerLoadSet(TIMER2_BASE, TIMER_A, PWM_RGB_LED_PERIOD);
     TimerControlLevel(TIMER2_BASE, TIMER_A, false);
+    TimerUpdateMode(TIMER2_BASE, TIMER_A, TIMER_UP_MATCH_TIMEOUT);
     TimerEnable(TIMER2_BASE, TIMER_A);
-    TimerMatchSet(TIMER2_BASE, TIMER_A, PWM_RGB_LED_PERIOD - 1);
+    TimerMatchSet(TIMER2_BASE, TIMER_A, g_ppui16PwmRgbLedLut[2][0]);
 
     // Set the initial RGB value.
     PwmRgbLedSet(0, 0, 0);
@@ -69,23 +158,147 @@ void PwmRgbLedInit(void)
 
 
 // Coerce a RGB value.
-int PwmRgbLedCoerce(int iRgb)
+static uint8_t PwmRgbLedCoerce(int iRgb)
 {
-    int iVal = iRgb;
+    if (iRgb < 0) return 0;
+    else if (iRgb > 255) return 255;
 
-    if (iVal < 1) iVal = 1;
-    else if (iVal > 255) iVal = 255;
-
-    return iVal;
+    return iRgb;
 }
 
 
 
-// Set the RGB LED value.
+// Set the RGB LED value. A running effect is stopped.
 void PwmRgbLedSet(int iR, int iG, int iB)
 {
-    PWMPulseWidthSet(PWM0_BASE, PWM_OUT_6, PwmRgbLedCoerce(iR));
-    PWMPulseWidthSet(PWM0_BASE, PWM_OUT_7, PwmRgbLedCoerce(iG));
-    TimerMatchSet(TIMER2_BASE, TIMER_A, PWM_RGB_LED_PERIOD - PwmRgbLedCoerce(iB));
+    PwmRgbLedFxStop();
+    g_sPwmRgbLedFx.pui8Color[0] = PwmRgbLedCoerce(iR);
+    g_sPwmRgbLedFx.pui8Color[1] = PwmRgbLedCoerce(iG);
+    g_sPwmRgbLedFx.pui8Color[2] = PwmRgbLedCoerce(iB);
+    PwmRgbLedOutput(g_sPwmRgbLedFx.pui8Color);
+}
+
+
+
+// Set up the timer for the effects. The RGB LED must be initialized with
+// PwmRgbLedInit before.
+void PwmRgbLedFxInit(uint32_t ui32SysClock)
+{
+    uint32_t ui32Ticks = ui32SysClock / PWM_RGB_LED_FX_RATE;
+    uint32_t ui32Prescale = (ui32Ticks - 1) >> 16;
+
+    g_ui32PwmRgbLedFxSysClock = ui32SysClock;
+    g_sPwmRgbLedFx.ui8Effect = PWM_RGB_LED_FX_NONE;
+    // Timer B is a 16 bit timer. The prescaler extends it to 24 bit.
+    TimerPrescaleSet(PWM_RGB_LED_FX_TIMER_BASE, TIMER_B, ui32Prescale);
+    TimerLoadSet(PWM_RGB_LED_FX_TIMER_BASE, TIMER_B, ui32Ticks / (ui32Prescale + 1) - 1);
+    TimerIntRegister(PWM_RGB_LED_FX_TIMER_BASE, TIMER_B, PwmRgbLedFxIntHandler);
+    TimerIntClear(PWM_RGB_LED_FX_TIMER_BASE, TIMER_TIMB_TIMEOUT);
+    TimerIntEnable(PWM_RGB_LED_FX_TIMER_BASE, TIMER_TIMB_TIMEOUT);
 }
 
+
+
+// Start an effect. The color ui32Rgb (0xRRGGBB) is the target color of a fade
+// or the color of the breathing. ui32PeriodMs is the duration of a fade or
+// the period of the breathing and the color ramp. Returns -1 on invalid
+// parameters.
+int PwmRgbLedFxStart(uint8_t ui8Effect, uint32_t ui32Rgb, uint32_t ui32PeriodMs)
+{
+    uint32_t ui32Steps = ui32PeriodMs * PWM_RGB_LED_FX_RATE / 1000;
+
+    if (!g_ui32PwmRgbLedFxSysClock || ui8Effect == PWM_RGB_LED_FX_NONE || ui8Effect > PWM_RGB_LED_FX_RAMP) return -1;
+    if (ui32PeriodMs > 3600000) return -1;
+    if (ui32Steps < 1) ui32Steps = 1;
+
+    PwmRgbLedFxStop();
+    for (int i = 0; i < 3; i++) {
+        g_sPwmRgbLedFx.pui8Start[i] = g_sPwmRgbLedFx.pui8Color[i];
+        g_sPwmRgbLedFx.pui8Target[i] = (ui32Rgb >> (16 - 8 * i)) & 0xff;
+    }
+    g_sPwmRgbLedFx.ui32Steps = ui32Steps;
+    g_sPwmRgbLedFx.ui32Step = 0;
+    g_sPwmRgbLedFx.ui8Effect = ui8Effect;
+    TimerEnable(PWM_RGB_LED_FX_TIMER_BASE, TIMER_B);
+
+    return 0;
+}
+
+
+
+// Stop a running effect. The RGB LED keeps its current color.
+void PwmRgbLedFxStop(void)
+{
+    if (!g_ui32PwmRgbLedFxSysClock) return;
+    TimerDisable(PWM_RGB_LED_FX_TIMER_BASE, TIMER_B);
+    g_sPwmRgbLedFx.ui8Effect = PWM_RGB_LED_FX_NONE;
+}
+
+
+
+// Get the running effect.
+uint8_t PwmRgbLedFxGet(void)
+{
+    return g_sPwmRgbLedFx.ui8Effect;
+}
+
+
+
+// Output a color using the lookup tables.
+static void PwmRgbLedOutput(const uint8_t *pui8Color)
+{
+    PWMPulseWidthSet(PWM0_BASE, PWM_OUT_6, g_ppui16PwmRgbLedLut[0][pui8Color[0]]);
+    PWMPulseWidthSet(PWM0_BASE, PWM_OUT_7, g_ppui16PwmRgbLedLut[1][pui8Color[1]]);
+    TimerMatchSet(TIMER2_BASE, TIMER_A, g_ppui16PwmRgbLedLut[2][pui8Color[2]]);
+}
+
+
+
+// Interrupt handler of the effects timer. Calculates the next color of the
+// running effect.
+static void PwmRgbLedFxIntHandler(void)
+{
+    tPwmRgbLedFx *psFx = &g_sPwmRgbLedFx;
+    uint32_t ui32Pos, ui32Index, ui32Frac, ui32Level;
+    int32_t i32Diff;
+
+    TimerIntClear(PWM_RGB_LED_FX_TIMER_BASE, TIMER_TIMB_TIMEOUT);
+    psFx->ui32Step++;
+    switch (psFx->ui8Effect) {
+        case PWM_RGB_LED_FX_FADE:
+            for (int i = 0; i < 3; i++) {
+                i32Diff = (int32_t) psFx->pui8Target[i] - psFx->pui8Start[i];
+                psFx->pui8Color[i] = psFx->pui8Start[i] + i32Diff * (int32_t) psFx->ui32Step / (int32_t) psFx->ui32Steps;
+            }
+            // Keep the target color at the end of the fade.
+            if (psFx->ui32Step >= psFx->ui32Steps) {
+                TimerDisable(PWM_RGB_LED_FX_TIMER_BASE, TIMER_B);
+                psFx->ui8Effect = PWM_RGB_LED_FX_NONE;
+            }
+            break;
+        case PWM_RGB_LED_FX_BREATHE:
+            if (psFx->ui32Step >= psFx->ui32Steps) psFx->ui32Step = 0;
+            // Interpolate the breathing table. The position has 8 fractional bits.
+            ui32Pos = (uint64_t) psFx->ui32Step * (PWM_RGB_LED_BREATHE_LEN << 8) / psFx->ui32Steps;
+            ui32Index = ui32Pos >> 8;
+            ui32Frac = ui32Pos & 0xff;
+            ui32Level = (g_pui8PwmRgbLedBreathe[ui32Index] * (256 - ui32Frac) +
+                         g_pui8PwmRgbLedBreathe[(ui32Index + 1) & (PWM_RGB_LED_BREATHE_LEN - 1)] * ui32Frac) >> 8;
+            for (int i = 0; i < 3; i++) psFx->pui8Color[i] = psFx->pui8Target[i] * ui32Level / 255;
+            break;
+        case PWM_RGB_LED_FX_RAMP:
+            if (psFx->ui32Step >= psFx->ui32Steps) psFx->ui32Step = 0;
+            // Color wheel: red -> green -> blue -> red in 3 sections of 256 levels.
+            ui32Pos = (uint64_t) psFx->ui32Step * 768 / psFx->ui32Steps;
+            ui32Index = ui32Pos >> 8;
+            ui32Frac = ui32Pos & 0xff;
+            psFx->pui8Color[ui32Index] = 255 - ui32Frac;
+            psFx->pui8Color[(ui32Index + 1) % 3] = ui32Frac;
+            psFx->pui8Color[(ui32Index + 2) % 3] = 0;
+            break;
+        default:
+            TimerDisable(PWM_RGB_LED_FX_TIMER_BASE, TIMER_B);
+            return;
+    }
+    PwmRgbLedOutput(psFx->pui8Color);
+}
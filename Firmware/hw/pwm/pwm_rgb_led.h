@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 10 Feb 2020
-// Rev.: 04 Apr 2020
+// Rev.: 17 Oct 2026
 //
 // Header file for the RGB LED control using PWD functions on the TI Tiva
 // TM4C1294 Connected LaunchPad Evaluation Kit.
@@ -15,14 +15,42 @@
 
 
 
-// Dim down the overall brightness of the RGB LED by increasing this number.
-#define PWM_RGB_LED_PERIOD 5000
+// PWM period in system clock cycles (2.4 kHz at 120 MHz).
+#define PWM_RGB_LED_PERIOD          50000
+
+// Pulse width at full brightness in system clock cycles. Dim down the overall
+// brightness of the RGB LED by decreasing this number.
+#define PWM_RGB_LED_PULSE_MAX       2550
+
+// Gains of the white balance in 1/256. They scale the full brightness of each
+// channel, so the color 0xffffff appears white. Adjust them to the LED.
+#define PWM_RGB_LED_WB_R            256
+#define PWM_RGB_LED_WB_G            192
+#define PWM_RGB_LED_WB_B            224
+
+// Timer for the update of the effects. Timer A of the same timer drives the
+// blue channel.
+#define PWM_RGB_LED_FX_TIMER_PERIPH SYSCTL_PERIPH_TIMER2
+#define PWM_RGB_LED_FX_TIMER_BASE   TIMER2_BASE
+
+// Update rate of the effects in Hz.
+#define PWM_RGB_LED_FX_RATE         100
+
+// Effects.
+#define PWM_RGB_LED_FX_NONE         0       // Static color.
+#define PWM_RGB_LED_FX_FADE         1       // Fade to a color once.
+#define PWM_RGB_LED_FX_BREATHE      2       // Periodically fade a color in and out.
+#define PWM_RGB_LED_FX_RAMP         3       // Periodically run through the color wheel.
 
 
 
 // Function prototypes.
 void PwmRgbLedInit(void);
 void PwmRgbLedSet(int iR, int iG, int iB);
+void PwmRgbLedFxInit(uint32_t ui32SysClock);
+int PwmRgbLedFxStart(uint8_t ui8Effect, uint32_t ui32Rgb, uint32_t ui32PeriodMs);
+void PwmRgbLedFxStop(void);
+uint8_t PwmRgbLedFxGet(void);
 
 
 
@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 06 Apr 2020
-// Rev.: 11 Apr 2020
+// Rev.: 17 Oct 2026
 //
 // Synchronous Serial Interface (SSI) functions on the TI Tiva TM4C1294
 // Connected LaunchPad Evaluation Kit.
@@ -10,18 +10,44 @@
 // The SSI can be configured to use either the Motorola SPI or the Texas
 // Instruments synchronous serial interface frame formats.
 //
+// Bulk transfers use the uDMA controller. Data items are 8 bit wide for data
+// widths up to 8 bits and 16 bit wide otherwise. Transfers longer than the
+// maximum uDMA transfer size are split up in the SSI interrupt handler.
+//
+// SsiMasterWrite and SsiMasterRead always move one data word at a time through
+// the FIFOs, also with the uDMA enabled. The data received during a write stay
+// in the receive FIFO, so SsiMasterRead returns them afterwards.
+//
 
 
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
+#include "inc/hw_ssi.h"
 #include "driverlib/gpio.h"
 #include "driverlib/ssi.h"
 #include "driverlib/sysctl.h"
+#include "driverlib/udma.h"
+#include "timebase.h"
+#include "udma.h"
 #include "ssi.h"
 
 
 
+// Dummy data sent during receive-only uDMA transfers.
+static uint16_t g_ui16SsiDmaDummy = 0;
+
+
+
+// Function prototypes of local functions.
+static void SsiMasterDmaArm(tSSI *psSsi, bool bTx);
+static void SsiMasterDmaStop(tSSI *psSsi);
+static uint32_t SsiMasterTimeoutUs(tSSI *psSsi);
+static bool SsiMasterWait(tSSI *psSsi);
+
+
+
 // Initialize an SSI master.
 void SsiMasterInit(tSSI *psSsi)
 {
@@ -47,32 +73,23 @@ void SsiMasterInit(tSSI *psSsi)
                        psSsi->ui32Mode,
                        psSsi->ui32BitRate,
                        psSsi->ui32DataWidth);
+    // Restore the uDMA interrupts after a reset of the SSI peripheral.
+    if (psSsi->bDmaEnabled) SSIIntEnable(psSsi->ui32BaseSsi, SSI_DMATX | SSI_DMARX);
     SSIEnable(psSsi->ui32BaseSsi);
 }
 
 
 
-// Write data to an SSI master.
-uint32_t SsiMasterWrite(tSSI *psSsi, uint32_t *pui32Data, uint8_t ui8Length)
+// Write data to an SSI master. Returns 0 on success, -1 on timeout.
+uint32_t SsiMasterWrite(tSSI *psSsi, uint32_t *pui32Data, uint32_t ui32Length)
 {
-    uint32_t ui32Timeout = psSsi->ui32Timeout + 10;     // Guarantee some minimum timeout value.
-
-    if (ui8Length < 1) return 1;
+    if (ui32Length < 1) return 1;
 
     // Send data.
-    for (int i = 0; i < ui8Length; i++) {
+    for (uint32_t i = 0; i < ui32Length; i++) {
         SSIDataPut(psSsi->ui32BaseSsi, pui32Data[i]);
         // Wait until the transfer is finished.
-        SysCtlDelay(psSsi->ui32SsiClk / 3e5);   // 10 us delay.
-                                                // Note: The SysCtlDelay executes a simple 3 instruction cycle loop.
-        for (int i = 0; i <= ui32Timeout; i++) {
-            if (!SSIBusy(psSsi->ui32BaseSsi)) break;
-            SysCtlDelay(psSsi->ui32SsiClk / 3e5);   // 10 us delay.
-            // Timeout while waiting for the SSI master to be free.
-            if (i == ui32Timeout) {
-                return -1;
-            }
-        }
+        if (!SsiMasterWait(psSsi)) return -1;
     }
 
     return 0;
@@ -80,29 +97,228 @@ uint32_t SsiMasterWrite(tSSI *psSsi, uint32_t *pui32Data, uint8_t ui8Length)
 
 
 
-// Read data from an SSI master (blocking).
-int32_t SsiMasterRead(tSSI *psSsi, uint32_t *pui32Data, uint8_t ui8Length)
+// Read data from an SSI master (blocking). Only the data already in the
+// receive FIFO are collected. Returns the number of data words read or -1 on
+// timeout.
+int32_t SsiMasterRead(tSSI *psSsi, uint32_t *pui32Data, uint32_t ui32Length)
 {
-    uint32_t ui32Timeout = psSsi->ui32Timeout + 10;     // Guarantee some minimum timeout value.
     int32_t i32Cnt = 0;
 
-    if (ui8Length < 1) return 1;
+    if (ui32Length < 1) return 1;
 
     // Receive data.
-    for (int i = 0; i < ui8Length; i++) {
+    for (uint32_t i = 0; i < ui32Length; i++) {
         i32Cnt += SSIDataGetNonBlocking(psSsi->ui32BaseSsi, &pui32Data[i]);
         // Wait until the transfer is finished.
-        SysCtlDelay(psSsi->ui32SsiClk / 3e5);   // 10 us delay.
-        for (int i = 0; i <= ui32Timeout; i++) {
-            if (!SSIBusy(psSsi->ui32BaseSsi)) break;
-            SysCtlDelay(psSsi->ui32SsiClk / 3e5);   // 10 us delay.
-            // Timeout while waiting for the I2C bus to be free.
-            if (i == ui32Timeout) {
-                return -1;
-            }
-        }
+        if (!SsiMasterWait(psSsi)) return -1;
     }
 
     return i32Cnt;
 }
 
+
+
+// Enable uDMA transfers on an SSI master. The SSI master must be initialized
+// with SsiMasterInit before. The interrupt handler must call
+// SsiMasterDmaIntHandler for this SSI master.
+int SsiMasterDmaInit(tSSI *psSsi, void (*pfnIntHandler)(void))
+{
+    uint32_t ui32ChannelRx = UDMA_CHANNEL_NUM(psSsi->ui32UdmaChannelRx);
+    uint32_t ui32ChannelTx = UDMA_CHANNEL_NUM(psSsi->ui32UdmaChannelTx);
+
+    if (!psSsi->ui32UdmaChannelRx || !psSsi->ui32UdmaChannelTx) return -1;
+
+    UdmaInit();
+
+    // Set up the uDMA channels. Receive has a higher priority to avoid an
+    // overrun of the receive FIFO.
+    uDMAChannelAssign(psSsi->ui32UdmaChannelRx);
+    uDMAChannelAssign(psSsi->ui32UdmaChannelTx);
+    uDMAChannelAttributeDisable(ui32ChannelRx, UDMA_ATTR_ALL);
+    uDMAChannelAttributeDisable(ui32ChannelTx, UDMA_ATTR_ALL);
+    uDMAChannelAttributeEnable(ui32ChannelRx, UDMA_ATTR_HIGH_PRIORITY);
+
+    psSsi->bDmaBusy = false;
+    psSsi->bDmaEnabled = true;
+
+    // Register and enable interrupt function.
+    SSIIntClear(psSsi->ui32BaseSsi, SSI_DMATX | SSI_DMARX);
+    SSIIntEnable(psSsi->ui32BaseSsi, SSI_DMATX | SSI_DMARX);
+    SSIIntRegister(psSsi->ui32BaseSsi, pfnIntHandler);
+
+    return 0;
+}
+
+
+
+// Interrupt handler of the SSI master uDMA transfers.
+void SsiMasterDmaIntHandler(tSSI *psSsi)
+{
+    uint32_t ui32SsiInt;
+    bool bTxDone, bRxDone;
+
+    ui32SsiInt = SSIIntStatus(psSsi->ui32BaseSsi, true);
+    SSIIntClear(psSsi->ui32BaseSsi, ui32SsiInt);
+
+    if (!psSsi->bDmaBusy) return;
+
+    // Continue with the next part of the transfer.
+    bTxDone = !uDMAChannelIsEnabled(UDMA_CHANNEL_NUM(psSsi->ui32UdmaChannelTx));
+    if (bTxDone && psSsi->ui32DmaTxRemain) {
+        SsiMasterDmaArm(psSsi, true);
+        bTxDone = false;
+    }
+    bRxDone = !uDMAChannelIsEnabled(UDMA_CHANNEL_NUM(psSsi->ui32UdmaChannelRx));
+    if (bRxDone && psSsi->ui32DmaRxRemain) {
+        SsiMasterDmaArm(psSsi, false);
+        bRxDone = false;
+    }
+
+    if (bTxDone && (bRxDone || !psSsi->pui8DmaRx)) SsiMasterDmaStop(psSsi);
+}
+
+
+
+// Start a uDMA transfer on an SSI master. If pvTxData is NULL, dummy data are
+// sent. If pvRxData is NULL, received data are discarded. The length is given
+// in data items. Returns 0 on success, -1 on error or if the uDMA channels are
+// busy, also with a transfer of another driver sharing them.
+int SsiMasterDmaStart(tSSI *psSsi, void *pvTxData, void *pvRxData, uint32_t ui32Length)
+{
+    uint32_t ui32Data;
+
+    if (!psSsi->bDmaEnabled || psSsi->bDmaBusy || (ui32Length < 1)) return -1;
+    if (psSsi->pfnDmaShared && psSsi->pfnDmaShared()) return -1;
+
+    // Flush the receive FIFO.
+    while (SSIDataGetNonBlocking(psSsi->ui32BaseSsi, &ui32Data));
+
+    psSsi->pui8DmaTx = pvTxData;
+    psSsi->pui8DmaRx = pvRxData;
+    psSsi->ui32DmaLength = ui32Length;
+    psSsi->ui32DmaTxRemain = ui32Length;
+    psSsi->ui32DmaRxRemain = pvRxData ? ui32Length : 0;
+    psSsi->bDmaBusy = true;
+
+    // Set up the receive channel before the transmit channel.
+    if (pvRxData) SsiMasterDmaArm(psSsi, false);
+    SsiMasterDmaArm(psSsi, true);
+    SSIDMAEnable(psSsi->ui32BaseSsi, pvRxData ? SSI_DMA_TX | SSI_DMA_RX : SSI_DMA_TX);
+
+    return 0;
+}
+
+
+
+// Check if a uDMA transfer of an SSI master is in progress.
+bool SsiMasterDmaBusy(tSSI *psSsi)
+{
+    return psSsi->bDmaBusy;
+}
+
+
+
+// Wait until a uDMA transfer of an SSI master is finished. Returns 0 on
+// success, -1 on timeout.
+int SsiMasterDmaWait(tSSI *psSsi)
+{
+    tTimeout sTimeout;
+
+    // Allow twice the nominal transfer time plus the SSI timeout. Busy
+    // waiting keeps the cycle counter running for the SSI benchmark.
+    TimeoutStart(&sTimeout, (uint64_t) psSsi->ui32DmaLength * psSsi->ui32DataWidth * 2000000 / psSsi->ui32BitRate +
+                            SsiMasterTimeoutUs(psSsi));
+    while (psSsi->bDmaBusy || SSIBusy(psSsi->ui32BaseSsi)) {
+        // Timeout while waiting for the uDMA transfer to be finished.
+        if (TimeoutExpired(&sTimeout)) {
+            SsiMasterDmaStop(psSsi);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+
+
+// Transfer data using the uDMA and wait until the transfer is finished.
+int SsiMasterDmaTransfer(tSSI *psSsi, void *pvTxData, void *pvRxData, uint32_t ui32Length)
+{
+    if (SsiMasterDmaStart(psSsi, pvTxData, pvRxData, ui32Length)) return -1;
+
+    return SsiMasterDmaWait(psSsi);
+}
+
+
+
+// Set up the next part of a uDMA transfer on the transmit or the receive
+// channel.
+static void SsiMasterDmaArm(tSSI *psSsi, bool bTx)
+{
+    uint32_t ui32Channel, ui32Size, ui32Inc, ui32Cnt;
+    uint32_t ui32ItemSize = (psSsi->ui32DataWidth > 8) ? 2 : 1;
+    void *pvDataReg = (void *) (psSsi->ui32BaseSsi + SSI_O_DR);
+
+    ui32Size = (ui32ItemSize == 2) ? UDMA_SIZE_16 : UDMA_SIZE_8;
+    if (bTx) {
+        ui32Channel = UDMA_CHANNEL_NUM(psSsi->ui32UdmaChannelTx);
+        ui32Cnt = (psSsi->ui32DmaTxRemain > UDMA_XFER_SIZE_MAX) ? UDMA_XFER_SIZE_MAX : psSsi->ui32DmaTxRemain;
+        if (!psSsi->pui8DmaTx) ui32Inc = UDMA_SRC_INC_NONE;
+        else ui32Inc = (ui32ItemSize == 2) ? UDMA_SRC_INC_16 : UDMA_SRC_INC_8;
+        uDMAChannelControlSet(ui32Channel | UDMA_PRI_SELECT, ui32Size | ui32Inc | UDMA_DST_INC_NONE | UDMA_ARB_4);
+        uDMAChannelTransferSet(ui32Channel | UDMA_PRI_SELECT, UDMA_MODE_BASIC,
+                               psSsi->pui8DmaTx ? (void *) psSsi->pui8DmaTx : (void *) &g_ui16SsiDmaDummy,
+                               pvDataReg, ui32Cnt);
+        if (psSsi->pui8DmaTx) psSsi->pui8DmaTx += ui32Cnt * ui32ItemSize;
+        psSsi->ui32DmaTxRemain -= ui32Cnt;
+    } else {
+        ui32Channel = UDMA_CHANNEL_NUM(psSsi->ui32UdmaChannelRx);
+        ui32Cnt = (psSsi->ui32DmaRxRemain > UDMA_XFER_SIZE_MAX) ? UDMA_XFER_SIZE_MAX : psSsi->ui32DmaRxRemain;
+        ui32Inc = (ui32ItemSize == 2) ? UDMA_DST_INC_16 : UDMA_DST_INC_8;
+        uDMAChannelControlSet(ui32Channel | UDMA_PRI_SELECT, ui32Size | UDMA_SRC_INC_NONE | ui32Inc | UDMA_ARB_4);
+        uDMAChannelTransferSet(ui32Channel | UDMA_PRI_SELECT, UDMA_MODE_BASIC,
+                               pvDataReg, psSsi->pui8DmaRx, ui32Cnt);
+        psSsi->pui8DmaRx += ui32Cnt * ui32ItemSize;
+        psSsi->ui32DmaRxRemain -= ui32Cnt;
+    }
+    uDMAChannelEnable(ui32Channel);
+}
+
+
+
+// Stop a uDMA transfer of an SSI master. A transfer of another driver sharing
+// the uDMA channels is left alone.
+static void SsiMasterDmaStop(tSSI *psSsi)
+{
+    if (!psSsi->bDmaBusy) return;
+    SSIDMADisable(psSsi->ui32BaseSsi, SSI_DMA_TX | SSI_DMA_RX);
+    uDMAChannelDisable(UDMA_CHANNEL_NUM(psSsi->ui32UdmaChannelTx));
+    uDMAChannelDisable(UDMA_CHANNEL_NUM(psSsi->ui32UdmaChannelRx));
+    psSsi->ui32DmaTxRemain = 0;
+    psSsi->ui32DmaRxRemain = 0;
+    psSsi->bDmaBusy = false;
+}
+
+
+
+// Get the timeout for waiting on the SSI master in microseconds.
+static uint32_t SsiMasterTimeoutUs(tSSI *psSsi)
+{
+    return (psSsi->ui32Timeout + 10) * 10;  // Guarantee some minimum timeout value.
+}
+
+
+
+// Wait until the SSI master has finished the current transfer. The busy flag
+// is set as long as the transmit FIFO is not empty. Returns false on timeout.
+static bool SsiMasterWait(tSSI *psSsi)
+{
+    tTimeout sTimeout;
+
+    TimeoutStart(&sTimeout, SsiMasterTimeoutUs(psSsi));
+    while (SSIBusy(psSsi->ui32BaseSsi)) {
+        if (TimeoutExpired(&sTimeout)) return false;
+    }
+
+    return true;
+}
@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 06 Apr 2020
-// Rev.: 11 Apr 2020
+// Rev.: 17 Oct 2026
 //
 // Header file for the Synchronous Serial Interface (SSI) functions on the TI
 // Tiva TM4C1294 Connected LaunchPad Evaluation Kit.
@@ -15,6 +15,11 @@
 
 
 
+// Constants.
+#define SSI_FIFO_DEPTH          8       // Depth of the transmit and receive FIFOs in data items.
+
+
+
 // Types.
 typedef struct {
     uint32_t ui32PeripheralSsi;
@@ -35,13 +40,30 @@ typedef struct {
     uint32_t ui32BitRate;
     uint32_t ui32DataWidth;
     uint32_t ui32Timeout;
+    uint32_t ui32UdmaChannelRx;     // uDMA channel assignment (UDMA_CHn_SSIxRX)
+    uint32_t ui32UdmaChannelTx;     // uDMA channel assignment (UDMA_CHn_SSIxTX)
+    bool     (*pfnDmaShared)(void); // Optional: true while another driver uses the uDMA channels.
+    // State of the uDMA transfer. Managed by the driver.
+    bool     bDmaEnabled;
+    volatile bool bDmaBusy;
+    uint8_t  *pui8DmaTx;            // NULL = send dummy data
+    uint8_t  *pui8DmaRx;            // NULL = discard received data
+    uint32_t ui32DmaLength;
+    volatile uint32_t ui32DmaTxRemain;
+    volatile uint32_t ui32DmaRxRemain;
 } tSSI;
 
 
 // Function prototypes.
 void SsiMasterInit(tSSI *psSsi);
-uint32_t SsiMasterWrite(tSSI *psSsi, uint32_t *pui32Data, uint8_t ui8Length);
-int32_t SsiMasterRead(tSSI *psSsi, uint32_t *pui32Data, uint8_t ui8Length);
+uint32_t SsiMasterWrite(tSSI *psSsi, uint32_t *pui32Data, uint32_t ui32Length);
+int32_t SsiMasterRead(tSSI *psSsi, uint32_t *pui32Data, uint32_t ui32Length);
+int SsiMasterDmaInit(tSSI *psSsi, void (*pfnIntHandler)(void));
+void SsiMasterDmaIntHandler(tSSI *psSsi);
+int SsiMasterDmaStart(tSSI *psSsi, void *pvTxData, void *pvRxData, uint32_t ui32Length);
+bool SsiMasterDmaBusy(tSSI *psSsi);
+int SsiMasterDmaWait(tSSI *psSsi);
+int SsiMasterDmaTransfer(tSSI *psSsi, void *pvTxData, void *pvRxData, uint32_t ui32Length);
 
 
 
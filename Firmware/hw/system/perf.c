@@ -0,0 +1,104 @@
+// File: perf.c
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 17 Oct 2026
+// Rev.: 17 Oct 2026
+//
+// Performance measurement functions on the TI Tiva TM4C1294 Connected
+// LaunchPad Evaluation Kit. Probes collect the run time statistics of code
+// sections measured with the cycle counter. The CPU load is measured with the
+// TivaWare CPU usage module, which counts the system clock cycles while the
+// processor is not sleeping.
+//
+
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "driverlib/sysctl.h"
+#include "utils/cpu_usage.h"
+#include "perf.h"
+
+
+
+// Global variables.
+static uint32_t g_ui32PerfCpuTickRate;
+static uint32_t g_ui32PerfCpuTickCnt;
+static uint32_t g_ui32PerfCpuUsageSum;
+static volatile uint32_t g_ui32PerfCpuLoad;
+
+
+
+// Add a run time to the statistics of a probe.
+void PerfProbeUpdate(tPerfProbe *psPerfProbe, uint32_t ui32Cycles)
+{
+    uint32_t ui32Bin = 0;
+
+    // Bin 0 for less than PERF_HIST_BIN0 cycles, then one bin per factor 4.
+    if (ui32Cycles >= PERF_HIST_BIN0) {
+        ui32Bin = (31 - __builtin_clz(ui32Cycles / PERF_HIST_BIN0)) / 2 + 1;
+        if (ui32Bin >= PERF_HIST_BINS) ui32Bin = PERF_HIST_BINS - 1;
+    }
+    psPerfProbe->pui32Hist[ui32Bin]++;
+    if (!psPerfProbe->ui32Cnt || ui32Cycles < psPerfProbe->ui32CyclesMin) psPerfProbe->ui32CyclesMin = ui32Cycles;
+    if (ui32Cycles > psPerfProbe->ui32CyclesMax) psPerfProbe->ui32CyclesMax = ui32Cycles;
+    psPerfProbe->ui64Cycles += ui32Cycles;
+    psPerfProbe->ui32Cnt++;
+}
+
+
+
+// Reset the statistics of a probe.
+void PerfProbeReset(tPerfProbe *psPerfProbe)
+{
+    psPerfProbe->ui32Cnt = 0;
+    psPerfProbe->ui32CyclesMin = 0;
+    psPerfProbe->ui32CyclesMax = 0;
+    psPerfProbe->ui64Cycles = 0;
+    memset(psPerfProbe->pui32Hist, 0, sizeof(psPerfProbe->pui32Hist));
+}
+
+
+
+// Set up the CPU load measurement. PerfCpuTick must be called at
+// ui32TickRate, which must be at least 200 Hz at 120 MHz. The timer
+// ui32Timer (0..5) is used for counting the cycles. It is stopped while the
+// processor sleeps. This requires the peripheral clock gating in sleep mode,
+// so all peripherals which must keep running while the processor sleeps are
+// given in the list pui32PeriphSleep.
+void PerfCpuInit(uint32_t ui32SysClock, uint32_t ui32TickRate, uint32_t ui32Timer,
+                 const uint32_t *pui32PeriphSleep, uint32_t ui32PeriphSleepNum)
+{
+    g_ui32PerfCpuTickRate = ui32TickRate;
+    g_ui32PerfCpuTickCnt = 0;
+    g_ui32PerfCpuUsageSum = 0;
+    g_ui32PerfCpuLoad = 10000;
+    for (uint32_t i = 0; i < ui32PeriphSleepNum; i++) {
+        SysCtlPeripheralSleepEnable(pui32PeriphSleep[i]);
+    }
+    CPUUsageInit(ui32SysClock, ui32TickRate, ui32Timer);
+}
+
+
+
+// Update the CPU load measurement. Must be called periodically from an
+// interrupt handler at the tick rate given to PerfCpuInit.
+void PerfCpuTick(void)
+{
+    // The CPU usage is a 16.16 fixed-point percentage. Sum it up as 8.8
+    // fixed-point value over one second.
+    g_ui32PerfCpuUsageSum += CPUUsageTick() >> 8;
+    if (++g_ui32PerfCpuTickCnt < g_ui32PerfCpuTickRate) return;
+    g_ui32PerfCpuLoad = (uint64_t) g_ui32PerfCpuUsageSum * 100 / 256 / g_ui32PerfCpuTickCnt;
+    g_ui32PerfCpuTickCnt = 0;
+    g_ui32PerfCpuUsageSum = 0;
+}
+
+
+
+// Get the CPU load of the last second in units of 0.01 %.
+uint32_t PerfCpuLoadGet(void)
+{
+    return g_ui32PerfCpuLoad;
+}
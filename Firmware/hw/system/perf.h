@@ -0,0 +1,48 @@
+// File: perf.h
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 17 Oct 2026
+// Rev.: 17 Oct 2026
+//
+// Header file for the performance measurement functions on the TI Tiva
+// TM4C1294 Connected LaunchPad Evaluation Kit.
+//
+
+
+
+#ifndef __PERF_H__
+#define __PERF_H__
+
+
+
+// Run time histogram. Bin i counts run times below (PERF_HIST_BIN0 << (2 * i))
+// cycles. The last bin counts all longer run times.
+#define PERF_HIST_BINS          8
+#define PERF_HIST_BIN0          256
+
+
+
+// Types.
+typedef struct {
+    const char  *pcName;
+    // Statistics. Managed by the driver.
+    uint32_t    ui32Cnt;
+    uint32_t    ui32CyclesMin;
+    uint32_t    ui32CyclesMax;
+    uint64_t    ui64Cycles;
+    uint32_t    pui32Hist[PERF_HIST_BINS];
+} tPerfProbe;
+
+
+
+// Function prototypes.
+void PerfProbeUpdate(tPerfProbe *psPerfProbe, uint32_t ui32Cycles);
+void PerfProbeReset(tPerfProbe *psPerfProbe);
+void PerfCpuInit(uint32_t ui32SysClock, uint32_t ui32TickRate, uint32_t ui32Timer,
+                 const uint32_t *pui32PeriphSleep, uint32_t ui32PeriphSleepNum);
+void PerfCpuTick(void);
+uint32_t PerfCpuLoadGet(void);
+
+
+
+#endif  // __PERF_H__
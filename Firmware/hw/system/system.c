@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 11 Feb 2020
-// Rev.: 17 Feb 2020
+// Rev.: 17 Oct 2026
 //
 // System functions on the TI Tiva TM4C1294 Connected LaunchPad Evaluation Kit.
 //
@@ -12,6 +12,8 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include "inc/hw_memmap.h"
+#include "inc/hw_nvic.h"
+#include "inc/hw_types.h"
 #include "driverlib/gpio.h"
 #include "driverlib/pin_map.h"
 #include "driverlib/sysctl.h"
@@ -19,6 +21,14 @@
 
 
 
+// Data watchpoint and trace (DWT) unit registers of the ARM Cortex-M4.
+#define DWT_CTRL                0xE0001000  // DWT control register
+#define DWT_CYCCNT              0xE0001004  // DWT cycle count register
+#define DWT_CTRL_CYCCNTENA      0x00000001  // Enable the cycle counter
+#define NVIC_DBG_INT_TRCENA     0x01000000  // Enable the DWT unit
+
+
+
 // Set up the DIVSCLK pin (PQ4) to drive the system clock.
 // CAUTION: When enabled at boot up, this will cause further flashing to fail!
 //          When enabling it at run time, it will cause the MCU to reset.
@@ -45,3 +55,23 @@ void ClockOutputDisable(void)
     SysCtlClockOutConfig(SYSCTL_CLKOUT_DIS, 1);
 }
 
+
+
+
+// Enable the free running 32 bit cycle counter of the DWT unit. It counts
+// system clock cycles and wraps around after 2^32 cycles (about 35 seconds at
+// 120 MHz).
+void CycleCounterInit(void)
+{
+    HWREG(NVIC_DBG_INT) |= NVIC_DBG_INT_TRCENA;
+    HWREG(DWT_CYCCNT) = 0;
+    HWREG(DWT_CTRL) |= DWT_CTRL_CYCCNTENA;
+}
+
+
+
+// Get the value of the cycle counter.
+uint32_t CycleCounterGet(void)
+{
+    return HWREG(DWT_CYCCNT);
+}
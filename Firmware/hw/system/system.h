@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 11 Feb 2020
-// Rev.: 11 Feb 2020
+// Rev.: 17 Oct 2026
 //
 // Header file for the system functions on the TI Tiva TM4C1294 Connected
 // LaunchPad Evaluation Kit.
@@ -18,6 +18,8 @@
 // Function prototypes.
 void ClockOutputEnable(uint32_t ui32Div);
 void ClockOutputDisable(void);
+void CycleCounterInit(void);
+uint32_t CycleCounterGet(void);
 
 
 
@@ -0,0 +1,190 @@
+// File: timebase.c
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 17 Oct 2026
+// Rev.: 17 Oct 2026
+//
+// Free running 64 bit timebase on the TI Tiva TM4C1294 Connected LaunchPad
+// Evaluation Kit. A 32 bit timer counts the system clock cycles. Its overflows
+// are counted in software. Timeouts are based on the timebase. While waiting,
+// the processor sleeps until the next interrupt. The match interrupt of the
+// timer wakes it up on time.
+//
+
+
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_timer.h"
+#include "inc/hw_types.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/timer.h"
+#include "timebase.h"
+
+
+
+// Global variables.
+static uint32_t g_ui32TimebaseTicksPerUs = 1;
+static volatile uint32_t g_ui32TimebaseHigh = 0;    // Number of timer overflows.
+static bool g_bTimebaseInt = false;
+
+
+
+// Function prototypes of local functions.
+static bool TimebaseOverflow(void);
+static void TimebaseIntHandler(void);
+
+
+
+// Initialize and start the timebase. Without the interrupt (bIntEnable =
+// false), waiting is done by polling and the overflow of the timer is only
+// detected if the timebase is read at least every 2^32 system clock cycles
+// (about 35 seconds at 120 MHz).
+void TimebaseInit(uint32_t ui32SysClock, bool bIntEnable)
+{
+    g_ui32TimebaseTicksPerUs = ui32SysClock / 1000000;
+    g_ui32TimebaseHigh = 0;
+    g_bTimebaseInt = bIntEnable;
+    SysCtlPeripheralEnable(TIMEBASE_TIMER_PERIPH);
+    while(!SysCtlPeripheralReady(TIMEBASE_TIMER_PERIPH));
+    TimerConfigure(TIMEBASE_TIMER_BASE, TIMER_CFG_PERIODIC_UP);
+    TimerLoadSet(TIMEBASE_TIMER_BASE, TIMER_A, 0xffffffff);
+    // Enable the match interrupt used for waking up from sleep.
+    HWREG(TIMEBASE_TIMER_BASE + TIMER_O_TAMR) |= TIMER_TAMR_TAMIE;
+    TimerIntClear(TIMEBASE_TIMER_BASE, TIMER_TIMA_TIMEOUT | TIMER_TIMA_MATCH);
+    if (bIntEnable) {
+        TimerIntRegister(TIMEBASE_TIMER_BASE, TIMER_A, TimebaseIntHandler);
+        TimerIntEnable(TIMEBASE_TIMER_BASE, TIMER_TIMA_TIMEOUT);
+    } else {
+        TimerIntDisable(TIMEBASE_TIMER_BASE, TIMER_TIMA_TIMEOUT | TIMER_TIMA_MATCH);
+    }
+    TimerEnable(TIMEBASE_TIMER_BASE, TIMER_A);
+}
+
+
+
+// Get the timebase in system clock cycles.
+uint64_t TimebaseTicksGet(void)
+{
+    bool bIntDisabled = IntMasterDisable();
+    uint32_t ui32Low;
+    uint64_t ui64Ticks;
+
+    TimebaseOverflow();
+    ui32Low = TimerValueGet(TIMEBASE_TIMER_BASE, TIMER_A);
+    // Read the timer again if it has overflown meanwhile.
+    if (TimebaseOverflow()) ui32Low = TimerValueGet(TIMEBASE_TIMER_BASE, TIMER_A);
+    ui64Ticks = ((uint64_t) g_ui32TimebaseHigh << 32) | ui32Low;
+    if (!bIntDisabled) IntMasterEnable();
+
+    return ui64Ticks;
+}
+
+
+
+// Get the timebase in microseconds.
+uint64_t TimebaseUsGet(void)
+{
+    return TimebaseTicksGet() / g_ui32TimebaseTicksPerUs;
+}
+
+
+
+// Sleep until the timebase reaches ui64Us microseconds.
+void TimebaseSleepUntil(uint64_t ui64Us)
+{
+    tTimeout sTimeout;
+
+    sTimeout.ui64Deadline = ui64Us * g_ui32TimebaseTicksPerUs;
+    while (!TimeoutExpired(&sTimeout)) TimeoutSleep(&sTimeout, NULL);
+}
+
+
+
+// Delay in microseconds. The processor sleeps while waiting.
+void TimebaseDelayUs(uint32_t ui32DelayUs)
+{
+    tTimeout sTimeout;
+
+    TimeoutStart(&sTimeout, ui32DelayUs);
+    while (!TimeoutExpired(&sTimeout)) TimeoutSleep(&sTimeout, NULL);
+}
+
+
+
+// Start a timeout of ui32TimeoutUs microseconds.
+void TimeoutStart(tTimeout *psTimeout, uint32_t ui32TimeoutUs)
+{
+    psTimeout->ui64Deadline = TimebaseTicksGet() + (uint64_t) ui32TimeoutUs * g_ui32TimebaseTicksPerUs;
+}
+
+
+
+// Check if a timeout has expired.
+bool TimeoutExpired(const tTimeout *psTimeout)
+{
+    return TimebaseTicksGet() >= psTimeout->ui64Deadline;
+}
+
+
+
+// Sleep until the next interrupt, at the latest until the timeout expires.
+// The optional flag pbWake is set by an interrupt handler when the awaited
+// event has happened. It is checked with disabled interrupts, so the event is
+// not missed right before sleeping. Returns immediately without the timebase
+// interrupt.
+void TimeoutSleep(const tTimeout *psTimeout, const volatile bool *pbWake)
+{
+    bool bIntDisabled;
+    uint64_t ui64Ticks;
+
+    if (!g_bTimebaseInt) return;
+    // A pending interrupt wakes up the processor also while the interrupts
+    // are disabled. It is handled after enabling the interrupts again.
+    bIntDisabled = IntMasterDisable();
+    ui64Ticks = TimebaseTicksGet();
+    if (ui64Ticks < psTimeout->ui64Deadline && !(pbWake && *pbWake)) {
+        // Wake up by the match interrupt if the deadline is before the next
+        // overflow of the timer, else by the overflow interrupt.
+        if ((psTimeout->ui64Deadline >> 32) == (ui64Ticks >> 32)) {
+            TimerMatchSet(TIMEBASE_TIMER_BASE, TIMER_A, (uint32_t) psTimeout->ui64Deadline);
+            TimerIntClear(TIMEBASE_TIMER_BASE, TIMER_TIMA_MATCH);
+            TimerIntEnable(TIMEBASE_TIMER_BASE, TIMER_TIMA_MATCH);
+        }
+        // Check again, as the match may have passed before it was enabled.
+        if (!TimeoutExpired(psTimeout)) SysCtlSleep();
+    }
+    if (!bIntDisabled) IntMasterEnable();
+}
+
+
+
+// Count an overflow of the timer. Must be called with disabled interrupts.
+// Returns true if the timer has overflown.
+static bool TimebaseOverflow(void)
+{
+    if (!(TimerIntStatus(TIMEBASE_TIMER_BASE, false) & TIMER_TIMA_TIMEOUT)) return false;
+    TimerIntClear(TIMEBASE_TIMER_BASE, TIMER_TIMA_TIMEOUT);
+    g_ui32TimebaseHigh++;
+
+    return true;
+}
+
+
+
+// Interrupt handler of the timebase timer.
+static void TimebaseIntHandler(void)
+{
+    bool bIntDisabled = IntMasterDisable();
+
+    // The match interrupt only wakes up the processor.
+    if (TimerIntStatus(TIMEBASE_TIMER_BASE, true) & TIMER_TIMA_MATCH) {
+        TimerIntDisable(TIMEBASE_TIMER_BASE, TIMER_TIMA_MATCH);
+        TimerIntClear(TIMEBASE_TIMER_BASE, TIMER_TIMA_MATCH);
+    }
+    TimebaseOverflow();
+    if (!bIntDisabled) IntMasterEnable();
+}
@@ -0,0 +1,44 @@
+// File: timebase.h
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 17 Oct 2026
+// Rev.: 17 Oct 2026
+//
+// Header file for the free running 64 bit timebase on the TI Tiva TM4C1294
+// Connected LaunchPad Evaluation Kit.
+//
+
+
+
+#ifndef __TIMEBASE_H__
+#define __TIMEBASE_H__
+
+
+
+// Timer used for the timebase. It counts system clock cycles.
+#define TIMEBASE_TIMER_PERIPH       SYSCTL_PERIPH_TIMER0
+#define TIMEBASE_TIMER_BASE         TIMER0_BASE
+
+
+
+// Types.
+typedef struct {
+    uint64_t    ui64Deadline;       // Timebase ticks.
+} tTimeout;
+
+
+
+// Function prototypes.
+void TimebaseInit(uint32_t ui32SysClock, bool bIntEnable);
+uint64_t TimebaseTicksGet(void);
+uint64_t TimebaseUsGet(void);
+void TimebaseSleepUntil(uint64_t ui64Us);
+void TimebaseDelayUs(uint32_t ui32DelayUs);
+void TimeoutStart(tTimeout *psTimeout, uint32_t ui32TimeoutUs);
+bool TimeoutExpired(const tTimeout *psTimeout);
+void TimeoutSleep(const tTimeout *psTimeout, const volatile bool *pbWake);
+
+
+
+#endif  // __TIMEBASE_H__
+
@@ -2,10 +2,15 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 18 Feb 2020
-// Rev.: 17 Apr 2020
+// Rev.: 17 Oct 2026
 //
 // UART functions on the TI Tiva TM4C1294 Connected LaunchPad Evaluation Kit.
 //
+// After UartIntInit the UART is interrupt-driven. The interrupt handler moves
+// received data into the receive buffer and sends data from the transmit
+// buffer, so no data are lost between two reads as long as the receive buffer
+// does not overflow.
+//
 
 
 
@@ -14,10 +19,16 @@
 #include "driverlib/gpio.h"
 #include "driverlib/sysctl.h"
 #include "driverlib/uart.h"
+#include "utils/ringbuf.h"
 #include "uart.h"
 
 
 
+// Function prototypes of local functions.
+static void UartTxStart(tUART *psUart);
+
+
+
 // Initialize an UART.
 void UartInit(tUART *psUart)
 {
@@ -35,13 +46,82 @@ void UartInit(tUART *psUart)
     UARTFIFOEnable(psUart->ui32BaseUart);
     if (psUart->bLoopback) UARTLoopbackEnable(psUart->ui32BaseUart);
     UARTEnable(psUart->ui32BaseUart);
+    // Restore the interrupts after a reset of the UART peripheral.
+    if (psUart->bIntEnabled) {
+        UARTTxIntModeSet(psUart->ui32BaseUart, UART_TXINT_MODE_FIFO);
+        UARTIntEnable(psUart->ui32BaseUart, UART_INT_RX | UART_INT_RT | UART_INT_OE);
+        UartTxStart(psUart);
+    }
+}
+
+
+
+// Enable the interrupt-driven mode of an UART. The UART must be initialized
+// with UartInit before. The interrupt handler must call UartIntHandler for
+// this UART.
+void UartIntInit(tUART *psUart, void (*pfnIntHandler)(void))
+{
+    RingBufInit(&psUart->sRxRingBuf, psUart->pui8RxBuf, psUart->ui32RxBufSize);
+    RingBufInit(&psUart->sTxRingBuf, psUart->pui8TxBuf, psUart->ui32TxBufSize);
+    UartStatsReset(psUart);
+    psUart->bIntEnabled = true;
+
+    UARTIntRegister(psUart->ui32BaseUart, pfnIntHandler);
+    UARTTxIntModeSet(psUart->ui32BaseUart, UART_TXINT_MODE_FIFO);
+    UARTIntClear(psUart->ui32BaseUart, UART_INT_RX | UART_INT_RT | UART_INT_OE | UART_INT_TX);
+    UARTIntEnable(psUart->ui32BaseUart, UART_INT_RX | UART_INT_RT | UART_INT_OE);
+}
+
+
+
+// Interrupt handler of an UART. Moves the received data from the UART FIFO
+// into the receive buffer and refills the transmit FIFO.
+void UartIntHandler(tUART *psUart)
+{
+    uint32_t ui32Status, ui32Used;
+
+    ui32Status = UARTIntStatus(psUart->ui32BaseUart, true);
+    UARTIntClear(psUart->ui32BaseUart, ui32Status);
+
+    // Receive.
+    if (ui32Status & UART_INT_OE) {
+        psUart->ui32RxFifoOverrunCnt++;
+        UARTRxErrorClear(psUart->ui32BaseUart);
+    }
+    while (UARTCharsAvail(psUart->ui32BaseUart)) {
+        uint8_t ui8Data = UARTCharGetNonBlocking(psUart->ui32BaseUart) & 0xff;
+        if (RingBufFull(&psUart->sRxRingBuf)) {
+            psUart->ui32RxOverrunCnt++;
+            continue;
+        }
+        RingBufWriteOne(&psUart->sRxRingBuf, ui8Data);
+    }
+    ui32Used = RingBufUsed(&psUart->sRxRingBuf);
+    if (ui32Used > psUart->ui32RxMax) psUart->ui32RxMax = ui32Used;
+
+    // Transmit.
+    if (ui32Status & UART_INT_TX) {
+        while (!RingBufEmpty(&psUart->sTxRingBuf) && UARTSpaceAvail(psUart->ui32BaseUart)) {
+            UARTCharPutNonBlocking(psUart->ui32BaseUart, RingBufReadOne(&psUart->sTxRingBuf));
+        }
+        if (RingBufEmpty(&psUart->sTxRingBuf)) UARTIntDisable(psUart->ui32BaseUart, UART_INT_TX);
+    }
 }
 
 
 
-// Write data to an UART.
+// Write data to an UART. In the interrupt-driven mode, this waits only while
+// the transmit buffer is full.
 uint32_t UartWrite(tUART *psUart, uint8_t *pui8Data, uint8_t ui8Length)
 {
+    uint32_t ui32Cnt = 0;
+
+    if (psUart->bIntEnabled) {
+        while (ui32Cnt < ui8Length) {
+            ui32Cnt += UartWriteNonBlocking(psUart, pui8Data + ui32Cnt, ui8Length - ui32Cnt);
+        }
+        return 0;
+    }
     for (int i = 0; i < ui8Length; i++) {
         UARTCharPut(psUart->ui32BaseUart, pui8Data[i]);
     }
@@ -51,11 +131,42 @@ uint32_t UartWrite(tUART *psUart, uint8_t *pui8Data, uint8_t ui8Length)
 
 
 
+// Write as much data to the transmit buffer of an UART as fits into it.
+// Returns the number of bytes written. Without the interrupt-driven mode,
+// only the hardware FIFO is used.
+uint32_t UartWriteNonBlocking(tUART *psUart, const uint8_t *pui8Data, uint32_t ui32Length)
+{
+    uint32_t ui32Cnt;
+
+    if (!psUart->bIntEnabled) {
+        for (ui32Cnt = 0; ui32Cnt < ui32Length; ui32Cnt++) {
+            if (!UARTCharPutNonBlocking(psUart->ui32BaseUart, pui8Data[ui32Cnt])) break;
+        }
+        return ui32Cnt;
+    }
+    ui32Cnt = RingBufFree(&psUart->sTxRingBuf);
+    if (ui32Cnt > ui32Length) ui32Cnt = ui32Length;
+    if (ui32Cnt) {
+        RingBufWrite(&psUart->sTxRingBuf, (uint8_t *) pui8Data, ui32Cnt);
+        UartTxStart(psUart);
+    }
+
+    return ui32Cnt;
+}
+
+
+
 // Read data from an UART (non-blocking).
 uint32_t UartRead(tUART *psUart, uint8_t *pui8Data, uint8_t ui8Length)
 {
     int cnt = 0;
 
+    if (psUart->bIntEnabled) {
+        cnt = RingBufUsed(&psUart->sRxRingBuf);
+        if (cnt > ui8Length) cnt = ui8Length;
+        RingBufRead(&psUart->sRxRingBuf, pui8Data, cnt);
+        return cnt;
+    }
     for (cnt = 0; cnt < ui8Length; cnt++) {
         if (UARTCharsAvail(psUart->ui32BaseUart)) {
             pui8Data[cnt] = (uint8_t) UARTCharGet(psUart->ui32BaseUart) & 0xff;
@@ -73,9 +184,56 @@ uint32_t UartRead(tUART *psUart, uint8_t *pui8Data, uint8_t ui8Length)
 uint32_t UartReadBlocking(tUART *psUart, uint8_t *pui8Data, uint8_t ui8Length)
 {
     for (int i = 0; i < ui8Length; i++) {
-        pui8Data[i] = (uint8_t) UARTCharGet(psUart->ui32BaseUart) & 0xff;
+        if (psUart->bIntEnabled) {
+            while (RingBufEmpty(&psUart->sRxRingBuf));
+            pui8Data[i] = RingBufReadOne(&psUart->sRxRingBuf);
+        } else {
+            pui8Data[i] = (uint8_t) UARTCharGet(psUart->ui32BaseUart) & 0xff;
+        }
     }
 
     return 0;
 }
 
+
+
+// Get the number of bytes available for reading.
+uint32_t UartRxAvail(tUART *psUart)
+{
+    if (!psUart->bIntEnabled) return UARTCharsAvail(psUart->ui32BaseUart) ? 1 : 0;
+    return RingBufUsed(&psUart->sRxRingBuf);
+}
+
+
+
+// Get the free space of the transmit buffer.
+uint32_t UartTxFree(tUART *psUart)
+{
+    if (!psUart->bIntEnabled) return UARTSpaceAvail(psUart->ui32BaseUart) ? 1 : 0;
+    return RingBufFree(&psUart->sTxRingBuf);
+}
+
+
+
+// Reset the statistics of the interrupt-driven mode.
+void UartStatsReset(tUART *psUart)
+{
+    psUart->ui32RxMax = 0;
+    psUart->ui32RxOverrunCnt = 0;
+    psUart->ui32RxFifoOverrunCnt = 0;
+}
+
+
+
+// Fill the transmit FIFO from the transmit buffer and enable the transmit
+// interrupt for the remaining data. The transmit interrupt is disabled while
+// the FIFO is filled, so the interrupt handler does not read the transmit
+// buffer at the same time.
+static void UartTxStart(tUART *psUart)
+{
+    UARTIntDisable(psUart->ui32BaseUart, UART_INT_TX);
+    while (!RingBufEmpty(&psUart->sTxRingBuf) && UARTSpaceAvail(psUart->ui32BaseUart)) {
+        UARTCharPutNonBlocking(psUart->ui32BaseUart, RingBufReadOne(&psUart->sTxRingBuf));
+    }
+    if (!RingBufEmpty(&psUart->sTxRingBuf)) UARTIntEnable(psUart->ui32BaseUart, UART_INT_TX);
+}
@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 18 Feb 2020
-// Rev.: 11 Apr 2020
+// Rev.: 17 Oct 2026
 //
 // Header file for the UART functions on the TI Tiva TM4C1294 Connected
 // LaunchPad Evaluation Kit.
@@ -15,6 +15,10 @@
 
 
 
+#include "utils/ringbuf.h"
+
+
+
 // Types.
 typedef struct {
     uint32_t ui32PeripheralUart;
@@ -29,14 +33,33 @@ typedef struct {
     uint32_t ui32Baud;
     uint32_t ui32Config;
     bool     bLoopback;
+    // Buffers for the interrupt-driven mode. The sizes must be at least 2.
+    uint8_t  *pui8RxBuf;
+    uint32_t ui32RxBufSize;
+    uint8_t  *pui8TxBuf;
+    uint32_t ui32TxBufSize;
+    // State of the interrupt-driven mode. Managed by the driver.
+    bool     bIntEnabled;
+    tRingBufObject sRxRingBuf;
+    tRingBufObject sTxRingBuf;
+    volatile uint32_t ui32RxMax;            // Maximum fill level of the receive buffer.
+    volatile uint32_t ui32RxOverrunCnt;     // Bytes lost due to a full receive buffer.
+    volatile uint32_t ui32RxFifoOverrunCnt; // Overruns of the hardware receive FIFO.
 } tUART;
 
 
 
 // Function prototypes.
 void UartInit(tUART *uart);
+void UartIntInit(tUART *psUart, void (*pfnIntHandler)(void));
+void UartIntHandler(tUART *psUart);
 uint32_t UartWrite(tUART *psUart, uint8_t *ui8Data, uint8_t ui8Length);
+uint32_t UartWriteNonBlocking(tUART *psUart, const uint8_t *pui8Data, uint32_t ui32Length);
 uint32_t UartRead(tUART *psUart, uint8_t *ui8Data, uint8_t ui8Length);
+uint32_t UartReadBlocking(tUART *psUart, uint8_t *pui8Data, uint8_t ui8Length);
+uint32_t UartRxAvail(tUART *psUart);
+uint32_t UartTxFree(tUART *psUart);
+void UartStatsReset(tUART *psUart);
 
 
 
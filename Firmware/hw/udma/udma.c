@@ -0,0 +1,41 @@
+// File: udma.c
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 17 Oct 2026
+// Rev.: 17 Oct 2026
+//
+// Micro direct memory access (uDMA) functions on the TI Tiva TM4C1294
+// Connected LaunchPad Evaluation Kit.
+//
+// The uDMA channel control table is shared by all peripherals which use the
+// uDMA controller.
+//
+
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "driverlib/sysctl.h"
+#include "driverlib/udma.h"
+#include "udma.h"
+
+
+
+// uDMA channel control table. It must be aligned to a 1024 byte boundary.
+static tDMAControlTable g_psUdmaControlTable[64] __attribute__ ((aligned(1024)));
+static bool g_bUdmaInitDone = false;
+
+
+
+// Initialize the uDMA controller. It is safe to call this function multiple
+// times.
+void UdmaInit(void)
+{
+    if (g_bUdmaInitDone) return;
+
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_UDMA);
+    while(!SysCtlPeripheralReady(SYSCTL_PERIPH_UDMA));
+    uDMAEnable();
+    uDMAControlBaseSet(g_psUdmaControlTable);
+    g_bUdmaInitDone = true;
+}
@@ -0,0 +1,31 @@
+// File: udma.h
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 17 Oct 2026
+// Rev.: 17 Oct 2026
+//
+// Header file for the micro direct memory access (uDMA) functions on the TI
+// Tiva TM4C1294 Connected LaunchPad Evaluation Kit.
+//
+
+
+
+#ifndef __UDMA_H__
+#define __UDMA_H__
+
+
+
+// Maximum number of items of a single uDMA transfer.
+#define UDMA_XFER_SIZE_MAX      1024
+
+// Get the uDMA channel number from a channel assignment (UDMA_CHn_xxx).
+#define UDMA_CHANNEL_NUM(x)     ((x) & 0xff)
+
+
+
+// Function prototypes.
+void UdmaInit(void);
+
+
+
+#endif  // __UDMA_H__
@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 07 Feb 2020
-// Rev.: 27 Aug 2020
+// Rev.: 17 Oct 2026
 //
 // Hardware demo for the TI Tiva TM4C1294 Connected LaunchPad Evaluation Kit.
 //
@@ -18,10 +18,12 @@
 #include "inc/hw_nvic.h"
 #include "inc/hw_types.h"
 #include "driverlib/i2c.h"
+#include "driverlib/interrupt.h"
 #include "driverlib/rom.h"
 #include "driverlib/rom_map.h"
 #include "driverlib/ssi.h"
 #include "driverlib/sysctl.h"
+#include "driverlib/systick.h"
 #include "driverlib/uart.h"
 #include "utils/uartstdio.h"
 #include "hw/adc/adc.h"
@@ -34,11 +36,17 @@
 #include "hw/lcd/Crystalfontz128x128_ST7735.h"
 #include "hw/lcd/images.h"
 #include "hw/lcd/lcd.h"
+#include "hw/lcd/lcd_bench.h"
 #include "hw/pwm/pwm_rgb_led.h"
 #include "hw/ssi/ssi.h"
 #include "hw/system/system.h"
+#include "hw/system/timebase.h"
 #include "hw/uart/uart.h"
 #include "uart_ui.h"
+#include "bin_proto.h"
+#include "sensor.h"
+#include "task.h"
+#include "ui_cmd.h"
 #include "hw_demo.h"
 #include "hw_demo_io.h"
 
@@ -56,21 +64,40 @@ void __error__(char *pcFilename, uint32_t ui32Line)
 
 // Global variables.
 uint32_t g_ui32SysClock;
+uint8_t g_pui8SsiBenchBuf[SSI_BENCH_BUF_SIZE];
+// Frame of the ADC stream: block number and samples.
+uint32_t g_pui32AdcStreamFrame[1 + ADC_STREAM_BLOCK_LEN / 2];
+// Frame of the sensor log dump: index of the first sample and samples.
+uint32_t g_pui32SensorLogFrame[1 + SENSOR_LOG_FRAME_SAMPLES * sizeof(tSensorSample) / sizeof(uint32_t)];
+// Statistics of pipelined (tagged) commands.
+uint32_t g_ui32PipeCmdCnt;
+uint32_t g_ui32PipeCmdCycleLast;
+uint64_t g_ui64PipeCmdCycles;
+// Information shown on the LCD.
+tLcdFwInfo g_sLcdFwInfo;
+// Off-screen canvas of the status lines on the LCD.
+uint8_t g_pui8LcdStatusImage[LCD_CANVAS_SIZE(4, LCD_STATUS_WIDTH, LCD_STATUS_HEIGHT)];
+tLcdCanvas g_sLcdStatusCanvas;
+// Show a message for each button event.
+bool g_bButtonMsg = false;
 
 
 
 // Function prototypes.
-void Help(void);
-void Info(void);
+int Help(char *pcCmd, char *pcParam);
+int Info(char *pcCmd, char *pcParam);
 int DelayUs(uint32_t ui32DelayUs);
 int DelayUsCmd(char *pcCmd, char *pcParam);
 int McuReset(char *pcCmd, char *pcParam);
 int JumpToBootLoader(char *pcCmd, char *pcParam);
 int AdcRead(char *pcCmd, char *pcParam);
+int AdcStream(char *pcCmd, char *pcParam);
 int ButtonGet(char *pcCmd, char *pcParam);
-int LcdCmd(char *pcCmd, char *pcParam, tLcdFwInfo *psLcdFwInfo);
+void ButtonEventProcess(void);
+int LcdCmd(char *pcCmd, char *pcParam);
 int LcdCheckParamCnt(char *pcLcdCmd, int iLcdParamCntActual, int iLcdParamCntTarget);
 void LcdHelp(void);
+void LcdFlushStats(void);
 int LedGetSet(char *pcCmd, char *pcParam);
 int RgbLedSet(char *pcCmd, char *pcParam);
 int I2CAccess(char *pcCmd, char *pcParam);
@@ -79,14 +106,58 @@ int I2CPortCheck(uint8_t ui8I2CPort, tI2C **psI2C);
 int I2CDetect(char *pcCmd, char *pcParam);
 int TemperatureRead(char *pcCmd, char *pcParam);
 int IlluminanceRead(char *pcCmd, char *pcParam);
+int SensorCmd(char *pcCmd, char *pcParam);
+int SensorLogDump(void);
 int SsiAccess(char *pcCmd, char *pcParam);
 int SsiPortCheck(uint8_t ui8SsiPort, tSSI **psSsi);
 int SsiSetup(char *pcCmd, char *pcParam);
 void SsiSetupHelp(void);
+int SsiBenchmark(char *pcCmd, char *pcParam);
 int UartAccess(char *pcCmd, char *pcParam);
 int UartPortCheck(uint8_t ui8UartPort, tUART **psUart);
 int UartSetup(char *pcCmd, char *pcParam);
 void UartSetupHelp(void);
+int UartBridge(char *pcCmd, char *pcParam);
+int UartStats(char *pcCmd, char *pcParam);
+void PipeCmdStart(void);
+int PipeStats(char *pcCmd, char *pcParam);
+int ConsoleCmd(char *pcCmd, char *pcParam);
+int TasksCmd(char *pcCmd, char *pcParam);
+int PerfCmd(char *pcCmd, char *pcParam);
+void PerfProbeShow(const tPerfProbe *psPerfProbe);
+
+
+
+// Command table. The help text is shown in this order.
+const tUiCmd g_psUiCmd[] = {
+    {"help",    Help,               0, "",                          "Show this help text."},
+    {"adc",     AdcRead,            0, "[COUNT]",                   "Read ADC values."},
+    {"adc-str", AdcStream,          1, "RATE [BLOCKS]",             "Stream ADC values as binary frames (RATE:\n    samples/s per channel, BLOCKS: 0 = until\n    a key is pressed)."},
+    {"bootldr", JumpToBootLoader,   0, "",                          "Enter the boot loader for firmware update."},
+    {"button",  ButtonGet,          0, "[INDEX|msg on|off]",        "Get the status of the buttons or enable/disable\n    the messages on button events."},
+    {"console", ConsoleCmd,         0, "[block|drop|reset]",        "Show the console output statistics, select\n    the policy for a full output buffer or reset\n    the statistics."},
+    {"delay",   DelayUsCmd,         1, "MICROSECONDS",              "Delay execution."},
+    {"i2c",     I2CAccess,          3, "PORT SLV-ADR ACC NUM|DATA", "I2C access (ACC bits: R/W, Sr, nP, Q)."},
+    {"i2c-det", I2CDetect,          1, "PORT [MODE] [FIRST] [LAST]", "I2C detect devices (PORT: 0, 2 or all;\n    MODE: 0 = auto, 1 = quick command, 2 = read;\n    options: --fast = 400 kbps, --map = bitmap)."},
+    {"illum",   IlluminanceRead,    0, "[COUNT]",                   "Read ambient light sensor info."},
+    {"info",    Info,               0, "",                          "Show information about this firmware."},
+    {"lcd",     LcdCmd,             1, "CMD PARAMS",                "LCD commands."},
+    {"led",     LedGetSet,          0, "[VALUE]",                   "Get/Set the value of the user LEDs."},
+    {"perf",    PerfCmd,            0, "[reset]",                   "Show/reset the CPU load and the run time\n    statistics of drivers and commands."},
+    {"pipe",    PipeStats,          0, "[reset]",                   "Show/reset the statistics of pipelined commands."},
+    {"reset",   McuReset,           0, "",                          "Reset the MCU."},
+    {"rgb",     RgbLedSet,          1, "VALUE|EFFECT [VALUE] [MS]", "Set the RGB LED (RGB value = 0xRRGGBB) or run\n    an effect (fade|breathe VALUE MS, ramp MS,\n    stop)."},
+    {"sensor",  SensorCmd,          0, "[start|stop|dump|s0 [S0]]", "Show the status of the sensor log, start/stop\n    logging the TMP006 and OPT3001 sensors at\n    their max. rate or dump the log as binary\n    frames. Get/Set the TMP006 calibration\n    factor S0 (unit: 1e-17)."},
+    {"ssi",     SsiAccess,          2, "PORT R/W NUM|DATA",         "SSI/SPI access (R/W: 0 = write, 1 = read)."},
+    {"ssi-set", SsiSetup,           1, "PORT FREQ [MODE] [WIDTH]",  "Set up the SSI port."},
+    {"ssi-bm",  SsiBenchmark,       1, "PORT [NUM] [MODE]",         "SSI uDMA throughput benchmark (MODE: 0 = write,\n    1 = read, 2 = full-duplex)."},
+    {"tasks",   TasksCmd,           0, "[reset|NAME on|off]",       "Show the periodic tasks, reset their statistics\n    or enable/disable a task."},
+    {"temp",    TemperatureRead,    0, "[COUNT]",                   "Read temperature sensor info."},
+    {"uart",    UartAccess,         2, "PORT R/W NUM|DATA",         "UART access (R/W: 0 = write, 1 = read)."},
+    {"uart-s",  UartSetup,          1, "PORT BAUD [PARITY] [LOOP]", "Set up the UART port."},
+    {"uart-br", UartBridge,         1, "PORT",                      "Bridge the UART port to this console (Ctrl-]\n    quits)."},
+    {"uart-st", UartStats,          1, "PORT [reset]",              "Show/reset the UART buffer statistics."},
+};
 
 
 
@@ -96,80 +167,111 @@ int main(void)
     char pcUartStr[UI_STR_BUF_SIZE];
     char *pcUartCmd;
     char *pcUartParam;
+    char *pcUartTag;
+    int iUartLen;
+    bool bUartPrompt = true;
 
     // Set up the system clock.
     g_ui32SysClock = MAP_SysCtlClockFreqSet(SYSTEM_CLOCK_SETTINGS, SYSTEM_CLOCK_FREQ);
 
+    // Enable the cycle counter for time measurements.
+    CycleCounterInit();
+
+    // Start the timebase for delays and timeouts.
+    TimebaseInit(g_ui32SysClock, true);
+
     // Initialize the UART for the user interface.
     g_sUartUi.ui32SrcClock = g_ui32SysClock;
     UartUiInit(&g_sUartUi);
+    UartUiIntInit(&g_sUartUi, UART7IntHandler);
+    // Without the command hash table, the user interface cannot work.
+    if (UiCmdInit(g_psUiCmd, sizeof(g_psUiCmd) / sizeof(g_psUiCmd[0]))) {
+        UARTprintf("%s: %d commands do not fit into the command hash table. Increase UI_CMD_HASH_SIZE.\n",
+                   UI_STR_ERROR, sizeof(g_psUiCmd) / sizeof(g_psUiCmd[0]));
+        while (1) SysCtlSleep();
+    }
 
     // Initialize the ADCs.
-    AdcReset(&g_sAdcJoystickX);
-    AdcInit(&g_sAdcJoystickX);
-    AdcInit(&g_sAdcJoystickY);
-    AdcReset(&g_sAdcAccelX);
-    AdcInit(&g_sAdcAccelX);
-    AdcInit(&g_sAdcAccelY);
-    AdcInit(&g_sAdcAccelZ);
+    AdcReset(&g_sAdcJoystick);
+    AdcInit(&g_sAdcJoystick);
+    AdcReset(&g_sAdcAccel);
+    AdcInit(&g_sAdcAccel);
+    AdcStreamInit(&g_sAdcStream, ADC1SS0IntHandler);
 
-    // Initialize the user buttons.
-    GpioButtonInit();
+    // Initialize the user buttons. They are debounced by the scheduler tick.
+    GpioButtonInit(TASK_TICKS_PER_SECOND);
 
     // Initialize the LEDs.
     GpioLedInit();
 
     // Initialize the RGB LED on the Educational BoosterPack MK II.
     PwmRgbLedInit();
+    PwmRgbLedFxInit(g_ui32SysClock);
 
     // Initialize the I2C master for the BoosterPack 1 socket.
     g_sI2C0.ui32I2CClk = g_ui32SysClock;
     I2CMasterInit(&g_sI2C0);
+    I2CMasterIntInit(&g_sI2C0, I2C0IntHandler);
 
     // Initialize the I2C master for the Educational BoosterPack MK II
     // (BoosterPack 2 socket).
     g_sI2C2.ui32I2CClk = g_ui32SysClock;
     I2CMasterInit(&g_sI2C2);
+    I2CMasterIntInit(&g_sI2C2, I2C2IntHandler);
 
-    // Initialize the I2C devices.
-    I2CTmp006Reset(&g_sI2C2, EDUMKII_I2C_TMP006_SLV_ADR);
-    I2CTmp006Init(&g_sI2C2, EDUMKII_I2C_TMP006_SLV_ADR);
-    I2COpt3001Reset(&g_sI2C2, EDUMKII_I2C_OPT3001_SLV_ADR);
-    I2COpt3001Init(&g_sI2C2, EDUMKII_I2C_OPT3001_SLV_ADR);
+    // Initialize the I2C devices and read their IDs.
+    SensorInit();
 
     // Initialize SSI 2 for BoosterPack 1.
     g_sSsi2.ui32SsiClk = g_ui32SysClock;
     SsiMasterInit(&g_sSsi2);
+    SsiMasterDmaInit(&g_sSsi2, SSI2IntHandler);
 
     // Initialize SSI 3 for BoosterPack 2.
     g_sSsi3.ui32SsiClk = g_ui32SysClock;
     SsiMasterInit(&g_sSsi3);
+    SsiMasterDmaInit(&g_sSsi3, SSI3IntHandler);
 
     // Initialize the UART on the Educational BoosterPack MKII.
     g_sUart6.ui32UartClk = g_ui32SysClock;
 //    g_sUart6.bLoopback = true;        // Enable loopback for testing.
     UartInit(&g_sUart6);
+    UartIntInit(&g_sUart6, UART6IntHandler);
 
     // Initialize the LCD on the Educational BoosterPack MKII.
     tContext sContext;
     LcdInit(&sContext);
     LcdSetOrientation(&sContext, LCD_ORIENTATION_UP);
-    tLcdFwInfo sLcdFwInfo;
-    sLcdFwInfo.psContext            = &sContext;
-    sLcdFwInfo.ui32ColorBackground  = LCD_COLOR_WHITE;
-    sLcdFwInfo.ui32ColorFrame       = LCD_COLOR_MPG_GREY_DARK;
-    sLcdFwInfo.ui32ColorSeparator   = LCD_COLOR_MPG_GREEN_2;
-    sLcdFwInfo.ui32ColorTitle       = LCD_COLOR_MPG_GREEN_1;
-    sLcdFwInfo.ui32ColorText        = LCD_COLOR_BLACK;
-    sLcdFwInfo.pcTitle              = "TIVA TM4C1294";
-    sLcdFwInfo.pcFwName             = FW_NAME;
-    sLcdFwInfo.pcFwVersion          = FW_VERSION;
-    sLcdFwInfo.pcFwDate             = FW_RELEASEDATE;
-    sLcdFwInfo.pu8ImageData         = g_pui8LogoMpp;
-//    sLcdFwInfo.i32ImageX            = LCD_FRAME_PADDING + LCD_FRAME_WIDTH + LCD_CONTENT_PADDING;
-    sLcdFwInfo.i32ImageX            = -1;           // -1 = Auto center image.
-    sLcdFwInfo.i32ImageY            = 72;
-    LcdFwInfo(&sLcdFwInfo);
+    LcdBatchInit(g_ui32SysClock);
+    g_sLcdFwInfo.psContext            = &sContext;
+    g_sLcdFwInfo.ui32ColorBackground  = LCD_COLOR_WHITE;
+    g_sLcdFwInfo.ui32ColorFrame       = LCD_COLOR_MPG_GREY_DARK;
+    g_sLcdFwInfo.ui32ColorSeparator   = LCD_COLOR_MPG_GREEN_2;
+    g_sLcdFwInfo.ui32ColorTitle       = LCD_COLOR_MPG_GREEN_1;
+    g_sLcdFwInfo.ui32ColorText        = LCD_COLOR_BLACK;
+    g_sLcdFwInfo.pcTitle              = "TIVA TM4C1294";
+    g_sLcdFwInfo.pcFwName             = FW_NAME;
+    g_sLcdFwInfo.pcFwVersion          = FW_VERSION;
+    g_sLcdFwInfo.pcFwDate             = FW_RELEASEDATE;
+    g_sLcdFwInfo.pu8ImageData         = g_pui8LogoMpp;
+//    g_sLcdFwInfo.i32ImageX            = LCD_FRAME_PADDING + LCD_FRAME_WIDTH + LCD_CONTENT_PADDING;
+    g_sLcdFwInfo.i32ImageX            = -1;           // -1 = Auto center image.
+    g_sLcdFwInfo.i32ImageY            = 72;
+    uint32_t pui32LcdStatusPalette[2] = {g_sLcdFwInfo.ui32ColorBackground, g_sLcdFwInfo.ui32ColorText};
+    if (!LcdCanvasInit(&g_sLcdStatusCanvas, g_pui8LcdStatusImage, sizeof(g_pui8LcdStatusImage), 4,
+                       LCD_STATUS_WIDTH, LCD_STATUS_HEIGHT, pui32LcdStatusPalette, 2)) {
+        g_sLcdFwInfo.psStatusCanvas   = &g_sLcdStatusCanvas;
+    }
+    LcdFwInfo(&g_sLcdFwInfo);
+
+    // Initialize the binary command protocol.
+    BinProtoInit(&g_sUartUi, &sContext);
+
+    // Start the CPU load measurement. It requires the scheduler tick.
+    PerfCpuInit(g_ui32SysClock, TASK_TICKS_PER_SECOND, PERF_CPU_TIMER, g_pui32PerfPeriphSleep, g_ui32PerfPeriphSleepNum);
+
+    // Start the scheduler for the periodic tasks.
+    TaskInit(g_ui32SysClock, &g_sLcdFwInfo);
 
     // Send initial information to UART.
     UARTprintf("\n\n*******************************************************************************\n");
@@ -179,114 +281,73 @@ int main(void)
 
     while(1)
     {
-        UARTprintf("%s", UI_COMMAND_PROMPT);
-        UARTgets(pcUartStr, UI_STR_BUF_SIZE);
-        pcUartCmd = strtok(pcUartStr, UI_STR_DELIMITER);
+        if (bUartPrompt) UARTprintf("%s", UI_COMMAND_PROMPT);
+        bUartPrompt = false;
+        // Run the periodic tasks while waiting for a complete line.
+        SchedulerRun();
+        ButtonEventProcess();
+        LcdBatchProcess();
+        iUartLen = UartUiGetsNonBlocking(&g_sUartUi, pcUartStr, UI_STR_BUF_SIZE, BIN_PROTO_SYNC);
+        // Sleep until the next interrupt if there is nothing to do. The
+        // processor wakes up at the latest with the next scheduler tick.
+        if (iUartLen == UART_UI_GETS_PENDING) {
+            SysCtlSleep();
+            continue;
+        }
+        bUartPrompt = true;
+        // Binary frame. No prompt is sent after its response, so a host
+        // using the binary protocol does only receive frames.
+        if (iUartLen == UART_UI_GETS_SYNC) {
+            BinProtoProcess();
+            bUartPrompt = false;
+            continue;
+        }
+        // Pipelined command `@TAG COMMAND [PARAMS]' from a host. The response
+        // starts with `@TAG ' and ends with a line `@TAG.'. No prompt is sent,
+        // as the host does not wait for it. The commands are queued by the UART
+        // receive interrupt while a previous command is being executed.
+        if (pcUartStr[0] == UART_UI_TAG_CHAR) {
+            pcUartTag = strtok(pcUartStr + 1, UI_STR_DELIMITER);
+            pcUartCmd = strtok(NULL, UI_STR_DELIMITER);
+            if (pcUartTag == NULL) pcUartTag = "";
+            UARTprintf("%c%s ", UART_UI_TAG_CHAR, pcUartTag);
+            PipeCmdStart();
+            bUartPrompt = false;
+        } else {
+            pcUartTag = NULL;
+            pcUartCmd = strtok(pcUartStr, UI_STR_DELIMITER);
+        }
         pcUartParam = strtok(NULL, UI_STR_DELIMITER);
         if (pcUartCmd == NULL) {
-            continue;
-        // Show help.
-        } else if (!strcasecmp(pcUartCmd, "help")) {
-            Help();
-        // Show info.
-        } else if (!strcasecmp(pcUartCmd, "info")) {
-            Info();
-        // Delay execution for a given number of microseconds.
-        } else if (!strcasecmp(pcUartCmd, "delay")) {
-            DelayUsCmd(pcUartCmd, pcUartParam);
-        // Reset the MCU.
-        } else if (!strcasecmp(pcUartCmd, "reset")) {
-            McuReset(pcUartCmd, pcUartParam);
-        // Enter the boot loader for firmware update over UART.
-        } else if (!strcasecmp(pcUartCmd, "bootldr")) {
-            JumpToBootLoader(pcUartCmd, pcUartParam);
-        // ADC based functions.
-        } else if (!strcasecmp(pcUartCmd, "adc")) {
-            AdcRead(pcUartCmd, pcUartParam);
-        // GPIO button based functions.
-        } else if (!strcasecmp(pcUartCmd, "button")) {
-            ButtonGet(pcUartCmd, pcUartParam);
-        // I2C based functions.
-        } else if (!strcasecmp(pcUartCmd, "i2c")) {
-            I2CAccess(pcUartCmd, pcUartParam);
-        } else if (!strcasecmp(pcUartCmd, "i2c-det")) {
-            I2CDetect(pcUartCmd, pcUartParam);
-        } else if (!strcasecmp(pcUartCmd, "temp")) {
-            TemperatureRead(pcUartCmd, pcUartParam);
-        } else if (!strcasecmp(pcUartCmd, "illum")) {
-            IlluminanceRead(pcUartCmd, pcUartParam);
-        // LCD based functions.
-        } else if (!strcasecmp(pcUartCmd, "lcd")) {
-            LcdCmd(pcUartCmd, pcUartParam, &sLcdFwInfo);
-        // GPIO LED based functions.
-        } else if (!strcasecmp(pcUartCmd, "led")) {
-            LedGetSet(pcUartCmd, pcUartParam);
-        // PWM based functions.
-        } else if (!strcasecmp(pcUartCmd, "rgb")) {
-            RgbLedSet(pcUartCmd, pcUartParam);
-        // SSI based functions.
-        } else if (!strcasecmp(pcUartCmd, "ssi")) {
-            SsiAccess(pcUartCmd, pcUartParam);
-        } else if (!strcasecmp(pcUartCmd, "ssi-set")) {
-            SsiSetup(pcUartCmd, pcUartParam);
-        // UART based functions.
-        } else if (!strcasecmp(pcUartCmd, "uart")) {
-            UartAccess(pcUartCmd, pcUartParam);
-        } else if (!strcasecmp(pcUartCmd, "uart-s")) {
-            UartSetup(pcUartCmd, pcUartParam);
-//        } else if (!strcasecmp(pcUartCmd, "sysclk")) {
-//            pcUartParam = strtok(NULL, UI_STR_DELIMITER);
-//            if (pcUartParam == NULL) {
-//                UARTprintf("ERROR: Parameter required after command `%s'.", pcUartCmd);
-//            } else {
-//                ui32User0 = strtoul(pcUartParam, (char **) NULL, 0);
-//                ui32User0 &= 0xff;
-//                // Disable or enable the system clock output on the DIVSCLK pin (PQ4).
-//                if (ui32User0 == 0) ClockOutputDisable();
-//                else ClockOutputEnable(ui32User0);
-//                UARTprintf("%s.", UI_STR_OK);
-//            }
+            if (pcUartTag == NULL) continue;
+            UARTprintf("%s: Command required after tag `%s'.", UI_STR_ERROR, pcUartTag);
         } else {
-            UARTprintf("ERROR: Unknown command `%s'.", pcUartCmd);
+            UiCmdExec(pcUartCmd, pcUartParam);
         }
         UARTprintf("\n");
+        if (pcUartTag != NULL) UARTprintf("%c%s.\n", UART_UI_TAG_CHAR, pcUartTag);
     }
 }
 
 
 
 // Show help.
-void Help(void)
+int Help(char *pcCmd, char *pcParam)
 {
-    UARTprintf("Available commands:\n");
-    UARTprintf("  help                                Show this help text.\n");
-    UARTprintf("  adc     [COUNT]                     Read ADC values.\n");
-    UARTprintf("  bootldr                             Enter the boot loader for firmware update.\n");
-    UARTprintf("  button  [INDEX]                     Get the status of the buttons.\n");
-    UARTprintf("  delay   MICROSECONDS                Delay execution.\n");
-    UARTprintf("  i2c     PORT SLV-ADR ACC NUM|DATA   I2C access (ACC bits: R/W, Sr, nP, Q).\n");
-    UARTprintf("  i2c-det PORT [MODE]                 I2C detect devices (MODE: 0 = auto,\n");
-    UARTprintf("                                          1 = quick command, 2 = read).\n");
-    UARTprintf("  illum   [COUNT]                     Read ambient light sensor info.\n");
-    UARTprintf("  info                                Show information about this firmware.\n");
-    UARTprintf("  lcd     CMD PARAMS                  LCD commands.\n");
-    UARTprintf("  led     [VALUE]                     Get/Set the value of the user LEDs.\n");
-    UARTprintf("  reset                               Reset the MCU.\n");
-    UARTprintf("  rgb     VALUE                       Set the RGB LED (RGB value = 0xRRGGBB).\n");
-    UARTprintf("  ssi     PORT R/W NUM|DATA           SSI/SPI access (R/W: 0 = write, 1 = read).\n");
-    UARTprintf("  ssi-set PORT FREQ [MODE] [WIDTH]    Set up the SSI port.\n");
-    UARTprintf("  temp    [COUNT]                     Read temperature sensor info.\n");
-    UARTprintf("  uart    PORT R/W NUM|DATA           UART access (R/W: 0 = write, 1 = read).\n");
-    UARTprintf("  uart-s  PORT BAUD [PARITY] [LOOP]   Set up the UART port.");
+    UiCmdHelp();
+
+    return 0;
 }
 
 
 
 // Show information.
-void Info(void)
+int Info(char *pcCmd, char *pcParam)
 {
     UARTprintf("TIVA TM4C1294 `%s' firmware version %s, release date: %s\n", FW_NAME, FW_VERSION, FW_RELEASEDATE);
     UARTprintf("It was compiled using gcc %s at %s on %s.", __VERSION__, __TIME__, __DATE__);
+
+    return 0;
 }
 
 
@@ -296,10 +357,8 @@ int DelayUs(uint32_t ui32DelayUs)
 {
     // Limit the delay to max. 10 seconds.
     if (ui32DelayUs > 1e7) ui32DelayUs = 1e7;
-    // CAUTION: Calling SysCtlDelay(0) will hang the system.
-    if (ui32DelayUs > 0)
-        // Note: The SysCtlDelay executes a simple 3 instruction cycle loop.
-        SysCtlDelay((g_ui32SysClock / 3e6) * ui32DelayUs);
+    // The processor sleeps while waiting.
+    TimebaseDelayUs(ui32DelayUs);
 
     return 0;
 }
@@ -316,13 +375,7 @@ int DelayUsCmd(char *pcCmd, char *pcParam)
         return -1;
     }
     ui32DelayUs = strtoul(pcParam, (char **) NULL, 0);
-    // Limit the delay to max. 10 seconds.
-    if (ui32DelayUs > 1e7) ui32DelayUs = 1e7;
-    // CAUTION: Calling SysCtlDelay(0) will hang the system.
-    if (ui32DelayUs > 0)
-        // Note: The SysCtlDelay executes a simple 3 instruction cycle loop.
-        SysCtlDelay((g_ui32SysClock / 3e6) * ui32DelayUs);
-
+    DelayUs(ui32DelayUs);
     UARTprintf("%s.", UI_STR_OK);
 
     return 0;
@@ -336,11 +389,14 @@ int McuReset(char *pcCmd, char *pcParam)
     char pcUartStr[4];
 
     UARTprintf("Do you really want to reset the MCU (yes/no)? ");
-    UARTgets(pcUartStr, 4);
+    UartUiGets(&g_sUartUi, pcUartStr, 4, BIN_PROTO_SYNC);
 
     if (!strcasecmp(pcUartStr, "yes")) {
         UARTprintf("%s. Resetting the MCU.", UI_STR_OK);
         // Wait some time for the UART to send out the last message.
+#ifdef UART_BUFFERED
+        UARTFlushTx(false);
+#endif
         DelayUs(1e5);
 
         SysCtlReset();
@@ -358,11 +414,14 @@ int JumpToBootLoader(char *pcCmd, char *pcParam)
     char pcUartStr[4];
 
     UARTprintf("Do you really want to jump to the serial boot loader (yes/no)? ");
-    UARTgets(pcUartStr, 4);
+    UartUiGets(&g_sUartUi, pcUartStr, 4, BIN_PROTO_SYNC);
 
     if (!strcasecmp(pcUartStr, "yes")) {
         UARTprintf("%s. Entering the serial boot loader on UART %d.\n", UI_STR_OK, g_sUartUi.ui32Port);
         // Wait some time for the UART to send out the last message.
+#ifdef UART_BUFFERED
+        UARTFlushTx(false);
+#endif
         DelayUs(1e5);
 
         // Code copied from the EK-TM4C1294XL boot_demo1 example.
@@ -395,7 +454,8 @@ int JumpToBootLoader(char *pcCmd, char *pcParam)
 // Read values from the ADCs.
 int AdcRead(char *pcCmd, char *pcParam)
 {
-    uint32_t ui32Adc;
+    uint32_t pui32Joystick[2];  // X, Y
+    uint32_t pui32Accel[3];     // X, Y, Z
     int iCnt;
 
     if (pcParam == NULL) {
@@ -405,36 +465,18 @@ int AdcRead(char *pcCmd, char *pcParam)
     }
 
     for (int i = 0; i < iCnt; i++) {
+        AdcConvert(&g_sAdcJoystick, pui32Joystick);
+        AdcConvert(&g_sAdcAccel, pui32Accel);
         UARTprintf("%s: ", UI_STR_OK);
         #ifdef ADC_VALUES_HEX
-        // Joystick.
-        ui32Adc = AdcConvert(&sAdcJoystickX);
-        UARTprintf("Joystick: X = 0x%03x ", ui32Adc);
-        ui32Adc = AdcConvert(&sAdcJoystickY);
-        UARTprintf("Y = 0x%03x", ui32Adc);
-        // Accelerometer.
-        ui32Adc = AdcConvert(&sAdcAccelX);
-        UARTprintf(" ; Accelerometer: X = 0x%03x", ui32Adc);
-        ui32Adc = AdcConvert(&sAdcAccelY);
-        UARTprintf(" Y = 0x%03x", ui32Adc);
-        ui32Adc = AdcConvert(&sAdcAccelZ);
-        UARTprintf(" Z = 0x%03x", ui32Adc);
+        UARTprintf("Joystick: X = 0x%03x Y = 0x%03x", pui32Joystick[0], pui32Joystick[1]);
+        UARTprintf(" ; Accelerometer: X = 0x%03x Y = 0x%03x Z = 0x%03x", pui32Accel[0], pui32Accel[1], pui32Accel[2]);
         #else
-        // Joystick.
-        ui32Adc = AdcConvert(&g_sAdcJoystickX);
-        UARTprintf("Joystick: X = %4d ", ui32Adc);
-        ui32Adc = AdcConvert(&g_sAdcJoystickY);
-        UARTprintf("Y = %4d", ui32Adc);
-        // Accelerometer.
-        ui32Adc = AdcConvert(&g_sAdcAccelX);
-        UARTprintf(" ; Accelerometer: X = %4d", ui32Adc);
-        ui32Adc = AdcConvert(&g_sAdcAccelY);
-        UARTprintf(" Y = %4d", ui32Adc);
-        ui32Adc = AdcConvert(&g_sAdcAccelZ);
-        UARTprintf(" Z = %4d", ui32Adc);
+        UARTprintf("Joystick: X = %4d Y = %4d", pui32Joystick[0], pui32Joystick[1]);
+        UARTprintf(" ; Accelerometer: X = %4d Y = %4d Z = %4d", pui32Accel[0], pui32Accel[1], pui32Accel[2]);
         #endif
         if (i < iCnt - 1) {
-            DelayUs(5e4);
+            TaskDelayUs(5e4);
             UARTprintf("\n");
         }
     }
@@ -444,14 +486,99 @@ int AdcRead(char *pcCmd, char *pcParam)
 
 
 
-// Get the status of the GPIO buttons.
+// Stream the values of all ADCs. The samples are taken by the hardware at a
+// fixed rate. Each block of samples is sent as a binary protocol frame that
+// starts with the block number. Blocks completed while the previous one is
+// still being sent are dropped, so the host can detect gaps by the block
+// number.
+int AdcStream(char *pcCmd, char *pcParam)
+{
+    uint32_t pui32Args[2] = {0, 0};     // Rate, number of blocks.
+    uint32_t ui32Block = 0, ui32BlockCnt;
+    uint32_t ui32Sent = 0, ui32Dropped = 0;
+    uint16_t *pui16Data = (uint16_t *) &g_pui32AdcStreamFrame[1];
+    uint8_t ui8Status;
+    bool bIntDisabled;
+
+    if (UiCmdParseArgs(pcParam, pui32Args, 2) < 0) return -1;
+    if (AdcStreamStart(&g_sAdcStream, g_ui32SysClock, pui32Args[0])) {
+        UARTprintf("%s: The sample rate must be between 1 and %d samples/s per channel.",
+                   UI_STR_ERROR, ADC_STREAM_SAMPLE_RATE_MAX / ADC_STREAM_CHANNELS);
+        return -1;
+    }
+    // Send the latest block until the requested number of blocks is sent or
+    // a key is pressed.
+    while (g_sAdcStream.bRunning) {
+        if (UartUiCharGetNonBlocking(&g_sUartUi) >= 0) break;
+        ui32BlockCnt = g_sAdcStream.ui32BlockCnt;
+        // Run the periodic tasks while waiting for the next block. Then sleep
+        // until the next interrupt, e.g. the uDMA interrupt of the next block
+        // or the scheduler tick. The block count is checked again with
+        // disabled interrupts, so a block completed right before is not
+        // missed.
+        if (ui32BlockCnt == ui32Block) {
+            SchedulerRun();
+            bIntDisabled = IntMasterDisable();
+            if (g_sAdcStream.bRunning && (g_sAdcStream.ui32BlockCnt == ui32Block)) SysCtlSleep();
+            if (!bIntDisabled) IntMasterEnable();
+            continue;
+        }
+        ui8Status = BIN_PROTO_STATUS_OK;
+        if (ui32BlockCnt - ui32Block > 1) {
+            ui32Dropped += ui32BlockCnt - ui32Block - 1;
+            ui8Status = BIN_PROTO_STATUS_WARNING;
+        }
+        ui32Block = ui32BlockCnt - 1;
+        if (AdcStreamBlockCopy(&g_sAdcStream, ui32Block, pui16Data)) {
+            ui32Dropped++;
+            ui32Block++;
+            continue;
+        }
+        g_pui32AdcStreamFrame[0] = ui32Block;
+        BinProtoSendData(ui32Block & 0xff, BIN_PROTO_OPCODE_ADC_STREAM, ui8Status,
+                         g_pui32AdcStreamFrame, sizeof(g_pui32AdcStreamFrame));
+        ui32Block++;
+        ui32Sent++;
+        if (pui32Args[1] && ui32Sent >= pui32Args[1]) break;
+    }
+    AdcStreamStop(&g_sAdcStream);
+    UARTprintf("\n");
+    if (g_sAdcStream.ui32OverrunCnt) {
+        UARTprintf("%s: uDMA overrun of the ADC stream after %d blocks.", UI_STR_ERROR, g_sAdcStream.ui32BlockCnt);
+        return -1;
+    }
+    UARTprintf("%s. Sample rate: %d samples/s per channel. Blocks captured: %d, sent: %d, dropped: %d.", UI_STR_OK,
+               g_ui32SysClock / (g_ui32SysClock / pui32Args[0]), g_sAdcStream.ui32BlockCnt, ui32Sent, ui32Dropped);
+
+    return 0;
+}
+
+
+
+// Get the status of the GPIO buttons or enable/disable the messages on button
+// events.
 int ButtonGet(char *pcCmd, char *pcParam)
 {
     uint32_t ui32ButtonIndex;
+    char *pcState;
 
     if (pcParam == NULL) {
         UARTprintf("%s. ", UI_STR_OK);
         UARTprintf("Button %d..0 status: 0x%01x", GPIO_BUTTON_NUM - 1, GpioButtonGet());
+        if (g_ui32GpioButtonEventDropCnt) {
+            UARTprintf("\n%s: Button events dropped: %u.", UI_STR_WARNING, g_ui32GpioButtonEventDropCnt);
+        }
+    } else if (!strcasecmp(pcParam, "msg")) {
+        pcState = strtok(NULL, UI_STR_DELIMITER);
+        if (pcState != NULL && !strcasecmp(pcState, "on")) {
+            g_bButtonMsg = true;
+        } else if (pcState != NULL && !strcasecmp(pcState, "off")) {
+            g_bButtonMsg = false;
+        } else {
+            UARTprintf("%s: `on' or `off' required after `%s'.", UI_STR_ERROR, pcParam);
+            return -1;
+        }
+        UARTprintf("%s.", UI_STR_OK);
     } else {
         ui32ButtonIndex = strtoul(pcParam, (char **) NULL, 0);
         if (ui32ButtonIndex >= GPIO_BUTTON_NUM) {
@@ -460,18 +587,35 @@ int ButtonGet(char *pcCmd, char *pcParam)
         }
         UARTprintf("%s. ", UI_STR_OK);
         UARTprintf("Button %d status: 0x%1x, pressed count: %d, released count: %d",
-                   ui32ButtonIndex, g_ui8GpioButtonStatus[ui32ButtonIndex],
-                   g_ui32GpioButtonPressedCnt[ui32ButtonIndex],
-                   g_ui32GpioButtonReleasedCnt[ui32ButtonIndex]);
+                   ui32ButtonIndex, g_psGpioButton[ui32ButtonIndex].ui8Status,
+                   g_psGpioButton[ui32ButtonIndex].ui32PressedCnt,
+                   g_psGpioButton[ui32ButtonIndex].ui32ReleasedCnt);
     }
     return 0;
 }
 
 
 
+// Process the button events queued by the button driver. The events are
+// shown on the console if enabled.
+void ButtonEventProcess(void)
+{
+    tGpioButtonEvent sEvent;
+
+    while (GpioButtonEventGet(&sEvent)) {
+        if (!g_bButtonMsg) continue;
+        UARTprintf("%s %s at %u ms.\n", g_ppcGpioButtonName[sEvent.ui8Button],
+                   sEvent.ui8Status == GPIO_BUTTON_PRESSED ? "pressed" : "released",
+                   (uint32_t) (sEvent.ui64Ticks / (g_ui32SysClock / 1000)));
+    }
+}
+
+
+
 // LCD commands.
-int LcdCmd(char *pcCmd, char *pcParam, tLcdFwInfo *psLcdFwInfo)
+int LcdCmd(char *pcCmd, char *pcParam)
 {
+    tLcdFwInfo *psLcdFwInfo = &g_sLcdFwInfo;
     char *pcLcdCmd = pcParam;
     #define LCD_CMD_PARAM_MAX 64
     char *pcLcdParam[LCD_CMD_PARAM_MAX];
@@ -486,6 +630,8 @@ int LcdCmd(char *pcCmd, char *pcParam, tLcdFwInfo *psLcdFwInfo)
         LcdHelp();
         return -1;
     }
+    // The LCD is used by this command, so stop showing the sensor values.
+    TaskEnable(TASK_LCD, false);
     // Parse parameters of the LCD command.
     for (int i = 0; i < LCD_CMD_PARAM_MAX; i++) {
         iLcdParamCnt = i;
@@ -517,6 +663,47 @@ int LcdCmd(char *pcCmd, char *pcParam, tLcdFwInfo *psLcdFwInfo)
     } else if (!strcasecmp(pcLcdCmd, "info")) {
         if ((iRet = LcdCheckParamCnt(pcLcdCmd, iLcdParamCnt, 0)) < 0) return iRet;
         LcdFwInfo(psLcdFwInfo);
+    // Start batch mode.
+    } else if (!strcasecmp(pcLcdCmd, "begin")) {
+        if (iLcdParamCnt == 0) {
+            LcdBatchBegin(psLcdFwInfo->psContext, LCD_BATCH_TIMEOUT_DEFAULT);
+        } else {
+            if ((iRet = LcdCheckParamCnt(pcLcdCmd, iLcdParamCnt, 1)) < 0) return iRet;
+            LcdBatchBegin(psLcdFwInfo->psContext,
+                          strtoul(pcLcdParam[0], (char **) NULL, 0));  // ui32TimeoutMs
+        }
+    // Commit batch mode.
+    } else if (!strcasecmp(pcLcdCmd, "commit")) {
+        if ((iRet = LcdCheckParamCnt(pcLcdCmd, iLcdParamCnt, 0)) < 0) return iRet;
+        if (!LcdBatchActive()) UARTprintf("%s: Batch mode was not active. ", UI_STR_WARNING);
+        LcdBatchCommit(psLcdFwInfo->psContext);
+    // Benchmark the former and the current drawing functions.
+    } else if (!strcasecmp(pcLcdCmd, "bench")) {
+        tLcdBench psLcdBench[LCD_BENCH_NUM];
+        uint32_t ui32Loops = LCD_BENCH_LOOPS_DEFAULT;
+        if (iLcdParamCnt > 0) {
+            if ((iRet = LcdCheckParamCnt(pcLcdCmd, iLcdParamCnt, 1)) < 0) return iRet;
+            ui32Loops = strtoul(pcLcdParam[0], (char **) NULL, 0);
+        }
+        // The auto-commit of the batch mode would swap the frame buffers.
+        if (LcdBatchActive()) {
+            UARTprintf("%s: The LCD command `%s' is not available in batch mode!", UI_STR_ERROR, pcLcdCmd);
+            return -1;
+        }
+        if (LcdBench(psLcdFwInfo->psContext, ui32Loops, psLcdBench) < 0) {
+            UARTprintf("%s: The LCD command `%s' requires a 16 bpp frame buffer and 1 to %d loops!",
+                       UI_STR_ERROR, pcLcdCmd, LCD_BENCH_LOOPS_MAX);
+            return -1;
+        }
+        UARTprintf("%s. Cycles per loop (former/current drawing functions):", UI_STR_OK);
+        for (int i = 0; i < LCD_BENCH_NUM; i++) {
+            uint32_t ui32Speedup = psLcdBench[i].ui32CyclesOld * 100 / (psLcdBench[i].ui32CyclesNew ? psLcdBench[i].ui32CyclesNew : 1);
+            UARTprintf("\n  %16s: %8u / %8u, speedup: %u.%02u%s", psLcdBench[i].pcName,
+                       psLcdBench[i].ui32CyclesOld, psLcdBench[i].ui32CyclesNew,
+                       ui32Speedup / 100, ui32Speedup % 100,
+                       psLcdBench[i].bMatch ? "" : ", frames differ");
+        }
+        return 0;
     // Draw circle.
     } else if (!strcasecmp(pcLcdCmd, "circle")) {
         if ((iRet = LcdCheckParamCnt(pcLcdCmd, iLcdParamCnt, 5)) < 0) return iRet;
@@ -571,6 +758,32 @@ int LcdCmd(char *pcCmd, char *pcParam, tLcdFwInfo *psLcdFwInfo)
                     strtol(pcLcdParam[1], (char **) NULL, 0),       // i32Y
                     strtoul(pcLcdParam[2], (char **) NULL, 0),      // ui32Color
                     strtoul(pcLcdParam[3], (char **) NULL, 0));     // bCenter
+    // Show or reset the flush statistics.
+    } else if (!strcasecmp(pcLcdCmd, "stats")) {
+        if (iLcdParamCnt == 0) {
+            LcdFlushStats();
+            return 0;
+        }
+        if ((iRet = LcdCheckParamCnt(pcLcdCmd, iLcdParamCnt, 1)) < 0) return iRet;
+        if (strcasecmp(pcLcdParam[0], "reset")) {
+            UARTprintf("%s: Unknown parameter `%s' of the LCD command `%s'!", UI_STR_ERROR, pcLcdParam[0], pcLcdCmd);
+            return -1;
+        }
+        Crystalfontz128x128_ResetFlushStats();
+    // Send the frame to the LCD.
+    } else if (!strcasecmp(pcLcdCmd, "swap")) {
+        if (iLcdParamCnt == 0) {
+            LcdSwap(psLcdFwInfo->psContext, false);
+        } else {
+            if ((iRet = LcdCheckParamCnt(pcLcdCmd, iLcdParamCnt, 1)) < 0) return iRet;
+            if (strcasecmp(pcLcdParam[0], "sync")) {
+                UARTprintf("%s: Unknown parameter `%s' of the LCD command `%s'!", UI_STR_ERROR, pcLcdParam[0], pcLcdCmd);
+                return -1;
+            }
+            LcdSwap(psLcdFwInfo->psContext, true);
+            UARTprintf("%s. Frame time: %u us.", UI_STR_OK, Lcd_FrameCyclesLast / (g_ui32SysClock / 1000000));
+            return 0;
+        }
     } else {
         UARTprintf("%s: Unknown LCD command `%s'!\n", UI_STR_ERROR, pcLcdCmd);
         LcdHelp();
@@ -609,17 +822,53 @@ void LcdHelp(void)
     UARTprintf("Available LCD commands:\n");
     UARTprintf("  help                                Show this help text.\n");
     UARTprintf("  info                                Show firmware info.\n");
+    UARTprintf("  begin   [TIMEOUT]                   Start batch mode (auto-commit after TIMEOUT ms,\n");
+    UARTprintf("                                          0 = never, default: %d ms).\n", LCD_BATCH_TIMEOUT_DEFAULT);
+    UARTprintf("  commit                              End batch mode and update the LCD.\n");
+    UARTprintf("  bench   [LOOPS]                     Benchmark the drawing functions (default: %d loops).\n", LCD_BENCH_LOOPS_DEFAULT);
     UARTprintf("  circle  X Y RADIUS COLOR FILL       Draw a circle.\n");
     UARTprintf("  clear   COLOR                       Fill the LCD with COLOR.\n");
     UARTprintf("  line    X1 Y1 X2 Y2 COLOR           Draw a line.\n");
     UARTprintf("  orient  ORIENT                      Set the LCD orientation.\n");
     UARTprintf("  pixel   X Y COLOR                   Draw a pixel.\n");
     UARTprintf("  rect    X1 Y1 X2 Y2 COLOR FILL      Draw a rectangle.\n");
+    UARTprintf("  stats   [reset]                     Show/reset the flush and frame statistics.\n");
+    UARTprintf("  swap    [sync]                      Send the frame to the LCD (sync: wait until sent).\n");
     UARTprintf("  text    X Y COLOR CENTER TEXT       Draw a text message.");
 }
 
 
 
+// Show the LCD flush statistics.
+void LcdFlushStats(void)
+{
+    uint32_t ui32CyclesPerUs = g_ui32SysClock / 1000000;
+
+    UARTprintf("%s. Flushes: %u, bytes sent: %u", UI_STR_OK, Lcd_FlushCount, Lcd_FlushBytes);
+    if (Lcd_FlushCount == 0) {
+        UARTprintf(".");
+        return;
+    }
+    UARTprintf(", last flush: %u us, average flush: %u us (%u frames/s)",
+               Lcd_FlushCyclesLast / ui32CyclesPerUs,
+               (uint32_t) (Lcd_FlushCycles / Lcd_FlushCount / ui32CyclesPerUs),
+               (uint32_t) ((uint64_t) Lcd_FlushCount * g_ui32SysClock / (Lcd_FlushCycles ? Lcd_FlushCycles : 1)));
+    // The frame time includes the transfer in the background.
+    if (Lcd_FrameCount) {
+        UARTprintf(", last frame: %u us, average frame: %u us",
+                   Lcd_FrameCyclesLast / ui32CyclesPerUs,
+                   (uint32_t) (Lcd_FrameCycles / Lcd_FrameCount / ui32CyclesPerUs));
+    }
+    UARTprintf(", %d bpp frame buffer", LCD_BUFFER_BPP);
+#ifdef LCD_DOUBLE_BUFFER
+    UARTprintf(", double buffered.");
+#else
+    UARTprintf(".");
+#endif
+}
+
+
+
 // Get/Set the value of the user LEDs.
 int LedGetSet(char *pcCmd, char *pcParam)
 {
@@ -645,14 +894,33 @@ int LedGetSet(char *pcCmd, char *pcParam)
 
 
 
-// Set the RGB LED on the Educational BoosterPack MK II.
+// Set the RGB LED on the Educational BoosterPack MK II or run an effect.
 int RgbLedSet(char *pcCmd, char *pcParam)
 {
     uint32_t ui32RgbLedSet;
+    uint32_t pui32Args[2] = {0, 1000};
+    uint8_t ui8Effect;
 
     if (pcParam == NULL) {
         UARTprintf("%s: Parameter required after command `%s'.", UI_STR_ERROR, pcCmd);
         return -1;
+    } else if (!strcasecmp(pcParam, "stop")) {
+        PwmRgbLedFxStop();
+        UARTprintf("%s: RGB LED effect stopped.", UI_STR_OK);
+    } else if (!strcasecmp(pcParam, "fade") || !strcasecmp(pcParam, "breathe") || !strcasecmp(pcParam, "ramp")) {
+        if (!strcasecmp(pcParam, "fade")) ui8Effect = PWM_RGB_LED_FX_FADE;
+        else if (!strcasecmp(pcParam, "breathe")) ui8Effect = PWM_RGB_LED_FX_BREATHE;
+        else ui8Effect = PWM_RGB_LED_FX_RAMP;
+        // The color ramp has no color parameter. The duration defaults to 1 s.
+        for (int i = (ui8Effect == PWM_RGB_LED_FX_RAMP) ? 1 : 0; i < 2; i++) {
+            if ((pcParam = strtok(NULL, UI_STR_DELIMITER)) == NULL) break;
+            pui32Args[i] = strtoul(pcParam, (char **) NULL, 0);
+        }
+        if (PwmRgbLedFxStart(ui8Effect, pui32Args[0] & 0xffffff, pui32Args[1])) {
+            UARTprintf("%s: Cannot start the RGB LED effect.", UI_STR_ERROR);
+            return -1;
+        }
+        UARTprintf("%s: RGB LED effect started.", UI_STR_OK);
     } else {
         ui32RgbLedSet = strtoul(pcParam, (char **) NULL, 0) & 0xffffff;
         PwmRgbLedSet((ui32RgbLedSet & 0xff0000) >> 16, (ui32RgbLedSet & 0x00ff00) >> 8, (ui32RgbLedSet & 0x0000ff) >> 0);
@@ -678,51 +946,36 @@ int I2CAccess(char *pcCmd, char *pcParam)
     bool bI2CQuickCmd = false;      // Quick command.
     uint8_t ui8I2CDataNum = 0;
     uint8_t pui8I2CData[32];
+    uint32_t pui32Args[3 + sizeof(pui8I2CData) / sizeof(pui8I2CData[0])];
+    int iArgs;
     uint32_t ui32I2CMasterStatus;
     // Parse parameters.
-    for (i = 0; i < sizeof(pui8I2CData) / sizeof(pui8I2CData[0]); i++) {
-        if (i != 0) pcParam = strtok(NULL, UI_STR_DELIMITER);
-        if (i == 0) {
-            if (pcParam == NULL) {
-                UARTprintf("%s: I2C port number required after command `%s'.\n", UI_STR_ERROR, pcCmd);
-                I2CAccessHelp();
-                return -1;
-            } else {
-                ui8I2CPort = (uint8_t) strtoul(pcParam, (char **) NULL, 0) & 0xff;
-            }
-        } else if (i == 1) {
-            if (pcParam == NULL) {
-                UARTprintf("%s: I2C slave address required after command `%s'.\n", UI_STR_ERROR, pcCmd);
-                I2CAccessHelp();
-                return -1;
-            } else {
-                ui8I2CSlaveAddr = (uint8_t) strtoul(pcParam, (char **) NULL, 0) & 0xff;
-            }
-        } else if (i == 2) {
-            if (pcParam == NULL) {
-                UARTprintf("%s: I2C access mode required after command `%s'.\n", UI_STR_ERROR, pcCmd);
-                I2CAccessHelp();
-                return -1;
-            } else {
-                ui8I2CAccMode = (uint8_t) strtoul(pcParam, (char **) NULL, 0) & 0x0f;
-                ui8I2CRw = ui8I2CAccMode & 0x1;
-                bI2CRepeatedStart = (ui8I2CAccMode & 0x2) ? true : false;
-                bI2CStop = (ui8I2CAccMode & 0x4) ? false : true;
-                bI2CQuickCmd = (ui8I2CAccMode & 0x8) ? true : false;
-            }
-        } else {
-            if (i == 3 && ui8I2CRw == 0 && !bI2CQuickCmd && pcParam == NULL) {
-                UARTprintf("%s: At least one data byte required after I2C write command `%s'.\n", UI_STR_ERROR, pcCmd);
-                I2CAccessHelp();
-                return -1;
-            }
-            if (pcParam == NULL) break;
-            else pui8I2CData[i-3] = (uint8_t) strtoul(pcParam, (char **) NULL, 0) & 0xff;
-        }
+    if ((iArgs = UiCmdParseArgs(pcParam, pui32Args, sizeof(pui32Args) / sizeof(pui32Args[0]))) < 0) {
+        I2CAccessHelp();
+        return -1;
+    }
+    ui8I2CPort = pui32Args[0] & 0xff;
+    ui8I2CSlaveAddr = pui32Args[1] & 0xff;
+    ui8I2CAccMode = pui32Args[2] & 0x0f;
+    ui8I2CRw = ui8I2CAccMode & 0x1;
+    bI2CRepeatedStart = (ui8I2CAccMode & 0x2) ? true : false;
+    bI2CStop = (ui8I2CAccMode & 0x4) ? false : true;
+    bI2CQuickCmd = (ui8I2CAccMode & 0x8) ? true : false;
+    if (iArgs == 3 && ui8I2CRw == 0 && !bI2CQuickCmd) {
+        UARTprintf("%s: At least one data byte required after I2C write command `%s'.\n", UI_STR_ERROR, pcCmd);
+        I2CAccessHelp();
+        return -1;
     }
-    if (i < 3) return -1;
+    for (i = 3; i < iArgs; i++) pui8I2CData[i-3] = pui32Args[i] & 0xff;
     // Check if the I2C port number is valid. If so, set the psI2C pointer to the selected I2C port struct.
     if (I2CPortCheck(ui8I2CPort, &psI2C)) return -1;
+    // The I2C port 2 of the sensors is used by this command, so stop reading
+    // them. The sensor task and the sensor log must not access the bus between
+    // a transfer without stop condition and the next one with a repeated start.
+    if (psI2C == &g_sI2C2) {
+        TaskEnable(TASK_SENSOR, false);
+        SensorLogPause(true);
+    }
     // I2C quick command.
     if (bI2CQuickCmd) {
         ui32I2CMasterStatus = I2CMasterQuickCmdAdv(psI2C, ui8I2CSlaveAddr, ui8I2CRw, bI2CRepeatedStart);
@@ -741,6 +994,8 @@ int I2CAccess(char *pcCmd, char *pcParam)
             ui32I2CMasterStatus = I2CMasterReadAdv(psI2C, ui8I2CSlaveAddr, pui8I2CData, ui8I2CDataNum, bI2CRepeatedStart, bI2CStop);
         }
     }
+    // Resume the sensor log once the bus is released.
+    if ((psI2C == &g_sI2C2) && (ui32I2CMasterStatus || !I2CMasterXferBusHeld(psI2C))) SensorLogPause(false);
     // Check the I2C status.
     if (ui32I2CMasterStatus) {
         UARTprintf("%s: Error flags from I2C the master %d: 0x%08x", UI_STR_ERROR, ui8I2CPort, ui32I2CMasterStatus);
@@ -792,56 +1047,94 @@ int I2CPortCheck(uint8_t ui8I2CPort, tI2C **psI2C)
 
 
 
-// Detect I2C devices.
+// Detect I2C devices. The ports are scanned concurrently if all ports are
+// selected. The slave address range can be limited. With the option `--fast'
+// the scan runs at 400 kbps and with the option `--map' the result is shown
+// as a bitmap of the slave addresses.
 int I2CDetect(char *pcCmd, char *pcParam)
 {
     int i;
     tI2C *psI2C;
+    tI2C *ppsI2C[2];
+    tI2CScan psScan[2];
+    bool pbFast[2];
+    int iPorts, iScans;
+    bool bAll = false, bFast = false, bMap = false;
     uint8_t ui8I2CPort = 0;
-    uint8_t ui8I2CSlaveAddr = 0;
-    uint8_t ui8I2CDetectMode = 0;   // 0 = auto; 1 = quick command; 2 = read
-    uint8_t pui8I2CData[1];
-    uint32_t ui32I2CMasterStatus;
-    // Parse parameters.
-    for (i = 0; i < 4; i++) {
-        if (i != 0) pcParam = strtok(NULL, UI_STR_DELIMITER);
-        if (i == 0) {
-            if (pcParam == NULL) {
-                UARTprintf("%s: I2C port number required after command `%s'.", UI_STR_ERROR, pcCmd);
-                return -1;
-            } else {
-                ui8I2CPort = (uint8_t) strtoul(pcParam, (char **) NULL, 0) & 0xff;
-            }
-        } else if (i == 1 && pcParam != NULL) {
+    uint8_t ui8I2CDetectMode = I2C_SCAN_MODE_AUTO;
+    uint8_t pui8I2CAddr[2] = {0x01, 0x7f};  // First and last slave address.
+    uint32_t ui32I2CMasterStatus = 0;
+    // Parse parameters. The options can be given anywhere after the port.
+    if (pcParam == NULL) {
+        UARTprintf("%s: I2C port number required after command `%s'.", UI_STR_ERROR, pcCmd);
+        return -1;
+    }
+    if (!strcasecmp(pcParam, "all")) bAll = true;
+    else ui8I2CPort = (uint8_t) strtoul(pcParam, (char **) NULL, 0) & 0xff;
+    for (i = 0; (pcParam = strtok(NULL, UI_STR_DELIMITER)) != NULL; ) {
+        if (!strcasecmp(pcParam, "--fast")) {
+            bFast = true;
+        } else if (!strcasecmp(pcParam, "--map")) {
+            bMap = true;
+        } else if (i == 0) {
             ui8I2CDetectMode = (uint8_t) strtoul(pcParam, (char **) NULL, 0) & 0x0f;
-        } else {
-            break;
+            i++;
+        } else if (i < 3) {
+            pui8I2CAddr[i - 1] = (uint8_t) strtoul(pcParam, (char **) NULL, 0) & 0xff;
+            // Only the first slave address given: Scan this slave address.
+            if (i == 1) pui8I2CAddr[1] = pui8I2CAddr[0];
+            i++;
         }
     }
-    if (i < 1) return -1;
+    if (pui8I2CAddr[0] > pui8I2CAddr[1] || pui8I2CAddr[1] > 0x7f) {
+        UARTprintf("%s: Invalid slave address range 0x%02x..0x%02x!", UI_STR_ERROR, pui8I2CAddr[0], pui8I2CAddr[1]);
+        return -1;
+    }
     // Check if the I2C port number is valid. If so, set the psI2C pointer to the selected I2C port struct.
-    if (I2CPortCheck(ui8I2CPort, &psI2C)) return -1;
-    // Detect I2C devices based on the i2cdetect program of the i2c-tools.
-    // Please see: https://github.com/mozilla-b2g/i2c-tools/blob/master/tools/i2cdetect.c
+    if (bAll) {
+        ppsI2C[0] = &g_sI2C0;
+        ppsI2C[1] = &g_sI2C2;
+        iPorts = 2;
+    } else {
+        if (I2CPortCheck(ui8I2CPort, &psI2C)) return -1;
+        ppsI2C[0] = psI2C;
+        iPorts = 1;
+    }
+    // Start the scans on all selected ports, then wait until they are done.
+    // If a scan cannot be started, the scans already running are finished
+    // before the error is reported.
+    for (i = 0; i < iPorts; i++) {
+        pbFast[i] = ppsI2C[i]->bFast;
+        if (bFast) I2CMasterSpeedSet(ppsI2C[i], true);
+        if (I2CScanStart(&psScan[i], ppsI2C[i], pui8I2CAddr[0], pui8I2CAddr[1], ui8I2CDetectMode)) {
+            if (bFast) I2CMasterSpeedSet(ppsI2C[i], pbFast[i]);
+            break;
+        }
+    }
+    iScans = i;
+    for (i = 0; i < iScans; i++) {
+        ui32I2CMasterStatus |= I2CScanWait(&psScan[i]);
+        if (bFast) I2CMasterSpeedSet(ppsI2C[i], pbFast[i]);
+    }
+    if (iScans < iPorts) {
+        UARTprintf("%s: Cannot start detecting I2C devices on port %d!", UI_STR_ERROR, ppsI2C[iScans] == &g_sI2C0 ? 0 : 2);
+        return -1;
+    }
+    if (ui32I2CMasterStatus) {
+        UARTprintf("%s: Timeout while detecting I2C devices!", UI_STR_ERROR);
+        return -1;
+    }
     UARTprintf("%s. I2C device(s) found at slave address:", UI_STR_OK);
-    for (ui8I2CSlaveAddr = 1; ui8I2CSlaveAddr <= 0x7f; ui8I2CSlaveAddr++) {
-        switch (ui8I2CDetectMode) {
-            // Detection mode using I2C quick command.
-            case 1:
-                ui32I2CMasterStatus = I2CMasterQuickCmd(psI2C, ui8I2CSlaveAddr, false);   // false = write; true = read
-            // Detection mode using I2C read command.
-            case 2:
-                ui32I2CMasterStatus = I2CMasterRead(psI2C, ui8I2CSlaveAddr, pui8I2CData, 1);
-            // Automatic mode. Use I2C quick command or I2C read based on the slave address.
-            default:
-                if ((ui8I2CSlaveAddr >= 0x30 && ui8I2CSlaveAddr <= 0x37)
-                    || (ui8I2CSlaveAddr >= 0x50 && ui8I2CSlaveAddr <= 0x5F)) {
-                    ui32I2CMasterStatus = I2CMasterRead(psI2C, ui8I2CSlaveAddr, pui8I2CData, 1);
-                } else {
-                    ui32I2CMasterStatus = I2CMasterQuickCmd(psI2C, ui8I2CSlaveAddr, false);   // false = write; true = read
-                }
+    for (i = 0; i < iPorts; i++) {
+        if (bAll) UARTprintf("\n  Port %d:", ppsI2C[i] == &g_sI2C0 ? 0 : 2);
+        if (bMap) {
+            UARTprintf(" 0x%08x%08x%08x%08x", psScan[i].pui32Map[3], psScan[i].pui32Map[2],
+                       psScan[i].pui32Map[1], psScan[i].pui32Map[0]);
+            continue;
+        }
+        for (uint32_t ui32Addr = pui8I2CAddr[0]; ui32Addr <= pui8I2CAddr[1]; ui32Addr++) {
+            if (I2CScanFound(&psScan[i], ui32Addr)) UARTprintf(" 0x%02x", ui32Addr);
         }
-        if (!ui32I2CMasterStatus) UARTprintf(" 0x%02x", ui8I2CSlaveAddr);
     }
 
     return 0;
@@ -853,9 +1146,9 @@ int I2CDetect(char *pcCmd, char *pcParam)
 // BoosterPack MK II.
 int TemperatureRead(char *pcCmd, char *pcParam)
 {
-    float fTemp;
-    uint32_t ui32Tmp006ManufacturerId;
-    uint32_t ui32Tmp006DeviceId;
+    int32_t i32Temp, i32ObjTemp;
+    uint32_t ui32I2CMasterStatus;
+    tSensorId *psId = &g_psSensorId[SENSOR_TMP006];
     int iCnt;
 
     if (pcParam == NULL) {
@@ -865,20 +1158,28 @@ int TemperatureRead(char *pcCmd, char *pcParam)
     }
 
     for (int i = 0; i < iCnt; i++) {
-        fTemp = I2CTmp006ReadTemp(&g_sI2C2, EDUMKII_I2C_TMP006_SLV_ADR);
-        ui32Tmp006ManufacturerId = I2CTmp006ReadManufacturerId(&g_sI2C2, EDUMKII_I2C_TMP006_SLV_ADR);
-        ui32Tmp006DeviceId = I2CTmp006ReadDeviceId(&g_sI2C2, EDUMKII_I2C_TMP006_SLV_ADR);
-        if ((ui32Tmp006ManufacturerId == ~0) || (ui32Tmp006DeviceId == ~0)) {
+        ui32I2CMasterStatus = I2CTmp006ReadTempFixed(&g_sI2C2, EDUMKII_I2C_TMP006_SLV_ADR, &i32Temp);
+        ui32I2CMasterStatus |= I2CTmp006ReadObjTempFixed(&g_sI2C2, EDUMKII_I2C_TMP006_SLV_ADR, g_ui32SensorTmp006S0, &i32ObjTemp);
+        // The IDs were read at initialization.
+        if ((psId->ui32ManufacturerId == ~0) || (psId->ui32DeviceId == ~0) || ui32I2CMasterStatus) {
             UARTprintf("%s: Cannot read from the TMP006 IC.", UI_STR_ERROR);
             return -1;
         } else {
-            UARTprintf("%s: Temperature = %s%d.%05d *C ; Manufacturer ID = 0x%04x ; Device ID = 0x%04x",
+            UARTprintf("%s: Temperature = %s%d.%05d *C ; ",
                         UI_STR_OK,
-                        fTemp < 0 ? "-" : "", (int) abs(fTemp), (int) abs((fTemp - (int) fTemp) * 100000),
-                        ui32Tmp006ManufacturerId, ui32Tmp006DeviceId);
+                        i32Temp < 0 ? "-" : "", abs(i32Temp) >> I2C_TMP006_TEMP_FRAC_BITS,
+                        (abs(i32Temp) & ((1 << I2C_TMP006_TEMP_FRAC_BITS) - 1)) * (100000 >> I2C_TMP006_TEMP_FRAC_BITS));
+            if (i32ObjTemp == I2C_TMP006_OBJ_TEMP_INVALID) {
+                UARTprintf("Object temperature = invalid ; ");
+            } else {
+                UARTprintf("Object temperature = %s%d.%05d *C ; ",
+                            i32ObjTemp < 0 ? "-" : "", abs(i32ObjTemp) >> I2C_TMP006_TEMP_FRAC_BITS,
+                            (abs(i32ObjTemp) & ((1 << I2C_TMP006_TEMP_FRAC_BITS) - 1)) * (100000 >> I2C_TMP006_TEMP_FRAC_BITS));
+            }
+            UARTprintf("Manufacturer ID = 0x%04x ; Device ID = 0x%04x", psId->ui32ManufacturerId, psId->ui32DeviceId);
         }
         if (i < iCnt - 1) {
-            DelayUs(5e4);
+            TaskDelayUs(5e4);
             UARTprintf("\n");
         }
     }
@@ -892,9 +1193,9 @@ int TemperatureRead(char *pcCmd, char *pcParam)
 // BoosterPack MK II.
 int IlluminanceRead(char *pcCmd, char *pcParam)
 {
-    float fIlluminance;
-    uint32_t ui32Opt3001ManufacturerId;
-    uint32_t ui32Opt3001DeviceId;
+    uint32_t ui32Illuminance;
+    uint32_t ui32I2CMasterStatus;
+    tSensorId *psId = &g_psSensorId[SENSOR_OPT3001];
     int iCnt;
 
     if (pcParam == NULL) {
@@ -904,20 +1205,19 @@ int IlluminanceRead(char *pcCmd, char *pcParam)
     }
 
     for (int i = 0; i < iCnt; i++) {
-        fIlluminance = I2COpt3001ReadIlluminance(&g_sI2C2, EDUMKII_I2C_OPT3001_SLV_ADR);
-        ui32Opt3001ManufacturerId = I2COpt3001ReadManufacturerId(&g_sI2C2, EDUMKII_I2C_OPT3001_SLV_ADR);
-        ui32Opt3001DeviceId = I2COpt3001ReadDeviceId(&g_sI2C2, EDUMKII_I2C_OPT3001_SLV_ADR);
-        if ((ui32Opt3001ManufacturerId == ~0) || (ui32Opt3001DeviceId == ~0)) {
+        ui32I2CMasterStatus = I2COpt3001ReadIlluminanceFixed(&g_sI2C2, EDUMKII_I2C_OPT3001_SLV_ADR, &ui32Illuminance);
+        // The IDs were read at initialization.
+        if ((psId->ui32ManufacturerId == ~0) || (psId->ui32DeviceId == ~0) || ui32I2CMasterStatus) {
             UARTprintf("%s: Cannot read from the OPT3001 IC.", UI_STR_ERROR);
             return -1;
         } else {
             UARTprintf("%s: Illuminance = %d.%02d lux ; Manufacturer ID = 0x%04x ; Device ID = 0x%04x",
                         UI_STR_OK,
-                        (int) abs(fIlluminance), (int) abs((fIlluminance - (int) fIlluminance) * 100),
-                        ui32Opt3001ManufacturerId, ui32Opt3001DeviceId);
+                        ui32Illuminance / 100, ui32Illuminance % 100,
+                        psId->ui32ManufacturerId, psId->ui32DeviceId);
         }
         if (i < iCnt - 1) {
-            DelayUs(5e4);
+            TaskDelayUs(5e4);
             UARTprintf("\n");
         }
     }
@@ -927,6 +1227,84 @@ int IlluminanceRead(char *pcCmd, char *pcParam)
 
 
 
+// Show the status of the sensor log, start/stop logging the sensors, dump
+// the log or get/set the calibration factor S0 of the TMP006.
+int SensorCmd(char *pcCmd, char *pcParam)
+{
+    int32_t i32ObjTemp;
+    uint32_t ui32S0;
+
+    if (pcParam != NULL) {
+        if (!strcasecmp(pcParam, "start")) {
+            if (SensorLogStart()) {
+                UARTprintf("%s: Cannot set up the sensors for logging.", UI_STR_ERROR);
+                return -1;
+            }
+        } else if (!strcasecmp(pcParam, "stop")) {
+            SensorLogStop();
+        } else if (!strcasecmp(pcParam, "dump")) {
+            return SensorLogDump();
+        } else if (!strcasecmp(pcParam, "s0")) {
+            pcParam = strtok(NULL, UI_STR_DELIMITER);
+            if (pcParam != NULL) {
+                ui32S0 = strtoul(pcParam, (char **) NULL, 0);
+                if (ui32S0 < I2C_TMP006_S0_MIN || ui32S0 > I2C_TMP006_S0_MAX) {
+                    UARTprintf("%s: S0 must be in the range %u..%u (unit: 1e-17).", UI_STR_ERROR,
+                               I2C_TMP006_S0_MIN, I2C_TMP006_S0_MAX);
+                    return -1;
+                }
+                g_ui32SensorTmp006S0 = ui32S0;
+            }
+            UARTprintf("%s. TMP006 S0 = %u.%03ue-14", UI_STR_OK, g_ui32SensorTmp006S0 / 1000, g_ui32SensorTmp006S0 % 1000);
+            return 0;
+        } else {
+            UARTprintf("%s: Unknown parameter `%s' of the command `%s'!", UI_STR_ERROR, pcParam, pcCmd);
+            return -1;
+        }
+        UARTprintf("%s.", UI_STR_OK);
+        return 0;
+    }
+    UARTprintf("%s. Sensor log %s. Samples: %u logged, %u in the log, %u dropped. Overruns: %u, I2C errors: %u.",
+               UI_STR_OK, g_sSensorLog.bRunning ? (g_sSensorLog.bPaused ? "paused" : "running") : "stopped",
+               g_sSensorLog.ui32SampleCnt, g_sSensorLog.ui32SampleCnt - g_sSensorLog.ui32ReadCnt,
+               g_sSensorLog.ui32DropCnt, g_sSensorLog.ui32OverrunCnt, g_sSensorLog.ui32ErrCnt);
+    if (g_sSensorLog.ui32ObjTempCnt) {
+        i32ObjTemp = g_sSensorLog.i32ObjTemp;
+        UARTprintf(" Object temperature (average of %u): %s%d.%05d *C.", SENSOR_OBJ_AVG_LEN,
+                   i32ObjTemp < 0 ? "-" : "", abs(i32ObjTemp) >> I2C_TMP006_TEMP_FRAC_BITS,
+                   (abs(i32ObjTemp) & ((1 << I2C_TMP006_TEMP_FRAC_BITS) - 1)) * (100000 >> I2C_TMP006_TEMP_FRAC_BITS));
+    }
+
+    return 0;
+}
+
+
+
+// Send the samples of the sensor log as binary protocol frames. Each frame
+// starts with the index of its first sample. The last frame holds less than
+// SENSOR_LOG_FRAME_SAMPLES samples, so the host can detect the end of the
+// dump. The samples are removed from the log.
+int SensorLogDump(void)
+{
+    tSensorSample *psSample = (tSensorSample *) &g_pui32SensorLogFrame[1];
+    uint32_t ui32Num, ui32Frames = 0, ui32Samples = 0;
+
+    do {
+        g_pui32SensorLogFrame[0] = g_sSensorLog.ui32ReadCnt;
+        ui32Num = SensorLogRead(psSample, SENSOR_LOG_FRAME_SAMPLES);
+        BinProtoSendData(ui32Frames & 0xff, BIN_PROTO_OPCODE_SENSOR_LOG, BIN_PROTO_STATUS_OK,
+                         g_pui32SensorLogFrame, sizeof(uint32_t) + ui32Num * sizeof(tSensorSample));
+        ui32Frames++;
+        ui32Samples += ui32Num;
+    } while (ui32Num == SENSOR_LOG_FRAME_SAMPLES);
+    UARTprintf("\n");
+    UARTprintf("%s. Samples sent: %u in %u frames, dropped: %u.", UI_STR_OK, ui32Samples, ui32Frames, g_sSensorLog.ui32DropCnt);
+
+    return 0;
+}
+
+
+
 // SSI access.
 int SsiAccess(char *pcCmd, char *pcParam)
 {
@@ -935,35 +1313,18 @@ int SsiAccess(char *pcCmd, char *pcParam)
     uint8_t ui8SsiRw = 0;   // 0 = write; 1 = read
     uint8_t ui8SsiDataNum = 0;
     uint32_t pui32SsiData[32];
+    uint32_t pui32Args[2 + sizeof(pui32SsiData) / sizeof(pui32SsiData[0])];
     tSSI *psSsi;
     int32_t i32SsiStatus;
     // Parse parameters.
-    for (i = 0; i < sizeof(pui32SsiData) / sizeof(pui32SsiData[0]); i++) {
-        if (i != 0) pcParam = strtok(NULL, UI_STR_DELIMITER);
-        if (i == 0) {
-            if (pcParam == NULL) {
-                UARTprintf("%s: SSI port number required after command `%s'.", UI_STR_ERROR, pcCmd);
-                return -1;
-            } else {
-                ui8SsiPort = (uint8_t) strtoul(pcParam, (char **) NULL, 0) & 0xff;
-            }
-        } else if (i == 1) {
-            if (pcParam == NULL) {
-                UARTprintf("%s: SSI read/write required after command `%s'.", UI_STR_ERROR, pcCmd);
-                return -1;
-            } else {
-                ui8SsiRw = (uint8_t) strtoul(pcParam, (char **) NULL, 0) & 0x01;
-            }
-        } else {
-            if (i == 2 && ui8SsiRw == 0 && pcParam == NULL) {
-                UARTprintf("%s: At least one data byte required after SSI write command `%s'.", UI_STR_ERROR, pcCmd);
-                return -1;
-            }
-            if (pcParam == NULL) break;
-            else pui32SsiData[i-2] = (uint32_t) strtoul(pcParam, (char **) NULL, 0) & 0xffff;
-        }
+    if ((i = UiCmdParseArgs(pcParam, pui32Args, sizeof(pui32Args) / sizeof(pui32Args[0]))) < 0) return -1;
+    ui8SsiPort = pui32Args[0] & 0xff;
+    ui8SsiRw = pui32Args[1] & 0x01;
+    if (i == 2 && ui8SsiRw == 0) {
+        UARTprintf("%s: At least one data byte required after SSI write command `%s'.", UI_STR_ERROR, pcCmd);
+        return -1;
     }
-    if (i < 2) return -1;
+    for (int j = 2; j < i; j++) pui32SsiData[j-2] = pui32Args[j] & 0xffff;
     // Check if the SSI port number is valid. If so, set the psSsi pointer to the selected SSI port struct.
     if (SsiPortCheck(ui8SsiPort, &psSsi)) return -1;
     // SSI write.
@@ -977,9 +1338,10 @@ int SsiAccess(char *pcCmd, char *pcParam)
         }
     // SSI read.
     } else {
-        // Read all available data.
+        // Read all available data. The receive FIFO holds at most
+        // SSI_FIFO_DEPTH data words.
         if (i == 2) {
-            for (int iCnt = 0; ; iCnt++) {
+            for (int iCnt = 0; iCnt < SSI_FIFO_DEPTH; iCnt++) {
                 i32SsiStatus = SsiMasterRead(psSsi, pui32SsiData, 1);
                 if (i32SsiStatus != 1) {
                     if (iCnt == 0) UARTprintf("%s: No data available.", UI_STR_WARNING);
@@ -1126,43 +1488,117 @@ void SsiSetupHelp(void)
 
 
 
-// UART access.
-int UartAccess(char *pcCmd, char *pcParam)
+// SSI throughput benchmark using uDMA transfers.
+int SsiBenchmark(char *pcCmd, char *pcParam)
 {
     int i;
-    uint8_t ui8UartPort = 0;
-    uint8_t ui8UartRw = 0;  // 0 = write; 1 = read
-    uint8_t ui8UartDataNum = 0;
-    uint8_t pui8UartData[32];
-    tUART *psUart;
-    int32_t i32UartStatus;
+    uint8_t ui8SsiPort = 0;
+    uint32_t ui32SsiDataNum = SSI_BENCH_NUM_DEFAULT;
+    uint8_t ui8SsiMode = 0;     // 0 = write; 1 = read; 2 = full-duplex
+    uint32_t ui32ItemSize, ui32BufItems;
+    uint32_t ui32Tick, ui32TickPrev;
+    uint64_t ui64Ticks, ui64Bytes, ui64Bits;
+    void *pvTxData, *pvRxData;
+    tSSI *psSsi;
     // Parse parameters.
-    for (i = 0; i < sizeof(pui8UartData) / sizeof(pui8UartData[0]); i++) {
+    for (i = 0; i < 3; i++) {
         if (i != 0) pcParam = strtok(NULL, UI_STR_DELIMITER);
         if (i == 0) {
             if (pcParam == NULL) {
-                UARTprintf("%s: UART port number required after command `%s'.", UI_STR_ERROR, pcCmd);
+                UARTprintf("%s: SSI port number required after command `%s'.", UI_STR_ERROR, pcCmd);
                 return -1;
             } else {
-                ui8UartPort = (uint8_t) strtoul(pcParam, (char **) NULL, 0) & 0xff;
+                ui8SsiPort = (uint8_t) strtoul(pcParam, (char **) NULL, 0) & 0xff;
             }
         } else if (i == 1) {
-            if (pcParam == NULL) {
-                UARTprintf("%s: UART read/write required after command `%s'.", UI_STR_ERROR, pcCmd);
-                return -1;
-            } else {
-                ui8UartRw = (uint8_t) strtoul(pcParam, (char **) NULL, 0) & 0x01;
-            }
+            if (pcParam == NULL) break;
+            else ui32SsiDataNum = strtoul(pcParam, (char **) NULL, 0);
         } else {
-            if (i == 2 && ui8UartRw == 0 && pcParam == NULL) {
-                UARTprintf("%s: At least one data byte required after UART write command `%s'.", UI_STR_ERROR, pcCmd);
-                return -1;
-            }
             if (pcParam == NULL) break;
-            else pui8UartData[i-2] = (uint8_t) strtoul(pcParam, (char **) NULL, 0) & 0xff;
+            else ui8SsiMode = (uint8_t) strtoul(pcParam, (char **) NULL, 0) & 0xff;
         }
     }
-    if (i < 2) return -1;
+    if (ui8SsiMode > 2) {
+        UARTprintf("%s: Unknown SSI benchmark mode %d.", UI_STR_ERROR, ui8SsiMode);
+        return -1;
+    }
+    if (ui32SsiDataNum < 1) {
+        UARTprintf("%s: At least one data item required for command `%s'.", UI_STR_ERROR, pcCmd);
+        return -1;
+    }
+    // Check if the SSI port number is valid. If so, set the psSsi pointer to the selected SSI port struct.
+    if (SsiPortCheck(ui8SsiPort, &psSsi)) return -1;
+    if (!psSsi->bDmaEnabled) {
+        UARTprintf("%s: uDMA is not enabled for SSI port %d.", UI_STR_ERROR, ui8SsiPort);
+        return -1;
+    }
+    // Set up the data buffers. Write transfers longer than the buffer send
+    // dummy data. Read transfers are limited to the buffer size.
+    ui32ItemSize = (psSsi->ui32DataWidth > 8) ? 2 : 1;
+    ui32BufItems = SSI_BENCH_BUF_SIZE / ui32ItemSize;
+    if ((ui8SsiMode != 0) && (ui32SsiDataNum > ui32BufItems)) {
+        UARTprintf("%s: Number of data items limited to %d for reading.\n", UI_STR_WARNING, ui32BufItems);
+        ui32SsiDataNum = ui32BufItems;
+    }
+    for (i = 0; i < SSI_BENCH_BUF_SIZE; i++) g_pui8SsiBenchBuf[i] = i & 0xff;
+    pvTxData = ((ui8SsiMode != 1) && (ui32SsiDataNum <= ui32BufItems)) ? g_pui8SsiBenchBuf : NULL;
+    pvRxData = (ui8SsiMode != 0) ? g_pui8SsiBenchBuf : NULL;
+    // Measure the transfer time with the cycle counter. The SysTick timer is
+    // used by the scheduler.
+    ui64Ticks = 0;
+    ui32TickPrev = CycleCounterGet();
+    if (SsiMasterDmaStart(psSsi, pvTxData, pvRxData, ui32SsiDataNum)) {
+        UARTprintf("%s: Cannot start the uDMA transfer on SSI port %d. Is it busy, e.g. with the LCD?", UI_STR_ERROR, ui8SsiPort);
+        return -1;
+    }
+    while (SsiMasterDmaBusy(psSsi) || SSIBusy(psSsi->ui32BaseSsi)) {
+        ui32Tick = CycleCounterGet();
+        ui64Ticks += ui32Tick - ui32TickPrev;
+        ui32TickPrev = ui32Tick;
+        // Let the driver handle a timeout after 10 seconds.
+        if (ui64Ticks > (uint64_t) g_ui32SysClock * 10) break;
+    }
+    ui32Tick = CycleCounterGet();
+    ui64Ticks += ui32Tick - ui32TickPrev;
+    if (SsiMasterDmaWait(psSsi)) {
+        UARTprintf("%s: Timeout of the uDMA transfer on SSI port %d.", UI_STR_ERROR, ui8SsiPort);
+        return -1;
+    }
+    if (ui64Ticks < 1) ui64Ticks = 1;
+    ui64Bytes = (uint64_t) ui32SsiDataNum * ui32ItemSize;
+    ui64Bits = (uint64_t) ui32SsiDataNum * psSsi->ui32DataWidth;
+    UARTprintf("%s. Transferred %u bytes in %u us: %u bytes/s, %u bit/s (configured: %u bit/s).", UI_STR_OK,
+               (uint32_t) ui64Bytes,
+               (uint32_t) (ui64Ticks * 1000000 / g_ui32SysClock),
+               (uint32_t) (ui64Bytes * g_ui32SysClock / ui64Ticks),
+               (uint32_t) (ui64Bits * g_ui32SysClock / ui64Ticks),
+               psSsi->ui32BitRate);
+
+    return 0;
+}
+
+
+
+// UART access.
+int UartAccess(char *pcCmd, char *pcParam)
+{
+    int i;
+    uint8_t ui8UartPort = 0;
+    uint8_t ui8UartRw = 0;  // 0 = write; 1 = read
+    uint8_t ui8UartDataNum = 0;
+    uint8_t pui8UartData[32];
+    uint32_t pui32Args[2 + sizeof(pui8UartData) / sizeof(pui8UartData[0])];
+    tUART *psUart;
+    int32_t i32UartStatus;
+    // Parse parameters.
+    if ((i = UiCmdParseArgs(pcParam, pui32Args, sizeof(pui32Args) / sizeof(pui32Args[0]))) < 0) return -1;
+    ui8UartPort = pui32Args[0] & 0xff;
+    ui8UartRw = pui32Args[1] & 0x01;
+    if (i == 2 && ui8UartRw == 0) {
+        UARTprintf("%s: At least one data byte required after UART write command `%s'.", UI_STR_ERROR, pcCmd);
+        return -1;
+    }
+    for (int j = 2; j < i; j++) pui8UartData[j-2] = pui32Args[j] & 0xff;
     // Check if the UART port number is valid. If so, set the psUart pointer to the selected UART port struct.
     if (UartPortCheck(ui8UartPort, &psUart)) return -1;
     // UART write.
@@ -1319,3 +1755,259 @@ void UartSetupHelp(void)
     UARTprintf("  1: Enable internal loopback mode.\n");
 }
 
+
+
+// Bridge an UART to the UART user interface. Data received on the UART are
+// forwarded to the user interface and vice versa, until the escape character
+// is received from the user interface.
+int UartBridge(char *pcCmd, char *pcParam)
+{
+    uint8_t ui8UartPort;
+    uint8_t pui8UartData[16];
+    uint32_t ui32Cnt, ui32RxCnt = 0, ui32TxCnt = 0;
+    int32_t i32Char;
+    tUART *psUart;
+
+    ui8UartPort = (uint8_t) strtoul(pcParam, (char **) NULL, 0) & 0xff;
+    if (UartPortCheck(ui8UartPort, &psUart)) return -1;
+    UARTprintf("%s. Bridge to UART %d started. Press Ctrl-] to quit.\n", UI_STR_OK, ui8UartPort);
+#ifdef UART_BUFFERED
+    // The raw data must not overtake buffered console output.
+    UARTFlushTx(false);
+#endif
+    while (1) {
+        // UART to user interface. UARTwrite cannot be used, as it expands
+        // newlines.
+        ui32Cnt = UartRead(psUart, pui8UartData, sizeof(pui8UartData));
+        for (uint32_t i = 0; i < ui32Cnt; i++) MAP_UARTCharPut(g_sUartUi.ui32Base, pui8UartData[i]);
+        ui32RxCnt += ui32Cnt;
+        // User interface to UART.
+        if (!UartTxFree(psUart)) continue;
+        if ((i32Char = UartUiCharGetNonBlocking(&g_sUartUi)) < 0) continue;
+        if (i32Char == UART_BRIDGE_ESCAPE) break;
+        pui8UartData[0] = i32Char & 0xff;
+        UartWriteNonBlocking(psUart, pui8UartData, 1);
+        ui32TxCnt++;
+    }
+    UARTprintf("\n%s. Bridge to UART %d stopped. Bytes received: %u, sent: %u, receive overruns: %u.",
+               UI_STR_OK, ui8UartPort, ui32RxCnt, ui32TxCnt,
+               psUart->ui32RxOverrunCnt + psUart->ui32RxFifoOverrunCnt);
+
+    return 0;
+}
+
+
+
+// Show or reset the buffer statistics of an UART.
+int UartStats(char *pcCmd, char *pcParam)
+{
+    uint8_t ui8UartPort;
+    tUART *psUart;
+
+    ui8UartPort = (uint8_t) strtoul(pcParam, (char **) NULL, 0) & 0xff;
+    if (UartPortCheck(ui8UartPort, &psUart)) return -1;
+    pcParam = strtok(NULL, UI_STR_DELIMITER);
+    if (pcParam != NULL) {
+        if (strcasecmp(pcParam, "reset")) {
+            UARTprintf("%s: Unknown parameter `%s' of the command `%s'!", UI_STR_ERROR, pcParam, pcCmd);
+            return -1;
+        }
+        UartStatsReset(psUart);
+        UARTprintf("%s.", UI_STR_OK);
+        return 0;
+    }
+    if (!psUart->bIntEnabled) {
+        UARTprintf("%s: UART %d is not interrupt-driven.", UI_STR_WARNING, ui8UartPort);
+        return 0;
+    }
+    UARTprintf("%s. Receive buffer max. fill: %u of %u bytes, overruns: %u (buffer), %u (FIFO).", UI_STR_OK,
+               psUart->ui32RxMax, psUart->ui32RxBufSize - 1, psUart->ui32RxOverrunCnt, psUart->ui32RxFifoOverrunCnt);
+
+    return 0;
+}
+
+
+
+
+// Update the statistics when a pipelined command is started.
+void PipeCmdStart(void)
+{
+    uint32_t ui32Cycle = CycleCounterGet();
+
+    if (g_ui32PipeCmdCnt) g_ui64PipeCmdCycles += ui32Cycle - g_ui32PipeCmdCycleLast;
+    g_ui32PipeCmdCycleLast = ui32Cycle;
+    g_ui32PipeCmdCnt++;
+}
+
+
+
+// Show or reset the statistics of pipelined commands. The command rate is
+// measured from the start of the first to the start of the last pipelined
+// command since the last reset.
+int PipeStats(char *pcCmd, char *pcParam)
+{
+    if (pcParam != NULL) {
+        if (strcasecmp(pcParam, "reset")) {
+            UARTprintf("%s: Unknown parameter `%s' of the command `%s'!", UI_STR_ERROR, pcParam, pcCmd);
+            return -1;
+        }
+        g_ui32PipeCmdCnt = 0;
+        g_ui64PipeCmdCycles = 0;
+        g_sUartUi.ui32RxMax = 0;
+        g_sUartUi.ui32RxOverrunCnt = 0;
+        UARTprintf("%s.", UI_STR_OK);
+        return 0;
+    }
+    UARTprintf("%s. Pipelined commands: %u", UI_STR_OK, g_ui32PipeCmdCnt);
+    if (g_ui64PipeCmdCycles) {
+        UARTprintf(" (%u commands/s)",
+                   (uint32_t) ((uint64_t) (g_ui32PipeCmdCnt - 1) * g_ui32SysClock / g_ui64PipeCmdCycles));
+    }
+    UARTprintf(", receive queue max. fill: %u of %u bytes, overruns: %u.",
+               g_sUartUi.ui32RxMax, UART_UI_RX_BUF_SIZE, g_sUartUi.ui32RxOverrunCnt);
+
+    return 0;
+}
+
+
+
+// Show the statistics of the buffered console output, select what happens if
+// the output buffer is full or reset the statistics.
+int ConsoleCmd(char *pcCmd, char *pcParam)
+{
+#ifdef UART_BUFFERED
+    uint32_t ui32Dropped, ui32MaxUsed;
+
+    if (pcParam != NULL) {
+        if (!strcasecmp(pcParam, "block")) {
+            UARTTxPolicySet(UART_TX_POLICY_BLOCK);
+        } else if (!strcasecmp(pcParam, "drop")) {
+            UARTTxPolicySet(UART_TX_POLICY_DROP);
+        } else if (!strcasecmp(pcParam, "reset")) {
+            UARTTxStatsReset();
+        } else {
+            UARTprintf("%s: Unknown parameter `%s' of the command `%s'!", UI_STR_ERROR, pcParam, pcCmd);
+            return -1;
+        }
+        UARTprintf("%s.", UI_STR_OK);
+        return 0;
+    }
+    UARTTxStatsGet(&ui32Dropped, &ui32MaxUsed);
+    UARTprintf("%s. Console output buffer policy: %s, max. fill: %u of %u bytes, dropped: %u bytes.",
+               UI_STR_OK, UARTTxPolicyGet() == UART_TX_POLICY_DROP ? "drop" : "block",
+               ui32MaxUsed, UART_TX_BUFFER_SIZE, ui32Dropped);
+
+    return 0;
+#else
+    UARTprintf("%s: The console output is not buffered. Build the firmware with UART_BUFFERED.", UI_STR_ERROR);
+
+    return -1;
+#endif
+}
+
+
+
+// Show the periodic tasks and their statistics, reset the statistics or
+// enable/disable a task.
+int TasksCmd(char *pcCmd, char *pcParam)
+{
+    char *pcState;
+    uint32_t ui32Index;
+    tTaskInfo *psTask;
+
+    if (pcParam != NULL) {
+        if (!strcasecmp(pcParam, "reset")) {
+            TaskStatsReset();
+            UARTprintf("%s.", UI_STR_OK);
+            return 0;
+        }
+        for (ui32Index = 0; ui32Index < TASK_NUM; ui32Index++) {
+            if (!strcasecmp(pcParam, g_psTaskInfo[ui32Index].pcName)) break;
+        }
+        if (ui32Index >= TASK_NUM) {
+            UARTprintf("%s: Unknown task `%s'.", UI_STR_ERROR, pcParam);
+            return -1;
+        }
+        pcState = strtok(NULL, UI_STR_DELIMITER);
+        if (pcState != NULL && !strcasecmp(pcState, "on")) {
+            TaskEnable(ui32Index, true);
+        } else if (pcState != NULL && !strcasecmp(pcState, "off")) {
+            TaskEnable(ui32Index, false);
+        } else {
+            UARTprintf("%s: `on' or `off' required after task `%s'.", UI_STR_ERROR, pcParam);
+            return -1;
+        }
+        UARTprintf("%s.", UI_STR_OK);
+        return 0;
+    }
+    UARTprintf("%s. Scheduler tick: %d Hz, uptime: %u s.", UI_STR_OK,
+               TASK_TICKS_PER_SECOND, SchedulerTickCountGet() / TASK_TICKS_PER_SECOND);
+    for (ui32Index = 0; ui32Index < TASK_NUM; ui32Index++) {
+        psTask = &g_psTaskInfo[ui32Index];
+        UARTprintf("\n  %8s: %s, period: %u ms, runs: %u, deadline misses: %u, run time last/max/avg: %u/%u/%u us",
+                   psTask->pcName, g_psSchedulerTable[ui32Index].bActive ? "on" : "off",
+                   g_psSchedulerTable[ui32Index].ui32FrequencyTicks * 1000 / TASK_TICKS_PER_SECOND,
+                   psTask->ui32RunCnt, psTask->ui32MissCnt,
+                   (uint32_t) ((uint64_t) psTask->ui32CyclesLast * 1000000 / g_ui32SysClock),
+                   (uint32_t) ((uint64_t) psTask->ui32CyclesMax * 1000000 / g_ui32SysClock),
+                   psTask->ui32RunCnt ? (uint32_t) (psTask->ui64Cycles * 1000000 / g_ui32SysClock / psTask->ui32RunCnt) : 0);
+    }
+    if (g_sTaskSensor.ui32ErrCnt) {
+        UARTprintf("\n%s: Sensor read errors: %u.", UI_STR_WARNING, g_sTaskSensor.ui32ErrCnt);
+    }
+
+    return 0;
+}
+
+
+
+// Show the CPU load and the run time statistics of the driver functions and
+// of the commands or reset them.
+int PerfCmd(char *pcCmd, char *pcParam)
+{
+    tPerfProbe * const psPerfDriver[] = {&g_sPerfI2CRead, &g_sPerfSsiWrite, &g_sPerfAdcConvert, &Lcd_FlushProbe};
+    uint32_t ui32Load;
+    tPerfProbe *psPerfProbe;
+
+    if (pcParam != NULL) {
+        if (strcasecmp(pcParam, "reset")) {
+            UARTprintf("%s: Unknown parameter `%s'.", UI_STR_ERROR, pcParam);
+            return -1;
+        }
+        for (uint32_t i = 0; i < sizeof(psPerfDriver) / sizeof(psPerfDriver[0]); i++) {
+            PerfProbeReset(psPerfDriver[i]);
+        }
+        for (uint32_t i = 0; i < sizeof(g_psUiCmd) / sizeof(g_psUiCmd[0]); i++) {
+            PerfProbeReset(UiCmdPerfGet(&g_psUiCmd[i]));
+        }
+        UARTprintf("%s.", UI_STR_OK);
+        return 0;
+    }
+    ui32Load = PerfCpuLoadGet();
+    UARTprintf("%s. CPU load: %u.%02u %%.", UI_STR_OK, ui32Load / 100, ui32Load % 100);
+    UARTprintf("\nRun time count, min/avg/max in us, histogram (cycles <256 <1k <4k <16k <64k <256k <1M >=1M):");
+    for (uint32_t i = 0; i < sizeof(psPerfDriver) / sizeof(psPerfDriver[0]); i++) {
+        PerfProbeShow(psPerfDriver[i]);
+    }
+    // The run time of this command is only complete after it has finished.
+    for (uint32_t i = 0; i < sizeof(g_psUiCmd) / sizeof(g_psUiCmd[0]); i++) {
+        psPerfProbe = UiCmdPerfGet(&g_psUiCmd[i]);
+        if (psPerfProbe->ui32Cnt) PerfProbeShow(psPerfProbe);
+    }
+
+    return 0;
+}
+
+
+
+// Show the run time statistics of a probe.
+void PerfProbeShow(const tPerfProbe *psPerfProbe)
+{
+    UARTprintf("\n  %8s: %u, %u/%u/%u:", psPerfProbe->pcName, psPerfProbe->ui32Cnt,
+               (uint32_t) ((uint64_t) psPerfProbe->ui32CyclesMin * 1000000 / g_ui32SysClock),
+               psPerfProbe->ui32Cnt ? (uint32_t) (psPerfProbe->ui64Cycles * 1000000 / g_ui32SysClock / psPerfProbe->ui32Cnt) : 0,
+               (uint32_t) ((uint64_t) psPerfProbe->ui32CyclesMax * 1000000 / g_ui32SysClock));
+    for (uint32_t i = 0; i < PERF_HIST_BINS; i++) {
+        UARTprintf(" %u", psPerfProbe->pui32Hist[i]);
+    }
+}
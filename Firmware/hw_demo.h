@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 07 Feb 2020
-// Rev.: 26 Aug 2020
+// Rev.: 17 Oct 2026
 //
 // Header file of the hardware demo for the TI Tiva TM4C1294 Connected
 // LaunchPad Evaluation Kit.
@@ -54,6 +54,18 @@
 
 //#define ADC_VALUES_HEX
 
+// ADC stream parameters. A block of sample sets of all channels fits into one
+// binary protocol frame.
+#define ADC_STREAM_CHANNELS         5
+#define ADC_STREAM_BLOCK_SETS       24
+#define ADC_STREAM_BLOCK_LEN        (ADC_STREAM_CHANNELS * ADC_STREAM_BLOCK_SETS)
+
+// Samples of the sensor log per binary protocol frame.
+#define SENSOR_LOG_FRAME_SAMPLES    30
+
+// Timer used for the CPU load measurement.
+#define PERF_CPU_TIMER              4
+
 // I2C parameters.
 #define EDUMKII_I2C_TMP006_SLV_ADR  0x40
 #define EDUMKII_I2C_OPT3001_SLV_ADR 0x44
@@ -63,10 +75,15 @@
 #define SSI_FREQ_MAX                50000000
 #define SSI_DATAWIDTH_MIN           4
 #define SSI_DATAWIDTH_MAX           16
+#define SSI_BENCH_BUF_SIZE          4096
+#define SSI_BENCH_NUM_DEFAULT       4096
 
 // UART parameters.
 #define UART_BAUD_MIN               150
 #define UART_BAUD_MAX               15000000
+#define UART6_RX_BUF_SIZE           2048
+#define UART6_TX_BUF_SIZE           512
+#define UART_BRIDGE_ESCAPE          0x1d        // Ctrl-] ends the bridge mode.
 
 // LCD settings.
 #define LCD_COLOR_BLACK             0x000000
@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 09 Apr 2020
-// Rev.: 16 Apr 2020
+// Rev.: 17 Oct 2026
 //
 // IO peripheral definitions of the hardware demo for the TI Tiva TM4C1294
 // Connected LaunchPad Evaluation Kit.
@@ -19,7 +19,10 @@
 #include "driverlib/pin_map.h"
 #include "driverlib/ssi.h"
 #include "driverlib/sysctl.h"
+#include "driverlib/udma.h"
 #include "driverlib/uart.h"
+#include "hw/lcd/HAL_EK_TM4C1294XL_Crystalfontz128x128_ST7735.h"
+#include "hw/system/system.h"
 #include "hw_demo_io.h"
 
 
@@ -42,68 +45,70 @@ tUartUi g_sUartUi = {
     7                       // ui32Port
 };
 
+// Interrupt handler of the UART user interface.
+void UART7IntHandler(void)
+{
+    UartUiIntHandler(&g_sUartUi);
+}
+
 
 
 // ******************************************************************
 // ADC.
 // ******************************************************************
 
-// Joystick X.
-tADC g_sAdcJoystickX = {
+// Joystick X and Y.
+static const tADCChannel g_psAdcJoystickChannel[] = {
+    {SYSCTL_PERIPH_GPIOD, GPIO_PORTD_BASE, GPIO_PIN_2, ADC_CTL_CH13},   // X
+    {SYSCTL_PERIPH_GPIOK, GPIO_PORTK_BASE, GPIO_PIN_1, ADC_CTL_CH17}    // Y
+};
+tADC g_sAdcJoystick = {
     SYSCTL_PERIPH_ADC0,
-    SYSCTL_PERIPH_GPIOD,
-    GPIO_PORTD_BASE,
-    GPIO_PIN_2,
     ADC0_BASE,
     0,                      // ui32SequenceNum
-    0,                      // ui32Step
-    ADC_CTL_CH13 | ADC_CTL_IE | ADC_CTL_END
+    g_psAdcJoystickChannel,
+    2                       // ui32ChannelNum
 };
-// Joystick Y.
-tADC g_sAdcJoystickY = {
-    SYSCTL_PERIPH_ADC0,
-    SYSCTL_PERIPH_GPIOK,
-    GPIO_PORTK_BASE,
-    GPIO_PIN_1,
-    ADC0_BASE,
-    1,                      // ui32SequenceNum
-    0,                      // ui32Step
-    ADC_CTL_CH17 | ADC_CTL_IE | ADC_CTL_END
+// Accelerometer X, Y and Z. All axes are sampled by one trigger, so the
+// values are a coherent snapshot.
+static const tADCChannel g_psAdcAccelChannel[] = {
+    {SYSCTL_PERIPH_GPIOB, GPIO_PORTB_BASE, GPIO_PIN_4, ADC_CTL_CH10},   // X
+    {SYSCTL_PERIPH_GPIOB, GPIO_PORTB_BASE, GPIO_PIN_5, ADC_CTL_CH11},   // Y
+    {SYSCTL_PERIPH_GPIOK, GPIO_PORTK_BASE, GPIO_PIN_0, ADC_CTL_CH16}    // Z
 };
-// Accelerometer X.
-tADC g_sAdcAccelX = {
+tADC g_sAdcAccel = {
     SYSCTL_PERIPH_ADC1,
-    SYSCTL_PERIPH_GPIOB,
-    GPIO_PORTB_BASE,
-    GPIO_PIN_4,
     ADC1_BASE,
-    0,                      // ui32SequenceNum
-    0,                      // ui32Step
-    ADC_CTL_CH10 | ADC_CTL_IE | ADC_CTL_END
+    1,                      // ui32SequenceNum (sequence 0 is used by the ADC stream)
+    g_psAdcAccelChannel,
+    3                       // ui32ChannelNum
 };
-// Accelerometer Y.
-tADC g_sAdcAccelY = {
-    SYSCTL_PERIPH_ADC1,
-    SYSCTL_PERIPH_GPIOB,
-    GPIO_PORTB_BASE,
-    GPIO_PIN_5,
-    ADC1_BASE,
-    1,                      // ui32SequenceNum
-    0,                      // ui32Step
-    ADC_CTL_CH11 | ADC_CTL_IE | ADC_CTL_END
+
+// Stream of all channels of the joystick and accelerometer sequences. It uses
+// sample sequence 0 of ADC 1, which has enough steps for all channels.
+static tADC *g_ppsAdcStream[] = {
+    &g_sAdcJoystick,
+    &g_sAdcAccel
 };
-// Accelerometer Z.
-tADC g_sAdcAccelZ = {
-    SYSCTL_PERIPH_ADC1,
-    SYSCTL_PERIPH_GPIOK,
-    GPIO_PORTK_BASE,
-    GPIO_PIN_0,
+static uint16_t g_pui16AdcStreamBuf[2][ADC_STREAM_BLOCK_LEN];
+tADCStream g_sAdcStream = {
     ADC1_BASE,
-    2,                      // ui32SequenceNum
-    0,                      // ui32Step
-    ADC_CTL_CH16 | ADC_CTL_IE | ADC_CTL_END
+    0,                      // ui32SequenceNum
+    UDMA_CH24_ADC1_0,       // ui32UdmaChannel
+    SYSCTL_PERIPH_TIMER3,
+    TIMER3_BASE,
+    g_ppsAdcStream,
+    2,                      // ui32AdcNum
+    {g_pui16AdcStreamBuf[0], g_pui16AdcStreamBuf[1]},
+    ADC_STREAM_BLOCK_LEN    // ui32BufLength
 };
 
+// Interrupt handler of the ADC stream.
+void ADC1SS0IntHandler(void)
+{
+    AdcStreamIntHandler(&g_sAdcStream);
+}
+
 
 
 // ******************************************************************
@@ -144,6 +149,18 @@ tI2C g_sI2C2 = {
     100                     // ui32Timeout
 };
 
+// Interrupt handler of I2C master No. 0.
+void I2C0IntHandler(void)
+{
+    I2CMasterIntHandler(&g_sI2C0);
+}
+
+// Interrupt handler of I2C master No. 2.
+void I2C2IntHandler(void)
+{
+    I2CMasterIntHandler(&g_sI2C2);
+}
+
 
 
 // ******************************************************************
@@ -173,9 +190,17 @@ tSSI g_sSsi2 = {
     SSI_MODE_MASTER,        // ui32Mode
     15000000,               // ui32BitRate
     8,                      // ui32DataWidth
-    500                     // ui32Timeout
+    500,                    // ui32Timeout
+    UDMA_CH12_SSI2RX,       // ui32UdmaChannelRx
+    UDMA_CH13_SSI2TX        // ui32UdmaChannelTx
 };
 
+// Interrupt handler of SSI master No. 2.
+void SSI2IntHandler(void)
+{
+    SsiMasterDmaIntHandler(&g_sSsi2);
+}
+
 // SSI 3 for BoosterPack 2.
 tSSI g_sSsi3 = {
     SYSCTL_PERIPH_SSI3,
@@ -195,9 +220,20 @@ tSSI g_sSsi3 = {
     SSI_MODE_MASTER,        // ui32Mode
     15000000,               // ui32BitRate
     8,                      // ui32DataWidth
-    500                     // ui32Timeout
+    500,                    // ui32Timeout
+    UDMA_CH14_SSI3RX,       // ui32UdmaChannelRx
+    UDMA_CH15_SSI3TX,       // ui32UdmaChannelTx
+    HAL_LCD_busy            // pfnDmaShared: The LCD uses the transmit channel.
 };
 
+// Interrupt handler of SSI master No. 3. The LCD shares the SSI and detects the
+// end of its frame transfers here.
+void SSI3IntHandler(void)
+{
+    SsiMasterDmaIntHandler(&g_sSsi3);
+    HAL_LCD_dmaIntHandler();
+}
+
 
 
 // ******************************************************************
@@ -205,6 +241,8 @@ tSSI g_sSsi3 = {
 // ******************************************************************
 
 // UART on BoosterPack 2.
+static uint8_t g_pui8Uart6RxBuf[UART6_RX_BUF_SIZE];
+static uint8_t g_pui8Uart6TxBuf[UART6_TX_BUF_SIZE];
 tUART g_sUart6 = {
     SYSCTL_PERIPH_UART6,
     SYSCTL_PERIPH_GPIOP,
@@ -217,6 +255,75 @@ tUART g_sUart6 = {
     0,                      // ui32UartClk
     115200,                 // ui32Baud
     UART_CONFIG_WLEN_8 | UART_CONFIG_STOP_ONE | UART_CONFIG_PAR_NONE,
-    false                   // bLoopback
+    false,                  // bLoopback
+    g_pui8Uart6RxBuf,
+    UART6_RX_BUF_SIZE,      // ui32RxBufSize
+    g_pui8Uart6TxBuf,
+    UART6_TX_BUF_SIZE       // ui32TxBufSize
+};
+
+// Interrupt handler of UART 6.
+void UART6IntHandler(void)
+{
+    UartIntHandler(&g_sUart6);
+}
+
+
+
+// ******************************************************************
+// Performance measurement.
+// ******************************************************************
+
+// Peripherals which keep running while the processor sleeps. Clock gating in
+// sleep mode is enabled by the CPU load measurement.
+const uint32_t g_pui32PerfPeriphSleep[] = {
+    SYSCTL_PERIPH_GPIOA, SYSCTL_PERIPH_GPIOB, SYSCTL_PERIPH_GPIOC, SYSCTL_PERIPH_GPIOD,
+    SYSCTL_PERIPH_GPIOE, SYSCTL_PERIPH_GPIOF, SYSCTL_PERIPH_GPIOG, SYSCTL_PERIPH_GPIOH,
+    SYSCTL_PERIPH_GPIOJ, SYSCTL_PERIPH_GPIOK, SYSCTL_PERIPH_GPIOL, SYSCTL_PERIPH_GPIOM,
+    SYSCTL_PERIPH_GPION, SYSCTL_PERIPH_GPIOP, SYSCTL_PERIPH_GPIOQ,
+    SYSCTL_PERIPH_ADC0, SYSCTL_PERIPH_ADC1,
+    SYSCTL_PERIPH_I2C0, SYSCTL_PERIPH_I2C2,
+    SYSCTL_PERIPH_PWM0,
+    SYSCTL_PERIPH_SSI2, SYSCTL_PERIPH_SSI3,
+    SYSCTL_PERIPH_TIMER0, SYSCTL_PERIPH_TIMER2, SYSCTL_PERIPH_TIMER3, SYSCTL_PERIPH_TIMER5,
+    SYSCTL_PERIPH_UART6, SYSCTL_PERIPH_UART7,
+    SYSCTL_PERIPH_UDMA,
 };
+const uint32_t g_ui32PerfPeriphSleepNum = sizeof(g_pui32PerfPeriphSleep) / sizeof(g_pui32PerfPeriphSleep[0]);
+
+// Probes of driver functions. The linker redirects the calls of these driver
+// functions from other modules to the wrappers below (see the --wrap options
+// in the Makefile). Calls inside a driver module are not measured.
+tPerfProbe g_sPerfI2CRead = {"i2c-rd"};
+tPerfProbe g_sPerfSsiWrite = {"ssi-wr"};
+tPerfProbe g_sPerfAdcConvert = {"adc-conv"};
+
+uint32_t __wrap_I2CMasterReadAdv(tI2C *psI2C, uint8_t ui8SlaveAddr, uint8_t *pui8Data, uint8_t ui8Length, bool bRepeatedStart, bool bStop)
+{
+    uint32_t ui32Cycles = CycleCounterGet();
+    uint32_t ui32Ret = __real_I2CMasterReadAdv(psI2C, ui8SlaveAddr, pui8Data, ui8Length, bRepeatedStart, bStop);
+
+    PerfProbeUpdate(&g_sPerfI2CRead, CycleCounterGet() - ui32Cycles);
+
+    return ui32Ret;
+}
+
+uint32_t __wrap_SsiMasterWrite(tSSI *psSsi, uint32_t *pui32Data, uint32_t ui32Length)
+{
+    uint32_t ui32Cycles = CycleCounterGet();
+    uint32_t ui32Ret = __real_SsiMasterWrite(psSsi, pui32Data, ui32Length);
+
+    PerfProbeUpdate(&g_sPerfSsiWrite, CycleCounterGet() - ui32Cycles);
+
+    return ui32Ret;
+}
+
+uint32_t __wrap_AdcConvert(tADC *psAdc, uint32_t *pui32Values)
+{
+    uint32_t ui32Cycles = CycleCounterGet();
+    uint32_t ui32Ret = __real_AdcConvert(psAdc, pui32Values);
+
+    PerfProbeUpdate(&g_sPerfAdcConvert, CycleCounterGet() - ui32Cycles);
 
+    return ui32Ret;
+}
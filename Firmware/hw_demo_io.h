@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 09 Apr 2020
-// Rev.: 11 Apr 2020
+// Rev.: 17 Oct 2026
 //
 // Header file for the IO peripheral definitions of the hardware demo for the
 // TI Tiva TM4C1294 Connected LaunchPad Evaluation Kit.
@@ -19,6 +19,7 @@
 #include "hw/adc/adc.h"
 #include "hw/i2c/i2c.h"
 #include "hw/ssi/ssi.h"
+#include "hw/system/perf.h"
 #include "hw/uart/uart.h"
 #include "uart_ui.h"
 #include "hw_demo.h"
@@ -31,24 +32,42 @@
 
 // UART user inferface (UI).
 extern tUartUi g_sUartUi;
+void UART7IntHandler(void);
 
 // ADC.
-extern tADC g_sAdcJoystickX;
-extern tADC g_sAdcJoystickY;
-extern tADC g_sAdcAccelX;
-extern tADC g_sAdcAccelY;
-extern tADC g_sAdcAccelZ;
+extern tADC g_sAdcJoystick;        // X, Y
+extern tADC g_sAdcAccel;           // X, Y, Z
+extern tADCStream g_sAdcStream;
+void ADC1SS0IntHandler(void);
 
 // I2C masters.
 extern tI2C g_sI2C0;
 extern tI2C g_sI2C2;
+void I2C0IntHandler(void);
+void I2C2IntHandler(void);
 
 // Synchronous Serial Interface (SSI).
 extern tSSI g_sSsi2;
 extern tSSI g_sSsi3;
+void SSI2IntHandler(void);
+void SSI3IntHandler(void);
 
 // UARTs.
 extern tUART g_sUart6;
+void UART6IntHandler(void);
+
+// Performance measurement.
+extern const uint32_t g_pui32PerfPeriphSleep[];
+extern const uint32_t g_ui32PerfPeriphSleepNum;
+extern tPerfProbe g_sPerfI2CRead;
+extern tPerfProbe g_sPerfSsiWrite;
+extern tPerfProbe g_sPerfAdcConvert;
+uint32_t __real_I2CMasterReadAdv(tI2C *psI2C, uint8_t ui8SlaveAddr, uint8_t *pui8Data, uint8_t ui8Length, bool bRepeatedStart, bool bStop);
+uint32_t __wrap_I2CMasterReadAdv(tI2C *psI2C, uint8_t ui8SlaveAddr, uint8_t *pui8Data, uint8_t ui8Length, bool bRepeatedStart, bool bStop);
+uint32_t __real_SsiMasterWrite(tSSI *psSsi, uint32_t *pui32Data, uint32_t ui32Length);
+uint32_t __wrap_SsiMasterWrite(tSSI *psSsi, uint32_t *pui32Data, uint32_t ui32Length);
+uint32_t __real_AdcConvert(tADC *psAdc, uint32_t *pui32Values);
+uint32_t __wrap_AdcConvert(tADC *psAdc, uint32_t *pui32Values);
 
 
 
@@ -0,0 +1,382 @@
+// File: sensor.c
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 17 Oct 2026
+// Rev.: 17 Oct 2026
+//
+// TMP006 and OPT3001 sensors on the Educational BoosterPack MK II connected to
+// the TI Tiva TM4C1294 Connected LaunchPad Evaluation Kit.
+//
+// The IDs of the sensors are read once at initialization. In the logging mode
+// the sensors convert at their maximum rate and signal each finished
+// conversion on their data ready pins. The interrupt handler of a data ready
+// pin timestamps the conversion and queues the register reads on the
+// interrupt-driven I2C transfer engine. When the reads are done, the raw
+// values are put into a ring buffer, which is read by the main loop. So the
+// processor does not poll the sensors and each conversion is read exactly
+// once. The object temperature of the TMP006 is calculated from each
+// conversion and filtered with a moving average.
+//
+// Logging is paused while a host accesses the I2C bus of the sensors, so the
+// reads do not get between two transfers of the host joined by a repeated
+// start.
+//
+
+
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "inc/hw_memmap.h"
+#include "driverlib/gpio.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/sysctl.h"
+#include "hw/gpio/gpio.h"
+#include "hw/i2c/i2c.h"
+#include "hw/i2c/i2c_tmp006.h"
+#include "hw/i2c/i2c_opt3001.h"
+#include "hw/system/timebase.h"
+#include "sensor.h"
+#include "hw_demo.h"
+#include "hw_demo_io.h"
+
+
+
+// Registers read per conversion.
+#define SENSOR_XFER_NUM             2
+
+
+
+// Types.
+typedef struct {
+    tGPIO    sGpioDrdy;                         // Data ready signal (active low).
+    uint8_t  ui8SlaveAddr;
+    uint8_t  pui8Reg[SENSOR_XFER_NUM];          // Registers read per conversion.
+    uint8_t  pui8Channel[SENSOR_XFER_NUM];      // Log channel of each register.
+    void     (*pfnIntHandler)(void);
+    // State of the reads. Managed by the interrupt handlers.
+    tI2CXfer psXfer[SENSOR_XFER_NUM];
+    uint8_t  pui8Data[SENSOR_XFER_NUM][2];
+    uint32_t ui32TimeUs;
+    volatile bool bBusy;
+} tSensorSource;
+
+
+
+// Function prototypes of local functions.
+static void SensorRead(tSensorSource *psSource);
+static void SensorReadDone(tI2CXfer *psXfer);
+static void SensorLogPut(uint8_t ui8Channel, uint16_t ui16Raw, uint32_t ui32TimeUs);
+static void SensorObjTempPut(uint16_t ui16RawVolt, uint16_t ui16RawTemp, uint32_t ui32TimeUs);
+static void SensorTmp006DrdyIntHandler(void);
+static void SensorOpt3001IntIntHandler(void);
+
+
+
+// Data ready signals and registers of the sensors.
+static tSensorSource g_psSensorSource[SENSOR_NUM] = {
+    // TMP006 DRDY: BoosterPack 2 J2.11 (PM6). Reading the sensor voltage or
+    // the temperature register releases the DRDY signal.
+    {
+        {
+            SYSCTL_PERIPH_GPIOM,
+            GPIO_PORTM_BASE,
+            GPIO_PIN_6,             // ui8Pins
+            GPIO_STRENGTH_2MA,      // ui32Strength
+            GPIO_PIN_TYPE_STD_WPU,  // ui32PinType
+            true,                   // bInput: false = output, true = input
+            GPIO_FALLING_EDGE       // ui32IntType
+        },
+        EDUMKII_I2C_TMP006_SLV_ADR,
+        {I2C_TMP006_REG_VOLT, I2C_TMP006_REG_TEMP},
+        {SENSOR_CH_TMP006_VOLT, SENSOR_CH_TMP006_TEMP},
+        SensorTmp006DrdyIntHandler
+    },
+    // OPT3001 INT: BoosterPack 2 J1.8 (PP4). Reading the configuration
+    // register releases the INT signal.
+    {
+        {
+            SYSCTL_PERIPH_GPIOP,
+            GPIO_PORTP_BASE,
+            GPIO_PIN_4,             // ui8Pins
+            GPIO_STRENGTH_2MA,      // ui32Strength
+            GPIO_PIN_TYPE_STD_WPU,  // ui32PinType
+            true,                   // bInput: false = output, true = input
+            GPIO_FALLING_EDGE       // ui32IntType
+        },
+        EDUMKII_I2C_OPT3001_SLV_ADR,
+        {I2C_OPT3001_REG_RESULT, I2C_OPT3001_REG_CONFIG},
+        {SENSOR_CH_OPT3001_RESULT, SENSOR_CH_NONE},
+        SensorOpt3001IntIntHandler
+    },
+};
+
+
+
+// Global variables.
+tSensorId g_psSensorId[SENSOR_NUM];
+tSensorLog g_sSensorLog;
+uint32_t g_ui32SensorTmp006S0 = I2C_TMP006_S0_DEFAULT;    // Calibration factor in units of 1e-17.
+
+// Ring buffer of the sensor log with a single producer (I2C interrupt) and a
+// single consumer (main loop). The counters run freely and are masked on
+// access.
+static tSensorSample g_psSensorLogBuf[SENSOR_LOG_BUF_SIZE];
+
+// Last object temperatures for the moving average and their sum.
+static int32_t g_pi32SensorObjTemp[SENSOR_OBJ_AVG_LEN];
+static int32_t g_i32SensorObjTempSum;
+
+
+
+// Initialize the sensors and read their IDs. The data ready interrupts are
+// only enabled while logging.
+void SensorInit(void)
+{
+    tSensorSource *psSource;
+
+    I2CTmp006Reset(&g_sI2C2, EDUMKII_I2C_TMP006_SLV_ADR);
+    I2CTmp006Init(&g_sI2C2, EDUMKII_I2C_TMP006_SLV_ADR);
+    I2COpt3001Reset(&g_sI2C2, EDUMKII_I2C_OPT3001_SLV_ADR);
+    I2COpt3001Init(&g_sI2C2, EDUMKII_I2C_OPT3001_SLV_ADR);
+
+    // The IDs do not change, so there is no need to read them again.
+    g_psSensorId[SENSOR_TMP006].ui32ManufacturerId = I2CTmp006ReadManufacturerId(&g_sI2C2, EDUMKII_I2C_TMP006_SLV_ADR);
+    g_psSensorId[SENSOR_TMP006].ui32DeviceId = I2CTmp006ReadDeviceId(&g_sI2C2, EDUMKII_I2C_TMP006_SLV_ADR);
+    g_psSensorId[SENSOR_OPT3001].ui32ManufacturerId = I2COpt3001ReadManufacturerId(&g_sI2C2, EDUMKII_I2C_OPT3001_SLV_ADR);
+    g_psSensorId[SENSOR_OPT3001].ui32DeviceId = I2COpt3001ReadDeviceId(&g_sI2C2, EDUMKII_I2C_OPT3001_SLV_ADR);
+
+    for (uint32_t i = 0; i < SENSOR_NUM; i++) {
+        psSource = &g_psSensorSource[i];
+        GpioInitIntr(&psSource->sGpioDrdy, psSource->pfnIntHandler);
+        GPIOIntDisable(psSource->sGpioDrdy.ui32Port, psSource->sGpioDrdy.ui8Pins);
+        // All registers of a conversion are read with one transfer each. The
+        // last transfer puts the values into the log.
+        for (uint32_t j = 0; j < SENSOR_XFER_NUM; j++) {
+            psSource->psXfer[j].ui8SlaveAddr = psSource->ui8SlaveAddr;
+            psSource->psXfer[j].ui8Flags = 0;
+            psSource->psXfer[j].pui8WriteData = &psSource->pui8Reg[j];
+            psSource->psXfer[j].ui8WriteLength = 1;
+            psSource->psXfer[j].pui8ReadData = psSource->pui8Data[j];
+            psSource->psXfer[j].ui8ReadLength = 2;
+            psSource->psXfer[j].pfnCallback = (j == SENSOR_XFER_NUM - 1) ? SensorReadDone : NULL;
+            psSource->psXfer[j].pvCallbackData = psSource;
+        }
+        psSource->bBusy = false;
+    }
+}
+
+
+
+// Start logging the sensors at their maximum conversion rate. The log is
+// cleared. Returns -1 if the sensors cannot be set up.
+int SensorLogStart(void)
+{
+    tSensorSource *psSource;
+
+    if (g_sSensorLog.bRunning) return 0;
+    g_sSensorLog.ui32SampleCnt = 0;
+    g_sSensorLog.ui32ReadCnt = 0;
+    g_sSensorLog.ui32DropCnt = 0;
+    g_sSensorLog.ui32OverrunCnt = 0;
+    g_sSensorLog.ui32ErrCnt = 0;
+    g_sSensorLog.ui32ObjTempCnt = 0;
+    g_i32SensorObjTempSum = 0;
+    g_sSensorLog.bPaused = false;
+    if (I2CTmp006InitStream(&g_sI2C2, EDUMKII_I2C_TMP006_SLV_ADR) ||
+        I2COpt3001InitStream(&g_sI2C2, EDUMKII_I2C_OPT3001_SLV_ADR)) {
+        I2CTmp006Init(&g_sI2C2, EDUMKII_I2C_TMP006_SLV_ADR);
+        I2COpt3001Init(&g_sI2C2, EDUMKII_I2C_OPT3001_SLV_ADR);
+        return -1;
+    }
+    g_sSensorLog.bRunning = true;
+    for (uint32_t i = 0; i < SENSOR_NUM; i++) {
+        psSource = &g_psSensorSource[i];
+        GPIOIntClear(psSource->sGpioDrdy.ui32Port, psSource->sGpioDrdy.ui8Pins);
+        GPIOIntEnable(psSource->sGpioDrdy.ui32Port, psSource->sGpioDrdy.ui8Pins);
+        // Read the sensor once, so a data ready signal which is already
+        // asserted is released and the next conversion causes an edge.
+        SensorRead(psSource);
+    }
+
+    return 0;
+}
+
+
+
+// Stop logging and restore the default configuration of the sensors. The
+// samples in the log can still be read.
+void SensorLogStop(void)
+{
+    tSensorSource *psSource;
+
+    if (!g_sSensorLog.bRunning) return;
+    g_sSensorLog.bRunning = false;
+    for (uint32_t i = 0; i < SENSOR_NUM; i++) {
+        psSource = &g_psSensorSource[i];
+        GPIOIntDisable(psSource->sGpioDrdy.ui32Port, psSource->sGpioDrdy.ui8Pins);
+        if (psSource->bBusy) I2CMasterXferWait(&g_sI2C2, &psSource->psXfer[SENSOR_XFER_NUM - 1]);
+    }
+    I2CTmp006Init(&g_sI2C2, EDUMKII_I2C_TMP006_SLV_ADR);
+    I2COpt3001Init(&g_sI2C2, EDUMKII_I2C_OPT3001_SLV_ADR);
+}
+
+
+
+// Pause or resume logging. While paused, the data ready signals are ignored
+// and no reads are queued on the I2C bus. Conversions in between are lost.
+void SensorLogPause(bool bPause)
+{
+    tSensorSource *psSource;
+
+    if (!g_sSensorLog.bRunning || (g_sSensorLog.bPaused == bPause)) return;
+    g_sSensorLog.bPaused = bPause;
+    for (uint32_t i = 0; i < SENSOR_NUM; i++) {
+        psSource = &g_psSensorSource[i];
+        if (bPause) {
+            GPIOIntDisable(psSource->sGpioDrdy.ui32Port, psSource->sGpioDrdy.ui8Pins);
+            if (psSource->bBusy) I2CMasterXferWait(&g_sI2C2, &psSource->psXfer[SENSOR_XFER_NUM - 1]);
+        } else {
+            GPIOIntClear(psSource->sGpioDrdy.ui32Port, psSource->sGpioDrdy.ui8Pins);
+            GPIOIntEnable(psSource->sGpioDrdy.ui32Port, psSource->sGpioDrdy.ui8Pins);
+            // Release a data ready signal asserted while paused.
+            SensorRead(psSource);
+        }
+    }
+}
+
+
+
+// Read up to ui32Num samples from the sensor log. Returns the number of
+// samples read. Must only be called from the main loop.
+uint32_t SensorLogRead(tSensorSample *psSample, uint32_t ui32Num)
+{
+    uint32_t ui32ReadCnt = g_sSensorLog.ui32ReadCnt;
+    uint32_t ui32Avail = g_sSensorLog.ui32SampleCnt - ui32ReadCnt;
+
+    // Read the samples only after checking their number.
+    __sync_synchronize();
+    if (ui32Num > ui32Avail) ui32Num = ui32Avail;
+    for (uint32_t i = 0; i < ui32Num; i++) {
+        psSample[i] = g_psSensorLogBuf[(ui32ReadCnt + i) & (SENSOR_LOG_BUF_SIZE - 1)];
+    }
+    // Release the slots only after they have been read.
+    __sync_synchronize();
+    g_sSensorLog.ui32ReadCnt = ui32ReadCnt + ui32Num;
+
+    return ui32Num;
+}
+
+
+
+// Queue the register reads of a conversion. The reads of the previous
+// conversion must be done.
+static void SensorRead(tSensorSource *psSource)
+{
+    bool bIntDisabled = IntMasterDisable();
+
+    if (psSource->bBusy) {
+        g_sSensorLog.ui32OverrunCnt++;
+    } else {
+        psSource->bBusy = true;
+        psSource->ui32TimeUs = TimebaseUsGet();
+        for (uint32_t i = 0; i < SENSOR_XFER_NUM; i++) I2CMasterXferSubmit(&g_sI2C2, &psSource->psXfer[i]);
+    }
+    if (!bIntDisabled) IntMasterEnable();
+}
+
+
+
+// Called by the I2C interrupt handler when the last register read of a
+// conversion is done. Puts the raw register values into the log. For the
+// TMP006 also the object temperature is put into the log.
+static void SensorReadDone(tI2CXfer *psXfer)
+{
+    tSensorSource *psSource = (tSensorSource *) psXfer->pvCallbackData;
+
+    for (uint32_t i = 0; i < SENSOR_XFER_NUM; i++) {
+        if (psSource->psXfer[i].ui32Status) {
+            g_sSensorLog.ui32ErrCnt++;
+            psSource->bBusy = false;
+            return;
+        }
+    }
+    for (uint32_t i = 0; i < SENSOR_XFER_NUM; i++) {
+        if (psSource->pui8Channel[i] == SENSOR_CH_NONE) continue;
+        SensorLogPut(psSource->pui8Channel[i], (uint16_t) (psSource->pui8Data[i][0] << 8) | psSource->pui8Data[i][1],
+                     psSource->ui32TimeUs);
+    }
+    if (psSource == &g_psSensorSource[SENSOR_TMP006]) {
+        SensorObjTempPut((uint16_t) (psSource->pui8Data[0][0] << 8) | psSource->pui8Data[0][1],
+                         (uint16_t) (psSource->pui8Data[1][0] << 8) | psSource->pui8Data[1][1],
+                         psSource->ui32TimeUs);
+    }
+    psSource->bBusy = false;
+}
+
+
+
+// Put a sample into the sensor log. The sample is dropped if the log is full.
+static void SensorLogPut(uint8_t ui8Channel, uint16_t ui16Raw, uint32_t ui32TimeUs)
+{
+    uint32_t ui32SampleCnt = g_sSensorLog.ui32SampleCnt;
+    tSensorSample *psSample;
+
+    if (ui32SampleCnt - g_sSensorLog.ui32ReadCnt >= SENSOR_LOG_BUF_SIZE) {
+        g_sSensorLog.ui32DropCnt++;
+        return;
+    }
+    psSample = &g_psSensorLogBuf[ui32SampleCnt & (SENSOR_LOG_BUF_SIZE - 1)];
+    psSample->ui32TimeUs = ui32TimeUs;
+    psSample->ui16Raw = ui16Raw;
+    psSample->ui8Channel = ui8Channel;
+    psSample->ui8Reserved = 0;
+    // Publish the sample only after it has been written.
+    __sync_synchronize();
+    g_sSensorLog.ui32SampleCnt = ui32SampleCnt + 1;
+}
+
+
+
+// Calculate the object temperature of a TMP006 conversion and put the moving
+// average into the log. Until SENSOR_OBJ_AVG_LEN values are available, the
+// average is taken over the available values. Invalid values are skipped.
+static void SensorObjTempPut(uint16_t ui16RawVolt, uint16_t ui16RawTemp, uint32_t ui32TimeUs)
+{
+    int32_t i32ObjTemp = I2CTmp006ObjTempConv(ui16RawVolt, ui16RawTemp, g_ui32SensorTmp006S0);
+    uint32_t ui32ObjTempCnt = g_sSensorLog.ui32ObjTempCnt;
+    int32_t *pi32Slot = &g_pi32SensorObjTemp[ui32ObjTempCnt & (SENSOR_OBJ_AVG_LEN - 1)];
+
+    if (i32ObjTemp == I2C_TMP006_OBJ_TEMP_INVALID) return;
+    // Replace the oldest value in the sum.
+    if (ui32ObjTempCnt >= SENSOR_OBJ_AVG_LEN) g_i32SensorObjTempSum -= *pi32Slot;
+    *pi32Slot = i32ObjTemp;
+    g_i32SensorObjTempSum += i32ObjTemp;
+    ui32ObjTempCnt++;
+    if (ui32ObjTempCnt >= SENSOR_OBJ_AVG_LEN) {
+        g_sSensorLog.i32ObjTemp = g_i32SensorObjTempSum / SENSOR_OBJ_AVG_LEN;
+    } else {
+        g_sSensorLog.i32ObjTemp = g_i32SensorObjTempSum / (int32_t) ui32ObjTempCnt;
+    }
+    g_sSensorLog.ui32ObjTempCnt = ui32ObjTempCnt;
+    SensorLogPut(SENSOR_CH_TMP006_OBJ, (uint16_t) (int16_t) g_sSensorLog.i32ObjTemp, ui32TimeUs);
+}
+
+
+
+// Interrupt handlers of the data ready signals.
+static void SensorTmp006DrdyIntHandler(void)
+{
+    tSensorSource *psSource = &g_psSensorSource[SENSOR_TMP006];
+
+    GPIOIntClear(psSource->sGpioDrdy.ui32Port, psSource->sGpioDrdy.ui8Pins);
+    if (g_sSensorLog.bRunning && !g_sSensorLog.bPaused) SensorRead(psSource);
+}
+
+static void SensorOpt3001IntIntHandler(void)
+{
+    tSensorSource *psSource = &g_psSensorSource[SENSOR_OPT3001];
+
+    GPIOIntClear(psSource->sGpioDrdy.ui32Port, psSource->sGpioDrdy.ui8Pins);
+    if (g_sSensorLog.bRunning && !g_sSensorLog.bPaused) SensorRead(psSource);
+}
@@ -0,0 +1,85 @@
+// File: sensor.h
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 17 Oct 2026
+// Rev.: 17 Oct 2026
+//
+// Header file for the TMP006 and OPT3001 sensors on the Educational
+// BoosterPack MK II connected to the TI Tiva TM4C1294 Connected LaunchPad
+// Evaluation Kit.
+//
+
+
+
+#ifndef __SENSOR_H__
+#define __SENSOR_H__
+
+
+
+// Sensors.
+#define SENSOR_TMP006               0
+#define SENSOR_OPT3001              1
+#define SENSOR_NUM                  2
+
+// Channels of the sensor log. Each channel is one register of a sensor.
+#define SENSOR_CH_TMP006_VOLT       0       // TMP006 sensor voltage.
+#define SENSOR_CH_TMP006_TEMP       1       // TMP006 ambient temperature.
+#define SENSOR_CH_OPT3001_RESULT    2       // OPT3001 illuminance.
+#define SENSOR_CH_TMP006_OBJ        3       // TMP006 object temperature (moving average, *C with 5 fractional bits).
+#define SENSOR_CH_NUM               4
+#define SENSOR_CH_NONE              0xff    // Register is read, but not logged.
+
+// Size of the sensor log in samples. Must be a power of 2.
+#define SENSOR_LOG_BUF_SIZE         512
+
+// Length of the moving average of the object temperature. Must be a power of 2.
+#define SENSOR_OBJ_AVG_LEN          8
+
+
+
+// Types.
+typedef struct {
+    uint32_t ui32ManufacturerId;    // ~0 = cannot be read.
+    uint32_t ui32DeviceId;          // ~0 = cannot be read.
+} tSensorId;
+
+// Sample of the sensor log. It is sent as is in the binary frames of the
+// `sensor dump' command.
+typedef struct {
+    uint32_t ui32TimeUs;            // Timebase of the data ready signal (wraps after 71 minutes).
+    uint16_t ui16Raw;               // Raw register value.
+    uint8_t  ui8Channel;            // SENSOR_CH_*
+    uint8_t  ui8Reserved;
+} tSensorSample;
+
+typedef struct {
+    volatile bool     bRunning;
+    volatile bool     bPaused;          // The I2C bus is used by a host.
+    volatile uint32_t ui32SampleCnt;    // Samples put into the log.
+    volatile uint32_t ui32ReadCnt;      // Samples read from the log.
+    volatile uint32_t ui32DropCnt;      // Samples dropped, as the log was full.
+    volatile uint32_t ui32OverrunCnt;   // Data ready while the previous read was pending.
+    volatile uint32_t ui32ErrCnt;       // I2C errors.
+    volatile int32_t  i32ObjTemp;       // Moving average of the object temperature.
+    volatile uint32_t ui32ObjTempCnt;   // Object temperatures calculated.
+} tSensorLog;
+
+
+
+// Global variables.
+extern tSensorId g_psSensorId[SENSOR_NUM];
+extern tSensorLog g_sSensorLog;
+extern uint32_t g_ui32SensorTmp006S0;
+
+
+
+// Function prototypes.
+void SensorInit(void);
+int SensorLogStart(void);
+void SensorLogStop(void);
+void SensorLogPause(bool bPause);
+uint32_t SensorLogRead(tSensorSample *psSample, uint32_t ui32Num);
+
+
+
+#endif  // __SENSOR_H__
@@ -22,6 +22,7 @@
 //
 //*****************************************************************************
 
+#include <stdbool.h>
 #include <stdint.h>
 #include "inc/hw_nvic.h"
 #include "inc/hw_types.h"
@@ -45,12 +46,19 @@ static void FatalErrorMessage(void);
 //*****************************************************************************
 extern int main(void);
 
+//*****************************************************************************
+//
+// External declarations for the interrupt handlers used by the application.
+//
+//*****************************************************************************
+extern void UART7IntHandler(void);
+
 //*****************************************************************************
 //
 // Reserve space for the system stack.
 //
 //*****************************************************************************
-static uint32_t pui32Stack[128];
+static uint32_t pui32Stack[512];
 
 //*****************************************************************************
 //
@@ -138,7 +146,7 @@ void (* const g_pfnVectors[])(void) =
     IntDefaultHandler,                      // UART4 Rx and Tx
     IntDefaultHandler,                      // UART5 Rx and Tx
     IntDefaultHandler,                      // UART6 Rx and Tx
-    IntDefaultHandler,                      // UART7 Rx and Tx
+    UART7IntHandler,                        // UART7 Rx and Tx
     IntDefaultHandler,                      // I2C2 Master and Slave
     IntDefaultHandler,                      // I2C3 Master and Slave
     IntDefaultHandler,                      // Timer 4 subtimer A
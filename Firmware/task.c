@@ -0,0 +1,218 @@
+// File: task.c
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 17 Oct 2026
+// Rev.: 17 Oct 2026
+//
+// Periodic tasks of the hardware demo for the TI Tiva TM4C1294 Connected
+// LaunchPad Evaluation Kit. The tasks are called by the cooperative TivaWare
+// scheduler from the main loop while it waits for input of the user
+// interface. Each task is run by a task runner, which measures its run time
+// and counts deadline misses.
+//
+
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "driverlib/systick.h"
+#include "utils/scheduler.h"
+#include "utils/ustdlib.h"
+#include "hw/gpio/gpio_button.h"
+#include "hw/gpio/gpio_led.h"
+#include "hw/i2c/i2c.h"
+#include "hw/i2c/i2c_tmp006.h"
+#include "hw/i2c/i2c_opt3001.h"
+#include "hw/lcd/lcd.h"
+#include "hw/system/perf.h"
+#include "hw/system/system.h"
+#include "hw/system/timebase.h"
+#include "task.h"
+#include "hw_demo.h"
+#include "hw_demo_io.h"
+
+
+
+// Function prototypes of local functions.
+static void TaskSysTickIntHandler(void);
+static void TaskRun(void *pvParam);
+static void TaskSensor(void);
+static void TaskLcd(void);
+static void TaskLed(void);
+
+
+
+// Global variables.
+tTaskInfo g_psTaskInfo[TASK_NUM] = {
+    {"sensor",  TaskSensor},
+    {"lcd",     TaskLcd},
+    {"led",     TaskLed},
+};
+tTaskSensor g_sTaskSensor;
+static uint32_t g_ui32TaskSysClock;
+static tLcdFwInfo *g_psTaskLcdFwInfo;
+
+// Task table of the TivaWare scheduler. Each entry calls the task runner with
+// the task information as parameter. The heartbeat LED is disabled by
+// default, as it would interfere with the `led' command.
+tSchedulerTask g_psSchedulerTable[TASK_NUM] = {
+    {TaskRun,   &g_psTaskInfo[TASK_SENSOR], TASK_TICKS_PER_SECOND / 2, 0, true},
+    {TaskRun,   &g_psTaskInfo[TASK_LCD],    TASK_TICKS_PER_SECOND,     0, true},
+    {TaskRun,   &g_psTaskInfo[TASK_LED],    TASK_TICKS_PER_SECOND / 2, 0, false},
+};
+uint32_t g_ui32SchedulerNumTasks = TASK_NUM;
+
+
+
+// Initialize the scheduler. The SysTick timer is used for the scheduler tick.
+// The CPU load measurement must be set up before with PerfCpuInit.
+void TaskInit(uint32_t ui32SysClock, tLcdFwInfo *psLcdFwInfo)
+{
+    g_ui32TaskSysClock = ui32SysClock;
+    g_psTaskLcdFwInfo = psLcdFwInfo;
+    TaskStatsReset();
+    SysTickIntRegister(TaskSysTickIntHandler);
+    SchedulerInitEx(TASK_TICKS_PER_SECOND, ui32SysClock);
+}
+
+
+
+// Enable or disable a task. An enabled task is run on the next call of the
+// scheduler.
+void TaskEnable(uint32_t ui32Index, bool bEnable)
+{
+    if (ui32Index >= TASK_NUM) return;
+    if (bEnable) {
+        // Do not count the time while the task was disabled as deadline miss.
+        g_psTaskInfo[ui32Index].ui32LastTick = SchedulerTickCountGet() -
+                                               g_psSchedulerTable[ui32Index].ui32FrequencyTicks;
+        SchedulerTaskEnable(ui32Index, true);
+    } else {
+        SchedulerTaskDisable(ui32Index);
+        // The sensor values are not updated anymore.
+        if (ui32Index == TASK_SENSOR) g_sTaskSensor.bValid = false;
+    }
+}
+
+
+
+// Reset the statistics of all tasks.
+void TaskStatsReset(void)
+{
+    for (uint32_t i = 0; i < TASK_NUM; i++) {
+        g_psTaskInfo[i].ui32RunCnt = 0;
+        g_psTaskInfo[i].ui32MissCnt = 0;
+        g_psTaskInfo[i].ui32CyclesLast = 0;
+        g_psTaskInfo[i].ui32CyclesMax = 0;
+        g_psTaskInfo[i].ui64Cycles = 0;
+    }
+}
+
+
+
+// Delay execution for a given number of microseconds while running the
+// periodic tasks. Must not be called from a task.
+void TaskDelayUs(uint32_t ui32DelayUs)
+{
+    tTimeout sTimeout;
+
+    // Limit the delay to max. 10 seconds.
+    if (ui32DelayUs > 1e7) ui32DelayUs = 1e7;
+    TimeoutStart(&sTimeout, ui32DelayUs);
+    // The processor sleeps until the next scheduler tick or the end of the
+    // delay.
+    while (!TimeoutExpired(&sTimeout)) {
+        SchedulerRun();
+        TimeoutSleep(&sTimeout, NULL);
+    }
+}
+
+
+
+// SysTick interrupt handler. Advances the scheduler tick, updates the CPU
+// load measurement and debounces the buttons.
+static void TaskSysTickIntHandler(void)
+{
+    SchedulerSysTickIntHandler();
+    PerfCpuTick();
+    GpioButtonTick();
+}
+
+
+
+// Run a task and update its statistics. A task misses its deadline if it
+// starts a full period late, so at least one run was skipped.
+static void TaskRun(void *pvParam)
+{
+    tTaskInfo *psTask = (tTaskInfo *) pvParam;
+    uint32_t ui32Period = g_psSchedulerTable[psTask - g_psTaskInfo].ui32FrequencyTicks;
+    uint32_t ui32Tick = SchedulerTickCountGet();
+    uint32_t ui32Cycles;
+
+    if (SchedulerElapsedTicksCalc(psTask->ui32LastTick, ui32Tick) >= 2 * ui32Period) psTask->ui32MissCnt++;
+    psTask->ui32LastTick = ui32Tick;
+
+    ui32Cycles = CycleCounterGet();
+    psTask->pfnTask();
+    ui32Cycles = CycleCounterGet() - ui32Cycles;
+
+    psTask->ui32RunCnt++;
+    psTask->ui32CyclesLast = ui32Cycles;
+    if (ui32Cycles > psTask->ui32CyclesMax) psTask->ui32CyclesMax = ui32Cycles;
+    psTask->ui64Cycles += ui32Cycles;
+}
+
+
+
+// Read the temperature and the illuminance from the sensors on the
+// Educational BoosterPack MK II.
+static void TaskSensor(void)
+{
+    int32_t i32Temp;
+    uint32_t ui32Illuminance;
+
+    if (I2CTmp006ReadTempFixed(&g_sI2C2, EDUMKII_I2C_TMP006_SLV_ADR, &i32Temp) ||
+        I2COpt3001ReadIlluminanceFixed(&g_sI2C2, EDUMKII_I2C_OPT3001_SLV_ADR, &ui32Illuminance)) {
+        g_sTaskSensor.bValid = false;
+        g_sTaskSensor.ui32ErrCnt++;
+        return;
+    }
+    g_sTaskSensor.i32Temp = i32Temp;
+    g_sTaskSensor.ui32Illuminance = ui32Illuminance;
+    g_sTaskSensor.bValid = true;
+}
+
+
+
+// Show the sensor values and the uptime on the LCD below the firmware info.
+static void TaskLcd(void)
+{
+    // Static to save stack space.
+    static char pcLine[3][20];
+    static const char * const ppcLine[3] = {pcLine[0], pcLine[1], pcLine[2]};
+    int32_t i32Temp;
+
+    // Do not interfere with drawing operations of a host.
+    if (LcdBatchActive()) return;
+
+    if (g_sTaskSensor.bValid) {
+        i32Temp = g_sTaskSensor.i32Temp * 100 / (1 << I2C_TMP006_TEMP_FRAC_BITS);
+        usnprintf(pcLine[0], sizeof(pcLine[0]), "Temp.: %s%d.%02d C",
+                  i32Temp < 0 ? "-" : "", abs(i32Temp) / 100, abs(i32Temp) % 100);
+        usnprintf(pcLine[1], sizeof(pcLine[1]), "Light: %d lx", g_sTaskSensor.ui32Illuminance / 100);
+    } else {
+        usnprintf(pcLine[0], sizeof(pcLine[0]), "Temp.: n/a");
+        usnprintf(pcLine[1], sizeof(pcLine[1]), "Light: n/a");
+    }
+    usnprintf(pcLine[2], sizeof(pcLine[2]), "Uptime: %d s", SchedulerTickCountGet() / TASK_TICKS_PER_SECOND);
+    LcdFwInfoStatus(g_psTaskLcdFwInfo, ppcLine, 3);
+}
+
+
+
+// Toggle the user LED D4 as heartbeat.
+static void TaskLed(void)
+{
+    GpioLedSet(GpioLedGet() ^ 0x08);
+}
@@ -0,0 +1,70 @@
+// File: task.h
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 17 Oct 2026
+// Rev.: 17 Oct 2026
+//
+// Header file for the periodic tasks of the hardware demo for the TI Tiva
+// TM4C1294 Connected LaunchPad Evaluation Kit.
+//
+
+
+
+#ifndef __TASK_H__
+#define __TASK_H__
+
+
+
+#include "utils/scheduler.h"
+#include "hw/lcd/lcd.h"
+
+
+
+// Scheduler tick rate. The CPU load is measured at the same rate.
+#define TASK_TICKS_PER_SECOND   1000
+
+// Tasks in the order of the scheduler table.
+#define TASK_SENSOR             0       // Read the TMP006 and OPT3001 sensors.
+#define TASK_LCD                1       // Show the sensor values on the LCD.
+#define TASK_LED                2       // Heartbeat on the user LED D4.
+#define TASK_NUM                3
+
+
+
+// Types.
+typedef struct {
+    const char  *pcName;
+    void        (*pfnTask)(void);
+    // Statistics. Managed by the task runner.
+    uint32_t    ui32LastTick;
+    uint32_t    ui32RunCnt;
+    uint32_t    ui32MissCnt;            // Task started a full period late.
+    uint32_t    ui32CyclesLast;
+    uint32_t    ui32CyclesMax;
+    uint64_t    ui64Cycles;
+} tTaskInfo;
+
+typedef struct {
+    int32_t     i32Temp;                // *C with I2C_TMP006_TEMP_FRAC_BITS fractional bits
+    uint32_t    ui32Illuminance;        // 1/100 lux
+    bool        bValid;
+    uint32_t    ui32ErrCnt;
+} tTaskSensor;
+
+
+
+// Global variables.
+extern tTaskInfo g_psTaskInfo[TASK_NUM];
+extern tTaskSensor g_sTaskSensor;
+
+
+
+// Function prototypes.
+void TaskInit(uint32_t ui32SysClock, tLcdFwInfo *psLcdFwInfo);
+void TaskEnable(uint32_t ui32Index, bool bEnable);
+void TaskStatsReset(void);
+void TaskDelayUs(uint32_t ui32DelayUs);
+
+
+
+#endif  // __TASK_H__
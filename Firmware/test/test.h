@@ -0,0 +1,67 @@
+// File: test.h
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 17 Oct 2026
+// Rev.: 17 Oct 2026
+//
+// Minimal check macros for the host tests of the firmware. The tests are
+// compiled with the host compiler and run by `make test'.
+//
+
+
+
+#ifndef __TEST_H__
+#define __TEST_H__
+
+
+
+#include <stdio.h>
+
+
+
+// Global variables.
+static int g_iTestChecks = 0;
+static int g_iTestFailed = 0;
+
+
+
+// Check a condition. A failed check is reported, but the test goes on.
+#define TEST_CHECK(cond)    TestCheck((cond), #cond, __FILE__, __LINE__)
+
+// Check that two integer values are equal.
+#define TEST_CHECK_EQ(actual, expected) \
+    TestCheckEq((long long) (actual), (long long) (expected), #actual, __FILE__, __LINE__)
+
+
+
+static inline void TestCheck(int iCond, const char *pcCond, const char *pcFile, int iLine)
+{
+    g_iTestChecks++;
+    if (iCond) return;
+    g_iTestFailed++;
+    printf("%s:%d: Check failed: %s\n", pcFile, iLine, pcCond);
+}
+
+
+
+static inline void TestCheckEq(long long i64Actual, long long i64Expected, const char *pcActual,
+                               const char *pcFile, int iLine)
+{
+    g_iTestChecks++;
+    if (i64Actual == i64Expected) return;
+    g_iTestFailed++;
+    printf("%s:%d: Check failed: %s is %lld, expected %lld\n", pcFile, iLine, pcActual, i64Actual, i64Expected);
+}
+
+
+
+// Print the result of a test program. Returns the exit code.
+static inline int TestResult(const char *pcName)
+{
+    printf("%s: %d checks, %d failed.\n", pcName, g_iTestChecks, g_iTestFailed);
+    return g_iTestFailed ? 1 : 0;
+}
+
+
+
+#endif  // __TEST_H__
@@ -0,0 +1,316 @@
+// File: test_bin_proto.c
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 17 Oct 2026
+// Rev.: 17 Oct 2026
+//
+// Host emulation of the MCU side of the binary framed command protocol for
+// test_bin_proto.py. The firmware sources bin_proto.c and uart_ui.c run on the
+// host. The UART of the user interface is mapped to the standard input and
+// output, which test_bin_proto.py connects to a pseudo-terminal (pty). The
+// main loop works like the one of the hardware demo: binary frames are
+// processed by BinProtoProcess, all other lines get an error message and the
+// command prompt.
+//
+// Lines starting with `@' control the emulation:
+//   @corrupt N     Invert byte N of the next response frame.
+// The emulation exits when the pty is closed.
+//
+// The LED, SSI and UART functions used by the protocol are simulated. The SSI
+// and the UART loop the written data back.
+//
+
+
+
+#include <errno.h>
+#include <poll.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "driverlib/i2c.h"
+#include "driverlib/interrupt.h"
+#include "grlib/grlib.h"
+#include "utils/uartstdio.h"
+#include "hw/adc/adc.h"
+#include "hw/gpio/gpio_led.h"
+#include "hw/i2c/i2c.h"
+#include "hw/lcd/lcd.h"
+#include "hw/pwm/pwm_rgb_led.h"
+#include "hw/ssi/ssi.h"
+#include "hw/system/timebase.h"
+#include "hw/uart/uart.h"
+#include "uart_ui.h"
+#include "bin_proto.h"
+#include "sensor.h"
+#include "task.h"
+#include "hw_demo.h"
+#include "hw_demo_io.h"
+
+
+
+// File descriptors of the emulated UART.
+#define SIM_UART_FD_RX              STDIN_FILENO
+#define SIM_UART_FD_TX              STDOUT_FILENO
+
+// Time to wait for input while no line is pending.
+#define SIM_POLL_MS                 10
+
+#define SIM_LOOPBACK_SIZE           256
+#define SIM_LINE_SIZE               80
+
+
+
+// Types.
+// Loopback of written data.
+typedef struct {
+    uint32_t    pui32Data[SIM_LOOPBACK_SIZE];
+    uint32_t    ui32Num;
+} tSimLoopback;
+
+
+
+// Global variables.
+tUartUi g_sUartUi;
+tADC g_sAdcJoystick;
+tADC g_sAdcAccel;
+tI2C g_sI2C0;
+tI2C g_sI2C2;
+tSSI g_sSsi2;
+tSSI g_sSsi3;
+tUART g_sUart6;
+
+static uint32_t g_ui32SimLed = 0;
+static tSimLoopback g_sSimSsi;
+static tSimLoopback g_sSimUart;
+static int g_iSimCorrupt = -1;      // Byte of the next response frame to invert.
+static int g_iSimTxCnt = 0;
+
+
+
+// Exit if the pty was closed.
+static void SimExit(void)
+{
+    exit(0);
+}
+
+
+
+// Write to the emulated UART.
+static void SimWrite(const void *pvData, size_t sLength)
+{
+    if (write(SIM_UART_FD_TX, pvData, sLength) != (ssize_t) sLength) SimExit();
+}
+
+
+
+// Loopback of written data.
+static void SimLoopbackWrite(tSimLoopback *psLoopback, uint32_t ui32Data)
+{
+    if (psLoopback->ui32Num < SIM_LOOPBACK_SIZE) psLoopback->pui32Data[psLoopback->ui32Num++] = ui32Data;
+}
+
+static uint32_t SimLoopbackRead(tSimLoopback *psLoopback, uint32_t *pui32Data, uint32_t ui32Length)
+{
+    if (ui32Length > psLoopback->ui32Num) ui32Length = psLoopback->ui32Num;
+    memcpy(pui32Data, psLoopback->pui32Data, ui32Length * sizeof(uint32_t));
+    psLoopback->ui32Num -= ui32Length;
+    memmove(psLoopback->pui32Data, &psLoopback->pui32Data[ui32Length], psLoopback->ui32Num * sizeof(uint32_t));
+    return ui32Length;
+}
+
+
+
+// Stubs of the driverlib and uartstdio functions used by uart_ui.c and
+// bin_proto.c.
+void SysCtlPeripheralEnable(uint32_t ui32Peripheral) {}
+void SysCtlPeripheralDisable(uint32_t ui32Peripheral) {}
+void SysCtlPeripheralReset(uint32_t ui32Peripheral) {}
+void GPIOPinConfigure(uint32_t ui32PinConfig) {}
+void GPIOPinTypeUART(uint32_t ui32Port, uint8_t ui8Pins) {}
+void UARTStdioConfig(uint32_t ui32Port, uint32_t ui32Baud, uint32_t ui32SrcClock) {}
+void UARTIntRegister(uint32_t ui32Base, void (*pfnHandler)(void)) {}
+void UARTIntEnable(uint32_t ui32Base, uint32_t ui32IntFlags) {}
+void UARTIntDisable(uint32_t ui32Base, uint32_t ui32IntFlags) {}
+void UARTIntClear(uint32_t ui32Base, uint32_t ui32IntFlags) {}
+uint32_t UARTIntStatus(uint32_t ui32Base, bool bMasked) { return 0; }
+bool UARTCharsAvail(uint32_t ui32Base) { return false; }
+bool IntMasterDisable(void) { return false; }
+bool IntMasterEnable(void) { return false; }
+
+int32_t UARTCharGetNonBlocking(uint32_t ui32Base)
+{
+    struct pollfd sPoll = {SIM_UART_FD_RX, POLLIN, 0};
+    uint8_t ui8Char;
+
+    if (poll(&sPoll, 1, 0) < 1) return -1;
+    if (read(SIM_UART_FD_RX, &ui8Char, 1) != 1) SimExit();
+
+    return ui8Char;
+}
+
+int32_t UARTCharGet(uint32_t ui32Base)
+{
+    int32_t i32Char;
+
+    while ((i32Char = UARTCharGetNonBlocking(ui32Base)) < 0);
+
+    return i32Char;
+}
+
+// Raw output of the response frames.
+void UARTCharPut(uint32_t ui32Base, unsigned char ucData)
+{
+    if (g_iSimTxCnt++ == g_iSimCorrupt) {
+        ucData ^= 0xff;
+        g_iSimCorrupt = -1;
+    }
+    SimWrite(&ucData, 1);
+}
+
+// Console output.
+int UARTwrite(const char *pcBuf, uint32_t ui32Len)
+{
+    SimWrite(pcBuf, ui32Len);
+    return ui32Len;
+}
+
+void UARTprintf(const char *pcString, ...)
+{
+    char pcBuf[SIM_LINE_SIZE * 2];
+    va_list vaArgP;
+    int iLength;
+
+    va_start(vaArgP, pcString);
+    iLength = vsnprintf(pcBuf, sizeof(pcBuf), pcString, vaArgP);
+    va_end(vaArgP);
+    if (iLength > (int) sizeof(pcBuf) - 1) iLength = sizeof(pcBuf) - 1;
+    if (iLength > 0) SimWrite(pcBuf, iLength);
+}
+
+
+
+// Timebase on the host clock.
+void TimeoutStart(tTimeout *psTimeout, uint32_t ui32TimeoutUs)
+{
+    struct timespec sTime;
+
+    clock_gettime(CLOCK_MONOTONIC, &sTime);
+    psTimeout->ui64Deadline = (uint64_t) sTime.tv_sec * 1000000 + sTime.tv_nsec / 1000 + ui32TimeoutUs;
+}
+
+bool TimeoutExpired(const tTimeout *psTimeout)
+{
+    struct timespec sTime;
+
+    clock_gettime(CLOCK_MONOTONIC, &sTime);
+    return (uint64_t) sTime.tv_sec * 1000000 + sTime.tv_nsec / 1000 >= psTimeout->ui64Deadline;
+}
+
+
+
+// Simulated hardware functions used by the protocol.
+uint32_t AdcConvert(tADC *psAdc, uint32_t *pui32Values)
+{
+    for (int i = 0; i < 3; i++) pui32Values[i] = (psAdc == &g_sAdcJoystick ? 0x100 : 0x200) + i;
+    return 0;
+}
+
+// Only 4 LEDs exist.
+void GpioLedSet(uint32_t val) { g_ui32SimLed = val & 0x0f; }
+uint32_t GpioLedGet(void) { return g_ui32SimLed; }
+
+void PwmRgbLedSet(int iR, int iG, int iB) {}
+
+// No I2C slave answers.
+uint32_t I2CMasterWriteAdv(tI2C *psI2C, uint8_t ui8SlaveAddr, uint8_t *pui8Data, uint8_t ui8Length, bool bRepeatedStart, bool bStop) { return I2C_MASTER_ERR_ADDR_ACK; }
+uint32_t I2CMasterReadAdv(tI2C *psI2C, uint8_t ui8SlaveAddr, uint8_t *ui8Data, uint8_t ui8Length, bool bRepeatedStart, bool bStop) { return I2C_MASTER_ERR_ADDR_ACK; }
+uint32_t I2CMasterQuickCmdAdv(tI2C *psI2C, uint8_t ui8SlaveAddr, bool bReceive, bool bRepeatedStart) { return I2C_MASTER_ERR_ADDR_ACK; }
+
+uint32_t SsiMasterWrite(tSSI *psSsi, uint32_t *pui32Data, uint32_t ui32Length)
+{
+    for (uint32_t i = 0; i < ui32Length; i++) SimLoopbackWrite(&g_sSimSsi, pui32Data[i]);
+    return 0;
+}
+
+int32_t SsiMasterRead(tSSI *psSsi, uint32_t *pui32Data, uint32_t ui32Length)
+{
+    return SimLoopbackRead(&g_sSimSsi, pui32Data, ui32Length);
+}
+
+uint32_t UartWrite(tUART *psUart, uint8_t *ui8Data, uint8_t ui8Length)
+{
+    for (uint32_t i = 0; i < ui8Length; i++) SimLoopbackWrite(&g_sSimUart, ui8Data[i]);
+    return 0;
+}
+
+uint32_t UartRead(tUART *psUart, uint8_t *ui8Data, uint8_t ui8Length)
+{
+    uint32_t pui32Data[SIM_LOOPBACK_SIZE];
+    uint32_t ui32Num = SimLoopbackRead(&g_sSimUart, pui32Data, ui8Length);
+
+    for (uint32_t i = 0; i < ui32Num; i++) ui8Data[i] = pui32Data[i];
+    return ui32Num;
+}
+
+// There is no LCD. The LCD commands fail before they reach these functions.
+void TaskEnable(uint32_t ui32Index, bool bEnable) {}
+void SensorLogPause(bool bPause) {}
+bool I2CMasterXferBusHeld(tI2C *psI2C) { return false; }
+void LcdSetOrientation(tContext *psContext, uint8_t ui8Orientation) {}
+void LcdClear(tContext *psContext, uint32_t ui32Color) {}
+void LcdDrawPixel(tContext *psContext, int32_t i32X, int32_t i32Y, uint32_t ui32Color) {}
+void LcdDrawLine(tContext *psContext, int32_t i32X1, int32_t i32Y1, int32_t i32X2, int32_t i32Y2, uint32_t ui32Color) {}
+void LcdDrawRect(tContext *psContext, int16_t i16X1, int16_t i16Y1, int16_t i16X2, int16_t i16Y2, uint32_t ui32Color, bool bFill) {}
+void LcdDrawCircle(tContext *psContext, int32_t i32X, int32_t i32Y, int32_t iRadius, uint32_t ui32Color, bool bFill) {}
+void LcdDrawText(tContext *psContext, const char *pcText, int32_t i32X, int32_t i32Y, uint32_t ui32Color, bool bCenter) {}
+void LcdBatchBegin(tContext *psContext, uint32_t ui32TimeoutMs) {}
+void LcdBatchCommit(tContext *psContext) {}
+
+
+
+// Execute a control line of the emulation.
+static void SimControl(char *pcLine)
+{
+    if (!strncmp(pcLine, "@corrupt ", 9)) g_iSimCorrupt = atoi(&pcLine[9]);
+}
+
+
+
+int main(void)
+{
+    char pcLine[SIM_LINE_SIZE];
+    struct pollfd sPoll = {SIM_UART_FD_RX, POLLIN, 0};
+    int iLength;
+
+    UartUiInit(&g_sUartUi);
+    BinProtoInit(&g_sUartUi, NULL);
+    UARTprintf("\n%s firmware emulation for the binary protocol test\n%s", FW_NAME, UI_COMMAND_PROMPT);
+
+    while (1) {
+        iLength = UartUiGetsNonBlocking(&g_sUartUi, pcLine, sizeof(pcLine), BIN_PROTO_SYNC);
+        if (iLength == UART_UI_GETS_PENDING) {
+            if ((poll(&sPoll, 1, SIM_POLL_MS) < 0) && (errno != EINTR)) SimExit();
+            if (sPoll.revents & (POLLERR | POLLHUP)) SimExit();
+            continue;
+        }
+        // Binary frame.
+        if (iLength == UART_UI_GETS_SYNC) {
+            g_iSimTxCnt = 0;
+            BinProtoProcess();
+            continue;
+        }
+        if (pcLine[0] == UART_UI_TAG_CHAR) {
+            SimControl(pcLine);
+            continue;
+        }
+        if (iLength > 0) UARTprintf("%s: Unknown command `%s'!\n", UI_STR_ERROR, pcLine);
+        UARTprintf("%s", UI_COMMAND_PROMPT);
+    }
+
+    return 0;
+}
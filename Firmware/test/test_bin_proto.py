@@ -0,0 +1,197 @@
+#!/usr/bin/env python3
+#
+# File: test_bin_proto.py
+# Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+# Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+# Date: 17 Oct 2026
+# Rev.: 17 Oct 2026
+#
+# Host test of the binary framed command protocol. The MCU side is emulated by
+# the program test_bin_proto, which runs the firmware sources bin_proto.c and
+# uart_ui.c on the host. It is connected to the McuBinary class of pyMcu over
+# a pseudo-terminal (pty).
+#
+# Usage: test_bin_proto.py PROGRAM
+#
+
+
+
+# Append hardware classes folder of pyMcu to Python path.
+import os
+import sys
+sys.path.append(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', 'Software', 'pyMcu', 'hw'))
+
+
+
+# System modules.
+import contextlib
+import io
+import random
+import subprocess
+import time
+import tty
+
+
+
+# Hardware classes.
+import McuBinary
+
+
+
+# Timeout for a response in seconds.
+responseTimeout     = 0.5
+
+# Test results.
+testChecks          = 0
+testFailed          = 0
+
+
+
+# Check a condition. A failed check is reported, but the test goes on.
+def check(cond, desc):
+    global testChecks, testFailed
+    testChecks += 1
+    if not cond:
+        testFailed += 1
+        print("Check failed: " + desc)
+
+
+
+# Run a command that is expected to fail. Its error message is suppressed.
+def quiet(func, *args):
+    with contextlib.redirect_stdout(io.StringIO()):
+        return func(*args)
+
+
+
+# Send raw bytes to the MCU.
+def send_raw(mcu, data):
+    mcu.ser.write(data)
+    mcu.ser.flush()
+
+
+
+# Receive the response to a raw frame. Returns a tuple of the header and the
+# payload or None.
+def recv_raw(mcu):
+    return mcu.recv_frame()
+
+
+
+# Valid frames are echoed or executed.
+def test_round_trip(mcu):
+    rng = random.Random(1)
+    payloads = [b"", b"\x00", bytes(range(249)), b"\xa5\r\n\x1b\b@" * 8]
+    payloads += [bytes(rng.randrange(256) for i in range(rng.randrange(250))) for j in range(300)]
+    for payload in payloads:
+        status, data = mcu.ping(payload)
+        check(status == mcu.statusOk and data == payload, "ping with {0:d} bytes".format(len(payload)))
+    # The sequence number has wrapped around.
+    check(mcu.seq == len(payloads) & 0xff, "sequence number")
+
+    status, data = mcu.info()
+    check(status == mcu.statusOk and data.startswith("hw_demo "), "info: " + data)
+    check(mcu.adc_read() == (mcu.statusOk, (0x100, 0x101, 0x200, 0x201, 0x202)), "ADC read")
+    check(mcu.led_set(0x5) == (mcu.statusOk, 0x5), "LED set")
+    check(mcu.led_get() == (mcu.statusOk, 0x5), "LED get")
+    check(mcu.led_set(0x1f) == (mcu.statusErrHw, 0xf), "LED set of a missing LED")
+    check(mcu.ssi_write(2, [0x1234, 0xa5a5, 0xffff]) == mcu.statusOk, "SSI write")
+    check(mcu.ssi_read(2, 3) == (mcu.statusOk, [0x1234, 0xa5a5, 0xffff]), "SSI read")
+    check(mcu.ssi_read(3, 1) == (mcu.statusWarning, []), "SSI read without data")
+    check(mcu.ssi_read(1, 1)[0] == mcu.statusErrParam, "SSI read of an invalid port")
+    check(mcu.uart_write(6, b"\xa5\x00\r\n") == mcu.statusOk, "UART write")
+    check(mcu.uart_read(6, 8) == (mcu.statusWarning, b"\xa5\x00\r\n"), "UART read")
+    check(mcu.i2c_read(0, 0x40, 2) == (mcu.statusErrHw, 0x4, b""), "I2C read without slave")
+    check(mcu.lcd_clear(0) == mcu.statusErrHw, "LCD without context")
+    check(mcu.cmd(0x7f)[0] == mcu.statusErrOpcode, "unknown opcode")
+    check(mcu.ping(bytes(250))[0] == mcu.statusErrLength, "ping with 250 bytes")
+
+
+
+# Frames with a wrong CRC are rejected by both sides.
+def test_crc_error(mcu):
+    # MCU side: wrong CRC, corrupted payload and length.
+    frame = mcu.frame(0x10, mcu.opcodePing, b"\x01\x02\x03")
+    for i in (len(frame) - 1, len(frame) - 2, 4, 5, 6):
+        bad = bytearray(frame)
+        bad[i] ^= 0x01
+        send_raw(mcu, bad)
+        resp = recv_raw(mcu)
+        check(resp is not None and resp[0][:2] == bytes([0x10, mcu.opcodePing | mcu.protoOpcodeResponse]) and
+              resp[1] == bytes([mcu.statusErrCrc]), "CRC error of byte {0:d} detected by the MCU".format(i))
+    check(mcu.ping(b"ok") == (mcu.statusOk, b"ok"), "ping after CRC errors")
+
+    # Host side: the MCU inverts a byte of the next response frame.
+    for i in (4, 5, 6):
+        errorCount = mcu.errorCount
+        send_raw(mcu, "@corrupt {0:d}\r".format(i).encode('utf-8'))
+        check(quiet(mcu.ping) == (mcu.statusErrComm, b""), "CRC error of byte {0:d} detected by the host".format(i))
+        check(mcu.errorCount == errorCount + 1, "host error count")
+        check(mcu.ping(b"ok") == (mcu.statusOk, b"ok"), "ping after a CRC error")
+
+
+
+# Garbage bytes and broken frames do not disturb the following frames.
+def test_resync(mcu):
+    rng = random.Random(2)
+    garbageFixed = [b"\x00", b"\xff\xfe\x80", b"garbage", b"\b\b\bx", b"\x1b", bytes(200)]
+    # A line must neither start a frame nor a pipelined command.
+    garbageBytes = [b for b in range(256) if b not in (mcu.protoSync, ord("@"))]
+    garbageRandom = [bytes(rng.choice(garbageBytes) for i in range(rng.randrange(1, 100))) for j in range(50)]
+    for garbage in garbageFixed + garbageRandom:
+        bytesSkipped = mcu.bytesSkipped
+        send_raw(mcu, garbage + b"\r")
+        check(mcu.ping(garbage[:8]) == (mcu.statusOk, garbage[:8]), "ping after garbage " + garbage[:8].hex())
+        # The host skipped the echo, the error message and the prompt.
+        check(mcu.bytesSkipped > bytesSkipped, "host skipped the text output")
+    # Incomplete frames time out on the MCU.
+    frame = mcu.frame(0x20, mcu.opcodePing, b"\x01\x02\x03")
+    for i in (2, 4, len(frame) - 1):
+        send_raw(mcu, frame[:i])
+        time.sleep(0.2)
+        resp = recv_raw(mcu)
+        check(resp is not None and resp[1] == bytes([mcu.statusErrTimeout]),
+              "timeout of a frame with {0:d} bytes".format(i))
+        check(mcu.ping(b"ok") == (mcu.statusOk, b"ok"), "ping after an incomplete frame")
+    # Frame with a payload length beyond the maximum.
+    send_raw(mcu, bytes([mcu.protoSync, 0x30, mcu.opcodePing, mcu.protoPayloadMax + 1]))
+    resp = recv_raw(mcu)
+    check(resp is not None and resp[1] == bytes([mcu.statusErrLength]), "frame length error")
+    send_raw(mcu, b"\r")
+    check(mcu.ping(b"ok") == (mcu.statusOk, b"ok"), "ping after a frame length error")
+
+
+
+def main():
+    if len(sys.argv) != 2:
+        print("Usage: {0:s} PROGRAM".format(sys.argv[0]))
+        return 2
+
+    # Connect the MCU emulation to a pty.
+    master, slave = os.openpty()
+    tty.setraw(slave)
+    proc = subprocess.Popen([sys.argv[1]], stdin=master, stdout=master)
+    os.close(master)
+    mcu = McuBinary.McuBinary(os.ttyname(slave))
+    mcu.ser.timeout = responseTimeout
+
+    try:
+        test_round_trip(mcu)
+        test_crc_error(mcu)
+        test_resync(mcu)
+    finally:
+        # The MCU emulation exits when the pty is closed.
+        mcu.ser.close()
+        os.close(slave)
+        try:
+            proc.wait(timeout=2)
+        except subprocess.TimeoutExpired:
+            proc.kill()
+
+    print("{0:s}: {1:d} checks, {2:d} failed.".format(os.path.basename(sys.argv[1]), testChecks, testFailed))
+    return 1 if testFailed else 0
+
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,534 @@
+// File: test_i2c.c
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 17 Oct 2026
+// Rev.: 17 Oct 2026
+//
+// Host test of the interrupt-driven I2C master transfer engine in i2c.c. The
+// driverlib I2C functions are replaced by a simulated I2C master with slave
+// devices that have 256 byte register files. The simulated hardware executes
+// the commands while the driver sleeps, and calls the registered interrupt
+// handler. The timebase runs on a simulated clock, so timeouts are reached
+// without waiting.
+//
+
+
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "driverlib/i2c.h"
+#include "driverlib/interrupt.h"
+#include "timebase.h"
+#include "i2c.h"
+#include "test.h"
+
+
+
+// Simulated I2C master command bits.
+#define SIM_CMD_RUN                 0x01
+#define SIM_CMD_START               0x02
+#define SIM_CMD_STOP                0x04
+#define SIM_CMD_QUICK               0x20
+
+// Time per simulated sleep.
+#define SIM_SLEEP_US                10
+
+#define SIM_SLAVE_NUM               3
+#define SIM_CMD_LOG_SIZE            256
+#define SIM_XFER_LOG_SIZE           16
+
+
+
+// Types.
+// Simulated I2C slave. The first byte written after a start condition sets
+// the register pointer.
+typedef struct {
+    uint8_t     ui8Addr;
+    bool        bPresent;
+    bool        bHang;              // Holds SCL low: no command finishes.
+    uint8_t     pui8Reg[256];
+    uint8_t     ui8Ptr;
+    bool        bPtrSet;
+} tSimSlave;
+
+// Simulated I2C master.
+typedef struct {
+    void        (*pfnIntHandler)(void);
+    uint32_t    ui32IntMask;
+    uint32_t    ui32IntRaw;
+    uint32_t    ui32Err;
+    uint8_t     ui8SlaveAddr;
+    bool        bReceive;
+    uint8_t     ui8DataTx;
+    uint8_t     ui8DataRx;
+    uint32_t    ui32Cmd;
+    bool        bCmdPending;
+    bool        bBusOwned;
+    tSimSlave   *psSlave;           // Addressed slave.
+    uint32_t    pui32CmdLog[SIM_CMD_LOG_SIZE];
+    uint32_t    ui32CmdNum;
+} tSimI2C;
+
+
+
+// Global variables.
+static tSimI2C g_sSim;
+static tSimSlave g_psSimSlave[SIM_SLAVE_NUM];
+static bool g_bSimIntDisabled = false;
+static uint64_t g_ui64SimTimeUs = 0;
+
+static tI2C g_sI2C = {
+    0, 0, 0, 0, 0, 0, 0,
+    0x40020000,             // ui32BaseI2C
+    120000000,              // ui32I2CClk
+    false,                  // false = 100 kbps; true = 400 kbps
+    I2C_MASTER_INT_ARB_LOST | I2C_MASTER_INT_STOP | I2C_MASTER_INT_START |
+        I2C_MASTER_INT_NACK | I2C_MASTER_INT_TIMEOUT | I2C_MASTER_INT_DATA,
+    100                     // ui32Timeout
+};
+
+// Completion log of the transfers.
+static tI2CXfer *g_psXferLog[SIM_XFER_LOG_SIZE];
+static uint32_t g_ui32XferLogNum = 0;
+
+
+
+// ********** Simulated hardware. **********
+
+static tSimSlave *SimSlaveFind(uint8_t ui8Addr)
+{
+    for (int i = 0; i < SIM_SLAVE_NUM; i++) {
+        if (g_psSimSlave[i].bPresent && g_psSimSlave[i].ui8Addr == ui8Addr) return &g_psSimSlave[i];
+    }
+
+    return NULL;
+}
+
+
+
+// Raise the interrupt if it is enabled and not masked.
+static void SimInt(void)
+{
+    if (!g_bSimIntDisabled && (g_sSim.ui32IntRaw & g_sSim.ui32IntMask) && g_sSim.pfnIntHandler) {
+        g_sSim.pfnIntHandler();
+    }
+}
+
+
+
+// Execute the pending command. Returns false if no command was executed.
+static bool SimExec(void)
+{
+    uint32_t ui32Cmd = g_sSim.ui32Cmd;
+
+    if (!g_sSim.bCmdPending) return false;
+    // A stop condition without data is always possible.
+    if (ui32Cmd == SIM_CMD_STOP) {
+        g_sSim.bCmdPending = false;
+        g_sSim.bBusOwned = false;
+        g_sSim.psSlave = NULL;
+        g_sSim.ui32IntRaw |= I2C_MASTER_INT_STOP;
+        return true;
+    }
+    // Address phase.
+    if (ui32Cmd & SIM_CMD_START) {
+        g_sSim.bBusOwned = true;
+        g_sSim.psSlave = SimSlaveFind(g_sSim.ui8SlaveAddr);
+        if (!g_sSim.psSlave) {
+            g_sSim.bCmdPending = false;
+            g_sSim.ui32Err = I2C_MASTER_ERR_ADDR_ACK;
+            g_sSim.ui32IntRaw |= I2C_MASTER_INT_NACK | I2C_MASTER_INT_DATA;
+            return true;
+        }
+        if (!g_sSim.bReceive) g_sSim.psSlave->bPtrSet = false;
+    }
+    if (!g_sSim.psSlave || g_sSim.psSlave->bHang) return false;
+    g_sSim.bCmdPending = false;
+    g_sSim.ui32Err = I2C_MASTER_ERR_NONE;
+    // Data phase.
+    if (!(ui32Cmd & SIM_CMD_QUICK) && (ui32Cmd & SIM_CMD_RUN)) {
+        tSimSlave *psSlave = g_sSim.psSlave;
+        if (g_sSim.bReceive) {
+            g_sSim.ui8DataRx = psSlave->pui8Reg[psSlave->ui8Ptr++];
+        } else if (!psSlave->bPtrSet) {
+            psSlave->ui8Ptr = g_sSim.ui8DataTx;
+            psSlave->bPtrSet = true;
+        } else {
+            psSlave->pui8Reg[psSlave->ui8Ptr++] = g_sSim.ui8DataTx;
+        }
+    }
+    g_sSim.ui32IntRaw |= I2C_MASTER_INT_DATA;
+    if (ui32Cmd & SIM_CMD_STOP) {
+        g_sSim.bBusOwned = false;
+        g_sSim.psSlave = NULL;
+        g_sSim.ui32IntRaw |= I2C_MASTER_INT_STOP;
+    }
+
+    return true;
+}
+
+
+
+// Let the simulated hardware run until it has nothing to do.
+static void SimRun(void)
+{
+    for (int i = 0; i < 10000 && SimExec(); i++) SimInt();
+}
+
+
+
+static void SimReset(void)
+{
+    memset(&g_sSim, 0, sizeof(g_sSim));
+    memset(g_psSimSlave, 0, sizeof(g_psSimSlave));
+    g_psSimSlave[0].ui8Addr = 0x40;
+    g_psSimSlave[0].bPresent = true;
+    g_psSimSlave[1].ui8Addr = 0x44;
+    g_psSimSlave[1].bPresent = true;
+    g_psSimSlave[2].ui8Addr = 0x48;
+    g_psSimSlave[2].bPresent = true;
+    for (int i = 0; i < 256; i++) g_psSimSlave[0].pui8Reg[i] = i ^ 0x5a;
+    g_ui32XferLogNum = 0;
+}
+
+
+
+// ********** Replacements of the driverlib, interrupt and timebase functions. **********
+
+void SysCtlPeripheralEnable(uint32_t ui32Peripheral) {}
+void SysCtlPeripheralDisable(uint32_t ui32Peripheral) {}
+void SysCtlPeripheralReset(uint32_t ui32Peripheral) {}
+bool SysCtlPeripheralReady(uint32_t ui32Peripheral) { return true; }
+void GPIOPinConfigure(uint32_t ui32PinConfig) {}
+void GPIOPinTypeI2C(uint32_t ui32Port, uint8_t ui8Pins) {}
+void GPIOPinTypeI2CSCL(uint32_t ui32Port, uint8_t ui8Pins) {}
+
+void I2CMasterInitExpClk(uint32_t ui32Base, uint32_t ui32I2CClk, bool bFast) {}
+void I2CMasterEnable(uint32_t ui32Base) {}
+void I2CMasterTimeoutSet(uint32_t ui32Base, uint32_t ui32Value) {}
+
+void I2CIntRegister(uint32_t ui32Base, void (*pfnHandler)(void))
+{
+    g_sSim.pfnIntHandler = pfnHandler;
+}
+
+void I2CMasterIntEnableEx(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    g_sSim.ui32IntMask |= ui32IntFlags;
+}
+
+void I2CMasterIntClearEx(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    g_sSim.ui32IntRaw &= ~ui32IntFlags;
+}
+
+uint32_t I2CMasterIntStatusEx(uint32_t ui32Base, bool bMasked)
+{
+    return bMasked ? g_sSim.ui32IntRaw & g_sSim.ui32IntMask : g_sSim.ui32IntRaw;
+}
+
+void I2CMasterSlaveAddrSet(uint32_t ui32Base, uint8_t ui8SlaveAddr, bool bReceive)
+{
+    g_sSim.ui8SlaveAddr = ui8SlaveAddr;
+    g_sSim.bReceive = bReceive;
+}
+
+void I2CMasterDataPut(uint32_t ui32Base, uint8_t ui8Data)
+{
+    g_sSim.ui8DataTx = ui8Data;
+}
+
+uint32_t I2CMasterDataGet(uint32_t ui32Base)
+{
+    return g_sSim.ui8DataRx;
+}
+
+void I2CMasterControl(uint32_t ui32Base, uint32_t ui32Cmd)
+{
+    g_sSim.ui32Cmd = ui32Cmd;
+    g_sSim.bCmdPending = true;
+    if (g_sSim.ui32CmdNum < SIM_CMD_LOG_SIZE) g_sSim.pui32CmdLog[g_sSim.ui32CmdNum++] = ui32Cmd;
+}
+
+uint32_t I2CMasterErr(uint32_t ui32Base)
+{
+    return g_sSim.ui32Err;
+}
+
+bool I2CMasterBusy(uint32_t ui32Base)
+{
+    return g_sSim.bCmdPending;
+}
+
+bool I2CMasterBusBusy(uint32_t ui32Base)
+{
+    return g_sSim.bBusOwned;
+}
+
+bool IntMasterDisable(void)
+{
+    bool bIntDisabled = g_bSimIntDisabled;
+
+    g_bSimIntDisabled = true;
+    return bIntDisabled;
+}
+
+bool IntMasterEnable(void)
+{
+    bool bIntDisabled = g_bSimIntDisabled;
+
+    g_bSimIntDisabled = false;
+    SimInt();
+    return bIntDisabled;
+}
+
+void TimeoutStart(tTimeout *psTimeout, uint32_t ui32TimeoutUs)
+{
+    psTimeout->ui64Deadline = g_ui64SimTimeUs + ui32TimeoutUs;
+}
+
+bool TimeoutExpired(const tTimeout *psTimeout)
+{
+    return g_ui64SimTimeUs >= psTimeout->ui64Deadline;
+}
+
+// The hardware works while the processor sleeps.
+void TimeoutSleep(const tTimeout *psTimeout, const volatile bool *pbWake)
+{
+    g_ui64SimTimeUs += SIM_SLEEP_US;
+    SimRun();
+}
+
+
+
+// ********** Tests. **********
+
+static void I2CIntHandler(void)
+{
+    I2CMasterIntHandler(&g_sI2C);
+}
+
+
+
+static void XferDone(tI2CXfer *psXfer)
+{
+    if (g_ui32XferLogNum < SIM_XFER_LOG_SIZE) g_psXferLog[g_ui32XferLogNum++] = psXfer;
+}
+
+
+
+static void XferSet(tI2CXfer *psXfer, uint8_t ui8SlaveAddr, uint8_t *pui8WriteData, uint8_t ui8WriteLength,
+                    uint8_t *pui8ReadData, uint8_t ui8ReadLength)
+{
+    memset(psXfer, 0, sizeof(*psXfer));
+    psXfer->ui8SlaveAddr = ui8SlaveAddr;
+    psXfer->pui8WriteData = pui8WriteData;
+    psXfer->ui8WriteLength = ui8WriteLength;
+    psXfer->pui8ReadData = pui8ReadData;
+    psXfer->ui8ReadLength = ui8ReadLength;
+    psXfer->pfnCallback = XferDone;
+}
+
+
+
+static void TestInit(void)
+{
+    SimReset();
+    I2CMasterInit(&g_sI2C);
+    I2CMasterIntInit(&g_sI2C, I2CIntHandler);
+}
+
+
+
+// Queued transfers run one after another in the order of submission. Each
+// completion callback runs once.
+static void TestQueue(void)
+{
+    uint8_t pui8Write[3] = {0x10, 0xab, 0xcd};
+    uint8_t pui8Ptr[1] = {0x11};
+    uint8_t pui8Read[4] = {0};
+    uint8_t pui8ReadCont[2] = {0};
+    tI2CXfer sXfer[4];
+
+    TestInit();
+    XferSet(&sXfer[0], 0x40, pui8Write, 3, NULL, 0);            // Write 2 registers.
+    XferSet(&sXfer[1], 0x40, pui8Ptr, 1, pui8Read, 4);          // Write-then-read with repeated start.
+    XferSet(&sXfer[2], 0x40, NULL, 0, pui8ReadCont, 2);         // Read on.
+    sXfer[3].ui8SlaveAddr = 0x44;
+    sXfer[3].ui8Flags = I2C_XFER_FLAG_QUICK_CMD;
+    sXfer[3].pfnCallback = XferDone;
+
+    for (int i = 0; i < 4; i++) TEST_CHECK_EQ(I2CMasterXferSubmit(&g_sI2C, &sXfer[i]), 0);
+    TEST_CHECK(!I2CMasterXferIdle(&g_sI2C));
+    for (int i = 0; i < 4; i++) TEST_CHECK_EQ(sXfer[i].ui32Status, I2C_XFER_STATUS_PENDING);
+    TEST_CHECK_EQ(I2CMasterXferWait(&g_sI2C, &sXfer[3]), 0);
+    TEST_CHECK(I2CMasterXferIdle(&g_sI2C));
+
+    TEST_CHECK_EQ(g_ui32XferLogNum, 4);
+    for (int i = 0; i < 4; i++) {
+        TEST_CHECK(g_psXferLog[i] == &sXfer[i]);
+        TEST_CHECK(sXfer[i].bDone);
+        TEST_CHECK_EQ(sXfer[i].ui32Status, 0);
+    }
+    TEST_CHECK_EQ(g_psSimSlave[0].pui8Reg[0x10], 0xab);
+    TEST_CHECK_EQ(g_psSimSlave[0].pui8Reg[0x11], 0xcd);
+    TEST_CHECK_EQ(pui8Read[0], 0xcd);
+    TEST_CHECK_EQ(pui8Read[1], 0x12 ^ 0x5a);
+    TEST_CHECK_EQ(pui8Read[3], 0x14 ^ 0x5a);
+    TEST_CHECK_EQ(pui8ReadCont[0], 0x15 ^ 0x5a);
+    TEST_CHECK_EQ(pui8ReadCont[1], 0x16 ^ 0x5a);
+    TEST_CHECK_EQ(g_sI2C.ui32XferCnt, 4);
+    TEST_CHECK_EQ(g_sI2C.ui32XferErrCnt, 0);
+    // The bus is released after the last transfer.
+    TEST_CHECK(!g_sSim.bBusOwned);
+
+    // Invalid transfers are rejected.
+    XferSet(&sXfer[0], 0x40, NULL, 0, NULL, 0);
+    TEST_CHECK_EQ(I2CMasterXferSubmit(&g_sI2C, &sXfer[0]), -1);
+    TEST_CHECK_EQ(I2CMasterXferSubmit(&g_sI2C, NULL), -1);
+}
+
+
+
+// A slave that does not acknowledge fails its transfer, but not the next one.
+static void TestNack(void)
+{
+    uint8_t pui8Write[2] = {0x20, 0x01};
+    tI2CXfer sXfer[2];
+
+    TestInit();
+    XferSet(&sXfer[0], 0x50, pui8Write, 2, NULL, 0);
+    XferSet(&sXfer[1], 0x40, pui8Write, 2, NULL, 0);
+    I2CMasterXferSubmit(&g_sI2C, &sXfer[0]);
+    I2CMasterXferSubmit(&g_sI2C, &sXfer[1]);
+    TEST_CHECK_EQ(I2CMasterXferWait(&g_sI2C, &sXfer[1]), 0);
+    TEST_CHECK_EQ(sXfer[0].ui32Status, I2C_MASTER_INT_NACK);
+    TEST_CHECK_EQ(g_ui32XferLogNum, 2);
+    TEST_CHECK_EQ(g_sI2C.ui32XferErrCnt, 1);
+    TEST_CHECK_EQ(g_psSimSlave[0].pui8Reg[0x20], 0x01);
+    // The bus is released after the error.
+    TEST_CHECK(!g_sSim.bBusOwned);
+
+    // The blocking functions use the transfer engine.
+    TEST_CHECK_EQ(I2CMasterQuickCmd(&g_sI2C, 0x44, false), 0);
+    TEST_CHECK_EQ(I2CMasterQuickCmd(&g_sI2C, 0x45, false), I2C_MASTER_INT_NACK);
+}
+
+
+
+// A transfer that does not finish times out and is aborted. The bus is
+// released and the transfer engine goes on with the next transfer.
+static void TestTimeout(void)
+{
+    uint8_t pui8Write[2] = {0x30, 0x02};
+    uint8_t pui8Read[1] = {0};
+    uint32_t ui32CmdNum;
+    uint64_t ui64Start = g_ui64SimTimeUs;
+
+    TestInit();
+    g_psSimSlave[1].bHang = true;
+    TEST_CHECK_EQ(I2CMasterWrite(&g_sI2C, 0x44, pui8Write, 2), I2C_MASTER_INT_TIMEOUT);
+    TEST_CHECK(g_ui64SimTimeUs - ui64Start >= (g_sI2C.ui32Timeout + 10) * 10 * 3);
+    ui32CmdNum = g_sSim.ui32CmdNum;
+    TEST_CHECK_EQ(g_sSim.pui32CmdLog[ui32CmdNum - 1], I2C_MASTER_CMD_BURST_SEND_ERROR_STOP);
+    TEST_CHECK_EQ(g_sI2C.ui32XferErrCnt, 1);
+    // The transfer engine gets idle when the stop condition is done.
+    TEST_CHECK(!I2CMasterXferIdle(&g_sI2C));
+    SimRun();
+    TEST_CHECK(I2CMasterXferIdle(&g_sI2C));
+    TEST_CHECK(!g_sSim.bBusOwned);
+
+    g_psSimSlave[1].bHang = false;
+    SimRun();
+    TEST_CHECK_EQ(I2CMasterRead(&g_sI2C, 0x40, pui8Read, 1), 0);
+}
+
+
+
+// Aborting a transfer leaves the other queued transfers alone.
+static void TestAbort(void)
+{
+    uint8_t pui8Write[2] = {0x40, 0x03};
+    uint8_t pui8Read[2] = {0};
+    tI2CXfer sXfer[3];
+    uint32_t ui32CmdNum;
+
+    TestInit();
+    g_psSimSlave[1].bHang = true;
+    XferSet(&sXfer[0], 0x44, pui8Write, 2, NULL, 0);    // Hangs.
+    XferSet(&sXfer[1], 0x40, pui8Write, 2, NULL, 0);
+    XferSet(&sXfer[2], 0x40, NULL, 0, pui8Read, 2);
+    for (int i = 0; i < 3; i++) I2CMasterXferSubmit(&g_sI2C, &sXfer[i]);
+    SimRun();
+    TEST_CHECK_EQ(g_ui32XferLogNum, 0);
+
+    // Abort a queued transfer: nothing is sent on the bus.
+    ui32CmdNum = g_sSim.ui32CmdNum;
+    I2CMasterXferAbort(&g_sI2C, &sXfer[1]);
+    TEST_CHECK_EQ(g_sSim.ui32CmdNum, ui32CmdNum);
+    TEST_CHECK(sXfer[1].bDone);
+    TEST_CHECK_EQ(sXfer[1].ui32Status, I2C_MASTER_INT_TIMEOUT);
+    TEST_CHECK(!sXfer[0].bDone);
+    TEST_CHECK(!sXfer[2].bDone);
+    TEST_CHECK_EQ(g_ui32XferLogNum, 1);
+    TEST_CHECK(g_psXferLog[0] == &sXfer[1]);
+    TEST_CHECK_EQ(g_psSimSlave[0].pui8Reg[0x40], 0x40 ^ 0x5a);
+
+    // Abort the transfer in progress: the next one is started after the stop
+    // condition.
+    g_psSimSlave[1].bHang = false;
+    I2CMasterXferAbort(&g_sI2C, &sXfer[0]);
+    TEST_CHECK_EQ(g_sSim.ui32CmdNum, ui32CmdNum + 1);
+    TEST_CHECK_EQ(g_sSim.pui32CmdLog[ui32CmdNum], I2C_MASTER_CMD_BURST_SEND_ERROR_STOP);
+    TEST_CHECK(sXfer[0].bDone);
+    TEST_CHECK_EQ(sXfer[0].ui32Status, I2C_MASTER_INT_TIMEOUT);
+    TEST_CHECK(!sXfer[2].bDone);
+    SimExec();
+    TEST_CHECK(!g_sSim.bBusOwned);
+    SimInt();
+    TEST_CHECK_EQ(g_sSim.ui32CmdNum, ui32CmdNum + 2);
+    TEST_CHECK_EQ(g_sSim.pui32CmdLog[ui32CmdNum + 1], I2C_MASTER_CMD_BURST_RECEIVE_START);
+    TEST_CHECK_EQ(I2CMasterXferWait(&g_sI2C, &sXfer[2]), 0);
+    TEST_CHECK_EQ(g_ui32XferLogNum, 3);
+    TEST_CHECK(g_psXferLog[1] == &sXfer[0]);
+    TEST_CHECK(g_psXferLog[2] == &sXfer[2]);
+    TEST_CHECK_EQ(pui8Read[0], 0x00 ^ 0x5a);
+    TEST_CHECK(I2CMasterXferIdle(&g_sI2C));
+
+    // Aborting a finished transfer does nothing.
+    I2CMasterXferAbort(&g_sI2C, &sXfer[2]);
+    TEST_CHECK_EQ(sXfer[2].ui32Status, 0);
+    TEST_CHECK_EQ(g_ui32XferLogNum, 3);
+}
+
+
+
+// A bus scan finds exactly the present slaves.
+static void TestScan(void)
+{
+    tI2CScan sScan;
+
+    TestInit();
+    TEST_CHECK_EQ(I2CScanStart(&sScan, &g_sI2C, 0x03, 0x77, I2C_SCAN_MODE_AUTO), 0);
+    TEST_CHECK_EQ(I2CScanWait(&sScan), 0);
+    for (int i = 0x03; i <= 0x77; i++) {
+        TEST_CHECK_EQ(I2CScanFound(&sScan, i), SimSlaveFind(i) != NULL);
+    }
+    TEST_CHECK(I2CMasterXferIdle(&g_sI2C));
+    TEST_CHECK_EQ(I2CScanStart(&sScan, &g_sI2C, 0x10, 0x08, I2C_SCAN_MODE_AUTO), -1);
+}
+
+
+
+int main(void)
+{
+    TestQueue();
+    TestNack();
+    TestTimeout();
+    TestAbort();
+    TestScan();
+
+    return TestResult("test_i2c");
+}
@@ -0,0 +1,394 @@
+// File: test_i2c_sensor.c
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 17 Oct 2026
+// Rev.: 17 Oct 2026
+//
+// Host test of the fixed-point conversions of the TMP006 and OPT3001 sensor
+// values in i2c_tmp006.c and i2c_opt3001.c. The sensor voltage, temperature
+// and illuminance are compared for all raw register values with the former
+// floating-point conversions and with a reference in double precision. The
+// object temperature is checked with test vectors and with a sweep of the die
+// temperature, sensor voltage and calibration factor against the double
+// precision reference. The I2C master functions are replaced by simulated sensors with
+// 256 register files of 16 bit.
+//
+
+
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "driverlib/i2c.h"
+#include "i2c.h"
+#include "i2c_tmp006.h"
+#include "i2c_opt3001.h"
+#include "test.h"
+
+
+
+// Slave addresses of the simulated sensors.
+#define SIM_TMP006_ADDR             0x40
+#define SIM_OPT3001_ADDR            0x44
+
+// Allowed difference of the object temperature from the test vectors in
+// 1/1000 degree Celcius.
+#define TEST_OBJ_TEMP_TOL           40
+
+// Ranges of the object temperature sweep.
+#define TEST_SWEEP_DIE_MIN          -40     // Degree Celcius.
+#define TEST_SWEEP_DIE_MAX          125
+#define TEST_SWEEP_DIE_STEP         5
+#define TEST_SWEEP_VOLT_STEP        16      // 156.25 nV.
+#define TEST_SWEEP_S0_STEP          500     // 1e-17.
+#define TEST_SWEEP_OBJ_MIN          -60     // Degree Celcius.
+#define TEST_SWEEP_OBJ_MAX          400
+
+
+
+// Types.
+// Simulated sensor. The first byte written sets the register pointer.
+typedef struct {
+    uint8_t     ui8Addr;
+    uint16_t    pui16Reg[256];
+    uint8_t     ui8Ptr;
+} tSimSensor;
+
+// Test vector of the object temperature.
+typedef struct {
+    uint16_t    ui16RawVolt;
+    uint16_t    ui16RawTemp;
+    uint32_t    ui32S0;
+    int32_t     i32ObjTemp;         // 1/1000 degree Celcius or I2C_TMP006_OBJ_TEMP_INVALID.
+} tObjTempVector;
+
+
+
+// Global variables.
+static tSimSensor g_psSimSensor[] = {
+    {SIM_TMP006_ADDR},
+    {SIM_OPT3001_ADDR},
+};
+static tI2C g_sI2C;
+
+// Object temperature test vectors. The expected values are calculated with the
+// equations of the TMP006 user's guide (SBOU107) in double precision. Die
+// temperatures: 0xec00 = -40 *C, 0x0c80 = 25 *C, 0x1e00 = 60 *C, 0x3e80 =
+// 125 *C. Sensor voltages: 0xf830 = -2000, 0x07d0 = 2000 and 0x1388 = 5000
+// times 156.25 nV.
+static const tObjTempVector g_psObjTempVector[] = {
+    {0xfe0c, 0xec00, 6400,  -98092},
+    {0x0000, 0xec00, 6400,  -51043},
+    {0x07d0, 0xec00, 6400,   29976},
+    {0x1388, 0xec00, 6400,   90828},
+    {0xf830, 0x0000, 6400, -114948},
+    {0x0000, 0x0000, 6400,    2451},
+    {0x01f4, 0x0000, 6400,   16737},
+    {0x1388, 0x0000, 6400,   97215},
+    {0xf830, 0x0c80, 6400,  -30000},
+    {0xff9c, 0x0c80, 6400,   27010},
+    {0x0000, 0x0c80, 6400,   29243},
+    {0x0064, 0x0c80, 6400,   31429},
+    {0x07d0, 0x0c80, 6400,   66246},
+    {0x0000, 0x1e00, 6400,   64350},
+    {0x07d0, 0x1e00, 6400,   91556},
+    {0xf830, 0x3e80, 6400,  107159},
+    {0x1388, 0x3e80, 6400,  168400},
+    {0x0000, 0x0000, 5000,    3126},
+    {0xf830, 0x0c80, 5000,  -55078},
+    {0x07d0, 0x3e80, 5000,  150341},
+    {0xf830, 0x0000, 7000,  -93146},
+    {0x0000, 0x0c80, 7000,   28887},
+    {0x07d0, 0x1e00, 7000,   89159},
+    // The sensor voltage is too negative for the die temperature.
+    {0xf830, 0xec00, 6400, I2C_TMP006_OBJ_TEMP_INVALID},
+    {0xf830, 0x0000, 5000, I2C_TMP006_OBJ_TEMP_INVALID},
+    // Invalid calibration factor.
+    {0x0000, 0x0c80,    0, I2C_TMP006_OBJ_TEMP_INVALID},
+};
+
+
+
+// Find a simulated sensor. Returns NULL if no sensor answers.
+static tSimSensor *SimSensorFind(uint8_t ui8Addr)
+{
+    for (uint32_t i = 0; i < sizeof(g_psSimSensor) / sizeof(g_psSimSensor[0]); i++) {
+        if (g_psSimSensor[i].ui8Addr == ui8Addr) return &g_psSimSensor[i];
+    }
+
+    return NULL;
+}
+
+
+
+// Simulated I2C master functions used by the sensor drivers.
+uint32_t I2CMasterWrite(tI2C *psI2C, uint8_t ui8SlaveAddr, uint8_t *pui8Data, uint8_t ui8Length)
+{
+    tSimSensor *psSensor = SimSensorFind(ui8SlaveAddr);
+
+    if (!psSensor) return I2C_MASTER_ERR_ADDR_ACK;
+    if (ui8Length >= 1) psSensor->ui8Ptr = pui8Data[0];
+    if (ui8Length >= 3) psSensor->pui16Reg[psSensor->ui8Ptr] = (pui8Data[1] << 8) | pui8Data[2];
+
+    return 0;
+}
+
+uint32_t I2CMasterRead(tI2C *psI2C, uint8_t ui8SlaveAddr, uint8_t *pui8Data, uint8_t ui8Length)
+{
+    tSimSensor *psSensor = SimSensorFind(ui8SlaveAddr);
+    uint16_t ui16Reg;
+
+    if (!psSensor) return I2C_MASTER_ERR_ADDR_ACK;
+    ui16Reg = psSensor->pui16Reg[psSensor->ui8Ptr];
+    for (uint32_t i = 0; i < ui8Length; i++) pui8Data[i] = (i & 1) ? ui16Reg & 0xff : ui16Reg >> 8;
+
+    return 0;
+}
+
+
+
+// Former floating-point conversions.
+// Sensor voltage in nV.
+static float FloatVolt(uint16_t ui16Raw)
+{
+    uint32_t ui32VoltageRaw = ui16Raw;
+    int iVoltageSign;
+
+    if (ui32VoltageRaw & 0x8000) {
+        ui32VoltageRaw = (~ui32VoltageRaw + 1) & 0x7fff;
+        iVoltageSign = -1;
+    } else {
+        iVoltageSign = 1;
+    }
+
+    return (float) ui32VoltageRaw * 156.25 * iVoltageSign;
+}
+
+// Temperature in degree Celcius.
+static float FloatTemp(uint16_t ui16Raw)
+{
+    uint32_t ui32TemperatureRaw = ui16Raw >> 2;
+    int iTemperatureSign;
+
+    if (ui32TemperatureRaw & 0x2000) {
+        ui32TemperatureRaw = (~ui32TemperatureRaw + 1) & 0x1fff;
+        iTemperatureSign = -1;
+    } else {
+        iTemperatureSign = 1;
+    }
+
+    return (float) ui32TemperatureRaw / 32 * iTemperatureSign;
+}
+
+// Illuminance in lux.
+static float FloatIlluminance(uint16_t ui16Raw)
+{
+    return (float) (ui16Raw & 0x0fff) * 0.01 * (1 << (ui16Raw >> 12));
+}
+
+
+
+// Reference conversions in double precision.
+// Sensor voltage in nV.
+static double RefVolt(uint16_t ui16Raw)
+{
+    return (int16_t) ui16Raw * 156.25;
+}
+
+// Temperature in degree Celcius.
+static double RefTemp(uint16_t ui16Raw)
+{
+    return (int16_t) ui16Raw / 128.0;
+}
+
+// Object temperature in degree Celcius according to the TMP006 user's guide
+// (SBOU107). Returns NAN if there is no valid result.
+static double RefObjTemp(uint16_t ui16RawVolt, uint16_t ui16RawTemp, uint32_t ui32S0)
+{
+    double dTdie = RefTemp(ui16RawTemp) + 273.15;
+    double dTdiff = dTdie - 298.15;
+    double dS = ui32S0 * 1e-17 * (1 + 1.75e-3 * dTdiff - 1.678e-5 * dTdiff * dTdiff);
+    double dVos = -2.94e-5 - 5.7e-7 * dTdiff + 4.63e-9 * dTdiff * dTdiff;
+    double dV = RefVolt(ui16RawVolt) * 1e-9 - dVos;
+    double dT4 = pow(dTdie, 4) + (dV + 13.4 * dV * dV) / dS;
+
+    if ((ui32S0 == 0) || (dT4 <= 0)) return NAN;
+
+    return pow(dT4, 0.25) - 273.15;
+}
+
+// Illuminance in lux.
+static double RefIlluminance(uint16_t ui16Raw)
+{
+    return (ui16Raw & 0x0fff) * 0.01 * (1 << (ui16Raw >> 12));
+}
+
+
+
+// TMP006 sensor voltage. The fixed-point value is rounded toward zero. The
+// former conversion is rounded to single precision, which drops the fraction
+// of 1/4 or 3/4 nV above 4.19 mV. It returned 0 instead of -5.12 mV for the
+// raw value 0x8000.
+static void TestTmp006Volt(void)
+{
+    int iMismatch = 0, iMismatchRef = 0, iMismatchRead = 0;
+    int32_t i32Voltage;
+
+    for (uint32_t ui32Raw = 0; ui32Raw <= 0xffff; ui32Raw++) {
+        if (ui32Raw == 0x8000) continue;
+        if (fabsf(I2CTmp006VoltConv(ui32Raw) - FloatVolt(ui32Raw)) > 1) iMismatch++;
+        if (I2CTmp006VoltConv(ui32Raw) != (int32_t) RefVolt(ui32Raw)) iMismatchRef++;
+        // Read functions.
+        g_psSimSensor[0].pui16Reg[I2C_TMP006_REG_VOLT] = ui32Raw;
+        if (I2CTmp006ReadVoltFixed(&g_sI2C, SIM_TMP006_ADDR, &i32Voltage) ||
+            (i32Voltage != I2CTmp006VoltConv(ui32Raw)) ||
+            (fabsf(I2CTmp006ReadVolt(&g_sI2C, SIM_TMP006_ADDR) - FloatVolt(ui32Raw)) > 1)) iMismatchRead++;
+    }
+    TEST_CHECK_EQ(iMismatch, 0);
+    TEST_CHECK_EQ(iMismatchRef, 0);
+    TEST_CHECK_EQ(iMismatchRead, 0);
+    TEST_CHECK_EQ(I2CTmp006VoltConv(0x8000), -5120000);
+    TEST_CHECK_EQ(I2CTmp006VoltConv(0x7fff), 5119843);
+    TEST_CHECK_EQ(I2CTmp006VoltConv(0xffff), -156);
+}
+
+
+
+// TMP006 temperature. Both conversions are exact. The former conversion
+// returned 0 instead of -256 *C for the raw values 0x8000..0x8003.
+static void TestTmp006Temp(void)
+{
+    int iMismatch = 0, iMismatchRef = 0, iMismatchRead = 0;
+    int32_t i32Temperature;
+
+    for (uint32_t ui32Raw = 0; ui32Raw <= 0xffff; ui32Raw++) {
+        // The low 2 bits of the register are not used.
+        if ((double) I2CTmp006TempConv(ui32Raw) / (1 << I2C_TMP006_TEMP_FRAC_BITS) != RefTemp(ui32Raw & ~0x3)) iMismatchRef++;
+        if ((ui32Raw >> 2) == 0x2000) continue;
+        if ((float) I2CTmp006TempConv(ui32Raw) / (1 << I2C_TMP006_TEMP_FRAC_BITS) != FloatTemp(ui32Raw)) iMismatch++;
+        // Read functions.
+        g_psSimSensor[0].pui16Reg[I2C_TMP006_REG_TEMP] = ui32Raw;
+        if (I2CTmp006ReadTempFixed(&g_sI2C, SIM_TMP006_ADDR, &i32Temperature) ||
+            (i32Temperature != I2CTmp006TempConv(ui32Raw)) ||
+            (I2CTmp006ReadTemp(&g_sI2C, SIM_TMP006_ADDR) != FloatTemp(ui32Raw))) iMismatchRead++;
+    }
+    TEST_CHECK_EQ(iMismatch, 0);
+    TEST_CHECK_EQ(iMismatchRef, 0);
+    TEST_CHECK_EQ(iMismatchRead, 0);
+    TEST_CHECK_EQ(I2CTmp006TempConv(0x8000), -256 << I2C_TMP006_TEMP_FRAC_BITS);
+    TEST_CHECK_EQ(I2CTmp006TempConv(0x0c80), 25 << I2C_TMP006_TEMP_FRAC_BITS);
+    TEST_CHECK_EQ(I2CTmp006TempConv(0xfffc), -1);
+}
+
+
+
+// TMP006 object temperature.
+static void TestTmp006ObjTemp(void)
+{
+    const tObjTempVector *psVector;
+    int32_t i32Temperature;
+
+    for (uint32_t i = 0; i < sizeof(g_psObjTempVector) / sizeof(g_psObjTempVector[0]); i++) {
+        psVector = &g_psObjTempVector[i];
+        i32Temperature = I2CTmp006ObjTempConv(psVector->ui16RawVolt, psVector->ui16RawTemp, psVector->ui32S0);
+        if (psVector->i32ObjTemp == I2C_TMP006_OBJ_TEMP_INVALID) {
+            TEST_CHECK_EQ(i32Temperature, I2C_TMP006_OBJ_TEMP_INVALID);
+        } else {
+            TEST_CHECK(abs(i32Temperature * 1000 / (1 << I2C_TMP006_TEMP_FRAC_BITS) - psVector->i32ObjTemp) <=
+                       TEST_OBJ_TEMP_TOL);
+        }
+    }
+    // Read function.
+    psVector = &g_psObjTempVector[0];
+    g_psSimSensor[0].pui16Reg[I2C_TMP006_REG_VOLT] = psVector->ui16RawVolt;
+    g_psSimSensor[0].pui16Reg[I2C_TMP006_REG_TEMP] = psVector->ui16RawTemp;
+    TEST_CHECK_EQ(I2CTmp006ReadObjTempFixed(&g_sI2C, SIM_TMP006_ADDR, psVector->ui32S0, &i32Temperature), 0);
+    TEST_CHECK_EQ(i32Temperature, I2CTmp006ObjTempConv(psVector->ui16RawVolt, psVector->ui16RawTemp, psVector->ui32S0));
+}
+
+
+
+// TMP006 object temperature over the die temperature, sensor voltage and
+// calibration factor ranges. Object temperatures out of the sweep range and
+// invalid results of the reference are skipped.
+static void TestTmp006ObjTempSweep(void)
+{
+    int iChecked = 0, iMismatch = 0;
+    int32_t i32Temperature;
+    double dRef;
+
+    for (int iDie = TEST_SWEEP_DIE_MIN; iDie <= TEST_SWEEP_DIE_MAX; iDie += TEST_SWEEP_DIE_STEP) {
+        uint16_t ui16RawTemp = (uint16_t) (iDie * 128);
+        for (uint32_t ui32S0 = I2C_TMP006_S0_MIN; ui32S0 <= I2C_TMP006_S0_MAX; ui32S0 += TEST_SWEEP_S0_STEP) {
+            for (int32_t i32RawVolt = INT16_MIN; i32RawVolt <= INT16_MAX; i32RawVolt += TEST_SWEEP_VOLT_STEP) {
+                dRef = RefObjTemp(i32RawVolt, ui16RawTemp, ui32S0);
+                if (isnan(dRef) || (dRef < TEST_SWEEP_OBJ_MIN) || (dRef > TEST_SWEEP_OBJ_MAX)) continue;
+                i32Temperature = I2CTmp006ObjTempConv(i32RawVolt, ui16RawTemp, ui32S0);
+                iChecked++;
+                if ((i32Temperature == I2C_TMP006_OBJ_TEMP_INVALID) ||
+                    (fabs((double) i32Temperature / (1 << I2C_TMP006_TEMP_FRAC_BITS) - dRef) * 1000 > TEST_OBJ_TEMP_TOL)) iMismatch++;
+            }
+        }
+    }
+    TEST_CHECK(iChecked > 0);
+    TEST_CHECK_EQ(iMismatch, 0);
+}
+
+
+
+// OPT3001 illuminance. The fixed-point value is exact. The former conversion
+// is rounded to single precision.
+static void TestOpt3001Illuminance(void)
+{
+    int iMismatch = 0, iMismatchRef = 0, iMismatchRead = 0;
+    uint32_t ui32Illuminance;
+    float fIlluminance;
+
+    for (uint32_t ui32Raw = 0; ui32Raw <= 0xffff; ui32Raw++) {
+        fIlluminance = FloatIlluminance(ui32Raw);
+        if (fabs(I2COpt3001IlluminanceConv(ui32Raw) / 100.0 - fIlluminance) > fIlluminance * 1e-6) iMismatch++;
+        if (I2COpt3001IlluminanceConv(ui32Raw) != (uint32_t) round(RefIlluminance(ui32Raw) * 100)) iMismatchRef++;
+        // Read functions.
+        g_psSimSensor[1].pui16Reg[I2C_OPT3001_REG_RESULT] = ui32Raw;
+        if (I2COpt3001ReadIlluminanceFixed(&g_sI2C, SIM_OPT3001_ADDR, &ui32Illuminance) ||
+            (ui32Illuminance != I2COpt3001IlluminanceConv(ui32Raw)) ||
+            (fabsf(I2COpt3001ReadIlluminance(&g_sI2C, SIM_OPT3001_ADDR) - fIlluminance) > fIlluminance * 1e-6)) iMismatchRead++;
+    }
+    TEST_CHECK_EQ(iMismatch, 0);
+    TEST_CHECK_EQ(iMismatchRef, 0);
+    TEST_CHECK_EQ(iMismatchRead, 0);
+    TEST_CHECK_EQ(I2COpt3001IlluminanceConv(0x0001), 1);
+    TEST_CHECK_EQ(I2COpt3001IlluminanceConv(0xbfff), 4095 << 11);
+}
+
+
+
+// The read functions report I2C errors.
+static void TestI2CError(void)
+{
+    int32_t i32Value;
+    uint32_t ui32Value;
+
+    TEST_CHECK_EQ(I2CTmp006ReadVoltFixed(&g_sI2C, 0x41, &i32Value), I2C_MASTER_ERR_ADDR_ACK);
+    TEST_CHECK_EQ(I2CTmp006ReadTempFixed(&g_sI2C, 0x41, &i32Value), I2C_MASTER_ERR_ADDR_ACK);
+    TEST_CHECK_EQ(I2CTmp006ReadObjTempFixed(&g_sI2C, 0x41, I2C_TMP006_S0_DEFAULT, &i32Value), I2C_MASTER_ERR_ADDR_ACK);
+    TEST_CHECK_EQ(I2COpt3001ReadIlluminanceFixed(&g_sI2C, 0x45, &ui32Value), I2C_MASTER_ERR_ADDR_ACK);
+    TEST_CHECK(I2CTmp006ReadVolt(&g_sI2C, 0x41) == -255);
+    TEST_CHECK(I2CTmp006ReadTemp(&g_sI2C, 0x41) == -255);
+    TEST_CHECK(I2COpt3001ReadIlluminance(&g_sI2C, 0x45) == -255);
+}
+
+
+
+int main(void)
+{
+    TestTmp006Volt();
+    TestTmp006Temp();
+    TestTmp006ObjTemp();
+    TestTmp006ObjTempSweep();
+    TestOpt3001Illuminance();
+    TestI2CError();
+
+    return TestResult("test_i2c_sensor");
+}
@@ -0,0 +1,470 @@
+// File: test_lcd.c
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 17 Oct 2026
+// Rev.: 17 Oct 2026
+//
+// Host test of the frame buffer of the Crystalfontz128x128 LCD driver. It is
+// built for each frame buffer format (LCD_BUFFER_BPP = 16, 8 and 4, and 16
+// with LCD_DOUBLE_BUFFER). The HAL functions are replaced by a simulated
+// ST7735 display controller, which receives the commands and pixel data sent
+// by the driver into its display RAM. The test draws rectangles, lines,
+// pixels and 1, 4 and 8 bpp images with odd and even coordinates through
+// grlib, and compares the display RAM after each flush with a model of the
+// expected colors. For the indexed formats, the default palettes and the
+// translation through an application palette are checked as well.
+//
+
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "grlib/grlib.h"
+#include "Crystalfontz128x128_ST7735.h"
+#include "HAL_EK_TM4C1294XL_Crystalfontz128x128_ST7735.h"
+#include "test.h"
+
+
+
+// Size of the simulated display RAM of the ST7735.
+#define SIM_RAM_WIDTH               132
+#define SIM_RAM_HEIGHT              162
+
+// Offset of the visible area in the display RAM with the orientation up.
+#define SIM_OFFSET_X                2
+#define SIM_OFFSET_Y                3
+
+// Number of bytes per uDMA task.
+#define SIM_TASK_SIZE_MAX           1024
+
+
+
+// Global variables.
+// Simulated display controller.
+static uint16_t g_ppui16SimRam[SIM_RAM_HEIGHT][SIM_RAM_WIDTH];
+static uint8_t g_ui8SimCmd;
+static uint8_t g_pui8SimParam[4];
+static int g_iSimParamCnt;
+static uint32_t g_ui32SimX0, g_ui32SimX1, g_ui32SimY0, g_ui32SimY1;
+static uint32_t g_ui32SimX, g_ui32SimY;
+static uint8_t g_ui8SimHigh;
+static bool g_bSimHigh;
+static uint32_t g_ui32SimPixels;        // Pixels written since the last check.
+
+// Simulated task list of the asynchronous transfer.
+static struct {
+    const uint8_t   *pui8Data;
+    uint32_t        ui32Length;
+} g_psSimTask[HAL_LCD_TASK_MAX];
+static uint32_t g_ui32SimTaskCnt;
+static uint32_t g_ui32SimTaskMax = HAL_LCD_TASK_MAX;
+
+// Expected colors of the screen (24 bit RGB).
+static uint32_t g_ppui32Model[LCD_VERTICAL_MAX][LCD_HORIZONTAL_MAX];
+
+static tContext g_sContext;
+
+// Colors of the application palette.
+static const uint32_t g_pui32TestPalette[16] = {
+    0x000000, 0xffffff, 0xff0000, 0x00ff00, 0x0000ff, 0x204060, 0x806040, 0xc0a080,
+    0x10e0f0, 0xf01080, 0x7f7f7f, 0x3366cc, 0xcc6633, 0x08f808, 0xa0a0a0, 0x602090,
+};
+
+// Images. Palette entries are stored as blue, green, red.
+static const uint8_t g_pui8Image1Bpp[] = {
+    IMAGE_FMT_1BPP_UNCOMP, 11, 0, 3, 0,
+    0xa5, 0xc0,
+    0x3c, 0x20,
+    0xff, 0xe0,
+};
+static const uint8_t g_pui8Image4Bpp[] = {
+    IMAGE_FMT_4BPP_UNCOMP, 5, 0, 3, 0,
+    3,
+    0x40, 0x60, 0x80,   // 0x806040
+    0xf0, 0xe0, 0x10,   // 0x10e0f0
+    0x00, 0x00, 0xff,   // 0xff0000
+    0xcc, 0x66, 0x33,   // 0x3366cc
+    0x01, 0x23, 0x10,
+    0x32, 0x10, 0x20,
+    0x33, 0x33, 0x30,
+};
+static const uint8_t g_pui8Image8Bpp[] = {
+    IMAGE_FMT_8BPP_UNCOMP, 3, 0, 2, 0,
+    2,
+    0x00, 0x00, 0x00,   // 0x000000
+    0x90, 0x20, 0x60,   // 0x602090
+    0x08, 0xf8, 0x08,   // 0x08f808
+    0x00, 0x01, 0x02,
+    0x02, 0x02, 0x01,
+};
+
+
+
+// Stubs of the system functions used by the LCD driver.
+void TimebaseDelayUs(uint32_t ui32DelayUs) {}
+uint32_t CycleCounterGet(void) { return 0; }
+void PerfProbeUpdate(tPerfProbe *psPerfProbe, uint32_t ui32Cycles) {}
+
+
+
+// Simulated display controller. Only the commands used to write the display
+// RAM are evaluated.
+static void SimData(uint8_t ui8Data)
+{
+    switch (g_ui8SimCmd) {
+        case CM_CASET:
+        case CM_RASET:
+            if (g_iSimParamCnt >= 4) break;
+            g_pui8SimParam[g_iSimParamCnt++] = ui8Data;
+            if (g_iSimParamCnt < 4) break;
+            if (g_ui8SimCmd == CM_CASET) {
+                g_ui32SimX0 = (g_pui8SimParam[0] << 8) | g_pui8SimParam[1];
+                g_ui32SimX1 = (g_pui8SimParam[2] << 8) | g_pui8SimParam[3];
+            } else {
+                g_ui32SimY0 = (g_pui8SimParam[0] << 8) | g_pui8SimParam[1];
+                g_ui32SimY1 = (g_pui8SimParam[2] << 8) | g_pui8SimParam[3];
+            }
+            break;
+        case CM_RAMWR:
+            // RGB565, high byte first.
+            if (!g_bSimHigh) {
+                g_ui8SimHigh = ui8Data;
+                g_bSimHigh = true;
+                break;
+            }
+            g_bSimHigh = false;
+            if ((g_ui32SimX < SIM_RAM_WIDTH) && (g_ui32SimY < SIM_RAM_HEIGHT)) {
+                g_ppui16SimRam[g_ui32SimY][g_ui32SimX] = (g_ui8SimHigh << 8) | ui8Data;
+            }
+            g_ui32SimPixels++;
+            if (++g_ui32SimX > g_ui32SimX1) {
+                g_ui32SimX = g_ui32SimX0;
+                g_ui32SimY++;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+static void SimSend(const uint8_t *pui8Data, uint32_t ui32Length)
+{
+    while (ui32Length--) SimData(*pui8Data++);
+}
+
+
+
+// Simulated HAL functions. The queued data is sent when the transfer is
+// started, like by the uDMA controller.
+void HAL_LCD_PortInit(void) {}
+void HAL_LCD_SpiInit(void) {}
+
+void HAL_LCD_writeCommand(uint8_t ui8Cmd)
+{
+    g_ui8SimCmd = ui8Cmd;
+    g_iSimParamCnt = 0;
+    g_bSimHigh = false;
+    if (ui8Cmd == CM_RAMWR) {
+        g_ui32SimX = g_ui32SimX0;
+        g_ui32SimY = g_ui32SimY0;
+    }
+}
+
+void HAL_LCD_writeData(uint8_t ui8Data)
+{
+    SimData(ui8Data);
+}
+
+bool HAL_LCD_queueData(const uint8_t *pui8Data, uint32_t ui32Length)
+{
+    uint32_t ui32Cnt;
+
+    if (g_ui32SimTaskCnt + (ui32Length + SIM_TASK_SIZE_MAX - 1) / SIM_TASK_SIZE_MAX > g_ui32SimTaskMax) return false;
+    while (ui32Length) {
+        ui32Cnt = ui32Length > SIM_TASK_SIZE_MAX ? SIM_TASK_SIZE_MAX : ui32Length;
+        g_psSimTask[g_ui32SimTaskCnt].pui8Data = pui8Data;
+        g_psSimTask[g_ui32SimTaskCnt].ui32Length = ui32Cnt;
+        g_ui32SimTaskCnt++;
+        pui8Data += ui32Cnt;
+        ui32Length -= ui32Cnt;
+    }
+
+    return true;
+}
+
+void HAL_LCD_startQueue(void (*pfnCallback)(void))
+{
+    for (uint32_t i = 0; i < g_ui32SimTaskCnt; i++) SimSend(g_psSimTask[i].pui8Data, g_psSimTask[i].ui32Length);
+    g_ui32SimTaskCnt = 0;
+    if (pfnCallback) pfnCallback();
+}
+
+void HAL_LCD_writeDataBulk(const uint8_t *pui8Data, uint32_t ui32Length)
+{
+    TEST_CHECK_EQ(g_ui32SimTaskCnt, 0);
+    SimSend(pui8Data, ui32Length);
+}
+
+bool HAL_LCD_busy(void)
+{
+    return false;
+}
+
+void HAL_LCD_waitIdle(void) {}
+
+
+
+// Expected RGB565 value of a color in the display RAM.
+static uint16_t Rgb565(uint32_t ui32Rgb)
+{
+    return ((ui32Rgb >> 8) & 0xf800) | ((ui32Rgb >> 5) & 0x07e0) | ((ui32Rgb >> 3) & 0x001f);
+}
+
+
+
+// Update the model.
+static void ModelRect(int32_t i32X0, int32_t i32Y0, int32_t i32X1, int32_t i32Y1, uint32_t ui32Rgb)
+{
+    for (int32_t y = i32Y0; y <= i32Y1; y++) {
+        for (int32_t x = i32X0; x <= i32X1; x++) g_ppui32Model[y][x] = ui32Rgb;
+    }
+}
+
+// The colors of 1 bpp images are given by ui32Fg and ui32Bg.
+static void ModelImage(const uint8_t *pui8Image, int32_t i32X, int32_t i32Y, uint32_t ui32Fg, uint32_t ui32Bg)
+{
+    int32_t i32Bpp = pui8Image[0], i32Width = pui8Image[1], i32Height = pui8Image[3];
+    const uint8_t *pui8Palette = pui8Image + 6, *pui8Data = pui8Image + 5;
+    uint32_t ui32Index;
+
+    if (i32Bpp != IMAGE_FMT_1BPP_UNCOMP) pui8Data += 1 + (pui8Image[5] + 1) * 3;
+    for (int32_t y = 0; y < i32Height; y++) {
+        for (int32_t x = 0; x < i32Width; x++) {
+            ui32Index = (pui8Data[x * i32Bpp / 8] >> (8 - i32Bpp - (x * i32Bpp) % 8)) & ((1 << i32Bpp) - 1);
+            if (i32Bpp == IMAGE_FMT_1BPP_UNCOMP) {
+                g_ppui32Model[i32Y + y][i32X + x] = ui32Index ? ui32Fg : ui32Bg;
+            } else {
+                g_ppui32Model[i32Y + y][i32X + x] = (pui8Palette[3 * ui32Index + 2] << 16) |
+                                                   (pui8Palette[3 * ui32Index + 1] << 8) | pui8Palette[3 * ui32Index];
+            }
+        }
+        pui8Data += (i32Width * i32Bpp + 7) / 8;
+    }
+}
+
+
+
+// Flush the frame buffer and compare the display RAM with the model. The
+// number of pixels sent is returned.
+static uint32_t FlushCheck(void)
+{
+    int iMismatch = 0;
+    uint32_t ui32Pixels;
+
+    g_ui32SimPixels = 0;
+    GrFlush(&g_sContext);
+    for (int32_t y = 0; y < LCD_VERTICAL_MAX; y++) {
+        for (int32_t x = 0; x < LCD_HORIZONTAL_MAX; x++) {
+            if (g_ppui16SimRam[y + SIM_OFFSET_Y][x + SIM_OFFSET_X] != Rgb565(g_ppui32Model[y][x])) iMismatch++;
+        }
+    }
+    TEST_CHECK_EQ(iMismatch, 0);
+    TEST_CHECK_EQ(g_ui32SimTaskCnt, 0);
+    ui32Pixels = g_ui32SimPixels;
+
+    return ui32Pixels;
+}
+
+
+
+// Fill the screen with a color.
+static void Clear(uint32_t ui32Rgb)
+{
+    tRectangle sRect = {0, 0, LCD_HORIZONTAL_MAX - 1, LCD_VERTICAL_MAX - 1};
+
+    GrContextForegroundSet(&g_sContext, ui32Rgb);
+    GrRectFill(&g_sContext, &sRect);
+    ModelRect(0, 0, LCD_HORIZONTAL_MAX - 1, LCD_VERTICAL_MAX - 1, ui32Rgb);
+}
+
+
+
+// Colors of the default palettes. These colors are exact in the RGB 3-3-2
+// palette for 8 bpp and in the VGA palette for 4 bpp.
+static void TestDefaultPalette(void)
+{
+    const uint32_t pui32Rgb[] = {ClrBlack, ClrWhite, ClrRed, ClrLime, ClrBlue, ClrYellow, ClrCyan, ClrMagenta};
+    tRectangle sRect;
+
+    Clear(ClrBlack);
+    for (int i = 0; i < sizeof(pui32Rgb) / sizeof(pui32Rgb[0]); i++) {
+        sRect.i16XMin = 5 + 13 * i;
+        sRect.i16YMin = 3 * i;
+        sRect.i16XMax = sRect.i16XMin + 8 + i;
+        sRect.i16YMax = sRect.i16YMin + 40;
+        GrContextForegroundSet(&g_sContext, pui32Rgb[i]);
+        GrRectFill(&g_sContext, &sRect);
+        ModelRect(sRect.i16XMin, sRect.i16YMin, sRect.i16XMax, sRect.i16YMax, pui32Rgb[i]);
+    }
+    FlushCheck();
+}
+
+
+
+// Rectangles, lines and pixels with odd and even coordinates.
+static void TestDraw(void)
+{
+    const tRectangle psRect[] = {
+        {3, 5, 60, 77}, {0, 0, 0, 0}, {127, 127, 127, 127}, {1, 2, 2, 9}, {4, 10, 4, 10}, {6, 90, 7, 91},
+        {0, 100, 127, 101}, {121, 0, 127, 127},
+    };
+    tRectangle sRect;
+    uint32_t ui32Pixels;
+
+    Clear(g_pui32TestPalette[0]);
+    FlushCheck();
+    for (int i = 0; i < sizeof(psRect) / sizeof(psRect[0]); i++) {
+        GrContextForegroundSet(&g_sContext, g_pui32TestPalette[2 + i]);
+        GrRectFill(&g_sContext, &psRect[i]);
+        ModelRect(psRect[i].i16XMin, psRect[i].i16YMin, psRect[i].i16XMax, psRect[i].i16YMax, g_pui32TestPalette[2 + i]);
+    }
+    FlushCheck();
+
+    // Horizontal and vertical lines.
+    for (int i = 0; i < 8; i++) {
+        GrContextForegroundSet(&g_sContext, g_pui32TestPalette[(3 + i) & 15]);
+        GrLineDrawH(&g_sContext, 10 + (i >> 1), 20 + i + (i & 1) * 3, 80 + i);
+        ModelRect(10 + (i >> 1), 80 + i, 20 + i + (i & 1) * 3, 80 + i, g_pui32TestPalette[(3 + i) & 15]);
+        GrLineDrawV(&g_sContext, 30 + i, 40 + i, 60 - i);
+        ModelRect(30 + i, 40 + i, 30 + i, 60 - i, g_pui32TestPalette[(3 + i) & 15]);
+    }
+    GrContextForegroundSet(&g_sContext, g_pui32TestPalette[1]);
+    GrLineDrawH(&g_sContext, 7, 7, 20);
+    GrLineDrawH(&g_sContext, 8, 8, 21);
+    GrLineDrawV(&g_sContext, 9, 22, 22);
+    ModelRect(7, 20, 7, 20, g_pui32TestPalette[1]);
+    ModelRect(8, 21, 8, 21, g_pui32TestPalette[1]);
+    ModelRect(9, 22, 9, 22, g_pui32TestPalette[1]);
+    FlushCheck();
+
+    // Pixels.
+    for (int i = 0; i < 32; i++) {
+        GrContextForegroundSet(&g_sContext, g_pui32TestPalette[i & 15]);
+        GrPixelDraw(&g_sContext, 64 + i, 100 + (i % 5));
+        ModelRect(64 + i, 100 + (i % 5), 64 + i, 100 + (i % 5), g_pui32TestPalette[i & 15]);
+    }
+    FlushCheck();
+
+    // Only the dirty region is sent.
+    GrContextForegroundSet(&g_sContext, g_pui32TestPalette[9]);
+    sRect = (tRectangle) {33, 40, 42, 43};
+    GrRectFill(&g_sContext, &sRect);
+    ModelRect(33, 40, 42, 43, g_pui32TestPalette[9]);
+    ui32Pixels = FlushCheck();
+    TEST_CHECK_EQ(ui32Pixels, 10 * 4);
+    TEST_CHECK_EQ(FlushCheck(), 0);
+}
+
+
+
+// Images with odd and even coordinates.
+static void TestImage(void)
+{
+    Clear(g_pui32TestPalette[5]);
+    for (int i = 0; i < 2; i++) {
+        GrContextForegroundSet(&g_sContext, g_pui32TestPalette[1 + i]);
+        GrContextBackgroundSet(&g_sContext, g_pui32TestPalette[10 + i]);
+        GrImageDraw(&g_sContext, g_pui8Image1Bpp, 10 + i, 10 + 5 * i);
+        ModelImage(g_pui8Image1Bpp, 10 + i, 10 + 5 * i, g_pui32TestPalette[1 + i], g_pui32TestPalette[10 + i]);
+        GrImageDraw(&g_sContext, g_pui8Image4Bpp, 30 + i, 10 + 5 * i);
+        ModelImage(g_pui8Image4Bpp, 30 + i, 10 + 5 * i, 0, 0);
+        GrImageDraw(&g_sContext, g_pui8Image8Bpp, 50 + i, 10 + 5 * i);
+        ModelImage(g_pui8Image8Bpp, 50 + i, 10 + 5 * i, 0, 0);
+    }
+    FlushCheck();
+}
+
+
+
+// The task list is full: the rows are sent blocking.
+static void TestTaskListFull(void)
+{
+    tRectangle sRect = {17, 3, 90, 120};
+
+    g_ui32SimTaskMax = 8;
+    GrContextForegroundSet(&g_sContext, g_pui32TestPalette[12]);
+    GrRectFill(&g_sContext, &sRect);
+    ModelRect(17, 3, 90, 120, g_pui32TestPalette[12]);
+    TEST_CHECK_EQ(FlushCheck(), 74 * 118);
+    g_ui32SimTaskMax = HAL_LCD_TASK_MAX;
+}
+
+
+
+// Regions marked directly are clipped to the screen. Empty or inverted regions
+// are ignored.
+static void TestSetDirty(void)
+{
+    Crystalfontz128x128_SetDirty(120, -5, 140, 3);
+    TEST_CHECK_EQ(FlushCheck(), 8 * 4);
+    Crystalfontz128x128_SetDirty(-10, -10, 200, 300);
+    TEST_CHECK_EQ(FlushCheck(), LCD_HORIZONTAL_MAX * LCD_VERTICAL_MAX);
+    Crystalfontz128x128_SetDirty(10, 10, 5, 20);
+    Crystalfontz128x128_SetDirty(200, 10, 300, 20);
+    Crystalfontz128x128_SetDirty(10, -20, 20, -1);
+    TEST_CHECK_EQ(FlushCheck(), 0);
+}
+
+
+
+#if LCD_BUFFER_BPP != 16
+// A new palette changes the colors of all pixels with these indices.
+static void TestPaletteChange(void)
+{
+    uint32_t pui32Palette[16];
+
+    memcpy(pui32Palette, g_pui32TestPalette, sizeof(pui32Palette));
+    pui32Palette[12] = 0x123456;
+    Crystalfontz128x128_SetPalette(&pui32Palette[12], 12, 1);
+    for (int32_t y = 0; y < LCD_VERTICAL_MAX; y++) {
+        for (int32_t x = 0; x < LCD_HORIZONTAL_MAX; x++) {
+            if (g_ppui32Model[y][x] == g_pui32TestPalette[12]) g_ppui32Model[y][x] = pui32Palette[12];
+        }
+    }
+    TEST_CHECK_EQ(FlushCheck(), LCD_HORIZONTAL_MAX * LCD_VERTICAL_MAX);
+    // Colors map to the closest palette entry.
+    GrContextForegroundSet(&g_sContext, 0x10e8e8);
+    GrLineDrawH(&g_sContext, 0, 127, 0);
+    ModelRect(0, 0, 127, 0, g_pui32TestPalette[8]);
+    FlushCheck();
+    Crystalfontz128x128_SetPalette(g_pui32TestPalette, 0, 16);
+}
+#endif
+
+
+
+int main(void)
+{
+    Crystalfontz128x128_Init();
+    Crystalfontz128x128_SetOrientation(LCD_ORIENTATION_UP);
+    GrContextInit(&g_sContext, &g_sCrystalfontz128x128);
+
+    TestDefaultPalette();
+#if LCD_BUFFER_BPP != 16
+    Crystalfontz128x128_SetPalette(g_pui32TestPalette, 0, 16);
+#endif
+    TestDraw();
+    TestImage();
+    TestTaskListFull();
+    TestSetDirty();
+#if LCD_BUFFER_BPP != 16
+    TestPaletteChange();
+#endif
+
+#if defined(LCD_DOUBLE_BUFFER)
+    return TestResult("test_lcd (16 bpp, double buffer)");
+#else
+    return TestResult(LCD_BUFFER_BPP == 16 ? "test_lcd (16 bpp)" : LCD_BUFFER_BPP == 8 ? "test_lcd (8 bpp)" : "test_lcd (4 bpp)");
+#endif
+}
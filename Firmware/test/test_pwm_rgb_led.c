@@ -0,0 +1,148 @@
+// File: test_pwm_rgb_led.c
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 17 Oct 2026
+// Rev.: 17 Oct 2026
+//
+// Host test of the lookup tables of the RGB LED in pwm_rgb_led.c, which are
+// generated at compile time by PWM_RGB_LED_LUT_256. The driverlib PWM and
+// timer functions are replaced by stubs that record the pulse widths and the
+// match value, so the table entries are read back through PwmRgbLedSet. The
+// pulse widths must rise monotonically with the color value, start at the
+// minimum pulse width of 1 clock cycle and end at the maximum pulse width with
+// the white balance gain of the channel. The gamma correction is compared
+// with x^2.2.
+//
+
+
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "inc/hw_memmap.h"
+#include "driverlib/pwm.h"
+#include "driverlib/timer.h"
+#include "pwm_rgb_led.h"
+#include "test.h"
+
+
+
+// Allowed difference of the gamma correction from x^2.2 relative to the
+// maximum pulse width.
+#define TEST_GAMMA_TOL              0.01
+
+
+
+// Global variables.
+// Last pulse widths of the red and green PWM outputs and match value of the
+// blue timer output.
+static uint32_t g_ui32SimPulseR;
+static uint32_t g_ui32SimPulseG;
+static uint32_t g_ui32SimMatchB;
+
+
+
+// Stubs of the driverlib functions used by pwm_rgb_led.c.
+void SysCtlPeripheralEnable(uint32_t ui32Peripheral) {}
+void GPIOPinConfigure(uint32_t ui32PinConfig) {}
+void GPIOPinTypePWM(uint32_t ui32Port, uint8_t ui8Pins) {}
+void GPIOPinTypeTimer(uint32_t ui32Port, uint8_t ui8Pins) {}
+void PWMClockSet(uint32_t ui32Base, uint32_t ui32Config) {}
+void PWMGenConfigure(uint32_t ui32Base, uint32_t ui32Gen, uint32_t ui32Config) {}
+void PWMGenPeriodSet(uint32_t ui32Base, uint32_t ui32Gen, uint32_t ui32Period) {}
+void PWMGenEnable(uint32_t ui32Base, uint32_t ui32Gen) {}
+void PWMOutputState(uint32_t ui32Base, uint32_t ui32PWMOutBits, bool bEnable) {}
+void TimerClockSourceSet(uint32_t ui32Base, uint32_t ui32Source) {}
+void TimerConfigure(uint32_t ui32Base, uint32_t ui32Config) {}
+void TimerLoadSet(uint32_t ui32Base, uint32_t ui32Timer, uint32_t ui32Value) {}
+void TimerControlLevel(uint32_t ui32Base, uint32_t ui32Timer, bool bInvert) {}
+void TimerUpdateMode(uint32_t ui32Base, uint32_t ui32Timer, uint32_t ui32Config) {}
+void TimerEnable(uint32_t ui32Base, uint32_t ui32Timer) {}
+void TimerDisable(uint32_t ui32Base, uint32_t ui32Timer) {}
+void TimerPrescaleSet(uint32_t ui32Base, uint32_t ui32Timer, uint32_t ui32Value) {}
+void TimerIntRegister(uint32_t ui32Base, uint32_t ui32Timer, void (*pfnHandler)(void)) {}
+void TimerIntClear(uint32_t ui32Base, uint32_t ui32IntFlags) {}
+void TimerIntEnable(uint32_t ui32Base, uint32_t ui32IntFlags) {}
+
+void PWMPulseWidthSet(uint32_t ui32Base, uint32_t ui32PWMOut, uint32_t ui32Width)
+{
+    if (ui32Base != PWM0_BASE) return;
+    if (ui32PWMOut == PWM_OUT_6) g_ui32SimPulseR = ui32Width;
+    if (ui32PWMOut == PWM_OUT_7) g_ui32SimPulseG = ui32Width;
+}
+
+void TimerMatchSet(uint32_t ui32Base, uint32_t ui32Timer, uint32_t ui32Value)
+{
+    if ((ui32Base == TIMER2_BASE) && (ui32Timer == TIMER_A)) g_ui32SimMatchB = ui32Value;
+}
+
+
+
+// Get the pulse width of a channel (0 = red, 1 = green, 2 = blue) for a color
+// value. The other channels are set to 0.
+static uint32_t PulseGet(int iChannel, int iValue)
+{
+    PwmRgbLedSet(iChannel == 0 ? iValue : 0, iChannel == 1 ? iValue : 0, iChannel == 2 ? iValue : 0);
+    switch (iChannel) {
+        case 0: return g_ui32SimPulseR;
+        case 1: return g_ui32SimPulseG;
+        default:
+            // The timer output is high from the match value to the end of the period.
+            return PWM_RGB_LED_PERIOD - g_ui32SimMatchB;
+    }
+}
+
+
+
+// Lookup tables of the three channels.
+static void TestLut(void)
+{
+    const uint32_t pui32Wb[3] = {PWM_RGB_LED_WB_R, PWM_RGB_LED_WB_G, PWM_RGB_LED_WB_B};
+    uint32_t pui32Pulse[256], ui32PulseMax;
+    int iDecreasing, iGammaMismatch;
+
+    for (int iChannel = 0; iChannel < 3; iChannel++) {
+        iDecreasing = 0;
+        iGammaMismatch = 0;
+        ui32PulseMax = PWM_RGB_LED_PULSE_MAX * pui32Wb[iChannel] / 256;
+        for (int i = 0; i < 256; i++) {
+            pui32Pulse[i] = PulseGet(iChannel, i);
+            if ((i > 0) && (pui32Pulse[i] < pui32Pulse[i - 1])) iDecreasing++;
+            if (fabs(pui32Pulse[i] - ui32PulseMax * pow(i / 255.0, 2.2)) > ui32PulseMax * TEST_GAMMA_TOL) iGammaMismatch++;
+        }
+        TEST_CHECK_EQ(iDecreasing, 0);
+        TEST_CHECK_EQ(iGammaMismatch, 0);
+        // End points.
+        TEST_CHECK_EQ(pui32Pulse[0], 1);
+        TEST_CHECK_EQ(pui32Pulse[255], ui32PulseMax);
+        // The full range is used.
+        TEST_CHECK(pui32Pulse[128] > pui32Pulse[0]);
+        TEST_CHECK(pui32Pulse[255] > pui32Pulse[254]);
+    }
+    TEST_CHECK(PWM_RGB_LED_PULSE_MAX < PWM_RGB_LED_PERIOD);
+}
+
+
+
+// Color values out of range are coerced to 0..255.
+static void TestCoerce(void)
+{
+    PwmRgbLedSet(255, 255, 255);
+    PwmRgbLedSet(-1, 256, 1000);
+    TEST_CHECK_EQ(g_ui32SimPulseR, PulseGet(0, 0));
+    PwmRgbLedSet(-1, 256, 1000);
+    TEST_CHECK_EQ(g_ui32SimPulseG, PulseGet(1, 255));
+    PwmRgbLedSet(-1, 256, 1000);
+    TEST_CHECK_EQ(PWM_RGB_LED_PERIOD - g_ui32SimMatchB, PulseGet(2, 255));
+}
+
+
+
+int main(void)
+{
+    PwmRgbLedInit();
+    TestLut();
+    TestCoerce();
+
+    return TestResult("test_pwm_rgb_led");
+}
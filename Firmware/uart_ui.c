@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 07 Feb 2020
-// Rev.: 26 Aug 2020
+// Rev.: 17 Oct 2026
 //
 // UART user interface (UI) for the TI Tiva TM4C1294 Connected LaunchPad
 // Evaluation Kit.
@@ -13,12 +13,20 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include "driverlib/gpio.h"
+#include "driverlib/rom.h"
+#include "driverlib/rom_map.h"
 #include "driverlib/sysctl.h"
+#include "driverlib/uart.h"
 #include "utils/uartstdio.h"
 #include "uart_ui.h"
 
 
 
+// Function prototypes of local functions.
+static int UartUiLineChar(tUartUi *psUartUi, char *pcBuf, uint32_t ui32Len, uint8_t ui8Sync, uint8_t ui8Char);
+
+
+
 // Initialize the UART user interface and its pins.
 void UartUiInit(tUartUi *psUartUi)
 {
@@ -37,5 +45,163 @@ void UartUiInit(tUartUi *psUartUi)
 
     // Initialize the UART for console I/O.
     UARTStdioConfig(psUartUi->ui32Port, psUartUi->ui32Baud, psUartUi->ui32SrcClock);
+#ifdef UART_BUFFERED
+    // The console output is buffered by uartstdio, but the received characters
+    // are read by the user interface.
+    MAP_UARTIntDisable(psUartUi->ui32Base, UART_INT_RX | UART_INT_RT);
+#endif
+}
+
+
+
+// Enable the interrupt-driven receive queue of the UART user interface. Input
+// is then buffered while a command is being executed, so a host can send
+// several commands without waiting for the responses.
+void UartUiIntInit(tUartUi *psUartUi, void (*pfnIntHandler)(void))
+{
+    RingBufInit(&psUartUi->sRxRingBuf, psUartUi->pui8RxBuf, UART_UI_RX_BUF_SIZE);
+    psUartUi->ui32RxMax = 0;
+    psUartUi->ui32RxOverrunCnt = 0;
+    psUartUi->bIntEnabled = true;
+
+    UARTIntRegister(psUartUi->ui32Base, pfnIntHandler);
+    UARTIntClear(psUartUi->ui32Base, UART_INT_RX | UART_INT_RT);
+    UARTIntEnable(psUartUi->ui32Base, UART_INT_RX | UART_INT_RT);
+}
+
+
+
+// Interrupt handler of the UART user interface. Moves the received characters
+// from the UART FIFO into the receive queue. If the console output is
+// buffered, the transmit FIFO is also refilled from the uartstdio transmit
+// buffer.
+void UartUiIntHandler(tUartUi *psUartUi)
+{
+    uint32_t ui32Ints;
+    uint32_t ui32Used;
+
+    ui32Ints = UARTIntStatus(psUartUi->ui32Base, true);
+    UARTIntClear(psUartUi->ui32Base, ui32Ints);
+#ifdef UART_BUFFERED
+    if (ui32Ints & UART_INT_TX) UARTStdioTxIntHandler();
+#endif
+    if (!psUartUi->bIntEnabled) return;
+    while (UARTCharsAvail(psUartUi->ui32Base)) {
+        uint8_t ui8Char = UARTCharGetNonBlocking(psUartUi->ui32Base) & 0xff;
+        if (RingBufFull(&psUartUi->sRxRingBuf)) {
+            psUartUi->ui32RxOverrunCnt++;
+            continue;
+        }
+        RingBufWriteOne(&psUartUi->sRxRingBuf, ui8Char);
+    }
+    ui32Used = RingBufUsed(&psUartUi->sRxRingBuf);
+    if (ui32Used > psUartUi->ui32RxMax) psUartUi->ui32RxMax = ui32Used;
+}
+
+
+
+// Get a character from the UART user interface without waiting. Returns -1 if
+// no character is available.
+int32_t UartUiCharGetNonBlocking(tUartUi *psUartUi)
+{
+    if (psUartUi->bIntEnabled) {
+        if (RingBufEmpty(&psUartUi->sRxRingBuf)) return -1;
+        return RingBufReadOne(&psUartUi->sRxRingBuf);
+    }
+    return MAP_UARTCharGetNonBlocking(psUartUi->ui32Base);
+}
+
+
+
+// Get a character from the UART user interface. Waits until one is available.
+uint8_t UartUiCharGet(tUartUi *psUartUi)
+{
+    int32_t i32Char;
+
+    if (!psUartUi->bIntEnabled) return MAP_UARTCharGet(psUartUi->ui32Base) & 0xff;
+    while ((i32Char = UartUiCharGetNonBlocking(psUartUi)) < 0);
+    return i32Char & 0xff;
+}
+
+
+
+// Read a line from the UART user interface. This works like UARTgets, but
+// returns UART_UI_GETS_SYNC without consuming any further characters if the
+// first character of the line is the sync byte of a binary frame. Lines
+// starting with UART_UI_TAG_CHAR are not echoed.
+int UartUiGets(tUartUi *psUartUi, char *pcBuf, uint32_t ui32Len, uint8_t ui8Sync)
+{
+    int iRet;
+
+    while ((iRet = UartUiLineChar(psUartUi, pcBuf, ui32Len, ui8Sync, UartUiCharGet(psUartUi))) == UART_UI_GETS_PENDING);
+
+    return iRet;
 }
 
+
+
+// Read a line from the UART user interface without waiting. This works like
+// UartUiGets, but returns UART_UI_GETS_PENDING if the line is not complete
+// yet. The same buffer must be passed until the line is complete.
+int UartUiGetsNonBlocking(tUartUi *psUartUi, char *pcBuf, uint32_t ui32Len, uint8_t ui8Sync)
+{
+    int32_t i32Char;
+    int iRet;
+
+    while ((i32Char = UartUiCharGetNonBlocking(psUartUi)) >= 0) {
+        iRet = UartUiLineChar(psUartUi, pcBuf, ui32Len, ui8Sync, i32Char & 0xff);
+        if (iRet != UART_UI_GETS_PENDING) return iRet;
+    }
+
+    return UART_UI_GETS_PENDING;
+}
+
+
+
+// Add a received character to the line. Returns the length of the line if it
+// is complete, UART_UI_GETS_SYNC if a binary frame starts or
+// UART_UI_GETS_PENDING if the line is not complete yet.
+static int UartUiLineChar(tUartUi *psUartUi, char *pcBuf, uint32_t ui32Len, uint8_t ui8Sync, uint8_t ui8Char)
+{
+    int iRet;
+
+    // Binary frame detected.
+    if ((psUartUi->ui32LineCnt == 0) && (ui8Char == ui8Sync)) {
+        psUartUi->bLastWasCR = false;
+        pcBuf[0] = 0;
+        return UART_UI_GETS_SYNC;
+    }
+    if (psUartUi->ui32LineCnt == 0) psUartUi->bLineEcho = (ui8Char != UART_UI_TAG_CHAR);
+    // Backspace: rub out the previous character.
+    if (ui8Char == '\b') {
+        if (psUartUi->ui32LineCnt) {
+            if (psUartUi->bLineEcho) UARTwrite("\b \b", 3);
+            psUartUi->ui32LineCnt--;
+        }
+        return UART_UI_GETS_PENDING;
+    }
+    // A LF following a CR was already handled with the CR.
+    if ((ui8Char == '\n') && psUartUi->bLastWasCR) {
+        psUartUi->bLastWasCR = false;
+        return UART_UI_GETS_PENDING;
+    }
+    psUartUi->bLastWasCR = false;
+    // End of line: terminate the line and echo the newline.
+    if ((ui8Char == '\r') || (ui8Char == '\n') || (ui8Char == 0x1b)) {
+        if (ui8Char == '\r') psUartUi->bLastWasCR = true;
+        pcBuf[psUartUi->ui32LineCnt] = 0;
+        if (psUartUi->bLineEcho) UARTwrite("\r\n", 2);
+        iRet = psUartUi->ui32LineCnt;
+        psUartUi->ui32LineCnt = 0;
+        return iRet;
+    }
+    // Store and echo the character. Additional characters beyond the buffer
+    // size (leaving space for the trailing null terminator) are ignored until
+    // the end of the line.
+    if (psUartUi->ui32LineCnt < ui32Len - 1) {
+        pcBuf[psUartUi->ui32LineCnt++] = ui8Char;
+        if (psUartUi->bLineEcho) UARTwrite((char *) &ui8Char, 1);
+    }
+
+    return UART_UI_GETS_PENDING;
+}
@@ -2,7 +2,7 @@
 // Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 // Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 // Date: 07 Feb 2020
-// Rev.: 10 Apr 2020
+// Rev.: 17 Oct 2026
 //
 // Header file for the UART user interface (UI) for the TI Tiva TM4C1294
 // Connected LaunchPad Evaluation Kit.
@@ -15,6 +15,24 @@
 
 
 
+#include "utils/ringbuf.h"
+
+
+
+// Return value of UartUiGets if the sync byte of a binary frame was received.
+#define UART_UI_GETS_SYNC       -1
+// Return value of UartUiGetsNonBlocking if the line is not complete yet.
+#define UART_UI_GETS_PENDING    -2
+
+// Lines starting with the tag character are pipelined commands from a host.
+// They are not echoed.
+#define UART_UI_TAG_CHAR        '@'
+
+// Size of the receive queue used in interrupt mode.
+#define UART_UI_RX_BUF_SIZE     1024
+
+
+
 // Types.
 typedef struct {
     uint32_t ui32PeripheralUart;
@@ -28,12 +46,28 @@ typedef struct {
     uint32_t ui32SrcClock;
     uint32_t ui32Baud;
     uint32_t ui32Port;
+    // Receive queue filled by the interrupt handler. Managed by the driver.
+    bool     bIntEnabled;
+    tRingBufObject sRxRingBuf;
+    uint8_t  pui8RxBuf[UART_UI_RX_BUF_SIZE];
+    volatile uint32_t ui32RxMax;        // Maximum fill level of the receive queue.
+    volatile uint32_t ui32RxOverrunCnt; // Characters lost due to a full receive queue.
+    // Line being read. Managed by the driver.
+    uint32_t ui32LineCnt;
+    bool     bLineEcho;
+    bool     bLastWasCR;
 } tUartUi;
 
 
 
 // Function prototypes.
 void UartUiInit(tUartUi *psUartUi);
+void UartUiIntInit(tUartUi *psUartUi, void (*pfnIntHandler)(void));
+void UartUiIntHandler(tUartUi *psUartUi);
+int32_t UartUiCharGetNonBlocking(tUartUi *psUartUi);
+uint8_t UartUiCharGet(tUartUi *psUartUi);
+int UartUiGets(tUartUi *psUartUi, char *pcBuf, uint32_t ui32Len, uint8_t ui8Sync);
+int UartUiGetsNonBlocking(tUartUi *psUartUi, char *pcBuf, uint32_t ui32Len, uint8_t ui8Sync);
 
 
 
@@ -0,0 +1,189 @@
+// File: ui_cmd.c
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 17 Oct 2026
+// Rev.: 17 Oct 2026
+//
+// Command table and dispatcher of the UART user interface for the TI Tiva
+// TM4C1294 Connected LaunchPad Evaluation Kit. The commands are looked up with
+// a hash table that is built once from the command table.
+//
+
+
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "utils/uartstdio.h"
+#include "hw/system/perf.h"
+#include "hw/system/system.h"
+#include "ui_cmd.h"
+#include "hw_demo.h"
+
+
+
+// Global variables.
+static const tUiCmd *g_psUiCmd;
+static uint32_t g_ui32UiCmdNum;
+static uint8_t g_pui8UiCmdHash[UI_CMD_HASH_SIZE];
+static const tUiCmd *g_psUiCmdCurrent;      // Command being executed.
+static tPerfProbe g_psUiCmdPerf[UI_CMD_HASH_SIZE - 1];  // Run time of the command handlers.
+
+
+
+// Function prototypes of local functions.
+static uint32_t UiCmdHash(const char *pcName);
+
+
+
+// Build the hash table for the command table. Returns -1 if the hash table is
+// too small.
+int UiCmdInit(const tUiCmd *psUiCmd, uint32_t ui32UiCmdNum)
+{
+    uint32_t ui32Hash;
+
+    if (ui32UiCmdNum >= UI_CMD_HASH_SIZE || ui32UiCmdNum >= UI_CMD_HASH_EMPTY) return -1;
+    g_psUiCmd = psUiCmd;
+    g_ui32UiCmdNum = ui32UiCmdNum;
+    memset(g_pui8UiCmdHash, UI_CMD_HASH_EMPTY, sizeof(g_pui8UiCmdHash));
+    // Resolve collisions by linear probing.
+    for (uint32_t i = 0; i < ui32UiCmdNum; i++) {
+        ui32Hash = UiCmdHash(psUiCmd[i].pcName);
+        while (g_pui8UiCmdHash[ui32Hash] != UI_CMD_HASH_EMPTY) {
+            ui32Hash = (ui32Hash + 1) & (UI_CMD_HASH_SIZE - 1);
+        }
+        g_pui8UiCmdHash[ui32Hash] = i;
+        g_psUiCmdPerf[i].pcName = psUiCmd[i].pcName;
+    }
+
+    return 0;
+}
+
+
+
+// Find a command in the command table. The comparison is case-insensitive.
+// Returns NULL if the command is unknown. The search stops after probing the
+// whole hash table, so it also ends if the hash table was not built.
+const tUiCmd *UiCmdFind(const char *pcName)
+{
+    uint32_t ui32Hash = UiCmdHash(pcName);
+    uint8_t ui8Index;
+
+    for (uint32_t i = 0; i < UI_CMD_HASH_SIZE; i++) {
+        ui8Index = g_pui8UiCmdHash[ui32Hash];
+        if (ui8Index == UI_CMD_HASH_EMPTY || !g_psUiCmd) break;
+        if (!strcasecmp(g_psUiCmd[ui8Index].pcName, pcName)) return &g_psUiCmd[ui8Index];
+        ui32Hash = (ui32Hash + 1) & (UI_CMD_HASH_SIZE - 1);
+    }
+
+    return NULL;
+}
+
+
+
+// Execute a command. Returns the return value of the command handler or -1
+// if the command is unknown or a required parameter is missing. The run time
+// of the command handler is measured.
+int UiCmdExec(char *pcCmd, char *pcParam)
+{
+    const tUiCmd *psUiCmd = UiCmdFind(pcCmd);
+    uint32_t ui32Cycles;
+    int iRet;
+
+    if (psUiCmd == NULL) {
+        UARTprintf("%s: Unknown command `%s'.", UI_STR_ERROR, pcCmd);
+        return -1;
+    }
+    if (psUiCmd->ui8ParamMin && pcParam == NULL) {
+        UARTprintf("%s: Parameter required after command `%s'.\n", UI_STR_ERROR, pcCmd);
+        UiCmdUsage(psUiCmd);
+        return -1;
+    }
+    g_psUiCmdCurrent = psUiCmd;
+    ui32Cycles = CycleCounterGet();
+    iRet = psUiCmd->pfnHandler(pcCmd, pcParam);
+    PerfProbeUpdate(&g_psUiCmdPerf[psUiCmd - g_psUiCmd], CycleCounterGet() - ui32Cycles);
+
+    return iRet;
+}
+
+
+
+// Get the run time statistics of a command handler.
+tPerfProbe *UiCmdPerfGet(const tUiCmd *psUiCmd)
+{
+    return &g_psUiCmdPerf[psUiCmd - g_psUiCmd];
+}
+
+
+
+// Show the help text of all commands in the order of the command table.
+void UiCmdHelp(void)
+{
+    UARTprintf("Available commands:");
+    for (uint32_t i = 0; i < g_ui32UiCmdNum; i++) {
+        UARTprintf("\n");
+        UiCmdUsage(&g_psUiCmd[i]);
+    }
+}
+
+
+
+// Show the help text of a command. Continuation lines of the help text are
+// indented.
+void UiCmdUsage(const tUiCmd *psUiCmd)
+{
+    const char *pcHelp = psUiCmd->pcHelp;
+    const char *pcEnd;
+
+    UARTprintf("  %8s%28s", psUiCmd->pcName, psUiCmd->pcParams);
+    while ((pcEnd = strchr(pcHelp, '\n')) != NULL) {
+        UARTwrite(pcHelp, pcEnd - pcHelp);
+        UARTprintf("\n%38s", "");
+        pcHelp = pcEnd + 1;
+    }
+    UARTprintf("%s", pcHelp);
+}
+
+
+
+// Convert the parameter pcParam and all following parameters of the command
+// line into numbers. At most iArgsMax parameters are converted. Returns the
+// number of parameters or -1 if less parameters than required by the current
+// command are given.
+int UiCmdParseArgs(char *pcParam, uint32_t *pui32Args, int iArgsMax)
+{
+    int iArgs;
+
+    for (iArgs = 0; iArgs < iArgsMax && pcParam != NULL; iArgs++) {
+        pui32Args[iArgs] = strtoul(pcParam, (char **) NULL, 0);
+        pcParam = strtok(NULL, UI_STR_DELIMITER);
+    }
+    if (g_psUiCmdCurrent != NULL && iArgs < g_psUiCmdCurrent->ui8ParamMin) {
+        UARTprintf("%s: At least %d parameters required after command `%s'.\n",
+                   UI_STR_ERROR, g_psUiCmdCurrent->ui8ParamMin, g_psUiCmdCurrent->pcName);
+        UiCmdUsage(g_psUiCmdCurrent);
+        return -1;
+    }
+
+    return iArgs;
+}
+
+
+
+// Calculate the hash of a command name (FNV-1a of the lower case name).
+static uint32_t UiCmdHash(const char *pcName)
+{
+    uint32_t ui32Hash = 2166136261u;
+
+    while (*pcName) {
+        char cChar = *pcName++;
+        if (cChar >= 'A' && cChar <= 'Z') cChar += 'a' - 'A';
+        ui32Hash = (ui32Hash ^ (uint8_t) cChar) * 16777619u;
+    }
+
+    return ui32Hash & (UI_CMD_HASH_SIZE - 1);
+}
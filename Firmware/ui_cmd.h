@@ -0,0 +1,51 @@
+// File: ui_cmd.h
+// Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+// Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+// Date: 17 Oct 2026
+// Rev.: 17 Oct 2026
+//
+// Header file for the command table and dispatcher of the UART user interface
+// for the TI Tiva TM4C1294 Connected LaunchPad Evaluation Kit.
+//
+
+
+
+#ifndef __UI_CMD_H__
+#define __UI_CMD_H__
+
+
+
+// Size of the hash table. Must be a power of 2 and larger than the number of
+// commands.
+#define UI_CMD_HASH_SIZE        64
+#define UI_CMD_HASH_EMPTY       0xff
+
+
+
+#include "hw/system/perf.h"
+
+
+
+// Types.
+typedef struct {
+    const char *pcName;
+    int (*pfnHandler)(char *pcCmd, char *pcParam);
+    uint8_t ui8ParamMin;        // Minimum number of parameters.
+    const char *pcParams;       // Parameters shown in the help text.
+    const char *pcHelp;         // Help text. New lines are indented.
+} tUiCmd;
+
+
+
+// Function prototypes.
+int UiCmdInit(const tUiCmd *psUiCmd, uint32_t ui32UiCmdNum);
+const tUiCmd *UiCmdFind(const char *pcName);
+int UiCmdExec(char *pcCmd, char *pcParam);
+tPerfProbe *UiCmdPerfGet(const tUiCmd *psUiCmd);
+void UiCmdHelp(void);
+void UiCmdUsage(const tUiCmd *psUiCmd);
+int UiCmdParseArgs(char *pcParam, uint32_t *pui32Args, int iArgsMax);
+
+
+
+#endif  // __UI_CMD_H__
@@ -25,6 +25,10 @@
 //*****************************************************************************
 // Changes by M. Fras on 22 Nov 2019 to support up to 8 UARTs instead of the
 // default 3 UARTs.
+// Changes by M. Fras on 17 Oct 2026 to select what happens in buffered mode
+// when the transmit buffer is full (block or drop), to count the dropped
+// characters and the maximum fill level of the transmit buffer, and to allow
+// the application to handle the receive interrupt itself.
 //*****************************************************************************
 
 #include <stdbool.h>
@@ -32,6 +36,7 @@
 #include <stdarg.h>
 #include "inc/hw_ints.h"
 #include "inc/hw_memmap.h"
+#include "inc/hw_nvic.h"
 #include "inc/hw_types.h"
 #include "inc/hw_uart.h"
 #include "driverlib/debug.h"
@@ -40,7 +45,7 @@
 #include "driverlib/rom_map.h"
 #include "driverlib/sysctl.h"
 #include "driverlib/uart.h"
-#include "utils/uartstdio.h"
+#include "uartstdio.h"
 
 //*****************************************************************************
 //
@@ -78,6 +83,17 @@ static unsigned char g_pcUARTTxBuffer[UART_TX_BUFFER_SIZE];
 static volatile uint32_t g_ui32UARTTxWriteIndex = 0;
 static volatile uint32_t g_ui32UARTTxReadIndex = 0;
 
+//*****************************************************************************
+//
+// Policy if the transmit buffer is full, the number of characters dropped
+// because of a full transmit buffer and the maximum fill level of the transmit
+// buffer.
+//
+//*****************************************************************************
+static uint32_t g_ui32UARTTxPolicy = UART_TX_POLICY_BLOCK;
+static volatile uint32_t g_ui32UARTTxDropCount = 0;
+static volatile uint32_t g_ui32UARTTxMaxUsed = 0;
+
 //*****************************************************************************
 //
 // Input ring buffer.  Buffer is full if g_ui32UARTTxReadIndex is one ahead of
@@ -328,6 +344,47 @@ UARTPrimeTransmit(uint32_t ui32Base)
 }
 #endif
 
+//*****************************************************************************
+//
+// Put a character into the transmit buffer.  If the buffer is full and the
+// blocking policy is selected, wait until the UART has taken characters out
+// of the buffer.  Waiting is not possible in an interrupt handler, so the
+// character is always dropped there.  Returns false if the character was
+// dropped.
+//
+//*****************************************************************************
+#ifdef UART_BUFFERED
+static bool
+UARTTxBufferPut(unsigned char ucChar)
+{
+    uint32_t ui32Used;
+
+    if(TX_BUFFER_FULL)
+    {
+        if((g_ui32UARTTxPolicy == UART_TX_POLICY_DROP) ||
+           (HWREG(NVIC_INT_CTRL) & NVIC_INT_CTRL_VEC_ACT_M))
+        {
+            return(false);
+        }
+        while(TX_BUFFER_FULL)
+        {
+            UARTPrimeTransmit(g_ui32Base);
+        }
+    }
+
+    g_pcUARTTxBuffer[g_ui32UARTTxWriteIndex] = ucChar;
+    ADVANCE_TX_BUFFER_INDEX(g_ui32UARTTxWriteIndex);
+
+    ui32Used = TX_BUFFER_USED;
+    if(ui32Used > g_ui32UARTTxMaxUsed)
+    {
+        g_ui32UARTTxMaxUsed = ui32Used;
+    }
+
+    return(true);
+}
+#endif
+
 //*****************************************************************************
 //
 //! Configures the UART console.
@@ -451,8 +508,11 @@ UARTStdioConfig(uint32_t ui32PortNum, uint32_t ui32Baud, uint32_t ui32SrcClock)
 //! In non-buffered mode, this function is blocking and will not return until
 //! all the characters have been written to the output FIFO.  In buffered mode,
 //! the characters are written to the UART transmit buffer and the call returns
-//! immediately.  If insufficient space remains in the transmit buffer,
-//! additional characters are discarded.
+//! immediately.  If insufficient space remains in the transmit buffer, the
+//! function waits for free space with the \b UART_TX_POLICY_BLOCK policy or
+//! discards the additional characters with the \b UART_TX_POLICY_DROP policy,
+//! see UARTTxPolicySet().  Characters written from an interrupt handler are
+//! always discarded if the transmit buffer is full.
 //!
 //! \return Returns the count of characters written.
 //
@@ -480,16 +540,12 @@ UARTwrite(const char *pcBuf, uint32_t ui32Len)
         //
         if(pcBuf[uIdx] == '\n')
         {
-            if(!TX_BUFFER_FULL)
-            {
-                g_pcUARTTxBuffer[g_ui32UARTTxWriteIndex] = '\r';
-                ADVANCE_TX_BUFFER_INDEX(g_ui32UARTTxWriteIndex);
-            }
-            else
+            if(!UARTTxBufferPut('\r'))
             {
                 //
                 // Buffer is full - discard remaining characters and return.
                 //
+                g_ui32UARTTxDropCount += ui32Len - uIdx;
                 break;
             }
         }
@@ -501,16 +557,12 @@ UARTwrite(const char *pcBuf, uint32_t ui32Len)
         //
         // Send the character to the UART output.
         //
-        if(!TX_BUFFER_FULL)
-        {
-            g_pcUARTTxBuffer[g_ui32UARTTxWriteIndex] = pcBuf[uIdx];
-            ADVANCE_TX_BUFFER_INDEX(g_ui32UARTTxWriteIndex);
-        }
-        else
+        if(!UARTTxBufferPut(pcBuf[uIdx]))
         {
             //
             // Buffer is full - discard remaining characters and return.
             //
+            g_ui32UARTTxDropCount += ui32Len - uIdx;
             break;
         }
     }
@@ -1566,6 +1618,138 @@ UARTEchoSet(bool bEnable)
 }
 #endif
 
+//*****************************************************************************
+//
+//! Selects what happens if the transmit buffer is full.
+//!
+//! \param ui32Policy is \b UART_TX_POLICY_BLOCK to wait until there is space
+//! in the transmit buffer or \b UART_TX_POLICY_DROP to discard the characters
+//! that do not fit into the transmit buffer.
+//!
+//! This function, available only when the module is built to operate in
+//! buffered mode using \b UART_BUFFERED, may be used to select whether
+//! UARTwrite() and UARTprintf() wait for space in a full transmit buffer or
+//! discard the characters.  The blocking policy is the default.  Characters
+//! written from an interrupt handler are always discarded if the transmit
+//! buffer is full.
+//!
+//! \return None.
+//
+//*****************************************************************************
+#if defined(UART_BUFFERED) || defined(DOXYGEN)
+void
+UARTTxPolicySet(uint32_t ui32Policy)
+{
+    ASSERT((ui32Policy == UART_TX_POLICY_BLOCK) ||
+           (ui32Policy == UART_TX_POLICY_DROP));
+
+    g_ui32UARTTxPolicy = ui32Policy;
+}
+#endif
+
+//*****************************************************************************
+//
+//! Returns the policy used if the transmit buffer is full.
+//!
+//! This function, available only when the module is built to operate in
+//! buffered mode using \b UART_BUFFERED, returns the policy selected with
+//! UARTTxPolicySet().
+//!
+//! \return Returns \b UART_TX_POLICY_BLOCK or \b UART_TX_POLICY_DROP.
+//
+//*****************************************************************************
+#if defined(UART_BUFFERED) || defined(DOXYGEN)
+uint32_t
+UARTTxPolicyGet(void)
+{
+    return(g_ui32UARTTxPolicy);
+}
+#endif
+
+//*****************************************************************************
+//
+//! Returns the statistics of the transmit buffer.
+//!
+//! \param pui32Dropped points to storage for the number of characters that
+//! were discarded because the transmit buffer was full.
+//! \param pui32MaxUsed points to storage for the maximum number of characters
+//! that were in the transmit buffer.
+//!
+//! This function, available only when the module is built to operate in
+//! buffered mode using \b UART_BUFFERED, may be used to tune the size of the
+//! transmit buffer with \b UART_TX_BUFFER_SIZE.  Either pointer may be 0.
+//!
+//! \return None.
+//
+//*****************************************************************************
+#if defined(UART_BUFFERED) || defined(DOXYGEN)
+void
+UARTTxStatsGet(uint32_t *pui32Dropped, uint32_t *pui32MaxUsed)
+{
+    if(pui32Dropped)
+    {
+        *pui32Dropped = g_ui32UARTTxDropCount;
+    }
+    if(pui32MaxUsed)
+    {
+        *pui32MaxUsed = g_ui32UARTTxMaxUsed;
+    }
+}
+#endif
+
+//*****************************************************************************
+//
+//! Resets the statistics of the transmit buffer.
+//!
+//! This function, available only when the module is built to operate in
+//! buffered mode using \b UART_BUFFERED, clears the counters returned by
+//! UARTTxStatsGet().
+//!
+//! \return None.
+//
+//*****************************************************************************
+#if defined(UART_BUFFERED) || defined(DOXYGEN)
+void
+UARTTxStatsReset(void)
+{
+    g_ui32UARTTxDropCount = 0;
+    g_ui32UARTTxMaxUsed = TX_BUFFER_USED;
+}
+#endif
+
+//*****************************************************************************
+//
+//! Handles the transmit part of the UART interrupt.
+//!
+//! This function, available only when the module is built to operate in
+//! buffered mode using \b UART_BUFFERED, may be called from an application
+//! interrupt handler that reads the received characters itself instead of
+//! using UARTStdioIntHandler().  It copies data from the transmit buffer to
+//! the UART transmit FIFO.  The caller must already have cleared the interrupt
+//! sources.
+//!
+//! \return None.
+//
+//*****************************************************************************
+#if defined(UART_BUFFERED) || defined(DOXYGEN)
+void
+UARTStdioTxIntHandler(void)
+{
+    //
+    // Move as many bytes as we can into the transmit FIFO.
+    //
+    UARTPrimeTransmit(g_ui32Base);
+
+    //
+    // If the output buffer is empty, turn off the transmit interrupt.
+    //
+    if(TX_BUFFER_EMPTY)
+    {
+        MAP_UARTIntDisable(g_ui32Base, UART_INT_TX);
+    }
+}
+#endif
+
 //*****************************************************************************
 //
 //! Handles UART interrupts.
@@ -53,6 +53,15 @@ extern "C"
 #endif
 #endif
 
+//*****************************************************************************
+//
+// If built for buffered operation, the following labels select what happens
+// if the transmit buffer is full.
+//
+//*****************************************************************************
+#define UART_TX_POLICY_BLOCK    0
+#define UART_TX_POLICY_DROP     1
+
 //*****************************************************************************
 //
 // Prototypes for the APIs.
@@ -72,6 +81,11 @@ extern void UARTFlushRx(void);
 extern int UARTRxBytesAvail(void);
 extern int UARTTxBytesFree(void);
 extern void UARTEchoSet(bool bEnable);
+extern void UARTTxPolicySet(uint32_t ui32Policy);
+extern uint32_t UARTTxPolicyGet(void);
+extern void UARTTxStatsGet(uint32_t *pui32Dropped, uint32_t *pui32MaxUsed);
+extern void UARTTxStatsReset(void);
+extern void UARTStdioTxIntHandler(void);
 #endif
 
 //*****************************************************************************
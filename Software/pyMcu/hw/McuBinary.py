@@ -0,0 +1,403 @@
+# File: McuBinary.py
+# Auth: M. Fras, Electronics Division, MPI for Physics, Munich
+# Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
+# Date: 17 Oct 2026
+# Rev.: 17 Oct 2026
+#
+# Python class for communicating with the TM4C1294NCPDT MCU over a serial port
+# (UART) using the binary framed command protocol.
+#
+# Frame format (all multi-byte values are little endian):
+#   SYNC SEQ OPCODE LEN PAYLOAD[LEN] CRC16[2]
+# The CRC-16/CCITT (polynomial 0x1021, initial value 0xffff) is calculated over
+# SEQ, OPCODE, LEN and PAYLOAD. The payload of a response starts with a status
+# byte. See Firmware/bin_proto.h for the opcodes.
+#
+
+
+
+import struct
+import serial
+
+
+
+class McuBinary:
+
+    # Protocol parameters.
+    protoSync               = 0xa5
+    protoPayloadMax         = 250
+    protoOpcodeResponse     = 0x80
+    adcStreamChannels       = 5
+    sensorLogFrameSamples   = 30
+
+    # Opcodes.
+    opcodePing              = 0x00
+    opcodeInfo              = 0x01
+    opcodeAdc               = 0x10
+    opcodeAdcStream         = 0x11          # Sent by the MCU only.
+    opcodeLed               = 0x20
+    opcodeRgb               = 0x21
+    opcodeI2C               = 0x30
+    opcodeSensorLog         = 0x31          # Sent by the MCU only.
+    opcodeSsi               = 0x40
+    opcodeUart              = 0x50
+    opcodeLcdClear          = 0x60
+    opcodeLcdPixel          = 0x61
+    opcodeLcdLine           = 0x62
+    opcodeLcdRect           = 0x63
+    opcodeLcdCircle         = 0x64
+    opcodeLcdText           = 0x65
+    opcodeLcdOrient         = 0x66
+    opcodeLcdBegin          = 0x67
+    opcodeLcdCommit         = 0x68
+
+    # Response status codes.
+    statusOk                = 0x00
+    statusWarning           = 0x01
+    statusErrCrc            = 0x02
+    statusErrTimeout        = 0x03
+    statusErrLength         = 0x04
+    statusErrOpcode         = 0x05
+    statusErrParam          = 0x06
+    statusErrHw             = 0x07
+    statusErrComm           = -1            # No valid response received.
+    statusStr = {
+        statusOk:           "OK",
+        statusWarning:      "Warning",
+        statusErrCrc:       "CRC error",
+        statusErrTimeout:   "Timeout",
+        statusErrLength:    "Length error",
+        statusErrOpcode:    "Unknown opcode",
+        statusErrParam:     "Parameter error",
+        statusErrHw:        "Hardware error",
+        statusErrComm:      "Communication error",
+    }
+
+    # Message prefixes and separators.
+    prefixDetails       = " - "
+    separatorDetails    = " - "
+    prefixError = "ERROR: {0:s}: ".format(__file__)
+    prefixDebug = "DEBUG: {0:s}: ".format(__file__)
+
+    # Debug configuration.
+    debugLevel = 0                 # Debug verbosity.
+
+
+
+    # Initialize the serial port for communication with the MCU.
+    def __init__(self, port):
+        self.ser = serial.Serial()
+        self.ser.port = port
+        self.ser.baudrate = 115200
+        self.ser.bytesize = serial.EIGHTBITS
+        self.ser.parity = serial.PARITY_NONE
+        self.ser.stopbits = serial.STOPBITS_ONE
+        self.ser.timeout = 1                # Timeout for a response.
+        self.ser.xonxoff = False            # Disable software flow control.
+        self.ser.rtscts = False             # Disable hardware (RTS/CTS) flow control.
+        self.ser.dsrdtr = False             # Disable hardware (DSR/DTR) flow control.
+        self.ser.writeTimeout = 2           # Timeout for write.
+        self.seq = 0
+        self.errorCount = 0
+        self.accessRead = 0
+        self.accessWrite = 0
+        self.bytesRead = 0
+        self.bytesWritten = 0
+        self.bytesSkipped = 0
+        try:
+            self.ser.open()
+        except Exception as e:
+            self.errorCount += 1
+            print(self.prefixError + "Error opening serial port `" + port + "': " + str(e))
+            exit(-1)
+
+
+
+    # Print details.
+    def print_details(self):
+        print(self.prefixDetails, end='')
+        print("UART port: " + self.ser.port, end='')
+        print(self.separatorDetails + "Baud rate: {0:d}".format(self.ser.baudrate), end='')
+        print(self.separatorDetails + "Protocol: binary", end='')
+        if self.debugLevel >= 1:
+            print(self.separatorDetails + "Error count: {0:d}".format(self.errorCount), end='')
+            print(self.separatorDetails + "Read access count: {0:d}".format(self.accessRead), end='')
+            print(self.separatorDetails + "Write access count: {0:d}".format(self.accessWrite), end='')
+            print(self.separatorDetails + "Bytes read: {0:d}".format(self.bytesRead), end='')
+            print(self.separatorDetails + "Bytes written: {0:d}".format(self.bytesWritten), end='')
+            print(self.separatorDetails + "Bytes skipped: {0:d}".format(self.bytesSkipped), end='')
+        print()
+        return 0
+
+
+
+    # Calculate the CRC-16/CCITT.
+    @staticmethod
+    def crc16(data, crc=0xffff):
+        for b in data:
+            crc ^= b << 8
+            for i in range(8):
+                if crc & 0x8000:
+                    crc = ((crc << 1) ^ 0x1021) & 0xffff
+                else:
+                    crc = (crc << 1) & 0xffff
+        return crc
+
+
+
+    # Build a frame.
+    @classmethod
+    def frame(cls, seq, opcode, payload):
+        body = bytes([seq & 0xff, opcode & 0xff, len(payload)]) + bytes(payload)
+        return bytes([cls.protoSync]) + body + struct.pack("<H", cls.crc16(body))
+
+
+
+    # Read exactly cnt bytes. Returns None on timeout.
+    def read_exact(self, cnt):
+        data = self.ser.read(cnt)
+        self.bytesRead += len(data)
+        if len(data) != cnt:
+            return None
+        return data
+
+
+
+    # Receive a frame. Any text output (e.g. the command prompt) up to the sync
+    # byte is skipped. Returns a tuple of the header (SEQ, OPCODE, LEN) and the
+    # payload or None on timeout or CRC error.
+    def recv_frame(self):
+        while True:
+            b = self.read_exact(1)
+            if b is None:
+                return None
+            if b[0] != self.protoSync:
+                self.bytesSkipped += 1
+                continue
+            header = self.read_exact(3)
+            if header is None:
+                return None
+            data = self.read_exact(header[2] + 2)
+            if data is None:
+                return None
+            body = header + data[:-2]
+            if struct.unpack("<H", data[-2:])[0] != self.crc16(body):
+                if self.debugLevel >= 1:
+                    print(self.prefixDebug + "CRC error in frame: " + body.hex())
+                return None
+            if self.debugLevel >= 2:
+                print(self.prefixDebug + "Received frame: " + body.hex())
+            return header, data[:-2]
+
+
+
+    # Send a command frame and receive the response.
+    # Returns a tuple of the status and the response data.
+    def cmd(self, opcode, payload=b""):
+        if len(payload) > self.protoPayloadMax:
+            self.errorCount += 1
+            print(self.prefixError + "Payload of {0:d} bytes exceeds the maximum of {1:d} bytes!".format(len(payload), self.protoPayloadMax))
+            return self.statusErrLength, b""
+        seq = self.seq
+        self.seq = (self.seq + 1) & 0xff
+        frame = self.frame(seq, opcode, payload)
+        if self.debugLevel >= 2:
+            print(self.prefixDebug + "Sending frame: " + frame.hex())
+        try:
+            self.ser.write(frame)
+            self.ser.flush()
+            self.accessWrite += 1
+            self.bytesWritten += len(frame)
+        except Exception as e:
+            self.errorCount += 1
+            print(self.prefixError + "Error writing to serial port `" + self.ser.portstr + "': " + str(e))
+            return self.statusErrComm, b""
+        try:
+            self.accessRead += 1
+            while True:
+                frame = self.recv_frame()
+                if frame is None:
+                    break
+                header, data = frame
+                if header[0] != seq or header[1] != (opcode | self.protoOpcodeResponse) or header[2] < 1:
+                    if self.debugLevel >= 1:
+                        print(self.prefixDebug + "Discarding unexpected response frame: " + (header + data).hex())
+                    continue
+                status = data[0]
+                if status not in (self.statusOk, self.statusWarning):
+                    self.errorCount += 1
+                return status, data[1:]
+        except Exception as e:
+            self.errorCount += 1
+            print(self.prefixError + "Error reading from serial port `" + self.ser.portstr + "': " + str(e))
+            return self.statusErrComm, b""
+        self.errorCount += 1
+        print(self.prefixError + "No valid response to opcode 0x{0:02x} received!".format(opcode))
+        return self.statusErrComm, b""
+
+
+
+    # Echo the payload.
+    def ping(self, payload=b""):
+        return self.cmd(self.opcodePing, payload)
+
+    # Firmware name, version and release date.
+    def info(self):
+        status, data = self.cmd(self.opcodeInfo)
+        return status, data.decode('utf-8', 'replace')
+
+    # Read all ADC values: joystick X/Y, accelerometer X/Y/Z.
+    def adc_read(self):
+        status, data = self.cmd(self.opcodeAdc)
+        if len(data) != 10:
+            return status, ()
+        return status, struct.unpack("<5H", data)
+
+    # Stream ADC values with the `adc-str' shell command. The rate is given in
+    # samples/s per channel. Returns a tuple of the number of blocks lost and a
+    # list of sample sets (joystick X/Y, accelerometer X/Y/Z).
+    def adc_stream(self, rate, blocks):
+        samples = []
+        blockNext = 0
+        blocksLost = 0
+        try:
+            cmd = "adc-str {0:d} {1:d}\r".format(rate, blocks).encode('utf-8')
+            self.ser.write(cmd)
+            self.ser.flush()
+            self.accessWrite += 1
+            self.bytesWritten += len(cmd)
+            self.accessRead += 1
+            while blocks > 0:
+                frame = self.recv_frame()
+                if frame is None:
+                    self.errorCount += 1
+                    print(self.prefixError + "ADC stream interrupted after {0:d} sample sets!".format(len(samples)))
+                    break
+                header, data = frame
+                if header[1] != (self.opcodeAdcStream | self.protoOpcodeResponse) or len(data) < 5:
+                    continue
+                block = struct.unpack("<I", data[1:5])[0]
+                blocksLost += block - blockNext
+                blockNext = block + 1
+                cnt = (len(data) - 5) // 2
+                values = struct.unpack("<{0:d}H".format(cnt), data[5:5 + 2 * cnt])
+                for i in range(0, cnt - self.adcStreamChannels + 1, self.adcStreamChannels):
+                    samples.append(values[i:i + self.adcStreamChannels])
+                blocks -= 1
+        except Exception as e:
+            self.errorCount += 1
+            print(self.prefixError + "Error accessing serial port `" + self.ser.portstr + "': " + str(e))
+        return blocksLost, samples
+
+    # Dump the sensor log with the `sensor dump' shell command. Returns a list
+    # of samples (time in microseconds, channel, raw register value). The dump
+    # ends with a frame holding less than sensorLogFrameSamples samples.
+    def sensor_log_dump(self):
+        samples = []
+        try:
+            cmd = "sensor dump\r".encode('utf-8')
+            self.ser.write(cmd)
+            self.ser.flush()
+            self.accessWrite += 1
+            self.bytesWritten += len(cmd)
+            self.accessRead += 1
+            while True:
+                frame = self.recv_frame()
+                if frame is None:
+                    self.errorCount += 1
+                    print(self.prefixError + "Sensor log dump interrupted after {0:d} samples!".format(len(samples)))
+                    break
+                header, data = frame
+                if header[1] != (self.opcodeSensorLog | self.protoOpcodeResponse) or len(data) < 5:
+                    continue
+                cnt = (len(data) - 5) // 8
+                for i in range(cnt):
+                    timeUs, raw, channel, _ = struct.unpack("<IHBB", data[5 + 8 * i:13 + 8 * i])
+                    samples.append((timeUs, channel, raw))
+                if cnt < self.sensorLogFrameSamples:
+                    break
+        except Exception as e:
+            self.errorCount += 1
+            print(self.prefixError + "Error accessing serial port `" + self.ser.portstr + "': " + str(e))
+        return samples
+
+    # Get the LED value.
+    def led_get(self):
+        status, data = self.cmd(self.opcodeLed)
+        return status, data[0] if data else -1
+
+    # Set the LED value.
+    def led_set(self, value):
+        status, data = self.cmd(self.opcodeLed, bytes([value & 0xff]))
+        return status, data[0] if data else -1
+
+    # Set the RGB LED.
+    def rgb_set(self, r, g, b):
+        return self.cmd(self.opcodeRgb, bytes([r & 0xff, g & 0xff, b & 0xff]))[0]
+
+    # I2C access. The access mode bits are the same as for the `i2c' shell command.
+    # Returns a tuple of the status, the I2C master status and the read data.
+    def i2c(self, port, slaveAddr, accMode, data=b"", num=None):
+        payload = bytes([port & 0xff, slaveAddr & 0xff, accMode & 0x0f]) + bytes(data)
+        if num is not None:
+            payload += bytes([num & 0xff])
+        status, resp = self.cmd(self.opcodeI2C, payload)
+        if len(resp) < 4:
+            return status, -1, b""
+        return status, struct.unpack("<I", resp[:4])[0], resp[4:]
+
+    # I2C write.
+    def i2c_write(self, port, slaveAddr, data):
+        return self.i2c(port, slaveAddr, 0x0, data=data)
+
+    # I2C read.
+    def i2c_read(self, port, slaveAddr, num):
+        return self.i2c(port, slaveAddr, 0x1, num=num)
+
+    # SSI write of 16-bit data items.
+    def ssi_write(self, port, data):
+        payload = bytes([port & 0xff, 0]) + struct.pack("<{0:d}H".format(len(data)), *data)
+        return self.cmd(self.opcodeSsi, payload)[0]
+
+    # SSI read of 16-bit data items.
+    def ssi_read(self, port, num):
+        status, data = self.cmd(self.opcodeSsi, bytes([port & 0xff, 1, num & 0xff]))
+        return status, list(struct.unpack("<{0:d}H".format(len(data) // 2), data[:len(data) // 2 * 2]))
+
+    # UART write.
+    def uart_write(self, port, data):
+        return self.cmd(self.opcodeUart, bytes([port & 0xff, 0]) + bytes(data))[0]
+
+    # UART read.
+    def uart_read(self, port, num):
+        return self.cmd(self.opcodeUart, bytes([port & 0xff, 1, num & 0xff]))
+
+    # LCD commands.
+    def lcd_clear(self, color):
+        return self.cmd(self.opcodeLcdClear, struct.pack("<I", color))[0]
+
+    def lcd_pixel(self, x, y, color):
+        return self.cmd(self.opcodeLcdPixel, struct.pack("<hhI", x, y, color))[0]
+
+    def lcd_line(self, x1, y1, x2, y2, color):
+        return self.cmd(self.opcodeLcdLine, struct.pack("<hhhhI", x1, y1, x2, y2, color))[0]
+
+    def lcd_rect(self, x1, y1, x2, y2, color, fill):
+        return self.cmd(self.opcodeLcdRect, struct.pack("<hhhhIB", x1, y1, x2, y2, color, 1 if fill else 0))[0]
+
+    def lcd_circle(self, x, y, radius, color, fill):
+        return self.cmd(self.opcodeLcdCircle, struct.pack("<hhhIB", x, y, radius, color, 1 if fill else 0))[0]
+
+    def lcd_text(self, text, x, y, color, center):
+        return self.cmd(self.opcodeLcdText, struct.pack("<hhIB", x, y, color, 1 if center else 0) + text.encode('utf-8'))[0]
+
+    def lcd_orient(self, orientation):
+        return self.cmd(self.opcodeLcdOrient, bytes([orientation & 0xff]))[0]
+
+    def lcd_begin(self, timeoutMs=None):
+        if timeoutMs is None:
+            return self.cmd(self.opcodeLcdBegin)[0]
+        return self.cmd(self.opcodeLcdBegin, struct.pack("<I", timeoutMs))[0]
+
+    def lcd_commit(self):
+        return self.cmd(self.opcodeLcdCommit)[0]
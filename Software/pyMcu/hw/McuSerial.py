@@ -2,7 +2,7 @@
 # Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 # Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 # Date: 24 Mar 2020
-# Rev.: 04 May 2020
+# Rev.: 17 Oct 2026
 #
 # Python class for communicating with the TM4C1294NCPDT MCU over a serial port
 # (UART).
@@ -11,6 +11,7 @@
 
 
 import serial
+import time
 
 
 
@@ -29,6 +30,7 @@ class McuSerial:
     mcuResponseCodeError    = 2
     mcuResponseCodeFatal    = 3
     mcuResponseCodeUnknown  = -1
+    mcuTagChar              = "@"
 
     # Message prefixes and separators.
     prefixDetails       = " - "
@@ -64,6 +66,7 @@ class McuSerial:
         self.accessWrite = 0
         self.bytesRead = 0
         self.bytesWritten = 0
+        self.simTags = []
 
         try:
             if port:
@@ -238,3 +241,72 @@ class McuSerial:
             print(self.prefixError + "Error reading from serial port `" + self.ser.portstr + "': " + str(e))
             return -1
 
+
+
+
+    # Send a pipelined MCU command tagged with an ID to the serial port. This
+    # does not wait for the response, so several commands can be in flight.
+    # The responses are received with recv_tagged.
+    def send_tagged(self, cmd, tag):
+        if self.simulateHwAccess:
+            print(self.simulateHwAccessMsg + " Sending MCU command: " + cmd)
+            self.simTags.append(str(tag))
+            return self.mcuResponseCodeOk
+        cmdTagged = self.mcuTagChar + str(tag) + " " + cmd + "\r"
+        try:
+            if self.debugLevel >= 2:
+                print(self.prefixDebug + "Sending tagged MCU command: " + cmdTagged.rstrip("\r"))
+            self.ser.write(cmdTagged.encode('utf-8'))
+            self.accessWrite += 1
+            self.bytesWritten += len(cmdTagged)
+        except Exception as e:
+            self.errorCount += 1
+            print(self.prefixError + "Error writing to serial port `" + self.ser.portstr + "': " + str(e))
+            return -1
+        return 0
+
+
+
+    # Receive the response to a pipelined MCU command. The response starts with
+    # `@TAG ' and ends with a line `@TAG.'. Text outside of a tagged response
+    # (e.g. command prompts) is discarded. The response is stored like for the
+    # send function, so it can be evaluated with eval, get and get_full.
+    # Returns the tag, or None on timeout.
+    def recv_tagged(self, timeout=2.0):
+        self.mcuResponse = ""
+        if self.simulateHwAccess:
+            self.mcuResponse = self.mcuResponseOk + " (simulated hardware access)"
+            return self.simTags.pop(0) if self.simTags else None
+        tag = None
+        line = ""
+        tStart = time.time()
+        try:
+            self.accessRead += 1
+            while time.time() - tStart < timeout:
+                # Collect a full line, as readline returns partial data on timeout.
+                data = self.ser.readline().decode('utf-8', 'replace')
+                self.bytesRead += len(data)
+                line += data
+                if not line.endswith("\n"):
+                    continue
+                if tag is None:
+                    # Start of a tagged response, possibly after a prompt.
+                    while line.startswith(self.mcuCmdPrompt):
+                        line = line[len(self.mcuCmdPrompt):]
+                    if line.startswith(self.mcuTagChar):
+                        tag, sep, rest = line[len(self.mcuTagChar):].partition(" ")
+                        self.mcuResponse = rest
+                    line = ""
+                    continue
+                # End of the tagged response.
+                if line.rstrip("\n\r") == self.mcuTagChar + tag + ".":
+                    self.mcuResponse = self.mcuResponse.rstrip("\n\r")
+                    return tag
+                self.mcuResponse += line
+                line = ""
+        except Exception as e:
+            self.errorCount += 1
+            print(self.prefixError + "Error reading from serial port `" + self.ser.portstr + "': " + str(e))
+            return None
+        self.errorCount += 1
+        return None
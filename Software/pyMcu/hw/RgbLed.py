@@ -2,7 +2,7 @@
 # Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 # Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 # Date: 30 Mar 2020
-# Rev.: 21 Apr 2020
+# Rev.: 17 Oct 2026
 #
 # Python class for setting an RGB LED connected to PWM ports of the
 # TM4C1294NCPDT MCU.
@@ -60,3 +60,31 @@ class RgbLed:
             return ret
         return 0
 
+
+
+    # Run an effect of the RGB LED on the MCU: fade or breathe to the color
+    # valRgb (0xRRGGBB), ramp through the color wheel or stop the effect. The
+    # duration of a fade or the period is given in milliseconds.
+    def effect(self, effect, valRgb=0, periodMs=1000):
+        if effect == "stop":
+            cmd = "rgb stop"
+        elif effect == "ramp":
+            cmd = "rgb ramp {0:d}".format(periodMs)
+        else:
+            cmd = "rgb {0:s} 0x{1:06x} {2:d}".format(effect, valRgb & 0xffffff, periodMs)
+        # Debug: Show command.
+        if self.debugLevel >= 3:
+            print(self.prefixDebug + "Sending command for RGB LED: " + cmd)
+        # Send command.
+        self.mcuSer.send(cmd)
+        # Evaluate response.
+        ret = self.mcuSer.eval()
+        if ret:
+            self.errorCount += 1
+            print(self.prefixError + "Error sending command for RGB LED effect!")
+            if self.debugLevel >= 1:
+                print(self.prefixError + "Command sent to MCU: " + cmd)
+                print(self.prefixError + "Response from MCU:")
+                print(self.mcuSer.get_full())
+            return ret
+        return 0
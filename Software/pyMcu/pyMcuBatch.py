@@ -4,7 +4,7 @@
 # Auth: M. Fras, Electronics Division, MPI for Physics, Munich
 # Mod.: M. Fras, Electronics Division, MPI for Physics, Munich
 # Date: 20 Apr 2020
-# Rev.: 05 May 2020
+# Rev.: 17 Oct 2026
 #
 # Python script to load and execute a batch of MCU commands from a file on the
 # TM4C1294NCPDT MCU on the TM4C1294 Connected LaunchPad Evaluation Kit over a
@@ -51,7 +51,10 @@ mcuCmdDefLcdText        = "text"
 
 
 # Load and execute an MCU command batch.
-def exec_batch(serialDevice, batchFileName, stopOnError, verbosity):
+# With pipelineDepth > 1, up to pipelineDepth commands are sent tagged with
+# their line number without waiting for the responses. The responses are
+# evaluated when they arrive.
+def exec_batch(serialDevice, batchFileName, stopOnError, verbosity, pipelineDepth=1, benchmark=False):
     # Check if batchFileName is a file.
     if not os.path.isfile(batchFileName):
         print(prefixError + "The MCU command batch file parameter `{0:s}' is not a file!".format(batchFileName))
@@ -78,6 +81,56 @@ def exec_batch(serialDevice, batchFileName, stopOnError, verbosity):
     mcuSer.ser.mcuReadLineMax = 200
     mcuSer.ser.timeout = 0.05
 
+    # Commands in flight in pipeline mode: tag -> (line number, command, evaluate response).
+    mcuCmdPending = {}
+
+    # Evaluate the MCU response. Returns True if the execution should stop.
+    def eval_response(lineNumber, mcuCmdStr, evaluateResponse):
+        nonlocal okCount, warningCount, errorCount
+        # Debug message,
+        if verbosity >= 2:
+            print(mcuSer.get_full())
+        if not evaluateResponse:
+            return False
+        ret = mcuSer.eval()
+        if ret == mcuSer.mcuResponseCodeOk:
+            okCount += 1
+        elif ret == mcuSer.mcuResponseCodeWarning:
+            warningCount += 1
+            if verbosity >= 1:
+                print(prefixWarning + "Line {0:d}: Warning during execution of MCU command.".format(lineNumber), end='')
+                print(" Command batch file `{0:s}' line {1:d}: MCU command `{2:s}'".\
+                    format(batchFileName, lineNumber, mcuCmdStr))
+        else:
+            errorCount += 1
+            print(prefixError + "Line {0:d}: Error executing MCU command! Error code: {1:d}".format(lineNumber, ret), end='')
+            print(" Command batch file `{0:s}' line {1:d}: MCU command `{2:s}'".\
+                format(batchFileName, lineNumber, mcuCmdStr))
+            if stopOnError:
+                print("\n*** ", end='')
+                print(prefixError + "Execution of file `{0:s}' stopped after error in line {1:d}.".format(batchFileName, lineNumber))
+                return True
+        return False
+
+    # Receive pipelined responses until at most pendingMax commands are in flight.
+    # Returns True if the execution should stop.
+    def recv_pending(pendingMax):
+        nonlocal errorCount
+        stop = False
+        while len(mcuCmdPending) > pendingMax:
+            tag = mcuSer.recv_tagged()
+            if tag not in mcuCmdPending:
+                errorCount += len(mcuCmdPending)
+                print(prefixError + "No response received for {0:d} pipelined MCU command(s)!".format(len(mcuCmdPending)))
+                mcuCmdPending.clear()
+                return True
+            lineNumber, mcuCmdStr, evaluateResponse = mcuCmdPending.pop(tag)
+            if eval_response(lineNumber, mcuCmdStr, evaluateResponse):
+                stop = True
+        return stop
+
+    timeStart = time.time()
+
     # Read and process the batch command file.
     with open(batchFileName) as fileBatch:
         for fileBatchLine in fileBatch:
@@ -115,6 +168,9 @@ def exec_batch(serialDevice, batchFileName, stopOnError, verbosity):
                     continue
                 else:
                     internalCmdCount += 1
+                    # Wait until all pipelined commands have been executed.
+                    if recv_pending(0) and stopOnError:
+                        break
                     delayVal = int(lineElements[1], 0)
                     time.sleep(delayVal / 1e6)
                     continue
@@ -147,6 +203,19 @@ def exec_batch(serialDevice, batchFileName, stopOnError, verbosity):
             # Debug message,
             if verbosity >= 2:
                 print(mcuCmdPrompt + mcuCmdStr)
+            # Execute MCU command in pipeline mode.
+            if pipelineDepth > 1:
+                tag = str(batchFileLineCount)
+                if mcuSer.send_tagged(mcuCmdStr, tag):
+                    errorCount += 1
+                    print(prefixError + "Line {0:d}: Error sending command to MCU!".format(batchFileLineCount))
+                    if stopOnError:
+                        break
+                    continue
+                mcuCmdPending[tag] = (batchFileLineCount, mcuCmdStr, evaluateResponse)
+                if recv_pending(pipelineDepth - 1) and stopOnError:
+                    break
+                continue
             # Execute MCU command.
             ret = mcuSer.send(mcuCmdStr)
             if ret:
@@ -159,29 +228,12 @@ def exec_batch(serialDevice, batchFileName, stopOnError, verbosity):
                     print(prefixError + "Execution of file `{0:s}' stopped after error in line {1:d}.".format(batchFileName, batchFileLineCount))
                     break
                 continue
-            # Debug message,
-            if verbosity >= 2:
-                print(mcuSer.get_full())
             # Evaluate response.
-            if evaluateResponse:
-                ret = mcuSer.eval()
-                if ret == mcuSer.mcuResponseCodeOk:
-                    okCount += 1
-                elif ret == mcuSer.mcuResponseCodeWarning:
-                    warningCount += 1
-                    if verbosity >= 1:
-                        print(prefixWarning + "Line {0:d}: Warning during execution of MCU command.".format(batchFileLineCount), end='')
-                        print(" Command batch file `{0:s}' line {1:d}: MCU command `{2:s}'".\
-                            format(batchFileName, batchFileLineCount, mcuCmdStr))
-                else:
-                    errorCount += 1
-                    print(prefixError + "Line {0:d}: Error executing MCU command! Error code: {1:d}".format(batchFileLineCount, ret), end='')
-                    print(" Command batch file `{0:s}' line {1:d}: MCU command `{2:s}'".\
-                        format(batchFileName, batchFileLineCount, mcuCmdStr))
-                    if stopOnError:
-                        print("\n*** ", end='')
-                        print(prefixError + "Execution of file `{0:s}' stopped after error in line {1:d}.".format(batchFileName, batchFileLineCount))
-                        break
+            if eval_response(batchFileLineCount, mcuCmdStr, evaluateResponse):
+                break
+    # Wait for the responses of the remaining pipelined commands.
+    recv_pending(0)
+    timeElapsed = time.time() - timeStart
     if verbosity >= 2:
         print()
     if verbosity >= 1:
@@ -192,6 +244,11 @@ def exec_batch(serialDevice, batchFileName, stopOnError, verbosity):
         print("MCU commands w/o evaluation: {0:d}".format(noEvalCount))
         print("MCU command warnings:        {0:d}".format(warningCount))
         print("MCU command errors:          {0:d}".format(errorCount))
+    if benchmark:
+        print("Pipeline depth:              {0:d}".format(pipelineDepth))
+        print("Execution time:              {0:.3f} s".format(timeElapsed))
+        if timeElapsed > 0:
+            print("MCU commands per second:     {0:.1f}".format(mcuCmdCount / timeElapsed))
     if errorCount > 0:
         return -1
     return 0
@@ -212,11 +269,18 @@ if __name__ == "__main__":
     parser.add_argument('-s', '--stop-on-error', action='store_true',
                         dest='stopOnError', default=False,
                         help='Serial device to access the MCU.')
+    parser.add_argument('-p', '--pipeline', action='store', type=int,
+                        dest='pipelineDepth', default=1,
+                        help='Number of MCU commands sent without waiting for the response. The default is 1.')
+    parser.add_argument('-b', '--benchmark', action='store_true',
+                        dest='benchmark', default=False,
+                        help='Show the execution time and the achieved MCU commands per second.')
     parser.add_argument('-v', '--verbosity', action='store', type=int,
                         dest='verbosity', default="1", choices=range(0, 5),
                         help='Set the verbosity level. The default is 1.')
     args = parser.parse_args()
 
     # Load and execute the MCU command batch file.
-    exit(exec_batch(args.serialDevice, args.batchFileName, args.stopOnError, args.verbosity))
+    exit(exec_batch(args.serialDevice, args.batchFileName, args.stopOnError, args.verbosity,
+                    args.pipelineDepth, args.benchmark))
 